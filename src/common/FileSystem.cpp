@@ -45,6 +45,9 @@ along with Daemon Source Code.  If not, see <http://www.gnu.org/licenses/>.
 #include <fcntl.h>
 #include <dirent.h>
 #include <unistd.h>
+#ifndef BUILD_VM
+#include <sys/mman.h>
+#endif
 #endif
 #ifdef __APPLE__
 #include <mach-o/dyld.h>
@@ -902,10 +905,81 @@ public:
 			ClearErrorCode(err);
 	}
 
+	// Get the position of the currently open file in the archive. This only
+	// succeeds for files that are stored without compression or encryption.
+	bool GetStoredRange(offset_t& offset, offset_t& length, uint32_t& crc, std::error_code& err) const
+	{
+		unz_file_info64 fileInfo;
+		int result = unzGetCurrentFileInfo64(zipFile, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0);
+		if (result != UNZ_OK) {
+			SetErrorCodeZlib(err, result);
+			return false;
+		}
+		ClearErrorCode(err);
+
+		// Bit 0 of the flags indicates an encrypted file
+		if (fileInfo.compression_method != 0 || (fileInfo.flag & 1) || fileInfo.compressed_size != fileInfo.uncompressed_size)
+			return false;
+		offset = unzGetCurrentFileZStreamPos64(zipFile);
+		length = fileInfo.uncompressed_size;
+		crc = fileInfo.crc;
+		return true;
+	}
+
 private:
 	unzFile zipFile;
 };
 
+#ifndef BUILD_VM
+// Read-only memory mapping of an entire zip pak
+class PakMapping {
+public:
+	PakMapping(const char* base, size_t size)
+		: base(base), size(size) {}
+
+	// Noncopyable
+	PakMapping(const PakMapping&) = delete;
+	PakMapping& operator=(const PakMapping&) = delete;
+
+	~PakMapping()
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(base);
+#else
+		munmap(const_cast<char*>(base), size);
+#endif
+	}
+
+	// Map a pak from an existing file descriptor, returns null on failure.
+	// The mapping stays valid after the file descriptor is closed.
+	static std::shared_ptr<const PakMapping> Map(int fd)
+	{
+		my_stat_t st;
+		if (my_fstat(fd, &st) == -1 || st.st_size <= 0 || static_cast<uint64_t>(st.st_size) > SIZE_MAX)
+			return nullptr;
+
+#ifdef _WIN32
+		HANDLE mapping = CreateFileMappingW(reinterpret_cast<HANDLE>(_get_osfhandle(fd)), nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+			return nullptr;
+		void* base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if (!base)
+			return nullptr;
+#else
+		void* base = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if (base == MAP_FAILED)
+			return nullptr;
+#endif
+
+		return std::make_shared<PakMapping>(static_cast<const char*>(base), st.st_size);
+	}
+
+	const char* base;
+	size_t size;
+};
+#endif
+
 } // GCC bug workaround
 
 namespace PakPath {
@@ -917,6 +991,12 @@ static std::vector<PakInfo> loadedPaks;
 // the offset_t is the position within the zip archive (unused for PAK_DIR).
 static std::unordered_map<std::string, std::pair<uint32_t, offset_t>> fileMap;
 
+#ifndef BUILD_VM
+// Memory mappings of the loaded paks, indexed like loadedPaks. This is null
+// for directories and for zip paks that could not be mapped.
+static std::vector<std::shared_ptr<const PakMapping>> pakMappings;
+#endif
+
 #ifndef BUILD_VM
 // Parse the dependencies file of a package
 // Each line of the dependencies file is a name followed by an optional version
@@ -1007,6 +1087,7 @@ static void InternalLoadPak(const PakInfo& pak, Util::optional<uint32_t> expecte
 	// Add the pak to the list of loaded paks
 	Com_Printf("Loading pak '%s'...\n", pak.path.c_str());
 	loadedPaks.push_back(pak);
+	pakMappings.emplace_back();
 
 	// Update the list of files, but don't overwrite existing files to preserve sort order
 	if (pak.type == PAK_DIR) {
@@ -1033,6 +1114,11 @@ static void InternalLoadPak(const PakInfo& pak, Util::optional<uint32_t> expecte
 			return;
 		}
 
+		// Map the pak so files stored in it can be used without copying them
+		pakMappings.back() = PakMapping::Map(loadedPaks.back().fd);
+		if (!pakMappings.back())
+			fsLogs.Debug("Could not map pak '%s', files will be read from it instead", pak.path);
+
 		// Open zip
 		zipFile = ZipArchive::Open(loadedPaks.back().fd, err);
 		if (HaveError(err))
@@ -1120,6 +1206,7 @@ void LoadPakExplicit(const PakInfo& pak, uint32_t expectedChecksum, std::error_c
 void ClearPaks()
 {
 	fileMap.clear();
+	pakMappings.clear();
 	for (PakInfo& x: loadedPaks) {
 		if (x.type == PAK_ZIP)
 			close(x.fd);
@@ -1134,6 +1221,29 @@ const std::vector<PakInfo>& GetLoadedPaks()
 	return loadedPaks;
 }
 
+// Read the file currently open in a zip archive
+static std::string ReadZipFile(const ZipArchive& zipFile, std::error_code& err)
+{
+	// Get file length
+	offset_t length = zipFile.FileLength(err);
+	if (HaveError(err))
+		return "";
+
+	// Read file
+	std::string out;
+	out.resize(length);
+	zipFile.ReadFile(&out[0], length, err);
+	if (HaveError(err))
+		return "";
+
+	// Close file and check for CRC errors
+	zipFile.CloseFile(err);
+	if (HaveError(err))
+		return "";
+
+	return out;
+}
+
 std::string ReadFile(Str::StringRef path, std::error_code& err)
 {
 	auto it = fileMap.find(path);
@@ -1176,25 +1286,68 @@ std::string ReadFile(Str::StringRef path, std::error_code& err)
 		if (HaveError(err))
 			return "";
 
-		// Get file length
-		offset_t length = zipFile.FileLength(err);
-		if (HaveError(err))
-			return "";
+		return ReadZipFile(zipFile, err);
+	}
+}
 
-		// Read file
-		std::string out;
-		out.resize(length);
-		zipFile.ReadFile(&out[0], length, err);
+FileView ViewFile(Str::StringRef path, std::error_code& err)
+{
+	auto it = fileMap.find(path);
+	if (it == fileMap.end()) {
+		SetErrorCodeFilesystem(err, filesystem_error::no_such_file);
+		return FileView();
+	}
+
+	const PakInfo& pak = loadedPaks[it->second.first];
+	std::shared_ptr<std::string> buffer;
+	if (pak.type == PAK_DIR) {
+		buffer = std::make_shared<std::string>(ReadFile(path, err));
 		if (HaveError(err))
-			return "";
+			return FileView();
+	} else {
+		// Open zip
+		ZipArchive zipFile = ZipArchive::Open(pak.fd, err);
+		if (HaveError(err))
+			return FileView();
 
-		// Close file and check for CRC errors
-		zipFile.CloseFile(err);
+		// Open file in zip
+		zipFile.OpenFile(it->second.second, err);
 		if (HaveError(err))
-			return "";
+			return FileView();
 
-		return out;
+#ifndef BUILD_VM
+		// Stored files can be used directly from the mapping
+		const std::shared_ptr<const PakMapping>& mapping = pakMappings[it->second.first];
+		if (mapping) {
+			offset_t offset, length;
+			uint32_t crc;
+			bool stored = zipFile.GetStoredRange(offset, length, crc, err);
+			if (HaveError(err))
+				return FileView();
+
+			if (stored && offset >= 0 && static_cast<uint64_t>(offset + length) <= mapping->size) {
+				// Check for CRC errors like a read from the zip would
+				const char* data = mapping->base + offset;
+				uLong dataCrc = crc32(0, Z_NULL, 0);
+				for (offset_t pos = 0; pos < length; pos += INT_MAX)
+					dataCrc = crc32(dataCrc, reinterpret_cast<const Bytef*>(data + pos), std::min<offset_t>(length - pos, INT_MAX));
+				if (dataCrc != crc) {
+					SetErrorCodeZlib(err, UNZ_CRCERROR);
+					return FileView();
+				}
+
+				return FileView(mapping, data, length);
+			}
+		}
+#endif
+
+		// Compressed files are inflated into a buffer shared by all views
+		buffer = std::make_shared<std::string>(ReadZipFile(zipFile, err));
+		if (HaveError(err))
+			return FileView();
 	}
+
+	return FileView(buffer, buffer->data(), buffer->size());
 }
 
 void CopyFile(Str::StringRef path, const File& dest, std::error_code& err)
@@ -116,6 +116,44 @@ private:
 	FILE* fd;
 };
 
+// Read-only contents of a file. Files stored uncompressed in a zip pak point
+// directly into a memory mapping of the pak, other files own a buffer holding
+// their contents. Copies share the same data, which stays valid until the last
+// copy is destroyed, even if the pak it came from is unloaded.
+class FileView {
+public:
+	FileView()
+		: ptr(nullptr), len(0) {}
+	FileView(std::shared_ptr<const void> owner, const char* ptr, size_t len)
+		: owner(std::move(owner)), ptr(ptr), len(len) {}
+
+	const char* data() const
+	{
+		return ptr;
+	}
+	size_t size() const
+	{
+		return len;
+	}
+	bool empty() const
+	{
+		return len == 0;
+	}
+	const char* begin() const
+	{
+		return ptr;
+	}
+	const char* end() const
+	{
+		return ptr + len;
+	}
+
+private:
+	std::shared_ptr<const void> owner;
+	const char* ptr;
+	size_t len;
+};
+
 // Path manipulation functions
 namespace Path {
 
@@ -272,6 +310,10 @@ namespace PakPath {
 	// Read an entire file into a string
 	std::string ReadFile(Str::StringRef path, std::error_code& err = throws());
 
+	// Get the contents of a file without copying them out of the pak if it is
+	// stored uncompressed, otherwise the file is read into a new buffer
+	FileView ViewFile(Str::StringRef path, std::error_code& err = throws());
+
 	// Copy an entire file to another file
 	void CopyFile(Str::StringRef path, const File& dest, std::error_code& err = throws());
 
@@ -327,12 +327,11 @@ static void FreeHandles(const NaClHandle* h)
 }
 #endif
 
-bool InternalRecvMsg(OSHandleType handle, Reader& reader)
+static bool InternalRecvMsg(OSHandleType handle, Reader& reader, char* recvBuffer)
 {
 	NaClMessageHeader hdr;
 	NaClIOVec iov[2];
 	NaClHandle h[NACL_ABI_IMC_DESC_MAX];
-	std::unique_ptr<char[]> recvBuffer(new char[NACL_ABI_IMC_BYTES_MAX]);
 
 	for (size_t i = 0; i < NACL_ABI_IMC_DESC_MAX; i++)
 		h[i] = NACL_INVALID_HANDLE;
@@ -343,7 +342,7 @@ bool InternalRecvMsg(OSHandleType handle, Reader& reader)
 	hdr.handles = h;
 	hdr.handle_count = NACL_ABI_IMC_DESC_MAX;
 	hdr.flags = 0;
-	iov[0].base = recvBuffer.get();
+	iov[0].base = recvBuffer;
 	iov[0].length = NACL_ABI_IMC_BYTES_MAX;
 
 	int result = NaClReceiveDatagram(handle, &hdr, 0);
@@ -357,6 +356,8 @@ bool InternalRecvMsg(OSHandleType handle, Reader& reader)
 		if (h[i] != NACL_INVALID_HANDLE)
 			reader.GetHandles().push_back(h[i]);
 	}
+	if (reader.GetPool())
+		reader.GetPool()->Reserve(reader.GetData(), reader.GetData().size() + result - 1);
 	reader.GetData().insert(reader.GetData().end(), &recvBuffer[1], &recvBuffer[result]);
 	return recvBuffer[0];
 #else
@@ -443,6 +444,8 @@ bool InternalRecvMsg(OSHandleType handle, Reader& reader)
 			reader.GetHandles().back().flags = flags;
 	}
 
+	if (reader.GetPool())
+		reader.GetPool()->Reserve(reader.GetData(), reader.GetData().size() + result - 1);
 	reader.GetData().insert(reader.GetData().end(), &desc_end[1], &desc_end[result]);
 	return desc_end[0];
 #endif
@@ -451,10 +454,17 @@ bool InternalRecvMsg(OSHandleType handle, Reader& reader)
 Reader Socket::RecvMsg() const
 {
 	Reader out;
-	while (InternalRecvMsg(handle, out)) {}
+	RecvMsg(out);
 	return out;
 }
 
+void Socket::RecvMsg(Reader& reader) const
+{
+	if (!recvBuffer)
+		recvBuffer.reset(new char[NACL_ABI_IMC_BYTES_MAX]);
+	while (InternalRecvMsg(handle, reader, recvBuffer.get())) {}
+}
+
 std::pair<Socket, Socket> Socket::CreatePair()
 {
 	NaClHandle handles[2];
@@ -554,4 +564,243 @@ SharedMemory SharedMemory::Create(size_t size)
 	return out;
 }
 
+// Marker left in the ring when a message was sent through the socket instead
+static const uint32_t RING_SOCKET_MARKER = 0xffffffff;
+
+// Range of the number of times to poll the ring before going to sleep on the
+// socket. The count doubles when polling found a message and halves when the
+// receiver had to sleep anyway, so an idle peer barely spins at all.
+static const int RING_SPIN_MIN = 16;
+static const int RING_SPIN_MAX = 2048;
+
+// Spinning only helps if the peer can run at the same time
+static bool RingCanSpin()
+{
+	static const bool canSpin = std::thread::hardware_concurrency() > 1;
+	return canSpin;
+}
+
+static uint32_t RingAlign(uint32_t len)
+{
+	return (len + 3) & ~3;
+}
+
+static void RingCopyIn(char* ring, uint32_t size, uint32_t pos, const void* data, uint32_t len)
+{
+	uint32_t offset = pos & (size - 1);
+	uint32_t first = std::min(len, size - offset);
+	memcpy(ring + offset, data, first);
+	memcpy(ring, static_cast<const char*>(data) + first, len - first);
+}
+
+static void RingCopyOut(void* data, const char* ring, uint32_t size, uint32_t pos, uint32_t len)
+{
+	uint32_t offset = pos & (size - 1);
+	uint32_t first = std::min(len, size - offset);
+	memcpy(data, ring + offset, first);
+	memcpy(static_cast<char*>(data) + first, ring, len - first);
+}
+
+void Channel::EnableRing(size_t size)
+{
+	if (sendRing)
+		return;
+
+	// Round the capacity up to a power of two so positions can wrap freely
+	uint32_t capacity = 4096;
+	while (capacity < size)
+		capacity <<= 1;
+
+	SharedMemory memory = SharedMemory::Create(2 * (sizeof(RingHeader) + capacity));
+
+	Writer writer;
+	writer.Write<uint32_t>(ID_RING_SETUP);
+	writer.Write<uint32_t>(capacity);
+	writer.Write<SharedMemory>(memory);
+	socket.SendMsg(writer);
+
+	ringSize = capacity;
+	AttachRing(std::move(memory), true);
+}
+
+void Channel::AttachRing(SharedMemory memory, bool creator)
+{
+	if (ringSize < 4096 || (ringSize & (ringSize - 1)) || memory.GetSize() < 2 * (sizeof(RingHeader) + ringSize))
+		Com_Error(ERR_DROP, "IPC: Invalid shared memory ring of size %u", ringSize);
+
+	ringMemory = std::move(memory);
+	char* base = static_cast<char*>(ringMemory.GetBase());
+	RingHeader* first = reinterpret_cast<RingHeader*>(base);
+	RingHeader* second = reinterpret_cast<RingHeader*>(base + sizeof(RingHeader) + ringSize);
+
+	if (creator) {
+		for (RingHeader* ring: {first, second}) {
+			ring->head.store(0);
+			ring->tail.store(0);
+			ring->waiting.store(0);
+		}
+	}
+
+	// The creator sends on the first ring and receives on the second
+	sendRing = creator ? first : second;
+	recvRing = creator ? second : first;
+	sendData = reinterpret_cast<char*>(sendRing + 1);
+	recvData = reinterpret_cast<char*>(recvRing + 1);
+}
+
+bool Channel::RingWrite(const void* data, uint32_t len)
+{
+	if (len > ringSize / 4)
+		return false;
+
+	uint32_t head = sendRing->head.load(std::memory_order_relaxed);
+	uint32_t tail = sendRing->tail.load(std::memory_order_acquire);
+	uint32_t needed = sizeof(uint32_t) + RingAlign(len);
+
+	// Always leave room for a socket marker
+	if (ringSize - (head - tail) < needed + sizeof(uint32_t))
+		return false;
+
+	RingCopyIn(sendData, ringSize, head, &len, sizeof(uint32_t));
+	RingCopyIn(sendData, ringSize, head + sizeof(uint32_t), data, len);
+	sendRing->head.store(head + needed);
+	return true;
+}
+
+void Channel::RingWriteMarker()
+{
+	uint32_t head = sendRing->head.load(std::memory_order_relaxed);
+
+	// The consumer is draining the ring, so this only waits if a lot of
+	// large messages were queued back to back
+	while (ringSize - (head - sendRing->tail.load(std::memory_order_acquire)) < sizeof(uint32_t))
+		std::this_thread::yield();
+
+	RingCopyIn(sendData, ringSize, head, &RING_SOCKET_MARKER, sizeof(uint32_t));
+	sendRing->head.store(head + sizeof(uint32_t));
+}
+
+bool Channel::RingRead(Reader& reader)
+{
+	uint32_t tail = recvRing->tail.load(std::memory_order_relaxed);
+	uint32_t head = recvRing->head.load();
+	if (head == tail)
+		return false;
+
+	uint32_t len;
+	RingCopyOut(&len, recvData, ringSize, tail, sizeof(uint32_t));
+	if (len == RING_SOCKET_MARKER) {
+		recvRing->tail.store(tail + sizeof(uint32_t), std::memory_order_release);
+		while (!RecvSocketMsg(reader)) {}
+		return true;
+	}
+
+	if (len > ringSize / 4 || head - tail < sizeof(uint32_t) + RingAlign(len))
+		Com_Error(ERR_DROP, "IPC: Corrupted message in shared memory ring");
+
+	if (reader.GetPool())
+		reader.GetPool()->Reserve(reader.GetData(), len);
+	reader.GetData().resize(len);
+	RingCopyOut(reader.GetData().data(), recvData, ringSize, tail + sizeof(uint32_t), len);
+	recvRing->tail.store(tail + sizeof(uint32_t) + RingAlign(len), std::memory_order_release);
+	return true;
+}
+
+bool Channel::RecvSocketMsg(Reader& reader)
+{
+	// Messages are read into a pooled buffer, start from a fresh one
+	reader = Reader(pool);
+	socket.RecvMsg(reader);
+
+	uint32_t id = 0;
+	if (reader.GetData().size() >= sizeof(uint32_t))
+		memcpy(&id, reader.GetData().data(), sizeof(uint32_t));
+
+	if (id == ID_RING_WAKEUP)
+		return false;
+
+	if (id == ID_RING_SETUP) {
+		reader.Read<uint32_t>();
+		ringSize = reader.Read<uint32_t>();
+		AttachRing(reader.Read<SharedMemory>(), false);
+		return false;
+	}
+
+	return true;
+}
+
+void Channel::CountSendAllocations()
+{
+	if (sendBuffer.capacity() != sendCapacity) {
+		sendCapacity = sendBuffer.capacity();
+		sendGrowths++;
+	}
+}
+
+void Channel::SendMsg(const Writer& writer)
+{
+	if (!sendRing) {
+		socket.SendMsg(writer);
+		CountSendAllocations();
+		return;
+	}
+
+	const std::vector<char>& data = writer.GetData();
+	bool inRing = writer.GetHandles().empty() && RingWrite(data.data(), data.size());
+	if (!inRing)
+		RingWriteMarker();
+
+	// Only pay for a socket message if the peer went to sleep
+	if (sendRing->waiting.exchange(0)) {
+		Writer wakeup(controlBuffer);
+		wakeup.Write<uint32_t>(ID_RING_WAKEUP);
+		socket.SendMsg(wakeup);
+	}
+
+	if (!inRing)
+		socket.SendMsg(writer);
+
+	CountSendAllocations();
+}
+
+Reader Channel::RecvMsg()
+{
+	while (true) {
+		Reader reader(pool);
+
+		if (!recvRing) {
+			if (RecvSocketMsg(reader))
+				return reader;
+			continue;
+		}
+
+		if (RingCanSpin()) {
+			ringSpin = std::max(ringSpin, RING_SPIN_MIN);
+			for (int i = 0; i < ringSpin; i++) {
+				if (RingRead(reader)) {
+					ringSpin = std::min(ringSpin * 2, RING_SPIN_MAX);
+					return reader;
+				}
+			}
+			ringSpin = std::max(ringSpin / 2, RING_SPIN_MIN);
+		}
+
+		// Announce that we are going to sleep, then check again so that a
+		// message written in between isn't missed
+		recvRing->waiting.store(1);
+		if (RingRead(reader)) {
+			recvRing->waiting.store(0);
+			return reader;
+		}
+
+		// Messages sent through the socket by a peer using the rings are
+		// announced in the ring first and read from there, so anything else
+		// is from a peer that hasn't attached the rings yet
+		if (RecvSocketMsg(reader)) {
+			recvRing->waiting.store(0);
+			return reader;
+		}
+	}
+}
+
 } // namespace IPC
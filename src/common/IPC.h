@@ -100,13 +100,14 @@ public:
 	Socket()
 		: handle(INVALID_HANDLE) {}
 	Socket(Socket&& other) NOEXCEPT
-		: handle(other.handle)
+		: handle(other.handle), recvBuffer(std::move(other.recvBuffer))
 	{
 		other.handle = INVALID_HANDLE;
 	}
 	Socket& operator=(Socket&& other) NOEXCEPT
 	{
 		std::swap(handle, other.handle);
+		std::swap(recvBuffer, other.recvBuffer);
 		return *this;
 	}
 	~Socket()
@@ -137,11 +138,17 @@ public:
 
 	void SendMsg(const Writer& writer) const;
 	Reader RecvMsg() const;
+	// Receive into an existing Reader, appending to its data
+	void RecvMsg(Reader& reader) const;
 
 	static std::pair<Socket, Socket> CreatePair();
 
 private:
 	OSHandleType handle;
+
+	// Datagrams are received here before being copied into the reader,
+	// allocated on the first receive and reused after that
+	mutable std::unique_ptr<char[]> recvBuffer;
 };
 
 // Shared memory area, can be sent over a socket
@@ -196,13 +203,77 @@ private:
 // Base type for serialization traits.
 template<typename T, typename = void> struct SerializeTraits {};
 
-// Class to generate messages
+// Pool of message buffers shared by a Channel and the Readers it creates.
+// Buffers are handed back when a Reader is destroyed so that their capacity
+// is reused, and every time a buffer has to be allocated or grown it is
+// counted, so that a channel in steady state can be shown to not allocate.
+class BufferPool {
+public:
+	BufferPool()
+		: allocations(0)
+	{
+		freeBuffers.reserve(MAX_FREE_BUFFERS);
+	}
+
+	std::vector<char> Get()
+	{
+		if (freeBuffers.empty())
+			return std::vector<char>();
+		std::vector<char> buffer = std::move(freeBuffers.back());
+		freeBuffers.pop_back();
+		buffer.clear();
+		return buffer;
+	}
+	void Put(std::vector<char> buffer)
+	{
+		if (buffer.capacity() != 0 && freeBuffers.size() < MAX_FREE_BUFFERS)
+			freeBuffers.push_back(std::move(buffer));
+	}
+
+	// Make room for size bytes in a buffer, counting it if it has to grow
+	void Reserve(std::vector<char>& buffer, size_t size)
+	{
+		if (buffer.capacity() < size) {
+			allocations++;
+			buffer.reserve(size);
+		}
+	}
+
+	size_t GetAllocationCount() const
+	{
+		return allocations;
+	}
+
+private:
+	static const size_t MAX_FREE_BUFFERS = 16;
+	std::vector<std::vector<char>> freeBuffers;
+	size_t allocations;
+};
+
+// Class to generate messages. By default a Writer has its own storage, but it
+// can also write into a buffer owned by a Channel so the capacity is reused.
 class Writer {
 public:
+	Writer()
+		: data(ownData) {}
+	explicit Writer(std::vector<char>& buffer)
+		: data(buffer)
+	{
+		data.clear();
+	}
+	Writer(const Writer&) = delete;
+	Writer& operator=(const Writer&) = delete;
+
 	void WriteData(const void* p, size_t len)
 	{
 		data.insert(data.end(), static_cast<const char*>(p), static_cast<const char*>(p) + len);
 	}
+	void WriteAlign(size_t align)
+	{
+		// Offsets are relative to the start of the message, and message
+		// buffers are allocated with operator new which is suitably aligned
+		data.resize((data.size() + align - 1) & ~(align - 1));
+	}
 	void WriteSize(size_t size)
 	{
 		if (size > std::numeric_limits<uint32_t>::max())
@@ -228,7 +299,8 @@ public:
 	}
 
 private:
-	std::vector<char> data;
+	std::vector<char> ownData;
+	std::vector<char>& data;
 	std::vector<Desc> handles;
 };
 
@@ -237,14 +309,18 @@ class Reader {
 public:
 	Reader()
 		: pos(0), handles_pos(0) {}
+	// Use a buffer from the pool, and give it back once the message is read
+	explicit Reader(std::shared_ptr<BufferPool> bufferPool)
+		: data(bufferPool->Get()), pos(0), handles_pos(0), pool(std::move(bufferPool)) {}
 	Reader(Reader&& other) NOEXCEPT
-		: data(std::move(other.data)), handles(std::move(other.handles)), pos(other.pos), handles_pos(other.handles_pos) {}
+		: data(std::move(other.data)), handles(std::move(other.handles)), pos(other.pos), handles_pos(other.handles_pos), pool(std::move(other.pool)) {}
 	Reader& operator=(Reader&& other) NOEXCEPT
 	{
 		std::swap(data, other.data);
 		std::swap(handles, other.handles);
 		std::swap(pos, other.pos);
 		std::swap(handles_pos, other.handles_pos);
+		std::swap(pool, other.pool);
 		return *this;
 	}
 	~Reader()
@@ -252,6 +328,9 @@ public:
 		// Close any handles that weren't read
 		for (size_t i = handles_pos; i < handles.size(); i++)
 			CloseDesc(handles[i]);
+
+		if (pool)
+			pool->Put(std::move(data));
 	}
 
 	void ReadData(void* p, size_t len)
@@ -271,6 +350,14 @@ public:
 			Com_Error(ERR_DROP, "IPC: Size out of range in message");
 		return size;
 	}
+	void ReadAlign(size_t align)
+	{
+		size_t aligned = (pos + align - 1) & ~(align - 1);
+		if (aligned <= data.size())
+			pos = aligned;
+		else
+			Com_Error(ERR_DROP, "IPC: Unexpected end of message");
+	}
 	const void* ReadInline(size_t len)
 	{
 		if (pos + len <= data.size()) {
@@ -300,12 +387,17 @@ public:
 	{
 		return handles;
 	}
+	BufferPool* GetPool() const
+	{
+		return pool.get();
+	}
 
 private:
 	std::vector<char> data;
 	std::vector<Desc> handles;
 	size_t pos;
 	size_t handles_pos;
+	std::shared_ptr<BufferPool> pool;
 };
 
 // Simple implementation for POD types
@@ -424,6 +516,144 @@ template<> struct SerializeTraits<std::string> {
 	}
 };
 
+// Zero-copy views of a string or an array of POD values in a message. They
+// point into the Reader's buffer and are only valid while the message is
+// being handled, so use them in place of std::string and std::vector for
+// payloads that the handler doesn't keep. They have their own wire format and
+// can't be mixed with std::string and std::vector for the same message.
+class StringView {
+public:
+	StringView()
+		: ptr(""), len(0) {}
+	StringView(const char* ptr, size_t len)
+		: ptr(ptr), len(len) {}
+	StringView(const char* str)
+		: ptr(str), len(strlen(str)) {}
+	StringView(const std::string& str)
+		: ptr(str.c_str()), len(str.size()) {}
+
+	// Always null-terminated
+	const char* c_str() const
+	{
+		return ptr;
+	}
+	size_t size() const
+	{
+		return len;
+	}
+	std::string str() const
+	{
+		return std::string(ptr, len);
+	}
+
+private:
+	const char* ptr;
+	size_t len;
+};
+
+template<typename T> class ArrayView {
+	static_assert(std::is_pod<T>::value, "ArrayView only supports POD types");
+public:
+	ArrayView()
+		: ptr(nullptr), len(0) {}
+	ArrayView(const T* ptr, size_t len)
+		: ptr(ptr), len(len) {}
+	ArrayView(const std::vector<T>& vec)
+		: ptr(vec.data()), len(vec.size()) {}
+
+	const T* data() const
+	{
+		return ptr;
+	}
+	size_t size() const
+	{
+		return len;
+	}
+	const T* begin() const
+	{
+		return ptr;
+	}
+	const T* end() const
+	{
+		return ptr + len;
+	}
+	const T& operator[](size_t i) const
+	{
+		return ptr[i];
+	}
+
+private:
+	const T* ptr;
+	size_t len;
+};
+
+template<> struct SerializeTraits<StringView> {
+	static void Write(Writer& stream, StringView value)
+	{
+		stream.WriteSize(value.size());
+		stream.WriteData(value.c_str(), value.size() + 1);
+	}
+	static StringView Read(Reader& stream)
+	{
+		size_t size = stream.ReadSize<char>();
+		const char* p = static_cast<const char*>(stream.ReadInline(size + 1));
+		if (p[size] != '\0')
+			Com_Error(ERR_DROP, "IPC: String in message is not null-terminated");
+		return StringView(p, size);
+	}
+};
+
+template<typename T> struct SerializeTraits<ArrayView<T>> {
+	static void Write(Writer& stream, ArrayView<T> value)
+	{
+		stream.WriteSize(value.size());
+		stream.WriteAlign(std::alignment_of<T>::value);
+		stream.WriteData(value.data(), value.size() * sizeof(T));
+	}
+	static ArrayView<T> Read(Reader& stream)
+	{
+		size_t size = stream.ReadSize<T>();
+		stream.ReadAlign(std::alignment_of<T>::value);
+		return ArrayView<T>(static_cast<const T*>(stream.ReadInline(size * sizeof(T))), size);
+	}
+};
+
+// Read a value into an existing object. Strings and vectors of POD values
+// keep their capacity, so reply buffers that are reused don't allocate.
+template<typename T, typename = void> struct ReadIntoTraits {
+	template<typename U> static void ReadInto(Reader& stream, U& out)
+	{
+		out = stream.Read<T>();
+	}
+};
+template<typename T> struct ReadIntoTraits<std::vector<T>, typename std::enable_if<std::is_pod<T>::value>::type> {
+	static void ReadInto(Reader& stream, std::vector<T>& out)
+	{
+		out.resize(stream.ReadSize<T>());
+		stream.ReadData(out.data(), out.size() * sizeof(T));
+	}
+};
+template<> struct ReadIntoTraits<std::string> {
+	static void ReadInto(Reader& stream, std::string& out)
+	{
+		size_t size = stream.ReadSize<char>();
+		out.assign(static_cast<const char*>(stream.ReadInline(size)), size);
+	}
+};
+template<typename T> struct ReadIntoTraits<ArrayView<T>> {
+	// Only for message inputs, a view in a reply would outlive its message
+	static void ReadInto(Reader& stream, ArrayView<T>& out)
+	{
+		out = stream.Read<ArrayView<T>>();
+	}
+	static void ReadInto(Reader& stream, std::vector<T>& out)
+	{
+		ArrayView<T> view = stream.Read<ArrayView<T>>();
+		out.resize(view.size());
+		memcpy(out.data(), view.data(), view.size() * sizeof(T));
+	}
+};
+
 // std::map and std::unordered_map
 template<typename T, typename U>
 struct SerializeTraits<std::map<T, U>> {
@@ -538,19 +768,64 @@ template<uint16_t Major, uint16_t Minor> struct Id {
 	};
 };
 
+// Message IDs used internally by Channel, these never reach a message handler
+const uint32_t ID_RING_SETUP = 0xfffffffe;
+const uint32_t ID_RING_WAKEUP = 0xfffffffd;
+
+// Control block for one direction of a shared memory ring. There is a single
+// producer and a single consumer, so the positions only need acquire/release
+// ordering. Each field gets its own cache line to avoid false sharing.
+struct RingHeader {
+	alignas(64) std::atomic<uint32_t> head; // written by the producer
+	alignas(64) std::atomic<uint32_t> tail; // written by the consumer
+	alignas(64) std::atomic<uint32_t> waiting; // consumer is blocked on the socket
+};
+
 // An IPC channel wraps a socket and provides additional support for sending
 // synchronous typed messages over it.
+//
+// A channel can optionally pass messages through a pair of rings in shared
+// memory instead of the socket. Messages that carry handles or that are too
+// big for the ring still go through the socket, with a marker left in the
+// ring so that the peer reads them in order. The socket is only used to wake
+// the peer up when it has gone to sleep waiting for a message, or by a peer
+// that hasn't picked up the rings yet.
 class Channel {
 public:
 	Channel()
-		: counter(0) {}
+		: counter(0), pool(std::make_shared<BufferPool>()), sendCapacity(0), sendGrowths(0),
+		  sendRing(nullptr), recvRing(nullptr), sendData(nullptr), recvData(nullptr), ringSize(0), ringSpin(0) {}
 	Channel(Socket socket)
-		: socket(std::move(socket)), counter(0) {}
+		: socket(std::move(socket)), counter(0), pool(std::make_shared<BufferPool>()), sendCapacity(0), sendGrowths(0),
+		  sendRing(nullptr), recvRing(nullptr), sendData(nullptr), recvData(nullptr), ringSize(0), ringSpin(0) {}
 	Channel(Channel&& other)
-		: socket(std::move(other.socket)) {}
+		: socket(std::move(other.socket)), counter(other.counter), pool(std::move(other.pool)), replies(std::move(other.replies)),
+		  sendBuffer(std::move(other.sendBuffer)), controlBuffer(std::move(other.controlBuffer)), sendCapacity(other.sendCapacity), sendGrowths(other.sendGrowths),
+		  ringMemory(std::move(other.ringMemory)),
+		  sendRing(other.sendRing), recvRing(other.recvRing), sendData(other.sendData), recvData(other.recvData), ringSize(other.ringSize),
+		  ringSpin(other.ringSpin)
+	{
+		other.sendRing = other.recvRing = nullptr;
+		other.sendData = other.recvData = nullptr;
+		other.ringSize = 0;
+	}
 	Channel& operator=(Channel&& other)
 	{
 		std::swap(socket, other.socket);
+		std::swap(counter, other.counter);
+		std::swap(pool, other.pool);
+		std::swap(replies, other.replies);
+		std::swap(sendBuffer, other.sendBuffer);
+		std::swap(controlBuffer, other.controlBuffer);
+		std::swap(sendCapacity, other.sendCapacity);
+		std::swap(sendGrowths, other.sendGrowths);
+		std::swap(ringMemory, other.ringMemory);
+		std::swap(sendRing, other.sendRing);
+		std::swap(recvRing, other.recvRing);
+		std::swap(sendData, other.sendData);
+		std::swap(recvData, other.recvData);
+		std::swap(ringSize, other.ringSize);
+		std::swap(ringSpin, other.ringSpin);
 		return *this;
 	}
 	explicit operator bool() const
@@ -558,14 +833,29 @@ public:
 		return bool(socket);
 	}
 
-	// Wrappers around socket functions
-	void SendMsg(const Writer& writer) const
+	// Send and receive messages, through the rings if they are enabled
+	void SendMsg(const Writer& writer);
+	Reader RecvMsg();
+
+	// Create the shared memory rings and hand them to the peer. The peer
+	// picks them up automatically the next time it receives a message.
+	void EnableRing(size_t size = 1 << 20);
+	bool RingEnabled() const
 	{
-		socket.SendMsg(writer);
+		return sendRing != nullptr;
 	}
-	Reader RecvMsg() const
+
+	// Buffer for writing outgoing messages, which must be sent before another
+	// message is written to the channel
+	std::vector<char>& GetSendBuffer()
 	{
-		return socket.RecvMsg();
+		return sendBuffer;
+	}
+
+	// Number of times a message buffer had to be allocated or grown
+	size_t GetAllocationCount() const
+	{
+		return sendGrowths + (pool ? pool->GetAllocationCount() : 0);
 	}
 
 	// Generate a unique message key to match messages with replies
@@ -605,9 +895,30 @@ public:
 	}
 
 private:
+	void AttachRing(SharedMemory memory, bool creator);
+	bool RingWrite(const void* data, uint32_t len);
+	void RingWriteMarker();
+	bool RingRead(Reader& reader);
+	bool RecvSocketMsg(Reader& reader);
+	void CountSendAllocations();
+
 	Socket socket;
 	uint32_t counter;
+	std::shared_ptr<BufferPool> pool;
 	std::unordered_map<uint32_t, Reader> replies;
+
+	std::vector<char> sendBuffer;
+	std::vector<char> controlBuffer;
+	size_t sendCapacity;
+	size_t sendGrowths;
+
+	SharedMemory ringMemory;
+	RingHeader* sendRing;
+	RingHeader* recvRing;
+	char* sendData;
+	char* recvData;
+	uint32_t ringSize;
+	int ringSpin; // polls of the ring before sleeping, adapts to the traffic
 };
 
 // Asynchronous message which does not wait for a reply
@@ -654,7 +965,7 @@ template<typename Types, typename Tuple> void SerializeTuple(Types, Writer& writ
 template<size_t Index, typename Tuple> void FillTuple(Util::TypeList<>, Tuple&, Reader&) {}
 template<size_t Index, typename Type0, typename... Types, typename Tuple> void FillTuple(Util::TypeList<Type0, Types...>, Tuple& tuple, Reader& stream)
 {
-	std::get<Index>(tuple) = stream.Read<Type0>();
+	ReadIntoTraits<Type0>::ReadInto(stream, std::get<Index>(tuple));
 	FillTuple<Index + 1>(Util::TypeList<Types...>(), tuple, stream);
 }
 
@@ -673,7 +984,7 @@ template<typename Func, typename Id, typename... MsgArgs, typename... Args> void
 	typedef Message<Id, MsgArgs...> Message;
 	static_assert(sizeof...(Args) == std::tuple_size<typename Message::Inputs>::value, "Incorrect number of arguments for IPC::SendMsg");
 
-	Writer writer;
+	Writer writer(channel.GetSendBuffer());
 	writer.Write<uint32_t>(Message::id);
 	SerializeArgs(Util::TypeListFromTuple<typename Message::Inputs>(), writer, std::forward<Args>(args)...);
 	channel.SendMsg(writer);
@@ -683,12 +994,16 @@ template<typename Func, typename Msg, typename Reply, typename... Args> void Sen
 	typedef SyncMessage<Msg, Reply> Message;
 	static_assert(sizeof...(Args) == std::tuple_size<typename Message::Inputs>::value + std::tuple_size<typename Message::Outputs>::value, "Incorrect number of arguments for IPC::SendMsg");
 
-	Writer writer;
-	writer.Write<uint32_t>(Message::id);
 	uint32_t key = channel.GenMsgKey();
-	writer.Write<uint32_t>(key);
-	SerializeArgs(Util::TypeListFromTuple<typename Message::Inputs>(), writer, std::forward<Args>(args)...);
-	channel.SendMsg(writer);
+	{
+		// The send buffer is free again once the message is sent, so
+		// handlers of incoming messages below can reuse it
+		Writer writer(channel.GetSendBuffer());
+		writer.Write<uint32_t>(Message::id);
+		writer.Write<uint32_t>(key);
+		SerializeArgs(Util::TypeListFromTuple<typename Message::Inputs>(), writer, std::forward<Args>(args)...);
+		channel.SendMsg(writer);
+	}
 
 	while (true) {
 		Reader reader;
@@ -722,7 +1037,7 @@ template<typename Func, typename Msg, typename Reply> void HandleMsg(Channel& ch
 	FillTuple<0>(Util::TypeListFromTuple<typename Message::Inputs>(), inputs, reader);
 	Util::apply(std::forward<Func>(func), std::tuple_cat(Util::ref_tuple(std::move(inputs)), Util::ref_tuple(outputs)));
 
-	Writer writer;
+	Writer writer(channel.GetSendBuffer());
 	writer.Write<uint32_t>(ID_RETURN);
 	writer.Write<uint32_t>(key);
 	SerializeTuple(Util::TypeListFromTuple<typename Message::Outputs>(), writer, std::move(outputs));
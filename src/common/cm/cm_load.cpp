@@ -47,8 +47,8 @@ Maryland 20850 USA.
 #define LL( x ) x = LittleLong( x )
 
 clipMap_t cm;
-int       c_pointcontents;
-int       c_traces, c_brush_traces, c_patch_traces, c_trisoup_traces;
+std::atomic<int> c_pointcontents;
+std::atomic<int> c_traces, c_brush_traces, c_patch_traces, c_trisoup_traces;
 
 byte      *cmod_base;
 
@@ -300,6 +300,98 @@ void CMod_LoadBrushes( lump_t *l )
 		out->contents = cm.shaders[ shaderNum ].contentFlags;
 
 		CM_BoundBrush( out );
+		CM_BuildBrushPlaneGroups( out );
+	}
+}
+
+/*
+=================
+CM_SetPlaneGroupLane
+=================
+*/
+static void CM_SetPlaneGroupLane( cPlaneGroup_t *group, int lane, const vec3_t normal, float dist, int signbits )
+{
+	int i;
+
+	for ( i = 0; i < 3; i++ )
+	{
+		group->normal[ i ][ lane ] = normal[ i ];
+		group->negative[ i ][ lane ] = ( signbits & ( 1 << i ) ) ? ~0 : 0;
+	}
+
+	group->dist[ lane ] = dist;
+}
+
+/*
+=================
+CM_BuildBrushPlaneGroups
+
+Also called again for the box brush whenever its planes move
+=================
+*/
+void CM_BuildBrushPlaneGroups( cbrush_t *brush )
+{
+	int      i;
+	cplane_t *plane;
+
+	if ( !brush->planeGroups )
+	{
+		brush->planeGroups = ( cPlaneGroup_t * ) CM_Alloc( ( ( brush->numsides + 3 ) >> 2 ) * sizeof( cPlaneGroup_t ) );
+	}
+
+	for ( i = 0; i < brush->numsides; i++ )
+	{
+		plane = brush->sides[ i ].plane;
+		CM_SetPlaneGroupLane( &brush->planeGroups[ i >> 2 ], i & 3, plane->normal, plane->dist, plane->signbits );
+	}
+}
+
+/*
+=================
+CM_BuildFacetPlaneGroups
+
+Each facet gets its own groups, starting with the surface plane, with the
+inward border planes already flipped
+=================
+*/
+void CM_BuildFacetPlaneGroups( cSurfaceCollide_t *sc )
+{
+	int      i, j, numGroups;
+	cFacet_t *facet;
+	cPlane_t *plane;
+	vec3_t   normal;
+
+	numGroups = 0;
+
+	for ( i = 0, facet = sc->facets; i < sc->numFacets; i++, facet++ )
+	{
+		facet->firstPlaneGroup = numGroups;
+		numGroups += ( facet->numBorders + 4 ) >> 2;
+	}
+
+	sc->planeGroups = ( cPlaneGroup_t * ) CM_Alloc( numGroups * sizeof( cPlaneGroup_t ) );
+
+	for ( i = 0, facet = sc->facets; i < sc->numFacets; i++, facet++ )
+	{
+		cPlaneGroup_t *groups = &sc->planeGroups[ facet->firstPlaneGroup ];
+
+		plane = &sc->planes[ facet->surfacePlane ];
+		CM_SetPlaneGroupLane( &groups[ 0 ], 0, plane->plane, plane->plane[ 3 ], plane->signbits );
+
+		for ( j = 0; j < facet->numBorders; j++ )
+		{
+			plane = &sc->planes[ facet->borderPlanes[ j ] ];
+
+			if ( facet->borderInward[ j ] )
+			{
+				VectorNegate( plane->plane, normal );
+				CM_SetPlaneGroupLane( &groups[ ( j + 1 ) >> 2 ], ( j + 1 ) & 3, normal, -plane->plane[ 3 ], plane->signbits );
+			}
+			else
+			{
+				CM_SetPlaneGroupLane( &groups[ ( j + 1 ) >> 2 ], ( j + 1 ) & 3, plane->plane, plane->plane[ 3 ], plane->signbits );
+			}
+		}
 	}
 }
 
@@ -854,6 +946,7 @@ void CMod_LoadSurfaces( lump_t *surfs, lump_t *verts, lump_t *indexesLump )
 
 			// create the internal facet structure
 			surface->sc = CM_GeneratePatchCollide( width, height, vertexes );
+			CM_BuildFacetPlaneGroups( surface->sc );
 		}
 		else if ( LittleLong( in->surfaceType ) == MST_TRIANGLE_SOUP && ( cm.perPolyCollision || cm_forceTriangles.Get() ) )
 		{
@@ -904,6 +997,7 @@ void CMod_LoadSurfaces( lump_t *surfs, lump_t *verts, lump_t *indexesLump )
 
 			// create the internal facet structure
 			surface->sc = CM_GenerateTriangleSoupCollide( numVertexes, vertexes, numIndexes, indexes );
+			CM_BuildFacetPlaneGroups( surface->sc );
 		}
 	}
 }
@@ -936,6 +1030,8 @@ void CM_LoadMap( const char *name, const void* buffer, qboolean clientload )
 
 	// free old stuff
     CM_FreeAll();
+	CM_FreeChecks();
+	CM_ClearRecordedTraces();
 	memset( &cm, 0, sizeof( cm ) );
 	CM_ClearLevelPatches();
 
@@ -997,6 +1093,8 @@ CM_ClearMap
 */
 void CM_ClearMap( void )
 {
+	CM_FreeChecks();
+	CM_ClearRecordedTraces();
 	Com_Memset( &cm, 0, sizeof( cm ) );
 	CM_ClearLevelPatches();
 }
@@ -1098,6 +1196,7 @@ void CM_InitBoxHull( void )
 	box_brush->contents = CONTENTS_BODY;
 	box_brush->edges = ( cbrushedge_t * ) CM_Alloc( sizeof( cbrushedge_t ) * 12 );
 	box_brush->numEdges = 12;
+	box_brush->planeGroups = ( cPlaneGroup_t * ) CM_Alloc( 2 * sizeof( cPlaneGroup_t ) );
 
 	box_model.leaf.numLeafBrushes = 1;
 //  box_model.leaf.firstLeafBrush = cm.numBrushes;
@@ -1195,6 +1294,8 @@ clipHandle_t CM_TempBoxModel( const vec3_t mins, const vec3_t maxs, int capsule
 	VectorCopy( mins, box_brush->bounds[ 0 ] );
 	VectorCopy( maxs, box_brush->bounds[ 1 ] );
 
+	CM_BuildBrushPlaneGroups( box_brush );
+
 	return BOX_MODEL_HANDLE;
 }
 
@@ -82,16 +82,23 @@ typedef struct
 	winding_t *winding;
 } cbrushside_t;
 
+// brush sides or facet planes in groups of four, laid out for the SIMD trace kernels
 typedef struct
 {
-	int          contents;
-	vec3_t       bounds[ 2 ];
-	int          numsides;
-	cbrushside_t *sides;
-	int          checkcount; // to avoid repeated testings
-	qboolean     collided; // marker for optimisation
-	cbrushedge_t *edges;
-	int          numEdges;
+	float normal[ 3 ][ 4 ];
+	float dist[ 4 ];
+	int   negative[ 3 ][ 4 ]; // ~0 where the signbits of the unflipped plane are set
+} cPlaneGroup_t;
+
+typedef struct
+{
+	int           contents;
+	vec3_t        bounds[ 2 ];
+	int           numsides;
+	cbrushside_t  *sides;
+	cPlaneGroup_t *planeGroups; // ( numsides + 3 ) / 4 groups
+	cbrushedge_t  *edges;
+	int           numEdges;
 } cbrush_t;
 
 typedef struct cPlane_s
@@ -112,6 +119,7 @@ typedef struct
 	int      borderPlanes[ MAX_FACET_BEVELS ];
 	int      borderInward[ MAX_FACET_BEVELS ];
 	qboolean borderNoAdjust[ MAX_FACET_BEVELS ];
+	int      firstPlaneGroup; // surface plane followed by the border planes
 } cFacet_t;
 
 typedef struct cSurfaceCollide_s
@@ -122,11 +130,12 @@ typedef struct cSurfaceCollide_s
 
 	int      numFacets;
 	cFacet_t *facets;
+
+	cPlaneGroup_t *planeGroups;
 } cSurfaceCollide_t;
 
 typedef struct
 {
-	int               checkcount; // to avoid repeated testings
 	int               surfaceFlags;
 	int               contents;
 	cSurfaceCollide_t *sc;
@@ -186,7 +195,6 @@ typedef struct
 	cSurface_t   **surfaces; // non-patches will be NULL
 
 	int          floodvalid;
-	int          checkcount; // incremented on each trace
 	qboolean     perPolyCollision;
 } clipMap_t;
 
@@ -195,13 +203,39 @@ typedef struct
 #define SURFACE_CLIP_EPSILON ( 0.125 )
 
 extern clipMap_t cm;
-extern int       c_pointcontents;
-extern int       c_traces, c_brush_traces, c_patch_traces, c_trisoup_traces;
+extern std::atomic<int> c_pointcontents;
+extern std::atomic<int> c_traces, c_brush_traces, c_patch_traces, c_trisoup_traces;
 extern Cvar::Cvar<bool> cm_forceTriangles;
 extern Log::Logger cmLog;
 
 // cm_test.c
 
+// per-query state, so that traces can run on several threads at once
+typedef struct cmCheck_s
+{
+	int              stamp; // incremented on each query
+	int              numBrushes;
+	int              numSurfaces;
+	int              *brushChecked; // stamp of the last query that tested the brush
+	int              *brushCollided; // stamp of the last query that crossed one of its faces
+	int              *surfaceChecked; // stamp of the last query that tested the surface
+
+	// scratch space for point traces through surfaces
+	qboolean         frontFacing[ SHADER_MAX_TRIANGLES ];
+	float            intersection[ SHADER_MAX_TRIANGLES ];
+
+	qboolean         owned; // held by a thread
+	qboolean         busy; // a query is running with it
+
+	struct cmCheck_s *next;
+} cmCheck_t;
+
+cmCheck_t *CM_AcquireCheck( void );
+void      CM_ReleaseCheck( cmCheck_t *check );
+void      CM_FreeChecks( void );
+
+void      CM_ClearRecordedTraces( void );
+
 typedef struct
 {
 	float startRadius;
@@ -233,6 +267,7 @@ typedef struct
 	sphere_t    sphere; // sphere for oriendted capsule collision
 	biSphere_t  biSphere;
 	qboolean    testLateralCollision; // whether or not to test for lateral collision
+	cmCheck_t   *check; // avoids testing brushes and surfaces twice
 } traceWork_t;
 
 typedef struct leafList_s
@@ -269,6 +304,8 @@ cSurfaceCollide_t              *CM_GenerateTriangleSoupCollide( int numVertexes,
 
 
 void* CM_Alloc( int size );
+void  CM_BuildBrushPlaneGroups( cbrush_t *brush );
+void  CM_BuildFacetPlaneGroups( cSurfaceCollide_t *sc );
 
 // cm_plane.c
 
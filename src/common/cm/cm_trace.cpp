@@ -155,6 +155,173 @@ float CM_DistanceFromLineSquared( vec3_t p, vec3_t lp1, vec3_t lp2, vec3_t dir )
 /*
 ===============================================================================
 
+CHECK CONTEXTS
+
+Each query marks the brushes and surfaces it has already tested with its own
+stamp, rather than in the shared map data, so that traces can run on several
+threads at once. The temp box model is still shared and must only be used
+from one thread.
+
+===============================================================================
+*/
+
+static std::mutex cmCheckLock;
+static cmCheck_t  *cmChecks; // every context ever created, linked through next
+
+/*
+================
+cmThreadCheck_t
+
+Each thread keeps the context it was given until it exits, so the pool lock
+is only taken on a thread's first query
+================
+*/
+struct cmThreadCheck_t
+{
+	cmCheck_t *check;
+
+	~cmThreadCheck_t()
+	{
+		if ( check )
+		{
+			std::lock_guard<std::mutex> lock( cmCheckLock );
+
+			check->owned = qfalse;
+		}
+	}
+};
+
+static thread_local cmThreadCheck_t cmThreadCheck;
+
+/*
+================
+CM_FreeCheckArrays
+================
+*/
+static void CM_FreeCheckArrays( cmCheck_t *check )
+{
+	free( check->brushChecked );
+	free( check->brushCollided );
+	free( check->surfaceChecked );
+
+	check->stamp = 0;
+	check->numBrushes = 0;
+	check->numSurfaces = 0;
+	check->brushChecked = NULL;
+	check->brushCollided = NULL;
+	check->surfaceChecked = NULL;
+}
+
+/*
+================
+CM_ResizeCheck
+================
+*/
+static void CM_ResizeCheck( cmCheck_t *check, int numBrushes, int numSurfaces )
+{
+	CM_FreeCheckArrays( check );
+
+	check->numBrushes = numBrushes;
+	check->numSurfaces = numSurfaces;
+	check->brushChecked = ( int * ) calloc( numBrushes, sizeof( int ) );
+	check->brushCollided = ( int * ) calloc( numBrushes, sizeof( int ) );
+	check->surfaceChecked = ( int * ) calloc( numSurfaces, sizeof( int ) );
+}
+
+/*
+================
+CM_ClaimCheck
+
+Finds a context no thread owns, or creates one
+================
+*/
+static cmCheck_t *CM_ClaimCheck( void )
+{
+	std::lock_guard<std::mutex> lock( cmCheckLock );
+	cmCheck_t                   *check;
+
+	for ( check = cmChecks; check; check = check->next )
+	{
+		if ( !check->owned )
+		{
+			break;
+		}
+	}
+
+	if ( !check )
+	{
+		check = ( cmCheck_t * ) calloc( 1, sizeof( *check ) );
+		check->next = cmChecks;
+		cmChecks = check;
+	}
+
+	check->owned = qtrue;
+
+	return check;
+}
+
+/*
+================
+CM_AcquireCheck
+
+Returns the calling thread's context with a fresh stamp for a single query
+================
+*/
+cmCheck_t *CM_AcquireCheck( void )
+{
+	cmCheck_t *check = cmThreadCheck.check;
+	int       numBrushes = cm.numBrushes + 1; // the temp box brush follows the map brushes
+
+	if ( !check )
+	{
+		check = cmThreadCheck.check = CM_ClaimCheck();
+	}
+
+	// a query on this thread is still using the stamp
+	assert( !check->busy );
+	check->busy = qtrue;
+
+	if ( check->numBrushes != numBrushes || check->numSurfaces != cm.numSurfaces || check->stamp == INT_MAX )
+	{
+		CM_ResizeCheck( check, numBrushes, cm.numSurfaces );
+	}
+
+	check->stamp++;
+
+	return check;
+}
+
+/*
+================
+CM_ReleaseCheck
+================
+*/
+void CM_ReleaseCheck( cmCheck_t *check )
+{
+	check->busy = qfalse;
+}
+
+/*
+================
+CM_FreeChecks
+
+Called when the map changes, no query may be running. The contexts stay with
+their threads, only the per-map arrays are freed.
+================
+*/
+void CM_FreeChecks( void )
+{
+	std::lock_guard<std::mutex> lock( cmCheckLock );
+
+	for ( cmCheck_t *check = cmChecks; check; check = check->next )
+	{
+		CM_FreeCheckArrays( check );
+	}
+}
+
+/*
+===============================================================================
+
 POSITION TESTING
 
 ===============================================================================
@@ -375,6 +542,7 @@ void CM_TestInLeaf( traceWork_t *tw, cLeaf_t *leaf )
 {
 	int        k;
 	int        brushnum;
+	int        surfacenum;
 	cbrush_t   *b;
 	cSurface_t *surface;
 
@@ -384,12 +552,12 @@ void CM_TestInLeaf( traceWork_t *tw, cLeaf_t *leaf )
 		brushnum = cm.leafbrushes[ leaf->firstLeafBrush + k ];
 		b = &cm.brushes[ brushnum ];
 
-		if ( b->checkcount == cm.checkcount )
+		if ( tw->check->brushChecked[ brushnum ] == tw->check->stamp )
 		{
 			continue; // already checked this brush in another leaf
 		}
 
-		b->checkcount = cm.checkcount;
+		tw->check->brushChecked[ brushnum ] = tw->check->stamp;
 
 		if ( !( b->contents & tw->contents ) )
 		{
@@ -407,19 +575,20 @@ void CM_TestInLeaf( traceWork_t *tw, cLeaf_t *leaf )
 	// test against all surfaces
 	for ( k = 0; k < leaf->numLeafSurfaces; k++ )
 	{
-		surface = cm.surfaces[ cm.leafsurfaces[ leaf->firstLeafSurface + k ] ];
+		surfacenum = cm.leafsurfaces[ leaf->firstLeafSurface + k ];
+		surface = cm.surfaces[ surfacenum ];
 
 		if ( !surface )
 		{
 			continue;
 		}
 
-		if ( surface->checkcount == cm.checkcount )
+		if ( tw->check->surfaceChecked[ surfacenum ] == tw->check->stamp )
 		{
 			continue; // already checked this surface in another leaf
 		}
 
-		surface->checkcount = cm.checkcount;
+		tw->check->surfaceChecked[ surfacenum ] = tw->check->stamp;
 
 		if ( !( surface->contents & tw->contents ) )
 		{
@@ -606,12 +775,8 @@ void CM_PositionTest( traceWork_t *tw )
 	ll.lastLeaf = 0;
 	ll.overflowed = qfalse;
 
-	cm.checkcount++;
-
 	CM_BoxLeafnums_r( &ll, 0 );
 
-	cm.checkcount++;
-
 	// test the contents of the leafs
 	for ( i = 0; i < ll.count; i++ )
 	{
@@ -641,8 +806,8 @@ CM_TracePointThroughSurfaceCollide
 */
 void CM_TracePointThroughSurfaceCollide( traceWork_t *tw, const cSurfaceCollide_t *sc )
 {
-	static qboolean frontFacing[ SHADER_MAX_TRIANGLES ];
-	static float    intersection[ SHADER_MAX_TRIANGLES ];
+	qboolean        *frontFacing = tw->check->frontFacing;
+	float           *intersection = tw->check->intersection;
 	float           intersect;
 	const cPlane_t  *planes;
 	const cFacet_t  *facet;
@@ -752,20 +917,156 @@ void CM_TracePointThroughSurfaceCollide( traceWork_t *tw, const cSurfaceCollide_
 	}
 }
 
+static bool cmScalarKernels; // only changed by cm_traceBenchmark
+
+/*
+====================
+CM_PlaneGroupDistances
+
+Distances from the trace start and end to four planes, pushed out by the
+traced volume. Lanes from firstBorder on are facet borders, which may be
+flipped so they are pushed out by the absolute box offset. Also returns the
+pushed out plane distances.
+====================
+*/
+static void CM_PlaneGroupDistances( const traceWork_t *tw, const cPlaneGroup_t *group, traceType_t type, int firstBorder,
+                                    float dist[ 4 ], float d1[ 4 ], float d2[ 4 ] )
+{
+	int    i;
+	float  offset, t;
+	vec3_t normal, corner, startp, endp;
+
+#if idx86_sse
+	if ( !cmScalarKernels )
+	{
+		__m128 nx = _mm_loadu_ps( group->normal[ 0 ] );
+		__m128 ny = _mm_loadu_ps( group->normal[ 1 ] );
+		__m128 nz = _mm_loadu_ps( group->normal[ 2 ] );
+		__m128 gdist = _mm_loadu_ps( group->dist );
+		__m128 pdist, s1, s2;
+
+		if ( type == TT_CAPSULE )
+		{
+			// find the closest point on the capsule to each plane
+			__m128 front = _mm_cmpgt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( nx, _mm_set1_ps( tw->sphere.offset[ 0 ] ) ),
+			                                                     _mm_mul_ps( ny, _mm_set1_ps( tw->sphere.offset[ 1 ] ) ) ),
+			                                          _mm_mul_ps( nz, _mm_set1_ps( tw->sphere.offset[ 2 ] ) ) ), _mm_setzero_ps() );
+			__m128 p[ 3 ], q[ 3 ];
+
+			for ( i = 0; i < 3; i++ )
+			{
+				p[ i ] = _mm_or_ps( _mm_and_ps( front, _mm_set1_ps( tw->start[ i ] - tw->sphere.offset[ i ] ) ),
+				                    _mm_andnot_ps( front, _mm_set1_ps( tw->start[ i ] + tw->sphere.offset[ i ] ) ) );
+				q[ i ] = _mm_or_ps( _mm_and_ps( front, _mm_set1_ps( tw->end[ i ] - tw->sphere.offset[ i ] ) ),
+				                    _mm_andnot_ps( front, _mm_set1_ps( tw->end[ i ] + tw->sphere.offset[ i ] ) ) );
+			}
+
+			pdist = _mm_add_ps( gdist, _mm_set1_ps( tw->sphere.radius ) );
+			s1 = _mm_sub_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( p[ 0 ], nx ), _mm_mul_ps( p[ 1 ], ny ) ), _mm_mul_ps( p[ 2 ], nz ) ), pdist );
+			s2 = _mm_sub_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( q[ 0 ], nx ), _mm_mul_ps( q[ 1 ], ny ) ), _mm_mul_ps( q[ 2 ], nz ) ), pdist );
+		}
+		else
+		{
+			s1 = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( tw->start[ 0 ] ), nx ), _mm_mul_ps( _mm_set1_ps( tw->start[ 1 ] ), ny ) ),
+			                 _mm_mul_ps( _mm_set1_ps( tw->start[ 2 ] ), nz ) );
+			s2 = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( tw->end[ 0 ] ), nx ), _mm_mul_ps( _mm_set1_ps( tw->end[ 1 ] ), ny ) ),
+			                 _mm_mul_ps( _mm_set1_ps( tw->end[ 2 ] ), nz ) );
+
+			if ( type == TT_BISPHERE )
+			{
+				pdist = gdist;
+				s1 = _mm_sub_ps( s1, _mm_add_ps( gdist, _mm_set1_ps( tw->biSphere.startRadius ) ) );
+				s2 = _mm_sub_ps( s2, _mm_add_ps( gdist, _mm_set1_ps( tw->biSphere.endRadius ) ) );
+			}
+			else
+			{
+				// pick the box corner the scalar code finds through the plane signbits
+				__m128 o[ 3 ], boxOffset, border;
+
+				for ( i = 0; i < 3; i++ )
+				{
+					__m128 negative = _mm_loadu_ps( ( const float * ) group->negative[ i ] );
+
+					o[ i ] = _mm_or_ps( _mm_and_ps( negative, _mm_set1_ps( tw->size[ 1 ][ i ] ) ),
+					                    _mm_andnot_ps( negative, _mm_set1_ps( tw->size[ 0 ][ i ] ) ) );
+				}
+
+				boxOffset = _mm_add_ps( _mm_add_ps( _mm_mul_ps( o[ 0 ], nx ), _mm_mul_ps( o[ 1 ], ny ) ), _mm_mul_ps( o[ 2 ], nz ) );
+				border = _mm_cmpge_ps( _mm_set_ps( 3, 2, 1, 0 ), _mm_set1_ps( firstBorder ) );
+
+				pdist = _mm_or_ps( _mm_and_ps( border, _mm_add_ps( gdist, _mm_andnot_ps( _mm_set1_ps( -0.0f ), boxOffset ) ) ),
+				                   _mm_andnot_ps( border, _mm_sub_ps( gdist, boxOffset ) ) );
+				s1 = _mm_sub_ps( s1, pdist );
+				s2 = _mm_sub_ps( s2, pdist );
+			}
+		}
+
+		_mm_storeu_ps( dist, pdist );
+		_mm_storeu_ps( d1, s1 );
+		_mm_storeu_ps( d2, s2 );
+		return;
+	}
+#endif
+
+	for ( i = 0; i < 4; i++ )
+	{
+		VectorSet( normal, group->normal[ 0 ][ i ], group->normal[ 1 ][ i ], group->normal[ 2 ][ i ] );
+
+		if ( type == TT_CAPSULE )
+		{
+			// adjust the plane distance appropriately for radius
+			dist[ i ] = group->dist[ i ] + tw->sphere.radius;
+
+			// find the closest point on the capsule to the plane
+			t = DotProduct( normal, tw->sphere.offset );
+
+			if ( t > 0 )
+			{
+				VectorSubtract( tw->start, tw->sphere.offset, startp );
+				VectorSubtract( tw->end, tw->sphere.offset, endp );
+			}
+			else
+			{
+				VectorAdd( tw->start, tw->sphere.offset, startp );
+				VectorAdd( tw->end, tw->sphere.offset, endp );
+			}
+
+			d1[ i ] = DotProduct( startp, normal ) - dist[ i ];
+			d2[ i ] = DotProduct( endp, normal ) - dist[ i ];
+		}
+		else if ( type == TT_BISPHERE )
+		{
+			// adjust the plane distance appropriately for radius
+			dist[ i ] = group->dist[ i ];
+			d1[ i ] = DotProduct( tw->start, normal ) - ( dist[ i ] + tw->biSphere.startRadius );
+			d2[ i ] = DotProduct( tw->end, normal ) - ( dist[ i ] + tw->biSphere.endRadius );
+		}
+		else
+		{
+			// adjust the plane distance appropriately for mins/maxs
+			VectorSet( corner, tw->size[ group->negative[ 0 ][ i ] ? 1 : 0 ][ 0 ], tw->size[ group->negative[ 1 ][ i ] ? 1 : 0 ][ 1 ],
+			           tw->size[ group->negative[ 2 ][ i ] ? 1 : 0 ][ 2 ] );
+			offset = DotProduct( corner, normal );
+
+			// NOTE: this works for flipped facet borders because the bbox is centered
+			dist[ i ] = i >= firstBorder ? group->dist[ i ] + fabs( offset ) : group->dist[ i ] - offset;
+			d1[ i ] = DotProduct( tw->start, normal ) - dist[ i ];
+			d2[ i ] = DotProduct( tw->end, normal ) - dist[ i ];
+		}
+	}
+}
+
 /*
 ====================
 CM_CheckFacetPlane
 ====================
 */
-int CM_CheckFacetPlane( float *plane, vec3_t start, vec3_t end, float *enterFrac, float *leaveFrac, int *hit )
+int CM_CheckFacetPlane( float d1, float d2, float *enterFrac, float *leaveFrac, int *hit )
 {
-	float d1, d2, f;
+	float f;
 
 	*hit = qfalse;
 
-	d1 = DotProduct( start, plane ) - plane[ 3 ];
-	d2 = DotProduct( end, plane ) - plane[ 3 ];
-
 	// if completely in front of face, no intersection with the entire facet
 	if ( d1 > 0 && ( d2 >= SURFACE_CLIP_EPSILON || d2 >= d1 ) )
 	{
@@ -822,13 +1123,13 @@ CM_TraceThroughSurfaceCollide
 */
 void CM_TraceThroughSurfaceCollide( traceWork_t *tw, const cSurfaceCollide_t *sc )
 {
-	int           i, j, hit, hitnum;
-	float         offset, enterFrac, leaveFrac, t;
-	cPlane_t      *planes;
-	cFacet_t      *facet;
-	float         plane[ 4 ] = { 0, 0, 0, 0 };
-	float         bestplane[ 4 ] = { 0, 0, 0, 0 };
-	vec3_t        startp, endp;
+	int                 i, j, hit, hitnum;
+	float               enterFrac, leaveFrac;
+	const cFacet_t      *facet;
+	const cPlaneGroup_t *groups;
+	float               bestplane[ 4 ] = { 0, 0, 0, 0 };
+	float               dist[ 4 ], d1[ 4 ], d2[ 4 ];
+	traceType_t         type;
 
 	if ( !CM_BoundsIntersect( tw->bounds[ 0 ], tw->bounds[ 1 ], sc->bounds[ 0 ], sc->bounds[ 1 ] ) )
 	{
@@ -841,109 +1142,40 @@ void CM_TraceThroughSurfaceCollide( traceWork_t *tw, const cSurfaceCollide_t *sc
 		return;
 	}
 
+	type = tw->type == TT_CAPSULE ? TT_CAPSULE : TT_AABB;
+
 	for ( i = 0, facet = sc->facets; i < sc->numFacets; i++, facet++ )
 	{
 		enterFrac = -1.0;
 		leaveFrac = 1.0;
 		hitnum = -1;
 
-		planes = &sc->planes[ facet->surfacePlane ];
-		VectorCopy( planes->plane, plane );
-		plane[ 3 ] = planes->plane[ 3 ];
-
-		if ( tw->type == TT_CAPSULE )
-		{
-			// adjust the plane distance appropriately for radius
-			plane[ 3 ] += tw->sphere.radius;
-
-			// find the closest point on the capsule to the plane
-			t = DotProduct( plane, tw->sphere.offset );
-
-			if ( t > 0.0f )
-			{
-				VectorSubtract( tw->start, tw->sphere.offset, startp );
-				VectorSubtract( tw->end, tw->sphere.offset, endp );
-			}
-			else
-			{
-				VectorAdd( tw->start, tw->sphere.offset, startp );
-				VectorAdd( tw->end, tw->sphere.offset, endp );
-			}
-		}
-		else
-		{
-			offset = DotProduct( tw->offsets[ planes->signbits ], plane );
-			plane[ 3 ] -= offset;
-			VectorCopy( tw->start, startp );
-			VectorCopy( tw->end, endp );
-		}
-
-		if ( !CM_CheckFacetPlane( plane, startp, endp, &enterFrac, &leaveFrac, &hit ) )
-		{
-			continue;
-		}
+		groups = &sc->planeGroups[ facet->firstPlaneGroup ];
 
-		if ( hit )
+		// the surface plane comes first, followed by the borders
+		for ( j = 0; j <= facet->numBorders; j++ )
 		{
-			Vector4Copy( plane, bestplane );
-		}
-
-		for ( j = 0; j < facet->numBorders; j++ )
-		{
-			planes = &sc->planes[ facet->borderPlanes[ j ] ];
-
-			if ( facet->borderInward[ j ] )
-			{
-				VectorNegate( planes->plane, plane );
-				plane[ 3 ] = -planes->plane[ 3 ];
-			}
-			else
-			{
-				VectorCopy( planes->plane, plane );
-				plane[ 3 ] = planes->plane[ 3 ];
-			}
-
-			if ( tw->type == TT_CAPSULE )
-			{
-				// adjust the plane distance appropriately for radius
-				plane[ 3 ] += tw->sphere.radius;
-
-				// find the closest point on the capsule to the plane
-				t = DotProduct( plane, tw->sphere.offset );
-
-				if ( t > 0.0f )
-				{
-					VectorSubtract( tw->start, tw->sphere.offset, startp );
-					VectorSubtract( tw->end, tw->sphere.offset, endp );
-				}
-				else
-				{
-					VectorAdd( tw->start, tw->sphere.offset, startp );
-					VectorAdd( tw->end, tw->sphere.offset, endp );
-				}
-			}
-			else
+			if ( !( j & 3 ) )
 			{
-				// NOTE: this works even though the plane might be flipped because the bbox is centered
-				offset = DotProduct( tw->offsets[ planes->signbits ], plane );
-				plane[ 3 ] += fabs( offset );
-				VectorCopy( tw->start, startp );
-				VectorCopy( tw->end, endp );
+				CM_PlaneGroupDistances( tw, &groups[ j >> 2 ], type, j ? 0 : 1, dist, d1, d2 );
 			}
 
-			if ( !CM_CheckFacetPlane( plane, startp, endp, &enterFrac, &leaveFrac, &hit ) )
+			if ( !CM_CheckFacetPlane( d1[ j & 3 ], d2[ j & 3 ], &enterFrac, &leaveFrac, &hit ) )
 			{
 				break;
 			}
 
 			if ( hit )
 			{
-				hitnum = j;
-				Vector4Copy( plane, bestplane );
+				hitnum = j - 1;
+				bestplane[ 0 ] = groups[ j >> 2 ].normal[ 0 ][ j & 3 ];
+				bestplane[ 1 ] = groups[ j >> 2 ].normal[ 1 ][ j & 3 ];
+				bestplane[ 2 ] = groups[ j >> 2 ].normal[ 2 ][ j & 3 ];
+				bestplane[ 3 ] = dist[ j & 3 ];
 			}
 		}
 
-		if ( j < facet->numBorders )
+		if ( j <= facet->numBorders )
 		{
 			continue;
 		}
@@ -1001,257 +1233,82 @@ void CM_TraceThroughSurface( traceWork_t *tw, cSurface_t *surface )
 	{
 		tw->trace.surfaceFlags = surface->surfaceFlags;
 		tw->trace.contents = surface->contents;
-	}
-}
-
-/*
-================
-CM_TraceThroughBrush
-================
-*/
-void CM_TraceThroughBrush( traceWork_t *tw, cbrush_t *brush )
-{
-	int          i;
-	cplane_t     *plane, *clipplane;
-	float        dist;
-	float        enterFrac, leaveFrac;
-	float        d1, d2;
-	qboolean     getout, startout;
-	float        f;
-	cbrushside_t *side, *leadside;
-	float        t;
-	vec3_t       startp;
-	vec3_t       endp;
-
-	enterFrac = -1.0;
-	leaveFrac = 1.0;
-	clipplane = NULL;
-
-	if ( !brush->numsides )
-	{
-		return;
-	}
-
-	c_brush_traces++;
-
-	getout = qfalse;
-	startout = qfalse;
-
-	leadside = NULL;
-
-	if ( tw->type == TT_BISPHERE )
-	{
-		//
-		// compare the trace against all planes of the brush
-		// find the latest time the trace crosses a plane towards the interior
-		// and the earliest time the trace crosses a plane towards the exterior
-		//
-		for ( i = 0; i < brush->numsides; i++ )
-		{
-			side = brush->sides + i;
-			plane = side->plane;
-
-			// adjust the plane distance appropriately for radius
-			d1 = DotProduct( tw->start, plane->normal ) - ( plane->dist + tw->biSphere.startRadius );
-			d2 = DotProduct( tw->end, plane->normal ) - ( plane->dist + tw->biSphere.endRadius );
-
-			if ( d2 > 0 )
-			{
-				getout = qtrue; // endpoint is not in solid
-			}
-
-			if ( d1 > 0 )
-			{
-				startout = qtrue;
-			}
-
-			// if completely in front of face, no intersection with the entire brush
-			if ( d1 > 0 && ( d2 >= SURFACE_CLIP_EPSILON || d2 >= d1 ) )
-			{
-				return;
-			}
-
-			// if it doesn't cross the plane, the plane isn't relevent
-			if ( d1 <= 0 && d2 <= 0 )
-			{
-				continue;
-			}
-
-			brush->collided = qtrue;
-
-			// crosses face
-			if ( d1 > d2 )
-			{
-				// enter
-				f = ( d1 - SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
-
-				if ( f < 0 )
-				{
-					f = 0;
-				}
-
-				if ( f > enterFrac )
-				{
-					enterFrac = f;
-					clipplane = plane;
-					leadside = side;
-				}
-			}
-			else
-			{
-				// leave
-				f = ( d1 + SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
-
-				if ( f > 1 )
-				{
-					f = 1;
-				}
-
-				if ( f < leaveFrac )
-				{
-					leaveFrac = f;
-				}
-			}
-		}
-	}
-	else if ( tw->type == TT_CAPSULE )
-	{
-		//
-		// compare the trace against all planes of the brush
-		// find the latest time the trace crosses a plane towards the interior
-		// and the earliest time the trace crosses a plane towards the exterior
-		//
-		for ( i = 0; i < brush->numsides; i++ )
-		{
-			side = brush->sides + i;
-			plane = side->plane;
-
-			// adjust the plane distance appropriately for radius
-			dist = plane->dist + tw->sphere.radius;
-
-			// find the closest point on the capsule to the plane
-			t = DotProduct( plane->normal, tw->sphere.offset );
-
-			if ( t > 0 )
-			{
-				VectorSubtract( tw->start, tw->sphere.offset, startp );
-				VectorSubtract( tw->end, tw->sphere.offset, endp );
-			}
-			else
-			{
-				VectorAdd( tw->start, tw->sphere.offset, startp );
-				VectorAdd( tw->end, tw->sphere.offset, endp );
-			}
-
-			d1 = DotProduct( startp, plane->normal ) - dist;
-			d2 = DotProduct( endp, plane->normal ) - dist;
-
-			if ( d2 > 0 )
-			{
-				getout = qtrue; // endpoint is not in solid
-			}
-
-			if ( d1 > 0 )
-			{
-				startout = qtrue;
-			}
-
-			// if completely in front of face, no intersection with the entire brush
-			if ( d1 > 0 && ( d2 >= SURFACE_CLIP_EPSILON || d2 >= d1 ) )
-			{
-				return;
-			}
+	}
+}
 
-			// if it doesn't cross the plane, the plane isn't relevant
-			if ( d1 <= 0 && d2 <= 0 )
-			{
-				continue;
-			}
+/*
+================
+CM_TraceThroughBrush
+================
+*/
+void CM_TraceThroughBrush( traceWork_t *tw, cbrush_t *brush )
+{
+	int          i, j;
+	cplane_t     *clipplane;
+	float        enterFrac, leaveFrac;
+	float        dist[ 4 ], d1[ 4 ], d2[ 4 ];
+	qboolean     getout, startout;
+	float        f;
+	cbrushside_t *side, *leadside;
 
-			brush->collided = qtrue;
+	enterFrac = -1.0;
+	leaveFrac = 1.0;
+	clipplane = NULL;
 
-			// crosses face
-			if ( d1 > d2 )
-			{
-				// enter
-				f = ( d1 - SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
+	if ( !brush->numsides )
+	{
+		return;
+	}
 
-				if ( f < 0 )
-				{
-					f = 0;
-				}
+	c_brush_traces++;
 
-				if ( f > enterFrac )
-				{
-					enterFrac = f;
-					clipplane = plane;
-					leadside = side;
-				}
-			}
-			else
-			{
-				// leave
-				f = ( d1 + SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
+	getout = qfalse;
+	startout = qfalse;
 
-				if ( f > 1 )
-				{
-					f = 1;
-				}
+	leadside = NULL;
 
-				if ( f < leaveFrac )
-				{
-					leaveFrac = f;
-				}
-			}
-		}
-	}
-	else
+	//
+	// compare the trace against all planes of the brush, four at a time
+	// find the latest time the trace crosses a plane towards the interior
+	// and the earliest time the trace crosses a plane towards the exterior
+	//
+	for ( i = 0; i < brush->numsides; i += 4 )
 	{
-		//
-		// compare the trace against all planes of the brush
-		// find the latest time the trace crosses a plane towards the interior
-		// and the earliest time the trace crosses a plane towards the exterior
-		//
-		for ( i = 0; i < brush->numsides; i++ )
-		{
-			side = brush->sides + i;
-			plane = side->plane;
-
-			// adjust the plane distance appropriately for mins/maxs
-			dist = plane->dist - DotProduct( tw->offsets[ plane->signbits ], plane->normal );
+		CM_PlaneGroupDistances( tw, &brush->planeGroups[ i >> 2 ], tw->type, 4, dist, d1, d2 );
 
-			d1 = DotProduct( tw->start, plane->normal ) - dist;
-			d2 = DotProduct( tw->end, plane->normal ) - dist;
+		for ( j = 0; j < 4 && i + j < brush->numsides; j++ )
+		{
+			side = brush->sides + i + j;
 
-			if ( d2 > 0 )
+			if ( d2[ j ] > 0 )
 			{
 				getout = qtrue; // endpoint is not in solid
 			}
 
-			if ( d1 > 0 )
+			if ( d1[ j ] > 0 )
 			{
 				startout = qtrue;
 			}
 
 			// if completely in front of face, no intersection with the entire brush
-			if ( d1 > 0 && ( d2 >= SURFACE_CLIP_EPSILON || d2 >= d1 ) )
+			if ( d1[ j ] > 0 && ( d2[ j ] >= SURFACE_CLIP_EPSILON || d2[ j ] >= d1[ j ] ) )
 			{
 				return;
 			}
 
 			// if it doesn't cross the plane, the plane isn't relevant
-			if ( d1 <= 0 && d2 <= 0 )
+			if ( d1[ j ] <= 0 && d2[ j ] <= 0 )
 			{
 				continue;
 			}
 
-			brush->collided = qtrue;
+			tw->check->brushCollided[ brush - cm.brushes ] = tw->check->stamp;
 
 			// crosses face
-			if ( d1 > d2 )
+			if ( d1[ j ] > d2[ j ] )
 			{
 				// enter
-				f = ( d1 - SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
+				f = ( d1[ j ] - SURFACE_CLIP_EPSILON ) / ( d1[ j ] - d2[ j ] );
 
 				if ( f < 0 )
 				{
@@ -1261,14 +1318,14 @@ void CM_TraceThroughBrush( traceWork_t *tw, cbrush_t *brush )
 				if ( f > enterFrac )
 				{
 					enterFrac = f;
-					clipplane = plane;
+					clipplane = side->plane;
 					leadside = side;
 				}
 			}
 			else
 			{
 				// leave
-				f = ( d1 + SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
+				f = ( d1[ j ] + SURFACE_CLIP_EPSILON ) / ( d1[ j ] - d2[ j ] );
 
 				if ( f > 1 )
 				{
@@ -1343,6 +1400,7 @@ static void CM_ProximityToBrush( traceWork_t *tw, cbrush_t *brush )
 	VectorClear( tw2.sphere.offset );
 	VectorCopy( tw->start, tw2.start );
 	VectorCopy( tw->end, tw2.end );
+	tw2.check = tw->check;
 
 	CM_TraceThroughBrush( &tw2, brush );
 
@@ -1427,6 +1485,7 @@ void CM_TraceThroughLeaf( traceWork_t *tw, cLeaf_t *leaf )
 {
 	int        k;
 	int        brushnum;
+	int        surfacenum;
 	cbrush_t   *b;
 	cSurface_t *surface;
 
@@ -1437,20 +1496,18 @@ void CM_TraceThroughLeaf( traceWork_t *tw, cLeaf_t *leaf )
 
 		b = &cm.brushes[ brushnum ];
 
-		if ( b->checkcount == cm.checkcount )
+		if ( tw->check->brushChecked[ brushnum ] == tw->check->stamp )
 		{
 			continue; // already checked this brush in another leaf
 		}
 
-		b->checkcount = cm.checkcount;
+		tw->check->brushChecked[ brushnum ] = tw->check->stamp;
 
 		if ( !( b->contents & tw->contents ) )
 		{
 			continue;
 		}
 
-		b->collided = qfalse;
-
 		if ( !CM_BoundsIntersect( tw->bounds[ 0 ], tw->bounds[ 1 ], b->bounds[ 0 ], b->bounds[ 1 ] ) )
 		{
 			continue;
@@ -1468,19 +1525,20 @@ void CM_TraceThroughLeaf( traceWork_t *tw, cLeaf_t *leaf )
 	// trace line against all surfaces in the leaf
 	for ( k = 0; k < leaf->numLeafSurfaces; k++ )
 	{
-		surface = cm.surfaces[ cm.leafsurfaces[ leaf->firstLeafSurface + k ] ];
+		surfacenum = cm.leafsurfaces[ leaf->firstLeafSurface + k ];
+		surface = cm.surfaces[ surfacenum ];
 
 		if ( !surface )
 		{
 			continue;
 		}
 
-		if ( surface->checkcount == cm.checkcount )
+		if ( tw->check->surfaceChecked[ surfacenum ] == tw->check->stamp )
 		{
 			continue; // already checked this surface in another leaf
 		}
 
-		surface->checkcount = cm.checkcount;
+		tw->check->surfaceChecked[ surfacenum ] = tw->check->stamp;
 
 		if ( !( surface->contents & tw->contents ) )
 		{
@@ -1510,7 +1568,7 @@ void CM_TraceThroughLeaf( traceWork_t *tw, cLeaf_t *leaf )
 			b = &cm.brushes[ brushnum ];
 
 			// This brush never collided, so don't bother
-			if ( !b->collided )
+			if ( tw->check->brushCollided[ brushnum ] != tw->check->stamp )
 			{
 				continue;
 			}
@@ -2042,8 +2100,6 @@ static void CM_Trace( trace_t *results, const vec3_t start,
 
 	cmod = CM_ClipHandleToModel( model );
 
-	cm.checkcount++; // for multi-check avoidance
-
 	c_traces++; // for statistics, may be zeroed
 
 	// fill in a default trace
@@ -2059,6 +2115,8 @@ static void CM_Trace( trace_t *results, const vec3_t start,
 		return; // map not loaded, shouldn't happen
 	}
 
+	tw.check = CM_AcquireCheck();
+
 	// allow NULL to be passed in for 0,0,0
 	if ( !mins )
 	{
@@ -2290,9 +2348,84 @@ static void CM_Trace( trace_t *results, const vec3_t start,
 //	assert(tw.trace.fraction != 1.0);
 //	assert(VectorLength(tw.trace.plane.normal) > 0.9999);
 
+	CM_ReleaseCheck( tw.check );
+
 	*results = tw.trace;
 }
 
+/*
+===============================================================================
+
+TRACE RECORDING
+
+Keeps the box traces the game really does, to replay them in cm_traceBenchmark
+
+===============================================================================
+*/
+
+typedef struct
+{
+	vec3_t       start, end;
+	vec3_t       mins, maxs;
+	vec3_t       origin, angles;
+	clipHandle_t model;
+	int          brushmask;
+	traceType_t  type;
+} cmStressQuery_t;
+
+static Cvar::Range<Cvar::Cvar<int>> cm_recordTraces(VM_STRING_PREFIX "cm_recordTraces", "number of box traces to keep for cm_traceBenchmark", Cvar::CHEAT, 0, 0, 1000000);
+
+static std::mutex                   cmRecordLock;
+static std::vector<cmStressQuery_t> cmRecordedTraces;
+
+/*
+==================
+CM_RecordTrace
+==================
+*/
+static void CM_RecordTrace( const vec3_t start, const vec3_t end, const vec3_t mins, const vec3_t maxs, clipHandle_t model,
+                            int brushmask, const vec3_t origin, const vec3_t angles, traceType_t type )
+{
+	cmStressQuery_t query;
+
+	// temp models can't be replayed
+	if ( model == BOX_MODEL_HANDLE || model == CAPSULE_MODEL_HANDLE )
+	{
+		return;
+	}
+
+	VectorCopy( start, query.start );
+	VectorCopy( end, query.end );
+	VectorCopy( mins ? mins : vec3_origin, query.mins );
+	VectorCopy( maxs ? maxs : vec3_origin, query.maxs );
+	VectorCopy( origin, query.origin );
+	VectorCopy( angles, query.angles );
+	query.model = model;
+	query.brushmask = brushmask;
+	query.type = type;
+
+	std::lock_guard<std::mutex> lock( cmRecordLock );
+
+	if ( ( int ) cmRecordedTraces.size() < cm_recordTraces.Get() )
+	{
+		cmRecordedTraces.push_back( query );
+	}
+}
+
+/*
+==================
+CM_ClearRecordedTraces
+
+The clip handles only make sense for the map they were recorded on
+==================
+*/
+void CM_ClearRecordedTraces( void )
+{
+	std::lock_guard<std::mutex> lock( cmRecordLock );
+
+	cmRecordedTraces.clear();
+}
+
 /*
 ==================
 CM_BoxTrace
@@ -2301,6 +2434,11 @@ CM_BoxTrace
 void CM_BoxTrace( trace_t *results, const vec3_t start, const vec3_t end,
                   vec3_t mins, vec3_t maxs, clipHandle_t model, int brushmask, traceType_t type )
 {
+	if ( cm_recordTraces.Get() )
+	{
+		CM_RecordTrace( start, end, mins, maxs, model, brushmask, vec3_origin, vec3_origin, type );
+	}
+
 	CM_Trace( results, start, end, mins, maxs, model, vec3_origin, brushmask, type, NULL );
 }
 
@@ -2328,6 +2466,11 @@ void CM_TransformedBoxTrace( trace_t *results, const vec3_t start, const vec3_t
 	float    t;
 	sphere_t sphere;
 
+	if ( cm_recordTraces.Get() )
+	{
+		CM_RecordTrace( start, end, mins, maxs, model, brushmask, origin, angles, type );
+	}
+
 	if ( !mins )
 	{
 		mins = vec3_origin;
@@ -2427,8 +2570,6 @@ void CM_BiSphereTrace( trace_t *results, const vec3_t start,
 
 	cmod = CM_ClipHandleToModel( model );
 
-	cm.checkcount++; // for multi-check avoidance
-
 	c_traces++; // for statistics, may be zeroed
 
 	// fill in a default trace
@@ -2446,6 +2587,8 @@ void CM_BiSphereTrace( trace_t *results, const vec3_t start,
 		return; // map not loaded, shouldn't happen
 	}
 
+	tw.check = CM_AcquireCheck();
+
 	// set basic parms
 	tw.contents = mask;
 
@@ -2511,6 +2654,8 @@ void CM_BiSphereTrace( trace_t *results, const vec3_t start,
 	//  assert(tw.trace.fraction != 1.0);
 	//  assert(VectorLength(tw.trace.plane.normal) > 0.9999);
 
+	CM_ReleaseCheck( tw.check );
+
 	*results = tw.trace;
 }
 
@@ -2756,3 +2901,267 @@ void CM_DrawDebugSurface( void ( *drawPoly )( int color, int numPoints, float *p
 	}
 #endif
 }
+
+/*
+=======================================================================
+
+STRESS TEST AND BENCHMARK
+
+=======================================================================
+*/
+
+typedef struct
+{
+	trace_t trace;
+	int     contents;
+} cmStressResult_t;
+
+/*
+==================
+CM_StressRandom
+
+Small LCG so that the queries are the same on every run
+==================
+*/
+static float CM_StressRandom( unsigned int *seed, float low, float high )
+{
+	*seed = *seed * 1664525u + 1013904223u;
+
+	return low + ( high - low ) * ( ( *seed >> 8 ) / 16777216.0f );
+}
+
+/*
+==================
+CM_StressQueries
+
+Random queries of all the kinds over the world and its submodels
+==================
+*/
+static void CM_StressQueries( std::vector<cmStressQuery_t>& queries, int numQueries )
+{
+	unsigned int seed = 1;
+	vec3_t       mins, maxs;
+
+	CM_ModelBounds( 0, mins, maxs );
+
+	queries.resize( numQueries );
+
+	for ( auto& query : queries )
+	{
+		float size = CM_StressRandom( &seed, 0.0f, 32.0f );
+		int   i;
+
+		for ( i = 0; i < 3; i++ )
+		{
+			query.start[ i ] = CM_StressRandom( &seed, mins[ i ], maxs[ i ] );
+			query.end[ i ] = query.start[ i ] + CM_StressRandom( &seed, -512.0f, 512.0f );
+			query.mins[ i ] = -size;
+			query.maxs[ i ] = size;
+			query.angles[ i ] = CM_StressRandom( &seed, -15.0f, 15.0f );
+		}
+
+		VectorClear( query.origin );
+		query.brushmask = CONTENTS_SOLID;
+		query.model = CM_InlineModel( ( int ) CM_StressRandom( &seed, 0.0f, cm.numSubModels ) % cm.numSubModels );
+		query.type = ( traceType_t ) ( TT_AABB + ( int ) CM_StressRandom( &seed, 0.0f, 3.0f ) % 3 );
+
+		// some point traces and position tests
+		if ( CM_StressRandom( &seed, 0.0f, 1.0f ) < 0.1f )
+		{
+			VectorClear( query.mins );
+			VectorClear( query.maxs );
+		}
+		else if ( CM_StressRandom( &seed, 0.0f, 1.0f ) < 0.1f )
+		{
+			VectorCopy( query.start, query.end );
+		}
+	}
+}
+
+/*
+==================
+CM_StressQuery
+==================
+*/
+static void CM_StressQuery( const cmStressQuery_t *query, cmStressResult_t *result )
+{
+	if ( query->type == TT_BISPHERE )
+	{
+		CM_BiSphereTrace( &result->trace, query->start, query->end, query->maxs[ 0 ], query->maxs[ 1 ], query->model, query->brushmask );
+	}
+	else if ( query->model )
+	{
+		CM_TransformedBoxTrace( &result->trace, query->start, query->end, query->mins, query->maxs, query->model,
+		                        query->brushmask, query->origin, query->angles, query->type );
+	}
+	else
+	{
+		CM_BoxTrace( &result->trace, query->start, query->end, ( float * ) query->mins, ( float * ) query->maxs,
+		             query->model, query->brushmask, query->type );
+	}
+
+	result->contents = CM_TransformedPointContents( query->end, query->model, query->origin, query->angles );
+}
+
+/*
+==================
+CM_StressResultsMatch
+==================
+*/
+static bool CM_StressResultsMatch( const cmStressResult_t *a, const cmStressResult_t *b )
+{
+	return a->trace.allsolid == b->trace.allsolid && a->trace.startsolid == b->trace.startsolid &&
+	       a->trace.fraction == b->trace.fraction && VectorCompare( a->trace.endpos, b->trace.endpos ) &&
+	       VectorCompare( a->trace.plane.normal, b->trace.plane.normal ) && a->trace.plane.dist == b->trace.plane.dist &&
+	       a->trace.surfaceFlags == b->trace.surfaceFlags && a->trace.contents == b->trace.contents &&
+	       a->trace.lateralFraction == b->trace.lateralFraction && a->contents == b->contents;
+}
+
+class StressTestCmd: public Cmd::StaticCmd
+{
+public:
+	StressTestCmd()
+		: Cmd::StaticCmd(VM_STRING_PREFIX "cm_stressTest", Cmd::SYSTEM, N_("runs random traces on several threads and compares them with the serial results")) {}
+
+	void Run(const Cmd::Args& args) const OVERRIDE
+	{
+		int numQueries = args.Argc() > 1 ? atoi( args.Argv( 1 ).c_str() ) : 10000;
+		int numThreads = args.Argc() > 2 ? atoi( args.Argv( 2 ).c_str() ) : 4;
+
+		if ( !cm.numNodes )
+		{
+			Print( "no map loaded" );
+			return;
+		}
+
+		if ( numQueries <= 0 || numThreads <= 0 )
+		{
+			PrintUsage( args, "[queries] [threads]", "" );
+			return;
+		}
+
+		std::vector<cmStressQuery_t> queries;
+		std::vector<cmStressResult_t> serial( numQueries );
+
+		CM_StressQueries( queries, numQueries );
+
+		auto start = std::chrono::steady_clock::now();
+
+		for ( int i = 0; i < numQueries; i++ )
+		{
+			CM_StressQuery( &queries[ i ], &serial[ i ] );
+		}
+
+		auto serialTime = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start );
+		std::atomic<int> mismatches( 0 );
+		std::vector<std::thread> threads;
+
+		start = std::chrono::steady_clock::now();
+
+		for ( int t = 0; t < numThreads; t++ )
+		{
+			// every thread runs all the queries, starting at a different one
+			threads.emplace_back( [&, t] {
+				cmStressResult_t result;
+
+				for ( int k = 0; k < numQueries; k++ )
+				{
+					int i = ( k + t * numQueries / numThreads ) % numQueries;
+
+					CM_StressQuery( &queries[ i ], &result );
+
+					if ( !CM_StressResultsMatch( &result, &serial[ i ] ) )
+					{
+						mismatches++;
+					}
+				}
+			} );
+		}
+
+		for ( auto& thread : threads )
+		{
+			thread.join();
+		}
+
+		auto threadedTime = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start );
+
+		Print( "%i queries: serial %i msec, %i threads %i msec, %i mismatches", numQueries, ( int ) serialTime.count(), numThreads,
+		       ( int ) threadedTime.count(), mismatches.load() );
+	}
+};
+static StressTestCmd StressTestCmdRegistration;
+
+class TraceBenchmarkCmd: public Cmd::StaticCmd
+{
+public:
+	TraceBenchmarkCmd()
+		: Cmd::StaticCmd(VM_STRING_PREFIX "cm_traceBenchmark", Cmd::SYSTEM, N_("times the scalar and SIMD trace kernels on the recorded or random traces and compares them")) {}
+
+	void Run(const Cmd::Args& args) const OVERRIDE
+	{
+		int numQueries = args.Argc() > 1 ? atoi( args.Argv( 1 ).c_str() ) : 10000;
+		std::vector<cmStressQuery_t> queries;
+		bool recorded;
+
+		if ( !cm.numNodes )
+		{
+			Print( "no map loaded" );
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock( cmRecordLock );
+
+			queries = cmRecordedTraces;
+		}
+
+		recorded = !queries.empty();
+
+		if ( !recorded )
+		{
+			if ( numQueries <= 0 )
+			{
+				PrintUsage( args, "[queries]", "" );
+				return;
+			}
+
+			CM_StressQueries( queries, numQueries );
+		}
+
+		numQueries = queries.size();
+
+		std::vector<cmStressResult_t> scalar( numQueries );
+		cmStressResult_t result;
+		int mismatches = 0;
+
+		cmScalarKernels = true;
+		auto start = std::chrono::steady_clock::now();
+
+		for ( int i = 0; i < numQueries; i++ )
+		{
+			CM_StressQuery( &queries[ i ], &scalar[ i ] );
+		}
+
+		auto scalarTime = std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start );
+
+		cmScalarKernels = false;
+		start = std::chrono::steady_clock::now();
+
+		for ( int i = 0; i < numQueries; i++ )
+		{
+			CM_StressQuery( &queries[ i ], &result );
+
+			if ( !CM_StressResultsMatch( &result, &scalar[ i ] ) )
+			{
+				mismatches++;
+			}
+		}
+
+		auto simdTime = std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start );
+
+		Print( "%i %s queries: scalar %i usec, %s %i usec, %i mismatches", numQueries,
+		       recorded ? "recorded" : "random", ( int ) scalarTime.count(), idx86_sse ? "SSE" : "scalar again",
+		       ( int ) simdTime.count(), mismatches );
+	}
+};
+static TraceBenchmarkCmd TraceBenchmarkCmdRegistration;
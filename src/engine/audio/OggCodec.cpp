@@ -50,7 +50,7 @@ namespace Audio{
  *position tracks the current position while reading the file
  */
 struct OggDataSource {
-	std::string* audioFile;
+	const FS::FileView* audioFile;
 	int position;
 };
 
@@ -86,7 +86,7 @@ size_t OggCallbackRead(void* ptr, size_t size, size_t count, void* datasource)
 		return 0;
 	}
 
-	std::string* audioFile = data->audioFile;
+	const FS::FileView* audioFile = data->audioFile;
 	int position = data->position;
 	int bytesRemaining = audioFile->size() - position;
 	int bytesToRead = size * count;
@@ -94,7 +94,7 @@ size_t OggCallbackRead(void* ptr, size_t size, size_t count, void* datasource)
 		bytesToRead = bytesRemaining;
 	}
 
-	std::copy_n(audioFile->cbegin() + position, bytesToRead, static_cast<char*>(ptr));
+	std::copy_n(audioFile->data() + position, bytesToRead, static_cast<char*>(ptr));
 	data->position += bytesToRead;
 
 	int elementsRead = bytesToRead/size;
@@ -111,10 +111,10 @@ const ov_callbacks Ogg_Callbacks = {&OggCallbackRead, nullptr, nullptr, nullptr}
 
 AudioData LoadOggCodec(std::string filename)
 {
-	std::string audioFile;
+	FS::FileView audioFile;
 	try
 	{
-		audioFile = std::move(FS::PakPath::ReadFile(filename));
+		audioFile = FS::PakPath::ViewFile(filename);
 	}
 	catch (std::system_error& err)
 	{
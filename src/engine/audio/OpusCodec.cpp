@@ -45,7 +45,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace Audio{
 
 struct OpusDataSource {
-	std::string* audioFile;
+	const FS::FileView* audioFile;
 	int position;
 };
 
@@ -80,7 +80,7 @@ int OpusCallbackRead(void* dataSource, unsigned char* ptr, int nBytes)
 		return 0;
 	}
 
-	std::string* audioFile = data->audioFile;
+	const FS::FileView* audioFile = data->audioFile;
 	int position = data->position;
 	int bytesRemaining = audioFile->size() - position;
 	int bytesToRead = nBytes;
@@ -98,10 +98,10 @@ const OpusFileCallbacks Opus_Callbacks = {&OpusCallbackRead, nullptr, nullptr, n
 
 AudioData LoadOpusCodec(std::string filename)
 {
-	std::string audioFile;
+	FS::FileView audioFile;
 	try
 	{
-		audioFile = std::move(FS::PakPath::ReadFile(filename));
+		audioFile = FS::PakPath::ViewFile(filename);
 	}
 	catch (std::system_error& err)
 	{
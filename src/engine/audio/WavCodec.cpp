@@ -41,7 +41,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 namespace Audio {
 
-inline int PackChars(const std::string& input, int startingPosition, int numberOfCharsToPack)
+inline int PackChars(const FS::FileView& input, int startingPosition, int numberOfCharsToPack)
 {
 	int packed = 0;
 	int charsLeftToPack = numberOfCharsToPack;
@@ -49,7 +49,7 @@ inline int PackChars(const std::string& input, int startingPosition, int numberO
 		int position = numberOfCharsToPack - charsLeftToPack;
         //the number must be converted to unsinged char first
         //else if it's >127, 1s will be added to the higher-order bits
-		packed |= static_cast<unsigned char>(input[startingPosition + position]) << position * 8;
+		packed |= static_cast<unsigned char>(input.data()[startingPosition + position]) << position * 8;
 		--charsLeftToPack;
 	}
 	return packed;
@@ -57,11 +57,11 @@ inline int PackChars(const std::string& input, int startingPosition, int numberO
 
 AudioData LoadWavCodec(std::string filename)
 {
-	std::string audioFile;
+	FS::FileView audioFile;
 
 	try
 	{
-		audioFile = std::move(FS::PakPath::ReadFile(filename));
+		audioFile = FS::PakPath::ViewFile(filename);
 	}
 	catch (std::system_error& err)
 	{
@@ -69,14 +69,20 @@ AudioData LoadWavCodec(std::string filename)
         return AudioData();
 	}
 
-	std::string format = audioFile.substr(8, 4);
+	// The file may be mapped, so nothing may be read past its end
+	if (audioFile.size() < 36) {
+		audioLogs.Warn("%s is too short to be a WAVE file.", filename);
+		return AudioData();
+	}
+
+	std::string format(audioFile.data() + 8, 4);
 
 	if (format != "WAVE") {
 		audioLogs.Warn("The format label in %s is not \"WAVE\".", filename);
 		return AudioData();
 	}
 
-	std::string chunk1ID = audioFile.substr(12, 4);
+	std::string chunk1ID(audioFile.data() + 12, 4);
 
 	if (chunk1ID != "fmt ") {
 		audioLogs.Warn("The Chunk1ID in %s is not \"fmt\".", filename);
@@ -99,16 +105,17 @@ AudioData LoadWavCodec(std::string filename)
 	}
 
     //TODO  find the position of "data"
-    std::size_t dataOffset{audioFile.find("data", 36)};
-	if (dataOffset == std::string::npos) {
+    static const char dataID[] = "data";
+    const char* dataChunk = std::search(audioFile.begin() + 36, audioFile.end(), dataID, dataID + 4);
+	if (audioFile.end() - dataChunk < 8) {
 		audioLogs.Warn("Could not find the data chunk in %s", filename);
 		return AudioData();
 	}
-	std::string chunk2ID = audioFile.substr(dataOffset, 4);
+	std::size_t dataOffset = dataChunk - audioFile.begin();
 
 	int size = PackChars(audioFile, dataOffset + 4, 4);
 
-	if (size <= 0 || sampleRate  <=0 ){
+	if (size <= 0 || sampleRate  <=0 || static_cast<std::size_t>(size) > audioFile.size() - dataOffset - 8){
 		audioLogs.Warn("Error in reading %s.", filename);
 		return AudioData();
 	}
@@ -40,8 +40,20 @@ void         BotShutdownNav( void );
 void         BotDisableArea( const vec3_t origin, const vec3_t mins, const vec3_t maxs );
 void         BotEnableArea( const vec3_t origin, const vec3_t mins, const vec3_t maxs );
 void         BotSetNavMesh( int botClientNum, qhandle_t nav );
+
+// Queues a route search to a new goal. Returns qfalse right away if the goal
+// is known to be unreachable: no navmesh polygon is near the bot or the goal,
+// or a search between the same polygons failed recently. Otherwise the search
+// runs over the next frames while the bot keeps following its old corridor,
+// and the botNavCmd_t of the corridor updates reports routePending until it
+// is done, then routeFailed if no path was found.
 qboolean     BotFindRouteExt( int botClientNum, const botRouteTarget_t *target, qboolean allowPartial );
 void         BotUpdateCorridor( int botClientNum, const botRouteTarget_t *target, botNavCmd_t *cmd );
+void         BotUpdateCorridors( int numBots, const int *botClientNums, const botRouteTarget_t *targets, botNavCmd_t *cmds );
+
+// Runs the queued route searches for up to bot_routeIterations Detour
+// iterations, called once per server frame
+void         BotUpdateRouteQueue( void );
 void         BotFindRandomPoint( int botClientNum, vec3_t point );
 qboolean     BotFindRandomPointInRadius( int botClientNum, const vec3_t origin, vec3_t point, float radius );
 qboolean     BotNavTrace( int botClientNum, botTrace_t *trace, const vec3_t start, const vec3_t end );
@@ -343,10 +343,31 @@ void BotShutdownNav( void )
 			nav->query = 0;
 		}
 
+		if ( nav->planner )
+		{
+			dtFreeNavMeshQuery( nav->planner );
+			nav->planner = 0;
+		}
+
 		nav->process.con.reset();
 		memset( nav->name, 0, sizeof( nav->name ) );
 	}
 
+	BotShutdownNavWorkers();
+
+	for ( int i = 0; i < MAX_CLIENTS; i++ )
+	{
+		CancelRoute( &agents[ i ] );
+
+		if ( agents[ i ].query )
+		{
+			dtFreeNavMeshQuery( agents[ i ].query );
+			agents[ i ].query = 0;
+		}
+
+		agents[ i ].nav = NULL;
+	}
+
 #ifndef BUILD_SERVER
 	NavEditShutdown();
 #endif
@@ -379,6 +400,8 @@ qboolean BotSetupNav( const botClass_t *botClass, qhandle_t *navHandle )
 			agents[ i ].needReplan = true;
 			agents[ i ].nav = NULL;
 			agents[ i ].offMesh = false;
+			agents[ i ].routeRetryTime = 0;
+			CancelRoute( &agents[ i ] );
 			memset( agents[ i ].routeResults, 0, sizeof( agents[ i ].routeResults ) );
 		}
 #ifndef BUILD_SERVER
@@ -403,15 +426,17 @@ qboolean BotSetupNav( const botClass_t *botClass, qhandle_t *navHandle )
 
 	Q_strncpyz( nav->name, botClass->name, sizeof( nav->name ) );
 	nav->query = dtAllocNavMeshQuery();
+	nav->planner = dtAllocNavMeshQuery();
 
-	if ( !nav->query )
+	if ( !nav->query || !nav->planner )
 	{
 		Com_Printf( "Could not allocate Detour Navigation Mesh Query for navmesh %s\n", filename );
 		BotShutdownNav();
 		return qfalse;
 	}
 
-	if ( dtStatusFailed( nav->query->init( nav->mesh, maxNavNodes->integer ) ) )
+	if ( dtStatusFailed( nav->query->init( nav->mesh, maxNavNodes->integer ) )
+	     || dtStatusFailed( nav->planner->init( nav->mesh, maxNavNodes->integer ) ) )
 	{
 		Com_Printf( "Could not init Detour Navigation Mesh Query for navmesh %s\n", filename );
 		BotShutdownNav();
@@ -87,14 +87,14 @@ void FindWaypoints( Bot_t *bot, float *corners, unsigned char *cornerFlags, dtPo
 		return;
 	}
 
-	*numCorners = bot->corridor.findCorners( corners, cornerFlags, cornerPolys, maxCorners, bot->nav->query, &bot->nav->filter );
+	*numCorners = bot->corridor.findCorners( corners, cornerFlags, cornerPolys, maxCorners, bot->query, &bot->nav->filter );
 }
 
 bool PointInPolyExtents( Bot_t *bot, dtPolyRef ref, rVec point, rVec extents )
 {
 	rVec closest;
 
-	if ( dtStatusFailed( bot->nav->query->closestPointOnPolyBoundary( ref, point, closest ) ) )
+	if ( dtStatusFailed( bot->query->closestPointOnPolyBoundary( ref, point, closest ) ) )
 	{
 		return false;
 	}
@@ -126,7 +126,7 @@ bool BotFindNearestPoly( Bot_t *bot, rVec coord, dtPolyRef *nearestPoly, rVec &n
 	rVec start( coord );
 	rVec extents( 640, 96, 640 );
 	dtStatus status;
-	dtNavMeshQuery* navQuery = bot->nav->query;
+	dtNavMeshQuery* navQuery = bot->query;
 	dtQueryFilter* navFilter = &bot->nav->filter;
 
 	status = navQuery->findNearestPoly( start, extents, navFilter, nearestPoly, nearPoint );
@@ -160,13 +160,13 @@ static void InvalidateRouteResults( Bot_t *bot )
 			continue;
 		}
 
-		if ( !bot->nav->query->isValidPolyRef( res.startRef, &bot->nav->filter ) )
+		if ( !bot->query->isValidPolyRef( res.startRef, &bot->nav->filter ) )
 		{
 			res.invalid = true;
 			continue;
 		}
 
-		if ( !bot->nav->query->isValidPolyRef( res.endRef, &bot->nav->filter ) )
+		if ( !bot->query->isValidPolyRef( res.endRef, &bot->nav->filter ) )
 		{
 			res.invalid = true;
 			continue;
@@ -195,7 +195,7 @@ static dtRouteResult *FindRouteResult( Bot_t *bot, dtPolyRef start, dtPolyRef en
 			continue;
 		}
 
-		if ( res.endRef != start )
+		if ( res.endRef != end )
 		{
 			continue;
 		}
@@ -234,26 +234,74 @@ static void AddRouteResult( Bot_t *bot, dtPolyRef start, dtPolyRef end, dtStatus
 	bestPos->status = status;
 }
 
-bool FindRoute( Bot_t *bot, rVec s, botRouteTargetInternal rtarget, bool allowPartial )
+static bool FindRouteEnds( Bot_t *bot, rVec s, const botRouteTargetInternal &rtarget, dtPolyRef *startRef, rVec &start, dtPolyRef *endRef, rVec &end )
 {
-	rVec start;
-	rVec end;
-	dtPolyRef startRef, endRef = 1;
-	dtPolyRef pathPolys[ MAX_BOT_PATH ];
 	dtStatus status;
-	int pathNumPolys;
 
-	InvalidateRouteResults( bot );
+	if ( !BotFindNearestPoly( bot, s, startRef, start ) )
+	{
+		return false;
+	}
 
-	if ( !BotFindNearestPoly( bot, s, &startRef, start ) )
+	*endRef = 1;
+	status = bot->query->findNearestPoly( rtarget.pos, rtarget.polyExtents, 
+	                                      &bot->nav->filter, endRef, end ); 
+
+	if ( dtStatusFailed( status ) || !*endRef )
 	{
 		return false;
 	}
 
-	status = bot->nav->query->findNearestPoly( rtarget.pos, rtarget.polyExtents, 
-	                                           &bot->nav->filter, &endRef, end ); 
+	return true;
+}
 
-	if ( dtStatusFailed( status ) || !endRef )
+void SetRoute( Bot_t *bot, dtStatus status, dtPolyRef startRef, const float *start, const float *end, const dtPolyRef *path, int numPolys )
+{
+	if ( !path )
+	{
+		// keep the old corridor, but don't ask again right away
+		bot->routeRetryTime = svs.time + ROUTE_CACHE_TIME;
+		return;
+	}
+
+	bot->corridor.reset( startRef, start );
+	bot->corridor.setCorridor( end, path, numPolys );
+
+	bot->needReplan = false;
+	bot->offMesh = false;
+}
+
+/*
+====================
+Route queue
+
+Path searches are queued instead of being run when a bot asks for a route,
+so that a lot of bots retargeting at once can't cause a frame spike.  Every
+frame the queue spends at most bot_routeIterations Detour iterations on
+sliced searches, one route at a time, most urgent and then oldest first.
+Bots keep following their old corridor while their route is pending.  The
+queue is run once per server frame, after the game frame.
+====================
+*/
+
+static struct
+{
+	Bot_t     *bot;
+	dtPolyRef startRef;
+	dtPolyRef endRef;
+	rVec      start;
+	rVec      end;
+} routeSearch;
+
+bool RequestRoute( Bot_t *bot, rVec s, botRouteTargetInternal rtarget, bool allowPartial, int priority, BotRouteCallback callback )
+{
+	rVec start;
+	rVec end;
+	dtPolyRef startRef, endRef;
+
+	InvalidateRouteResults( bot );
+
+	if ( !FindRouteEnds( bot, s, rtarget, &startRef, start, &endRef, end ) )
 	{
 		return false;
 	}
@@ -273,25 +321,163 @@ bool FindRoute( Bot_t *bot, rVec s, botRouteTargetInternal rtarget, bool allowPa
 			return false;
 		}
 	}
-	
-	status = bot->nav->query->findPath( startRef, endRef, start, end, &bot->nav->filter, pathPolys, &pathNumPolys, MAX_BOT_PATH );
 
-	AddRouteResult( bot, startRef, endRef, status );
+	if ( bot->routePending )
+	{
+		bot->routeChanged = true;
+		bot->routePriority = std::max( bot->routePriority, priority );
+	}
+	else
+	{
+		bot->routePending = true;
+		bot->routePriority = priority;
+		bot->routeTime = svs.time;
+	}
+
+	bot->routeTarget = rtarget;
+	bot->routeAllowPartial = allowPartial;
+	bot->routeFailed = false;
+	bot->routeCallback = callback;
+	bot->needReplan = true;
+	return true;
+}
 
-	if ( dtStatusFailed( status ) )
+void CancelRoute( Bot_t *bot )
+{
+	bot->routePending = false;
+	bot->routeChanged = false;
+	bot->routeFailed = false;
+
+	if ( routeSearch.bot == bot )
 	{
-		return false;
+		routeSearch.bot = NULL;
 	}
+}
 
-	if ( dtStatusDetail( status, DT_PARTIAL_RESULT ) && !allowPartial )
+static Bot_t *NextRouteRequest( void )
+{
+	Bot_t *best = NULL;
+
+	for ( int i = 0; i < MAX_CLIENTS; i++ )
 	{
+		Bot_t *bot = &agents[ i ];
+
+		if ( !bot->routePending )
+		{
+			continue;
+		}
+
+		if ( !bot->nav )
+		{
+			CancelRoute( bot );
+			continue;
+		}
+
+		if ( !best || bot->routePriority > best->routePriority
+		     || ( bot->routePriority == best->routePriority && bot->routeTime < best->routeTime ) )
+		{
+			best = bot;
+		}
+	}
+
+	return best;
+}
+
+static void FinishRouteSearch( Bot_t *bot, dtStatus status, const dtPolyRef *path, int numPolys )
+{
+	AddRouteResult( bot, routeSearch.startRef, routeSearch.endRef, status );
+
+	if ( dtStatusFailed( status ) || ( dtStatusDetail( status, DT_PARTIAL_RESULT ) && !bot->routeAllowPartial ) )
+	{
+		path = NULL;
+		numPolys = 0;
+	}
+
+	routeSearch.bot = NULL;
+	bot->routePending = false;
+	bot->routeFailed = !path;
+	bot->routeCallback( bot, status, routeSearch.startRef, routeSearch.start, routeSearch.end, path, numPolys );
+}
+
+static bool StartRouteSearch( Bot_t *bot )
+{
+	rVec s = qVec( SV_GentityNum( bot->clientNum )->s.origin );
+
+	bot->routeChanged = false;
+	routeSearch.bot = bot;
+	routeSearch.startRef = routeSearch.endRef = 0;
+
+	// the bot has probably moved since the route was requested
+	InvalidateRouteResults( bot );
+
+	if ( !FindRouteEnds( bot, s, bot->routeTarget, &routeSearch.startRef, routeSearch.start, &routeSearch.endRef, routeSearch.end ) )
+	{
+		FinishRouteSearch( bot, DT_FAILURE, NULL, 0 );
 		return false;
 	}
 
-	bot->corridor.reset( startRef, start );
-	bot->corridor.setCorridor( end, pathPolys, pathNumPolys );
+	dtStatus status = bot->nav->planner->initSlicedFindPath( routeSearch.startRef, routeSearch.endRef,
+	                                                         routeSearch.start, routeSearch.end, &bot->nav->filter );
+
+	if ( dtStatusFailed( status ) )
+	{
+		FinishRouteSearch( bot, status, NULL, 0 );
+		return false;
+	}
 
-	bot->needReplan = false;
-	bot->offMesh = false;
 	return true;
 }
+
+void BotUpdateRouteQueue( void )
+{
+	static cvar_t *routeIterations = Cvar_Get( "bot_routeIterations", "1024", 0 );
+	dtPolyRef pathPolys[ MAX_BOT_PATH ];
+	int pathNumPolys;
+	int budget = std::max( routeIterations->integer, 1 );
+
+	while ( budget > 0 )
+	{
+		if ( routeSearch.bot && routeSearch.bot->routeChanged )
+		{
+			routeSearch.bot = NULL; // start over with the new target
+		}
+
+		if ( !routeSearch.bot )
+		{
+			Bot_t *bot = NextRouteRequest();
+
+			if ( !bot )
+			{
+				break;
+			}
+
+			if ( !StartRouteSearch( bot ) )
+			{
+				continue;
+			}
+		}
+
+		Bot_t *bot = routeSearch.bot;
+		int iterations = 0;
+		dtStatus status = bot->nav->planner->updateSlicedFindPath( budget, &iterations );
+
+		budget -= std::max( iterations, 1 );
+
+		if ( dtStatusInProgress( status ) )
+		{
+			continue;
+		}
+
+		if ( dtStatusSucceed( status ) )
+		{
+			status = bot->nav->planner->finalizeSlicedFindPath( pathPolys, &pathNumPolys, MAX_BOT_PATH );
+		}
+
+		if ( dtStatusFailed( status ) )
+		{
+			pathNumPolys = 0;
+		}
+
+		FinishRouteSearch( bot, status, pathPolys, pathNumPolys );
+	}
+}
@@ -40,6 +40,7 @@ Maryland 20850 USA.
 
 #include "../../libs/detour/DetourNavMeshBuilder.h"
 #include "../../libs/detour/DetourNavMeshQuery.h"
+#include "../../libs/detour/DetourNode.h"
 #include "../../libs/detour/DetourPathCorridor.h"
 #include "../../libs/detour/DetourCommon.h"
 #include "../../libs/detour/DetourTileCache.h"
@@ -58,6 +59,10 @@ const int MAX_ROUTE_PLANS = 2;
 const int MAX_ROUTE_CACHE = 20;
 const int ROUTE_CACHE_TIME = 200;
 
+// routes to a new goal are searched before replans of an existing one
+const int ROUTE_PRIORITY_REPLAN = 0;
+const int ROUTE_PRIORITY_GOAL = 1;
+
 typedef struct
 {
 	dtPolyRef startRef;
@@ -72,14 +77,22 @@ typedef struct
 	dtTileCache      *cache;
 	dtNavMesh        *mesh;
 	dtNavMeshQuery   *query;
+	dtNavMeshQuery   *planner; // only used for the sliced searches of the route queue
 	dtQueryFilter    filter;
 	MeshProcess      process;
 	char             name[ 64 ];
 } NavData_t;
 
-typedef struct
+struct Bot_s;
+
+// called once a queued route has been searched, path is NULL if the search failed
+typedef void ( *BotRouteCallback )( struct Bot_s *bot, dtStatus status, dtPolyRef startRef, const float *start,
+                                    const float *end, const dtPolyRef *path, int numPolys );
+
+typedef struct Bot_s
 {
 	NavData_t         *nav;
+	dtNavMeshQuery    *query; // owned by the bot so that bots can be updated in parallel
 	dtPathCorridor    corridor;
 	int               clientNum;
 	bool              needReplan;
@@ -92,6 +105,17 @@ typedef struct
 	rVec              offMeshEnd;
 	dtPolyRef         offMeshPoly;
 	dtRouteResult     routeResults[ MAX_ROUTE_CACHE ];
+
+	// queued route request, the corridor is kept until it has been searched
+	bool              routePending;
+	bool              routeChanged; // updated while being searched
+	bool              routeAllowPartial;
+	bool              routeFailed; // the last search found no path
+	int               routePriority;
+	int               routeTime;
+	int               routeRetryTime;
+	botRouteTargetInternal routeTarget;
+	BotRouteCallback  routeCallback;
 } Bot_t;
 
 extern int numNavData;
@@ -101,11 +125,14 @@ extern Bot_t agents[ MAX_CLIENTS ];
 void NavEditInit( void );
 void NavEditShutdown( void );
 void BotSaveOffMeshConnections( NavData_t *nav );
+void BotShutdownNavWorkers( void );
 
 void         BotCalcSteerDir( Bot_t *bot, rVec &dir );
 void         FindWaypoints( Bot_t *bot, float *corners, unsigned char *cornerFlags, dtPolyRef *cornerPolys, int *numCorners, int maxCorners );
 bool         PointInPolyExtents( Bot_t *bot, dtPolyRef ref, rVec point, rVec extents );
 bool         PointInPoly( Bot_t *bot, dtPolyRef ref, rVec point );
 bool         BotFindNearestPoly( Bot_t *bot, rVec coord, dtPolyRef *nearestPoly, rVec &nearPoint );
-bool         FindRoute( Bot_t *bot, rVec s, botRouteTargetInternal target, bool allowPartial );
+void         SetRoute( Bot_t *bot, dtStatus status, dtPolyRef startRef, const float *start, const float *end, const dtPolyRef *path, int numPolys );
+bool         RequestRoute( Bot_t *bot, rVec s, botRouteTargetInternal target, bool allowPartial, int priority, BotRouteCallback callback );
+void         CancelRoute( Bot_t *bot );
 #endif
@@ -34,6 +34,7 @@ Maryland 20850 USA.
 
 #include "bot_local.h"
 #include "../server/server.h"
+#include "../framework/WorkerPool.h"
 
 Bot_t agents[ MAX_CLIENTS ];
 
@@ -122,6 +123,24 @@ void BotSetNavMesh( int botClientNum, qhandle_t nav )
 
 	Bot_t *bot = &agents[ botClientNum ];
 
+	if ( !bot->query )
+	{
+		bot->query = dtAllocNavMeshQuery();
+
+		if ( !bot->query )
+		{
+			Com_Printf( "^3ERROR: Could not allocate Detour Navigation Mesh Query for bot %d\n", botClientNum );
+			return;
+		}
+	}
+
+	if ( dtStatusFailed( bot->query->init( BotNavData[ nav ].mesh, BotNavData[ nav ].query->getNodePool()->getMaxNodes() ) ) )
+	{
+		Com_Printf( "^3ERROR: Could not init Detour Navigation Mesh Query for bot %d\n", botClientNum );
+		return;
+	}
+
+	CancelRoute( bot );
 	bot->nav = &BotNavData[ nav ];
 	bot->needReplan = true;
 }
@@ -142,7 +161,7 @@ qboolean BotFindRouteExt( int botClientNum, const botRouteTarget_t *target, qboo
 	Bot_t *bot = &agents[ botClientNum ];
 
 	GetEntPosition( botClientNum, start );
-	bool result = FindRoute( bot, start, *target, allowPartial );
+	bool result = RequestRoute( bot, start, *target, allowPartial, ROUTE_PRIORITY_GOAL, SetRoute );
 	return static_cast<qboolean>( result );
 }
 
@@ -176,16 +195,17 @@ static bool overOffMeshConnectionStart( const Bot_t *bot, rVec pos )
 
 void UpdatePathCorridor( Bot_t *bot, rVec spos, botRouteTargetInternal target )
 {
-	bot->corridor.movePosition( spos, bot->nav->query, &bot->nav->filter );
+	bot->corridor.movePosition( spos, bot->query, &bot->nav->filter );
 
-	if ( target.type == BOT_TARGET_DYNAMIC )
+	// a pending route replaces the corridor anyway, so keep following the old one
+	if ( target.type == BOT_TARGET_DYNAMIC && !bot->routePending )
 	{
-		bot->corridor.moveTargetPosition( target.pos, bot->nav->query, &bot->nav->filter );
+		bot->corridor.moveTargetPosition( target.pos, bot->query, &bot->nav->filter );
 	}
 
-	if ( !bot->corridor.isValid( MAX_PATH_LOOKAHEAD, bot->nav->query, &bot->nav->filter ) )
+	if ( !bot->corridor.isValid( MAX_PATH_LOOKAHEAD, bot->query, &bot->nav->filter ) )
 	{
-		bot->corridor.trimInvalidPath( bot->corridor.getFirstPoly(), spos, bot->nav->query, &bot->nav->filter );
+		bot->corridor.trimInvalidPath( bot->corridor.getFirstPoly(), spos, bot->query, &bot->nav->filter );
 		bot->needReplan = qtrue;
 	}
 
@@ -213,15 +233,15 @@ void BotUpdateCorridor( int botClientNum, const botRouteTarget_t *target, botNav
 
 	if ( !bot->offMesh )
 	{
-		if ( bot->needReplan )
+		if ( bot->needReplan && !bot->routePending && svs.time >= bot->routeRetryTime )
 		{
-			if ( FindRoute( bot, spos, rtarget, false ) )
+			if ( !RequestRoute( bot, spos, rtarget, false, ROUTE_PRIORITY_REPLAN, SetRoute ) )
 			{
-				bot->needReplan = false;
+				bot->routeRetryTime = svs.time + ROUTE_CACHE_TIME;
 			}
 		}
 
-		cmd->havePath = !bot->needReplan;
+		cmd->havePath = !bot->needReplan || ( bot->routePending && bot->corridor.getFirstPoly() );
 
 		if ( overOffMeshConnectionStart( bot, spos ) )
 		{
@@ -231,7 +251,7 @@ void BotUpdateCorridor( int botClientNum, const botRouteTarget_t *target, botNav
 			int corner = bot->numCorners - 1;
 			dtPolyRef con = bot->cornerPolys[ corner ];
 
-			if ( bot->corridor.moveOverOffmeshConnection( con, refs, start, end, bot->nav->query ) )
+			if ( bot->corridor.moveOverOffmeshConnection( con, refs, start, end, bot->query ) )
 			{
 				bot->offMesh = true;
 				bot->offMeshPoly = con;
@@ -279,7 +299,7 @@ void BotUpdateCorridor( int botClientNum, const botRouteTarget_t *target, botNav
 			VectorCopy( bot->corridor.getTarget(), cmd->tpos );
 
 			float height;
-			if ( dtStatusSucceed( bot->nav->query->getPolyHeight( bot->corridor.getLastPoly(), cmd->tpos, &height ) ) )
+			if ( dtStatusSucceed( bot->query->getPolyHeight( bot->corridor.getLastPoly(), cmd->tpos, &height ) ) )
 			{
 				cmd->tpos[ 1 ] = height;
 			}
@@ -308,7 +328,7 @@ void BotUpdateCorridor( int botClientNum, const botRouteTarget_t *target, botNav
 
 		VectorCopy( bot->corridor.getTarget(), cmd->tpos );
 		float height;
-		if ( dtStatusSucceed( bot->nav->query->getPolyHeight( bot->corridor.getLastPoly(), cmd->tpos, &height ) ) )
+		if ( dtStatusSucceed( bot->query->getPolyHeight( bot->corridor.getLastPoly(), cmd->tpos, &height ) ) )
 		{
 			cmd->tpos[ 1 ] = height;
 		}
@@ -321,6 +341,54 @@ void BotUpdateCorridor( int botClientNum, const botRouteTarget_t *target, botNav
 			bot->offMesh = false;
 		}
 	}
+
+	cmd->routePending = bot->routePending;
+	cmd->routeFailed = bot->routeFailed;
+}
+
+/*
+====================
+Parallel corridor updates
+
+Every bot owns its path corridor, route cache and navmesh query, and only
+reads the navmesh and the entity positions while its corridor is updated,
+so the updates of a whole frame can be spread over a few worker threads.
+Nothing else touches the navmesh while a batch is running since the server
+is blocked in the syscall.
+====================
+*/
+
+static Parallel::WorkerPool navWorkers;
+
+void BotShutdownNavWorkers( void )
+{
+	navWorkers.Shutdown();
+}
+
+void BotUpdateCorridors( int numBots, const int *botClientNums, const botRouteTarget_t *targets, botNavCmd_t *cmds )
+{
+	bool seen[ MAX_CLIENTS ] = {};
+
+	// each bot may only be updated by one thread
+	for ( int i = 0; i < numBots; i++ )
+	{
+		int clientNum = botClientNums[ i ];
+
+		if ( clientNum < 0 || clientNum >= MAX_CLIENTS || seen[ clientNum ] || !agents[ clientNum ].nav )
+		{
+			Com_Printf( "^3ERROR: BotUpdateCorridors: bad bot %d\n", clientNum );
+			memset( cmds, 0, numBots * sizeof( *cmds ) );
+			return;
+		}
+
+		seen[ clientNum ] = true;
+	}
+
+	navWorkers.SetNumThreads( Cvar_Get( "bot_navThreads", "0", CVAR_LATCH )->integer );
+	navWorkers.ParallelFor( numBots, [ & ]( int i )
+	{
+		BotUpdateCorridor( botClientNums[ i ], &targets[ i ], &cmds[ i ] );
+	} );
 }
 
 float frand()
@@ -354,7 +422,7 @@ qboolean BotFindRandomPointInRadius( int botClientNum, const vec3_t origin, vec3
 	}
 
 	dtPolyRef randRef;
-	dtStatus status = bot->nav->query->findRandomPointAroundCircle( nearPoly, rorigin, radius, &bot->nav->filter, frand, &randRef, nearPoint );
+	dtStatus status = bot->query->findRandomPointAroundCircle( nearPoly, rorigin, radius, &bot->nav->filter, frand, &randRef, nearPoint );
 	
 	if ( dtStatusFailed( status ) )
 	{
@@ -378,19 +446,19 @@ qboolean BotNavTrace( int botClientNum, botTrace_t *trace, const vec3_t start, c
 
 	Bot_t *bot = &agents[ botClientNum ];
 
-	status = bot->nav->query->findNearestPoly( spos, extents, &bot->nav->filter, &startRef, NULL );
+	status = bot->query->findNearestPoly( spos, extents, &bot->nav->filter, &startRef, NULL );
 	if ( dtStatusFailed( status ) || startRef == 0 )
 	{
 		//try larger extents
 		extents[ 1 ] += 500;
-		status = bot->nav->query->findNearestPoly( spos, extents, &bot->nav->filter, &startRef, NULL );
+		status = bot->query->findNearestPoly( spos, extents, &bot->nav->filter, &startRef, NULL );
 		if ( dtStatusFailed( status ) || startRef == 0 )
 		{
 			return qfalse;
 		}
 	}
 
-	status = bot->nav->query->raycast( startRef, spos, epos, &bot->nav->filter, &trace->frac, trace->normal, NULL, NULL, 0 );
+	status = bot->query->raycast( startRef, spos, epos, &bot->nav->filter, &trace->frac, trace->normal, NULL, NULL, 0 );
 	if ( dtStatusFailed( status ) )
 	{
 		return qfalse;
@@ -57,6 +57,8 @@ typedef struct
 	float    dir[ 3 ];
 	int      directPathToGoal;
 	int      havePath;
+	int      routePending; // a route search to the goal hasn't finished yet
+	int      routeFailed; // the last route search to the goal found no path
 } botNavCmd_t;
 
 typedef enum
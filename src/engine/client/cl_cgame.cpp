@@ -561,8 +561,8 @@ void CL_CM_LoadMap( const char *mapname )
 	}
 
 
-	void* buffer;
-	FS_ReadFile( mapname, ( void ** ) &buffer );
+	const void* buffer;
+	FS_MapFile( mapname, &buffer );
 
 	if ( !buffer )
 	{
@@ -571,7 +571,7 @@ void CL_CM_LoadMap( const char *mapname )
 
 	CM_LoadMap( mapname, buffer, qtrue );
 
-	FS_FreeFile( buffer );
+	FS_UnmapFile( buffer );
 }
 
 /*
@@ -121,6 +121,7 @@ cvar_t *j_up_axis;
 cvar_t *cl_activeAction;
 
 cvar_t *cl_autorecord;
+cvar_t *cl_measureQuantization;
 
 cvar_t *cl_motdString;
 
@@ -3970,6 +3971,8 @@ qboolean CL_InitRef( )
 
 	ri.FS_ReadFile = FS_ReadFile;
 	ri.FS_FreeFile = FS_FreeFile;
+	ri.FS_MapFile = FS_MapFile;
+	ri.FS_UnmapFile = FS_UnmapFile;
 	ri.FS_WriteFile = FS_WriteFile;
 	ri.FS_FreeFileList = FS_FreeFileList;
 	ri.FS_ListFiles = FS_ListFiles;
@@ -4080,6 +4083,7 @@ void CL_Init( void )
 	rcon_client_password = Cvar_Get( "rconPassword", "", CVAR_TEMP );
 	cl_activeAction = Cvar_Get( "activeAction", "", CVAR_TEMP );
 	cl_autorecord = Cvar_Get( "cl_autorecord", "0", CVAR_TEMP );
+	cl_measureQuantization = Cvar_Get( "cl_measureQuantization", "0", CVAR_TEMP );
 
 	cl_timedemo = Cvar_Get( "timedemo", "0", 0 );
 	cl_forceavidemo = Cvar_Get( "cl_forceavidemo", "0", 0 );
@@ -4175,6 +4179,7 @@ void CL_Init( void )
 	Cvar_Get( "name", UNNAMED_PLAYER, CVAR_USERINFO | CVAR_ARCHIVE );
 	cl_rate = Cvar_Get( "rate", "25000", CVAR_USERINFO | CVAR_ARCHIVE );
 	Cvar_Get( "snaps", "40", CVAR_USERINFO  );
+	Cvar_Get( "cl_quantizeEntities", "0", CVAR_USERINFO | CVAR_ARCHIVE );
 //  Cvar_Get ("sex", "male", CVAR_USERINFO  );
 
 	Cvar_Get( "password", "", CVAR_USERINFO );
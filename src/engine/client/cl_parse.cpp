@@ -91,6 +91,11 @@ void CL_DeltaEntity( msg_t *msg, clSnapshot_t *frame, int newnum, entityState_t
 	else
 	{
 		MSG_ReadDeltaEntity( msg, old, state, newnum );
+
+		if ( cl_measureQuantization->integer && state->number != MAX_GENTITIES - 1 )
+		{
+			MSG_MeasureQuantization( old, state );
+		}
 	}
 
 	if ( state->number == ( MAX_GENTITIES - 1 ) )
@@ -411,7 +416,9 @@ void CL_ParseSnapshot( msg_t *msg )
 
 	// read packet entities
 	SHOWNET( msg, "packet entities" );
+	msg->quantized = ( newSnap.snapFlags & SNAPFLAG_QUANTIZED ) ? qtrue : qfalse;
 	CL_ParsePacketEntities( msg, old, &newSnap );
+	msg->quantized = qfalse;
 
 	// if not valid, dump the entire thing now that it has
 	// been properly read
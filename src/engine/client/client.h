@@ -489,6 +489,7 @@ extern cvar_t *cl_timedemo;
 
 extern cvar_t *cl_activeAction;
 extern cvar_t *cl_autorecord;
+extern cvar_t *cl_measureQuantization;
 
 extern cvar_t *cl_allowDownload;
 extern cvar_t *cl_conXOffset;
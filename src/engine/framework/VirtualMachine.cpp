@@ -411,6 +411,11 @@ int VMBase::Create()
 	// If this fails, we assume the remote process failed to start
 	IPC::Reader reader = rootChannel.RecvMsg();
 	Com_Printf("Loaded VM module in %d msec\n", Sys_Milliseconds() - loadStartTime);
+
+	// Switch to the shared memory transport once we know the module is alive
+	if (params.sharedRing.Get())
+		rootChannel.EnableRing();
+
 	return reader.Read<uint32_t>();
 }
 
@@ -485,4 +490,89 @@ void VMBase::Free()
 
 }
 
+// Messages used to measure the round trip time of each transport
+typedef IPC::SyncMessage<IPC::Message<IPC::Id<LAST_COMMON_SYSCALL, 0>, int, IPC::StringView>, IPC::Reply<int>> BenchmarkEchoMsg;
+typedef IPC::Message<IPC::Id<LAST_COMMON_SYSCALL, 1>> BenchmarkQuitMsg;
+
+struct BenchmarkResult {
+	double usecPerCall;
+	size_t allocations;
+};
+
+// Time synchronous round trips to an echo thread, and count the buffer
+// allocations made by both ends once they are warmed up
+static BenchmarkResult BenchmarkTransport(bool sharedRing, int count)
+{
+	const int warmup = 100;
+	std::pair<IPC::Socket, IPC::Socket> pair = IPC::Socket::CreatePair();
+	IPC::Channel channel(std::move(pair.first));
+	IPC::Socket peerSocket = std::move(pair.second);
+	size_t peerAllocations = 0;
+
+	std::thread peer([&peerSocket, &peerAllocations]() {
+		IPC::Channel peerChannel(std::move(peerSocket));
+		size_t base = 0;
+		while (true) {
+			IPC::Reader reader = peerChannel.RecvMsg();
+			if (reader.Read<uint32_t>() != BenchmarkEchoMsg::id)
+				break;
+			IPC::HandleMsg<BenchmarkEchoMsg>(peerChannel, std::move(reader), [&](int in, IPC::StringView, int& out) {
+				if (in == warmup)
+					base = peerChannel.GetAllocationCount();
+				out = in;
+			});
+		}
+		peerAllocations = peerChannel.GetAllocationCount() - base;
+	});
+
+	if (sharedRing)
+		channel.EnableRing();
+
+	auto noHandler = [](uint32_t, IPC::Reader) {};
+	std::chrono::high_resolution_clock::time_point start;
+	size_t base = 0;
+	for (int i = 0; i < warmup + count; i++) {
+		if (i == warmup) {
+			base = channel.GetAllocationCount();
+			start = std::chrono::high_resolution_clock::now();
+		}
+		int out;
+		IPC::SendMsg<BenchmarkEchoMsg>(channel, noHandler, i, "usercmd", out);
+		if (out != i)
+			Com_Error(ERR_DROP, "IPC benchmark: got %d back instead of %d", out, i);
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	size_t allocations = channel.GetAllocationCount() - base;
+
+	IPC::SendMsg<BenchmarkQuitMsg>(channel, noHandler);
+	peer.join();
+
+	return {std::chrono::duration<double, std::micro>(end - start).count() / count, allocations + peerAllocations};
+}
+
+class IPCBenchmarkCmd: public Cmd::StaticCmd {
+public:
+	IPCBenchmarkCmd()
+		: Cmd::StaticCmd("ipcBenchmark", Cmd::SYSTEM, N_("measures the syscall round trip time of the socket and shared memory transports")) {}
+
+	void Run(const Cmd::Args& args) const OVERRIDE
+	{
+		int count = 100000;
+		if (args.Argc() > 2) {
+			PrintUsage(args, _("[count]"), "");
+			return;
+		}
+		if (args.Argc() == 2 && (!Str::ParseInt(count, args.Argv(1)) || count <= 0)) {
+			PrintUsage(args, _("[count]"), "");
+			return;
+		}
+
+		BenchmarkResult socket = BenchmarkTransport(false, count);
+		BenchmarkResult ring = BenchmarkTransport(true, count);
+		Print("socket:        %.2f usec per round trip, %d buffer allocations", socket.usecPerCall, (int)socket.allocations);
+		Print("shared memory: %.2f usec per round trip, %d buffer allocations", ring.usecPerCall, (int)ring.allocations);
+	}
+};
+static IPCBenchmarkCmd IPCBenchmarkCmdRegistration;
+
 } // namespace VM
@@ -0,0 +1,151 @@
+/*
+===========================================================================
+Daemon BSD Source Code
+Copyright (c) 2014, Daemon Developers
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Daemon developers nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL DAEMON DEVELOPERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+===========================================================================
+*/
+
+#include "WorkerPool.h"
+
+namespace Parallel {
+
+    // More threads mostly fight over memory bandwidth for the kind of work done here
+    static const int MAX_AUTO_THREADS = 8;
+
+    WorkerPool::WorkerPool()
+        : requestedThreads(0), started(false), quit(false), generation(0), busy(0), job(nullptr), jobCount(0), nextJob(0) {
+    }
+
+    WorkerPool::~WorkerPool() {
+        Shutdown();
+    }
+
+    void WorkerPool::SetNumThreads(int numThreads) {
+        if (numThreads != requestedThreads) {
+            Shutdown();
+            requestedThreads = numThreads;
+        }
+    }
+
+    int WorkerPool::GetNumThreads() const {
+        return started ? threads.size() + 1 : 0;
+    }
+
+    void WorkerPool::ParallelFor(int count, const std::function<void(int)>& job) {
+        if (!started) {
+            Start();
+        }
+
+        if (threads.empty() || count < 2) {
+            for (int i = 0; i < count; i++) {
+                job(i);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            this->job = &job;
+            jobCount = count;
+            nextJob = 0;
+            busy = threads.size();
+            generation++;
+        }
+
+        wake.notify_all();
+        RunJobs();
+
+        // workers may still be finishing their last job or not have woken up at all yet
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return busy == 0; });
+        this->job = nullptr;
+    }
+
+    void WorkerPool::Shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+
+        wake.notify_all();
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        threads.clear();
+        started = false;
+        quit = false;
+    }
+
+    void WorkerPool::Start() {
+        int count = requestedThreads;
+
+        if (count <= 0) {
+            count = std::min<int>(std::thread::hardware_concurrency(), MAX_AUTO_THREADS);
+        }
+
+        // the calling thread takes part as well
+        for (int i = 1; i < count; i++) {
+            int current = generation;
+            threads.emplace_back([this, current] { WorkerMain(current); });
+        }
+
+        started = true;
+    }
+
+    void WorkerPool::WorkerMain(int seen) {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this, seen] { return quit || generation != seen; });
+
+                if (quit) {
+                    return;
+                }
+
+                seen = generation;
+            }
+
+            RunJobs();
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (--busy == 0) {
+                done.notify_one();
+            }
+        }
+    }
+
+    void WorkerPool::RunJobs() {
+        int i;
+
+        while ((i = nextJob++) < jobCount) {
+            (*job)(i);
+        }
+    }
+
+}
@@ -0,0 +1,85 @@
+/*
+===========================================================================
+Daemon BSD Source Code
+Copyright (c) 2014, Daemon Developers
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Daemon developers nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL DAEMON DEVELOPERS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+===========================================================================
+*/
+
+#ifndef FRAMEWORK_WORKER_POOL_H_
+#define FRAMEWORK_WORKER_POOL_H_
+
+#include "../../common/Common.h"
+
+/*
+ * A small pool of threads for splitting frame work into independent jobs.
+ *
+ * ParallelFor runs a job for every index of a range on the workers and the
+ * calling thread and only returns once all of them are done, so the caller
+ * can hand out pointers to its own data. Jobs must not touch state shared
+ * with other jobs nor call into code that isn't thread safe (the VMs, the
+ * filesystem, the console).
+ */
+
+namespace Parallel {
+
+    class WorkerPool {
+    public:
+        WorkerPool();
+        ~WorkerPool();
+
+        // Number of threads taking part in ParallelFor, including the caller.
+        // 0 means one per core. Takes effect on the next ParallelFor.
+        void SetNumThreads(int numThreads);
+        int GetNumThreads() const;
+
+        void ParallelFor(int count, const std::function<void(int)>& job);
+
+        // Stops the workers, they are started again when needed
+        void Shutdown();
+
+    private:
+        void Start();
+        void WorkerMain(int seen);
+        void RunJobs();
+
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        int requestedThreads;
+        bool started;
+        bool quit;
+        int generation;
+        size_t busy;
+
+        const std::function<void(int)>* job;
+        int jobCount;
+        std::atomic<int> nextJob;
+    };
+
+}
+
+#endif // FRAMEWORK_WORKER_POOL_H_
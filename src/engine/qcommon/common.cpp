@@ -2387,11 +2387,11 @@ void Com_Frame( void (*GetInput)( void ), void (*DoneInput)( void ) )
 	//
 	if ( showTraceStats.Get() )
 	{
-		extern int c_traces, c_brush_traces, c_patch_traces, c_trisoup_traces;
-		extern int c_pointcontents;
+		extern std::atomic<int> c_traces, c_brush_traces, c_patch_traces, c_trisoup_traces;
+		extern std::atomic<int> c_pointcontents;
 
-		Com_Printf( "%4i traces  (%ib %ip %it) %4i points\n", c_traces, c_brush_traces, c_patch_traces, c_trisoup_traces,
-		            c_pointcontents );
+		Com_Printf( "%4i traces  (%ib %ip %it) %4i points\n", c_traces.load(), c_brush_traces.load(), c_patch_traces.load(),
+		            c_trisoup_traces.load(), c_pointcontents.load() );
 		c_traces = 0;
 		c_brush_traces = 0;
 		c_patch_traces = 0;
@@ -51,6 +51,9 @@ struct handleData_t {
 
 #define MAX_FILE_HANDLES 64
 static handleData_t handleTable[MAX_FILE_HANDLES];
+
+// Files returned by FS_MapFile, indexed by the pointer given to the caller
+static std::unordered_multimap<const void*, FS::FileView> mappedFiles;
 static std::vector<std::tuple<std::string, std::string, uint32_t>> fs_missingPaks;
 
 static Cvar::Cvar<bool> allowRemotePakDir("client.allowRemotePakDir", "Connect to servers that load game data from directories", Cvar::TEMPORARY, false);
@@ -405,6 +408,24 @@ void FS_WriteFile(const char* path, const void* buffer, int size)
 
 int FS_ReadFile(const char* path, void** buffer)
 {
+	// Copy files in paks straight out of the pak instead of through a handle
+	if (buffer && FS::PakPath::FileExists(path)) {
+		FS::FileView view;
+		try {
+			view = FS::PakPath::ViewFile(path);
+		} catch (std::system_error& err) {
+			Com_DPrintf("Failed to open '%s' for reading: %s\n", path, err.what());
+			*buffer = nullptr;
+			return -1;
+		}
+
+		char* buf = new char[view.size() + 1];
+		*buffer = buf;
+		memcpy(buf, view.data(), view.size());
+		buf[view.size()] = '\0';
+		return view.size();
+	}
+
 	fileHandle_t handle;
 	int length = FS_FOpenFileRead(path, &handle, qtrue);
 
@@ -431,6 +452,39 @@ void FS_FreeFile(void* buffer)
 	delete[] buf;
 }
 
+int FS_MapFile(const char* path, const void** buffer)
+{
+	FS::FileView view;
+	try {
+		if (FS::PakPath::FileExists(path))
+			view = FS::PakPath::ViewFile(path);
+		else {
+			auto contents = std::make_shared<std::string>(FS::HomePath::OpenRead(path).ReadAll());
+			view = FS::FileView(contents, contents->data(), contents->size());
+		}
+	} catch (std::system_error& err) {
+		Com_DPrintf("Failed to open '%s' for reading: %s\n", path, err.what());
+		*buffer = nullptr;
+		return -1;
+	}
+
+	int length = view.size();
+	*buffer = view.data();
+	mappedFiles.insert(std::make_pair(view.data(), std::move(view)));
+	return length;
+}
+
+void FS_UnmapFile(const void* buffer)
+{
+	if (!buffer)
+		return;
+
+	auto it = mappedFiles.find(buffer);
+	if (it == mappedFiles.end())
+		Com_Error(ERR_DROP, "FS_UnmapFile: buffer was not returned by FS_MapFile");
+	mappedFiles.erase(it);
+}
+
 char** FS_ListFiles(const char* directory, const char* extension, int* numFiles)
 {
 	std::vector<char*> files;
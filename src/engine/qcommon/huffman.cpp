@@ -43,13 +43,13 @@ static int bloc = 0;
 
 //bani - optimized version
 //clears data along the way so we don't have to memset() it ahead of time
+//the write path only touches *offset, so messages may be encoded concurrently
 void Huff_putBit( int bit, byte *fout, int *offset )
 {
 	int x, y;
 
-	bloc = *offset;
-	x = bloc >> 3;
-	y = bloc & 7;
+	x = *offset >> 3;
+	y = ( *offset )++ & 7;
 
 	if ( !y )
 	{
@@ -57,8 +57,6 @@ void Huff_putBit( int bit, byte *fout, int *offset )
 	}
 
 	fout[ x ] |= bit << y;
-	bloc++;
-	*offset = bloc;
 }
 
 int     Huff_getBloc( void )
@@ -86,12 +84,12 @@ int Huff_getBit( byte *fin, int *offset )
 
 //bani - optimized version
 //clears data along the way so we don't have to memset() it ahead of time
-static void add_bit( char bit, byte *fout )
+static void add_bit( char bit, byte *fout, int *offset )
 {
 	int x, y;
 
-	y = bloc >> 3;
-	x = bloc++ & 7;
+	y = *offset >> 3;
+	x = ( *offset )++ & 7;
 
 	if ( !x )
 	{
@@ -435,22 +433,22 @@ void Huff_offsetReceive( node_t *node, int *ch, byte *fin, int *offset )
 }
 
 /* Send the prefix code for this node */
-static void send( node_t *node, node_t *child, byte *fout )
+static void send( node_t *node, node_t *child, byte *fout, int *offset )
 {
 	if ( node->parent )
 	{
-		send( node->parent, node, fout );
+		send( node->parent, node, fout, offset );
 	}
 
 	if ( child )
 	{
 		if ( node->right == child )
 		{
-			add_bit( 1, fout );
+			add_bit( 1, fout, offset );
 		}
 		else
 		{
-			add_bit( 0, fout );
+			add_bit( 0, fout, offset );
 		}
 	}
 }
@@ -467,20 +465,157 @@ void Huff_transmit( huff_t *huff, int ch, byte *fout )
 
 		for ( i = 7; i >= 0; i-- )
 		{
-			add_bit( ( char )( ( ch >> i ) & 0x1 ), fout );
+			add_bit( ( char )( ( ch >> i ) & 0x1 ), fout, &bloc );
 		}
 	}
 	else
 	{
-		send( huff->loc[ ch ], NULL, fout );
+		send( huff->loc[ ch ], NULL, fout, &bloc );
 	}
 }
 
 void Huff_offsetTransmit( huff_t *huff, int ch, byte *fout, int *offset )
 {
-	bloc = *offset;
-	send( huff->loc[ ch ], NULL, fout );
-	*offset = bloc;
+	send( huff->loc[ ch ], NULL, fout, offset );
+}
+
+//writes up to 56 bits at once, same semantics as Huff_putBit
+void Huff_putBits( uint64_t value, int bits, byte *fout, int *offset )
+{
+	int x, y, n;
+
+	x = *offset >> 3;
+	y = *offset & 7;
+
+	value <<= y;
+
+	if ( y )
+	{
+		value |= fout[ x ];
+	}
+
+	for ( n = y + bits; n > 0; n -= 8 )
+	{
+		fout[ x++ ] = ( byte ) value;
+		value >>= 8;
+	}
+
+	*offset += bits;
+}
+
+//reads up to 32 bits at once, touching the same bytes as Huff_getBit
+uint32_t Huff_getBits( const byte *fin, int *offset, int bits )
+{
+	int      x, y, n;
+	uint64_t value = 0;
+
+	x = *offset >> 3;
+	y = *offset & 7;
+
+	for ( n = 0; n < y + bits; n += 8 )
+	{
+		value |= ( uint64_t ) fin[ x++ ] << n;
+	}
+
+	*offset += bits;
+
+	return ( uint32_t )( ( value >> y ) & ( ( ( uint64_t ) 1 << bits ) - 1 ) );
+}
+
+/*
+Compiles the codes of a tree into tables, so a symbol can be sent as one
+group of bits and most can be received with a single lookup. The tree must
+not be updated afterwards; the codes are the tree's own, so the bits on the
+wire are the same as with Huff_offsetTransmit.
+*/
+void Huff_BuildCodes( const huff_t *huff, huffCodes_t *codes )
+{
+	const node_t *node, *child;
+	int          ch, i, n;
+
+	Com_Memset( codes, 0, sizeof( *codes ) );
+
+	for ( ch = 0; ch < HMAX; ch++ )
+	{
+		uint32_t code = 0;
+		int      length = 0;
+
+		if ( !huff->loc[ ch ] )
+		{
+			continue;
+		}
+
+		// walk up to the root, which sends the first bit
+		for ( child = huff->loc[ ch ], node = child->parent; node; child = node, node = node->parent )
+		{
+			if ( length == 32 )
+			{
+				break;
+			}
+
+			code = ( code << 1 ) | ( node->right == child );
+			length++;
+		}
+
+		if ( !node )
+		{
+			codes->code[ ch ] = code;
+			codes->length[ ch ] = length;
+		}
+	}
+
+	for ( i = 0; i < ( 1 << HUFF_LOOKUP_BITS ); i++ )
+	{
+		node = huff->tree;
+
+		for ( n = 0; node && node->symbol == INTERNAL_NODE && n < HUFF_LOOKUP_BITS; n++ )
+		{
+			node = ( ( i >> n ) & 1 ) ? node->right : node->left;
+		}
+
+		if ( node && node->symbol < HMAX && n > 0 )
+		{
+			codes->decode[ i ] = node->symbol | ( n << 8 );
+		}
+	}
+}
+
+void Huff_tableTransmit( const huffCodes_t *codes, huff_t *huff, int ch, byte *fout, int *offset )
+{
+	if ( codes->length[ ch ] )
+	{
+		Huff_putBits( codes->code[ ch ], codes->length[ ch ], fout, offset );
+	}
+	else
+	{
+		Huff_offsetTransmit( huff, ch, fout, offset );
+	}
+}
+
+//size is the size of fin, bits past it are read as 0
+void Huff_tableReceive( const huffCodes_t *codes, node_t *tree, int *ch, byte *fin, int *offset, int size )
+{
+	int      x, y, n, entry;
+	uint32_t window = 0;
+
+	x = *offset >> 3;
+	y = *offset & 7;
+
+	for ( n = 0; n < y + HUFF_LOOKUP_BITS && x < size; n += 8 )
+	{
+		window |= ( uint32_t ) fin[ x++ ] << n;
+	}
+
+	entry = codes->decode[ ( window >> y ) & ( ( 1 << HUFF_LOOKUP_BITS ) - 1 ) ];
+
+	if ( entry )
+	{
+		*ch = entry & 0xff;
+		*offset += entry >> 8;
+		return;
+	}
+
+	Huff_offsetReceive( tree, ch, fin, offset );
 }
 
 void Huff_Decompress( msg_t *mbuf, int offset )
@@ -36,6 +36,7 @@ Maryland 20850 USA.
 #include "qcommon.h"
 
 static huffman_t msgHuff;
+static huffCodes_t msgCodes; // msgHuff never changes after MSG_initHuffman
 static qboolean  msgInit = qfalse;
 
 /*
@@ -189,36 +190,97 @@ void MSG_WriteBits( msg_t *msg, int value, int bits )
 	}
 	else
 	{
+		uint64_t pending = 0;
+		int      numPending = 0;
+
 		value &= ( 0xffffffff >> ( 32 - bits ) );
 
+		// the odd bits are sent as they are, then the bytes huffman coded,
+		// all gathered in one accumulator
 		if ( bits & 7 )
 		{
-			int nbits;
+			numPending = bits & 7;
+			pending = value & ( ( 1 << numPending ) - 1 );
+			value = ( unsigned ) value >> numPending;
+			bits = bits - numPending;
+		}
 
-			nbits = bits & 7;
+		for ( i = 0; i < bits; i += 8 )
+		{
+			int ch = value & 0xff;
+			int length = msgCodes.length[ ch ];
 
-			for ( i = 0; i < nbits; i++ )
+			if ( !length || numPending + length > 56 )
 			{
-				Huff_putBit( ( value & 1 ), msg->data, &msg->bit );
-				value = ( value >> 1 );
+				Huff_putBits( pending, numPending, msg->data, &msg->bit );
+				pending = 0;
+				numPending = 0;
 			}
 
-			bits = bits - nbits;
-		}
-
-		if ( bits )
-		{
-			for ( i = 0; i < bits; i += 8 )
+			if ( length )
 			{
-				Huff_offsetTransmit( &msgHuff.compressor, ( value & 0xff ), msg->data, &msg->bit );
-				value = ( value >> 8 );
+				pending |= ( uint64_t ) msgCodes.code[ ch ] << numPending;
+				numPending += length;
 			}
+			else
+			{
+				Huff_offsetTransmit( &msgHuff.compressor, ch, msg->data, &msg->bit );
+			}
+
+			value = ( unsigned ) value >> 8;
 		}
 
+		Huff_putBits( pending, numPending, msg->data, &msg->bit );
+
 		msg->cursize = ( msg->bit >> 3 ) + 1;
 	}
 }
 
+/*
+Copies bits that have already been huffman coded out of a message, starting
+at bit offset start, so MSG_WriteCodedBits can put them in another one
+*/
+void MSG_GetCodedBits( const msg_t *msg, int start, byte *data, int bits )
+{
+	int offset = 0;
+
+	while ( bits > 0 )
+	{
+		int n = std::min( bits, 32 );
+
+		Huff_putBits( Huff_getBits( msg->data, &start, n ), n, data, &offset );
+		bits -= n;
+	}
+}
+
+/*
+Appends bits from MSG_GetCodedBits, the same as writing whatever they were
+made from again. uncompbits is only for the net debugging counters.
+*/
+void MSG_WriteCodedBits( msg_t *msg, const byte *data, int bits, int uncompbits )
+{
+	int offset = 0;
+
+	msg->uncompsize += uncompbits; // NERVE - SMF - net debugging
+
+	// this isn't an exact overflow check, but close enough
+	if ( msg->maxsize - msg->cursize < 32 + ( bits >> 3 ) )
+	{
+		msg->overflowed = qtrue;
+		return;
+	}
+
+	while ( bits > 0 )
+	{
+		int n = std::min( bits, 32 );
+
+		Huff_putBits( Huff_getBits( data, &offset, n ), n, msg->data, &msg->bit );
+		bits -= n;
+	}
+
+	msg->cursize = ( msg->bit >> 3 ) + 1;
+}
+
 int MSG_ReadBits( msg_t *msg, int bits )
 {
 	int      value;
@@ -274,22 +336,14 @@ int MSG_ReadBits( msg_t *msg, int bits )
 		if ( bits & 7 )
 		{
 			nbits = bits & 7;
-
-			for ( i = 0; i < nbits; i++ )
-			{
-				value |= ( Huff_getBit( msg->data, &msg->bit ) << i );
-			}
-
+			value = Huff_getBits( msg->data, &msg->bit, nbits );
 			bits = bits - nbits;
 		}
 
-		if ( bits )
+		for ( i = 0; i < bits; i += 8 )
 		{
-			for ( i = 0; i < bits; i += 8 )
-			{
-				Huff_offsetReceive( msgHuff.decompressor.tree, &get, msg->data, &msg->bit );
-				value |= ( get << ( i + nbits ) );
-			}
+			Huff_tableReceive( &msgCodes, msgHuff.decompressor.tree, &get, msg->data, &msg->bit, msg->maxsize );
+			value |= ( get << ( i + nbits ) );
 		}
 
 		msg->readcount = ( msg->bit >> 3 ) + 1;
@@ -913,8 +967,13 @@ typedef struct
 	int  offset;
 	int  bits;
 	int  used;
+	int  sentCount; // for MSG_GetFieldStats
+	int  sentBits;
 } netField_t;
 
+static qboolean   msgFieldStats;
+static netField_t msgArrayStats = { "stats/persistant/misc" };
+
 // using the stringizing operator to save typing...
 #define NETF( x ) # x,int((size_t)&( (entityState_t*)0 )->x)
 
@@ -1032,6 +1091,189 @@ void MSG_PrioritiseEntitystateFields( void )
 #define FLOAT_INT_BITS 13
 #define FLOAT_INT_BIAS ( 1 << ( FLOAT_INT_BITS - 1 ) )
 
+/*
+=============================================================================
+
+Quantized entity fields
+
+When msg->quantized is set, which the server only does for clients asking
+for it and flags with SNAPFLAG_QUANTIZED, trajectory positions and velocities
+are sent in 1/8 units and trajectory angles in 1/65536 turns.  A change is
+sent as the difference of the quantized values of the old and new state,
+which both sides compute the same way from their own copy of the old state:
+the client's copy is either exact or was already quantized, which doesn't
+change its quantized value.
+
+  0  + 8 bits   small difference
+  10 + 16 bits  larger difference
+  11 + float    as without quantization, for anything else
+
+=============================================================================
+*/
+
+#define QUANT_NONE           0
+#define QUANT_POSITION       1
+#define QUANT_ANGLE          2
+
+#define QUANT_POSITION_SCALE 8.0
+#define QUANT_ANGLE_SCALE    ( 65536.0 / 360.0 )
+#define QUANT_RANGE          ( 1 << 23 )
+
+#define ESF( x ) int((size_t)&( (entityState_t*)0 )->x)
+
+static int MSG_EntityFieldQuantization( const netField_t *field )
+{
+	if ( field->offset >= ESF( pos.trBase ) && field->offset < ESF( pos.trBase[ 3 ] ) )
+	{
+		return QUANT_POSITION;
+	}
+
+	if ( field->offset >= ESF( pos.trDelta ) && field->offset < ESF( pos.trDelta[ 3 ] ) )
+	{
+		return QUANT_POSITION;
+	}
+
+	if ( field->offset >= ESF( apos.trBase ) && field->offset < ESF( apos.trBase[ 3 ] ) )
+	{
+		return QUANT_ANGLE;
+	}
+
+	return QUANT_NONE;
+}
+
+static qboolean MSG_Quantize( int quant, float value, int *q )
+{
+	double scaled = value * ( quant == QUANT_ANGLE ? QUANT_ANGLE_SCALE : QUANT_POSITION_SCALE );
+
+	// also catches NaN
+	if ( !( fabs( scaled ) < QUANT_RANGE ) )
+	{
+		return qfalse;
+	}
+
+	*q = ( int ) floor( scaled + 0.5 );
+
+	if ( quant == QUANT_ANGLE )
+	{
+		*q &= 65535;
+	}
+
+	return qtrue;
+}
+
+static float MSG_Dequantize( int quant, int q )
+{
+	return ( float )( q / ( quant == QUANT_ANGLE ? QUANT_ANGLE_SCALE : QUANT_POSITION_SCALE ) );
+}
+
+/*
+==================
+MSG_WriteQuantizedFloat
+
+Returns qfalse if the float has to be written as usual after that
+==================
+*/
+static qboolean MSG_WriteQuantizedFloat( msg_t *msg, const netField_t *field, float from, float to )
+{
+	int quant = MSG_EntityFieldQuantization( field );
+	int qfrom, qto, delta;
+	int plainBits;
+
+	if ( quant == QUANT_NONE )
+	{
+		return qfalse;
+	}
+
+	if ( MSG_Quantize( quant, from, &qfrom ) && MSG_Quantize( quant, to, &qto ) )
+	{
+		delta = qto - qfrom;
+
+		if ( quant == QUANT_ANGLE )
+		{
+			delta = ( ( delta + 32768 ) & 65535 ) - 32768;
+		}
+
+		if ( delta >= -128 && delta < 128 )
+		{
+			MSG_WriteBits( msg, 0, 1 );
+			MSG_WriteBits( msg, delta, 8 );
+			return qtrue;
+		}
+
+		// small integers are cheap enough as they are
+		if ( to == 0.0f )
+		{
+			plainBits = 1;
+		}
+		else if ( ( int ) to == to && ( int ) to + FLOAT_INT_BIAS >= 0 && ( int ) to + FLOAT_INT_BIAS < ( 1 << FLOAT_INT_BITS ) )
+		{
+			plainBits = 2 + FLOAT_INT_BITS;
+		}
+		else
+		{
+			plainBits = 2 + 32;
+		}
+
+		if ( delta >= -32768 && delta < 32768 && plainBits > 16 )
+		{
+			MSG_WriteBits( msg, 1, 1 );
+			MSG_WriteBits( msg, 0, 1 );
+			MSG_WriteBits( msg, delta, 16 );
+			return qtrue;
+		}
+	}
+
+	MSG_WriteBits( msg, 1, 1 );
+	MSG_WriteBits( msg, 1, 1 );
+	return qfalse;
+}
+
+/*
+==================
+MSG_ReadQuantizedFloat
+
+Returns qfalse if the float has to be read as usual after that
+==================
+*/
+static qboolean MSG_ReadQuantizedFloat( msg_t *msg, const netField_t *field, float from, float *to )
+{
+	int quant = MSG_EntityFieldQuantization( field );
+	int qfrom, delta;
+
+	if ( quant == QUANT_NONE )
+	{
+		return qfalse;
+	}
+
+	if ( !MSG_ReadBits( msg, 1 ) )
+	{
+		delta = MSG_ReadBits( msg, -8 );
+	}
+	else if ( !MSG_ReadBits( msg, 1 ) )
+	{
+		delta = MSG_ReadBits( msg, -16 );
+	}
+	else
+	{
+		return qfalse;
+	}
+
+	if ( !MSG_Quantize( quant, from, &qfrom ) )
+	{
+		Com_Error( ERR_DROP, "MSG_ReadQuantizedFloat: %s can't be quantized", field->name );
+	}
+
+	qfrom += delta;
+
+	if ( quant == QUANT_ANGLE )
+	{
+		qfrom &= 65535;
+	}
+
+	*to = MSG_Dequantize( quant, qfrom );
+	return qtrue;
+}
+
 /*
 ==================
 MSG_WriteDeltaEntity
@@ -1045,7 +1287,7 @@ identical, under the assumption that the in-order delta code will catch it.
 */
 void MSG_WriteDeltaEntity( msg_t *msg, struct entityState_s *from, struct entityState_s *to, qboolean force )
 {
-	int        i, lc;
+	int        i, lc, start;
 	int        numFields;
 	netField_t *field;
 	int        trunc;
@@ -1133,9 +1375,16 @@ void MSG_WriteDeltaEntity( msg_t *msg, struct entityState_s *from, struct entity
 			continue;
 		}
 
+		start = msg->bit;
+
 		MSG_WriteBits( msg, 1, 1 );  // changed
 
-		if ( field->bits == 0 )
+		if ( field->bits == 0 && msg->quantized &&
+		     MSG_WriteQuantizedFloat( msg, field, * ( float * ) fromF, * ( float * ) toF ) )
+		{
+			// sent as a change of the quantized value
+		}
+		else if ( field->bits == 0 )
 		{
 			// float
 			fullFloat = * ( float * ) toF;
@@ -1185,6 +1434,12 @@ void MSG_WriteDeltaEntity( msg_t *msg, struct entityState_s *from, struct entity
 //              }
 			}
 		}
+
+		if ( msgFieldStats )
+		{
+			field->sentCount++;
+			field->sentBits += msg->bit - start;
+		}
 	}
 
 //  Com_Printf(_( "\n" ));
@@ -1297,7 +1552,15 @@ void MSG_ReadDeltaEntity( msg_t *msg, entityState_t *from, entityState_t *to, in
 		}
 		else
 		{
-			if ( field->bits == 0 )
+			if ( field->bits == 0 && msg->quantized &&
+			     MSG_ReadQuantizedFloat( msg, field, * ( float * ) fromF, ( float * ) toF ) )
+			{
+				if ( print )
+				{
+					Com_Printf( "%s:%f ", field->name, * ( float * ) toF );
+				}
+			}
+			else if ( field->bits == 0 )
 			{
 				// float
 				if ( MSG_ReadBits( msg, 1 ) == 0 )
@@ -1540,21 +1803,82 @@ void MSG_PrioritisePlayerStateFields( void )
 	Com_Printf( "};\n" );
 }
 
+/*
+=============
+MSG_SetFieldStats
+
+Counts the bits written for every field of the entity and player state
+deltas.  Not thread safe, so only for messages written one at a time.
+=============
+*/
+void MSG_SetFieldStats( qboolean enable )
+{
+	msgFieldStats = enable;
+}
+
+qboolean MSG_FieldStatsEnabled( void )
+{
+	return msgFieldStats;
+}
+
+static int MSG_CopyFieldStats( netField_t *fields, int numFields, msgFieldStats_t *stats, int maxStats, qboolean reset )
+{
+	int i;
+
+	for ( i = 0; i < numFields && i < maxStats; i++ )
+	{
+		stats[ i ].name = fields[ i ].name;
+		stats[ i ].count = fields[ i ].sentCount;
+		stats[ i ].bits = fields[ i ].sentBits;
+
+		if ( reset )
+		{
+			fields[ i ].sentCount = 0;
+			fields[ i ].sentBits = 0;
+		}
+	}
+
+	return i;
+}
+
+/*
+=============
+MSG_GetFieldStats
+
+Returns the number of fields filled in
+=============
+*/
+int MSG_GetFieldStats( qboolean playerState, msgFieldStats_t *stats, int maxStats, qboolean reset )
+{
+	int numStats;
+
+	if ( !playerState )
+	{
+		return MSG_CopyFieldStats( entityStateFields, ARRAY_LEN( entityStateFields ), stats, maxStats, reset );
+	}
+
+	numStats = MSG_CopyFieldStats( playerStateFields, ARRAY_LEN( playerStateFields ), stats, maxStats, reset );
+	numStats += MSG_CopyFieldStats( &msgArrayStats, 1, stats + numStats, maxStats - numStats, reset );
+
+	return numStats;
+}
+
 /*
 =============
 MSG_WriteDeltaPlayerstate
 
 =============
 */
-void MSG_WriteDeltaPlayerstate( msg_t *msg, struct playerState_s *from, struct playerState_s *to )
+void MSG_WriteDeltaPlayerstate( msg_t *msg, const struct playerState_s *from, struct playerState_s *to )
 {
-	int           i, lc;
+	int           i, lc, start;
 	playerState_t dummy;
 	int           statsbits;
 	int           persistantbits;
 	int           numFields;
 	netField_t *field;
-	int        *fromF, *toF;
+	const int  *fromF;
+	int        *toF;
 	float      fullFloat;
 	int        trunc;
 	int        startBit, endBit;
@@ -1594,7 +1918,7 @@ void MSG_WriteDeltaPlayerstate( msg_t *msg, struct playerState_s *from, struct p
 
 	for ( i = 0, field = playerStateFields; i < numFields; i++, field++ )
 	{
-		fromF = ( int * )( ( byte * ) from + field->offset );
+		fromF = ( const int * )( ( const byte * ) from + field->offset );
 		toF = ( int * )( ( byte * ) to + field->offset );
 
 		if ( *fromF != *toF )
@@ -1609,7 +1933,7 @@ void MSG_WriteDeltaPlayerstate( msg_t *msg, struct playerState_s *from, struct p
 
 	for ( i = 0, field = playerStateFields; i < lc; i++, field++ )
 	{
-		fromF = ( int * )( ( byte * ) from + field->offset );
+		fromF = ( const int * )( ( const byte * ) from + field->offset );
 		toF = ( int * )( ( byte * ) to + field->offset );
 
 		if ( *fromF == *toF )
@@ -1618,6 +1942,8 @@ void MSG_WriteDeltaPlayerstate( msg_t *msg, struct playerState_s *from, struct p
 			continue;
 		}
 
+		start = msg->bit;
+
 		MSG_WriteBits( msg, 1, 1 );  // changed
 
 		if ( field->bits == 0 )
@@ -1653,8 +1979,16 @@ void MSG_WriteDeltaPlayerstate( msg_t *msg, struct playerState_s *from, struct p
 //              Com_Printf(_( "%s:%i "), field->name, *toF );
 //          }
 		}
+
+		if ( msgFieldStats )
+		{
+			field->sentCount++;
+			field->sentBits += msg->bit - start;
+		}
 	}
 
+	start = msg->bit;
+
 	//
 	// send the arrays
 	//
@@ -1753,6 +2087,12 @@ void MSG_WriteDeltaPlayerstate( msg_t *msg, struct playerState_s *from, struct p
 		MSG_WriteBits( msg, 0, 1 );  // no change to any
 	}
 
+	if ( msgFieldStats )
+	{
+		msgArrayStats.sentCount += statsbits || persistantbits || miscbits;
+		msgArrayStats.sentBits += msg->bit - start;
+	}
+
 	if ( print )
 	{
 		if ( msg->bit == 0 )
@@ -2224,6 +2564,230 @@ void MSG_initHuffman( void )
 			Huff_addRef( &msgHuff.decompressor, ( byte ) i );  /* Do update */
 		}
 	}
+
+	Huff_BuildCodes( &msgHuff.compressor, &msgCodes );
 }
 
+/*
+=================
+Huffman benchmark
+
+Runs the message coder over the server messages of a demo, walking the tree
+and with the compiled tables, and checks that both give the same bits.
+=================
+*/
+class MsgBenchmarkCmd: public Cmd::StaticCmd {
+public:
+	MsgBenchmarkCmd()
+		: Cmd::StaticCmd("msgBenchmark", Cmd::SYSTEM, N_("times the huffman coder on the messages of a demo")) {}
+
+	void Run(const Cmd::Args& args) const OVERRIDE
+	{
+		if (args.Argc() < 2 || args.Argc() > 3) {
+			PrintUsage(args, _("<demo> [iterations]"), "");
+			return;
+		}
+
+		int iterations = args.Argc() == 3 ? std::max(1, atoi(args.Argv(2).c_str())) : 100;
+		byte *demo;
+		int demoSize = FS_ReadFile(va("demos/%s", args.Argv(1).c_str()), (void **) &demo);
+
+		if (demoSize <= 0) {
+			Print(_("Couldn't read demos/%s"), args.Argv(1));
+			return;
+		}
+
+		if (!msgInit) {
+			MSG_initHuffman();
+		}
+
+		// decode every message into the bytes it is made of, treating the
+		// odd bits like everything else is fine for timing
+		std::vector<byte> symbols;
+		std::vector<int> ends;
+
+		for (int pos = 0; pos + 8 <= demoSize;) {
+			int size = LittleLong(*(int *) &demo[pos + 4]);
+			pos += 8;
+
+			if (size < 0 || size > MAX_MSGLEN || pos + size > demoSize) {
+				break;
+			}
+
+			std::vector<byte> data(demo + pos, demo + pos + size);
+			data.resize(size + 8);
+
+			for (int bit = 0; bit < size * 8;) {
+				int ch;
+				Huff_offsetReceive(msgHuff.decompressor.tree, &ch, data.data(), &bit);
+				symbols.push_back(ch);
+			}
+
+			ends.push_back(symbols.size());
+			pos += size;
+		}
+
+		FS_FreeFile(demo);
+
+		if (symbols.empty()) {
+			Print(_("No messages in demos/%s"), args.Argv(1));
+			return;
+		}
+
+		std::vector<byte> treeBuf(symbols.size() * 4 + 8), tableBuf(treeBuf.size());
+		int treeBits = 0, tableBits = 0;
+		int treeEncode, tableEncode, treeDecode, tableDecode;
+		int mismatches = 0;
+		int start;
+
+		start = Sys_Milliseconds();
+		for (int n = 0; n < iterations; n++) {
+			treeBits = 0;
+			for (byte ch : symbols) {
+				Huff_offsetTransmit(&msgHuff.compressor, ch, treeBuf.data(), &treeBits);
+			}
+		}
+		treeEncode = Sys_Milliseconds() - start;
+
+		start = Sys_Milliseconds();
+		for (int n = 0; n < iterations; n++) {
+			tableBits = 0;
+			for (byte ch : symbols) {
+				Huff_tableTransmit(&msgCodes, &msgHuff.compressor, ch, tableBuf.data(), &tableBits);
+			}
+		}
+		tableEncode = Sys_Milliseconds() - start;
+
+		if (treeBits != tableBits || memcmp(treeBuf.data(), tableBuf.data(), (treeBits + 7) >> 3)) {
+			mismatches++;
+		}
+
+		std::vector<byte> decoded(symbols.size());
+
+		start = Sys_Milliseconds();
+		for (int n = 0; n < iterations; n++) {
+			int bit = 0;
+			for (size_t i = 0; i < symbols.size(); i++) {
+				int ch;
+				Huff_offsetReceive(msgHuff.decompressor.tree, &ch, treeBuf.data(), &bit);
+				decoded[i] = ch;
+			}
+		}
+		treeDecode = Sys_Milliseconds() - start;
+
+		start = Sys_Milliseconds();
+		for (int n = 0; n < iterations; n++) {
+			int bit = 0;
+			for (size_t i = 0; i < symbols.size(); i++) {
+				int ch;
+				Huff_tableReceive(&msgCodes, msgHuff.decompressor.tree, &ch, treeBuf.data(), &bit, treeBuf.size());
+				decoded[i] = ch;
+			}
+		}
+		tableDecode = Sys_Milliseconds() - start;
+
+		if (decoded != symbols) {
+			mismatches++;
+		}
+
+		Print("%d messages, %d bytes in %d bits, %d iterations", (int) ends.size(), (int) symbols.size(), treeBits, iterations);
+		Print("encode: tree %d msec, tables %d msec", treeEncode, tableEncode);
+		Print("decode: tree %d msec, tables %d msec", treeDecode, tableDecode);
+
+		if (mismatches) {
+			Print(S_COLOR_RED "tree and tables disagree");
+		}
+	}
+};
+static MsgBenchmarkCmd MsgBenchmarkCmdRegistration;
+
+/*
+=================
+Quantization statistics
+
+MSG_MeasureQuantization writes an entity delta with and without
+quantization and adds up the bits of every field, the client does it for
+all the deltas it reads with cl_measureQuantization set, so playing back
+demos shows what quantizing them would save.
+=================
+*/
+static int quantizationBits[ 2 ][ ARRAY_LEN( entityStateFields ) ];
+static int quantizationTotal[ 2 ];
+static int quantizationDeltas;
+
+void MSG_MeasureQuantization( entityState_t *from, entityState_t *to )
+{
+	netField_t saved[ ARRAY_LEN( entityStateFields ) ];
+	qboolean   savedFieldStats = msgFieldStats;
+	byte       buffer[ 2048 ];
+	msg_t      scratch;
+	int        mode;
+	size_t     i;
+
+	memcpy( saved, entityStateFields, sizeof( saved ) );
+	msgFieldStats = qtrue;
+
+	for ( mode = 0; mode < 2; mode++ )
+	{
+		for ( i = 0; i < ARRAY_LEN( entityStateFields ); i++ )
+		{
+			entityStateFields[ i ].sentBits = 0;
+		}
+
+		MSG_Init( &scratch, buffer, sizeof( buffer ) );
+		scratch.allowoverflow = qtrue;
+		scratch.quantized = mode;
+
+		MSG_WriteDeltaEntity( &scratch, from, to, qfalse );
+
+		for ( i = 0; i < ARRAY_LEN( entityStateFields ); i++ )
+		{
+			quantizationBits[ mode ][ i ] += entityStateFields[ i ].sentBits;
+		}
+
+		quantizationTotal[ mode ] += scratch.bit;
+	}
+
+	quantizationDeltas++;
+
+	memcpy( entityStateFields, saved, sizeof( saved ) );
+	msgFieldStats = savedFieldStats;
+}
+
+class QuantizeStatsCmd: public Cmd::StaticCmd {
+public:
+	QuantizeStatsCmd()
+		: Cmd::StaticCmd("quantizeStats", Cmd::SYSTEM, N_("prints the bits entity quantization would save on the deltas read so far")) {}
+
+	void Run(const Cmd::Args& args) const OVERRIDE
+	{
+		if (args.Argc() == 2 && args.Argv(1) == "reset") {
+			memset(quantizationBits, 0, sizeof(quantizationBits));
+			memset(quantizationTotal, 0, sizeof(quantizationTotal));
+			quantizationDeltas = 0;
+			return;
+		}
+
+		if (!quantizationDeltas) {
+			Print(_("No entity deltas measured, set cl_measureQuantization and play a demo"));
+			return;
+		}
+
+		Print("%-24s %12s %12s %7s", "field", "bits", "quantized", "saved");
+
+		for (size_t i = 0; i < ARRAY_LEN(entityStateFields); i++) {
+			int plain = quantizationBits[0][i], quantized = quantizationBits[1][i];
+
+			if (plain || quantized) {
+				Print("%-24s %12i %12i %6.1f%%", entityStateFields[i].name, plain, quantized,
+				      plain ? 100.0f * (plain - quantized) / plain : 0.0f);
+			}
+		}
+
+		Print("%i deltas, %i bits, %i quantized, %.1f%% saved", quantizationDeltas, quantizationTotal[0], quantizationTotal[1],
+		      quantizationTotal[0] ? 100.0f * (quantizationTotal[0] - quantizationTotal[1]) / quantizationTotal[0] : 0.0f);
+	}
+};
+static QuantizeStatsCmd QuantizeStatsCmdRegistration;
+
 //===========================================================================
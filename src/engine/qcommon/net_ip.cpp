@@ -136,6 +136,81 @@ static SOCKET              ip6_socket = INVALID_SOCKET;
 static SOCKET              socks_socket = INVALID_SOCKET;
 static SOCKET              multicast6_socket = INVALID_SOCKET;
 
+/*
+On Linux the server sockets are read and written several packets per
+system call: Sys_GetPacket hands out the packets of one recvmmsg at a time,
+and while a send batch is open (NET_BeginSendBatch) the outgoing packets
+are held back and sent with one sendmmsg by NET_FlushSendBatch.
+*/
+#ifdef __linux__
+#define NET_RECV_BATCH   16
+#define NET_SEND_BATCH   64
+#define NET_SEND_BATCHED 2048 // larger packets are sent on their own
+
+typedef struct
+{
+	int                     count;
+	int                     next;
+	struct mmsghdr          headers[ NET_RECV_BATCH ];
+	struct iovec            iovecs[ NET_RECV_BATCH ];
+	struct sockaddr_storage from[ NET_RECV_BATCH ];
+	byte                    data[ NET_RECV_BATCH ][ MAX_MSGLEN ];
+} netRecvBatch_t;
+
+typedef struct
+{
+	int                     count;
+	struct mmsghdr          headers[ NET_SEND_BATCH ];
+	struct iovec            iovecs[ NET_SEND_BATCH ];
+	struct sockaddr_storage to[ NET_SEND_BATCH ];
+	netadrtype_t            toType[ NET_SEND_BATCH ];
+	byte                    data[ NET_SEND_BATCH ][ NET_SEND_BATCHED ];
+} netSendBatch_t;
+
+static netRecvBatch_t      ipRecvBatch, ip6RecvBatch;
+static netSendBatch_t      ipSendBatch, ip6SendBatch;
+#endif
+
+static qboolean            sendBatchOpen = qfalse;
+static netBatchStats_t     batchStats;
+static std::atomic<int>    recvCalls, recvPackets; // also counted by the network thread
+
+/*
+With net_thread set, a dedicated server reads its sockets on a thread of its
+own, so that floods of packets don't eat into the frame. Connectionless
+queries beyond net_threadQueries a second are dropped there and then, and
+everything else is handed to Sys_GetPacket through a single producer,
+single consumer queue. Packets are still sent from the main thread.
+*/
+#define NET_QUEUE_SIZE  ( 1 << 20 ) // must be a power of two
+#define NET_QUEUE_ALIGN 8
+
+typedef struct
+{
+	int      length; // -1 marks the unused end of the queue before wrapping
+	netadr_t from;
+} netQueuedPacket_t;
+
+static struct
+{
+	std::atomic<unsigned> head; // only written by the network thread
+	std::atomic<unsigned> tail; // only written by the main thread
+	byte                  data[ NET_QUEUE_SIZE ];
+} netQueue;
+
+static cvar_t                  *net_thread;
+static cvar_t                  *net_threadQueries;
+
+static std::thread             netThread;
+static std::atomic<bool>       netThreadQuit;
+static qboolean                netThreadRunning = qfalse;
+static std::mutex              netWakeMutex;
+static std::condition_variable netWake;
+static std::atomic<int>        queueDrops, queryDrops;
+
+// the network thread must not print
+#define NET_RecvPrintf( ... ) do { if ( !netThreadRunning ) { Com_Printf( __VA_ARGS__ ); } } while ( 0 )
+
 // Keep track of currently joined multicast group.
 static struct ipv6_mreq    curgroup;
 
@@ -697,12 +772,62 @@ qboolean        NET_IsLocalAddress( netadr_t adr )
 
 /*
 ==================
-Sys_GetPacket
+NET_RecvFrom
 
-Never called by the game logic, just the system event queuing
+recvfrom on a server socket, refilling the socket's batch when it runs out
 ==================
 */
-qboolean Sys_GetPacket( netadr_t *net_from, msg_t *net_message )
+#ifdef __linux__
+static int NET_RecvFrom( SOCKET sock, netRecvBatch_t *batch, byte *data, int maxsize, struct sockaddr_storage *from, socklen_t *fromlen )
+{
+	int i, len;
+
+	if ( batch->next == batch->count )
+	{
+		int size = std::min( maxsize, MAX_MSGLEN );
+
+		for ( i = 0; i < NET_RECV_BATCH; i++ )
+		{
+			batch->iovecs[ i ].iov_base = batch->data[ i ];
+			batch->iovecs[ i ].iov_len = size;
+			batch->headers[ i ].msg_hdr.msg_name = &batch->from[ i ];
+			batch->headers[ i ].msg_hdr.msg_namelen = sizeof( batch->from[ i ] );
+			batch->headers[ i ].msg_hdr.msg_iov = &batch->iovecs[ i ];
+			batch->headers[ i ].msg_hdr.msg_iovlen = 1;
+			batch->headers[ i ].msg_hdr.msg_control = NULL;
+			batch->headers[ i ].msg_hdr.msg_controllen = 0;
+			batch->headers[ i ].msg_hdr.msg_flags = 0;
+		}
+
+		batch->next = batch->count = 0;
+		len = recvmmsg( sock, batch->headers, NET_RECV_BATCH, 0, NULL );
+		recvCalls++;
+
+		if ( len <= 0 )
+		{
+			return SOCKET_ERROR;
+		}
+
+		batch->count = len;
+		recvPackets += len;
+	}
+
+	i = batch->next++;
+	len = batch->headers[ i ].msg_len;
+	memcpy( data, batch->data[ i ], len );
+	memcpy( from, &batch->from[ i ], batch->headers[ i ].msg_hdr.msg_namelen );
+	*fromlen = batch->headers[ i ].msg_hdr.msg_namelen;
+
+	return len;
+}
+#endif
+
+/*
+==================
+NET_ReceivePacket
+==================
+*/
+static qboolean NET_ReceivePacket( netadr_t *net_from, msg_t *net_message )
 {
 	int                     ret;
 	struct sockaddr_storage from;
@@ -713,7 +838,13 @@ qboolean Sys_GetPacket( netadr_t *net_from, msg_t *net_message )
 	if ( ip_socket != INVALID_SOCKET )
 	{
 		fromlen = sizeof( from );
+#ifdef __linux__
+		ret = NET_RecvFrom( ip_socket, &ipRecvBatch, net_message->data, net_message->maxsize, &from, &fromlen );
+#else
 		ret = recvfrom( ip_socket, ( char * ) net_message->data, net_message->maxsize, 0, ( struct sockaddr * ) &from, &fromlen );
+		recvCalls++;
+		recvPackets += ret != SOCKET_ERROR;
+#endif
 
 		if ( ret == SOCKET_ERROR )
 		{
@@ -721,7 +852,7 @@ qboolean Sys_GetPacket( netadr_t *net_from, msg_t *net_message )
 
 			if ( err != EAGAIN && err != ECONNRESET )
 			{
-				Com_Printf( "NET_GetPacket: %s\n", NET_ErrorString() );
+				NET_RecvPrintf( "NET_GetPacket: %s\n", NET_ErrorString() );
 			}
 		}
 		else
@@ -751,7 +882,7 @@ qboolean Sys_GetPacket( netadr_t *net_from, msg_t *net_message )
 
 			if ( ret == net_message->maxsize )
 			{
-				Com_Printf( "Oversize packet from %s\n", NET_AdrToString( *net_from ) );
+				NET_RecvPrintf( "Oversize packet from %s\n", NET_AdrToString( *net_from ) );
 				return qfalse;
 			}
 
@@ -763,7 +894,13 @@ qboolean Sys_GetPacket( netadr_t *net_from, msg_t *net_message )
 	if ( ip6_socket != INVALID_SOCKET )
 	{
 		fromlen = sizeof( from );
+#ifdef __linux__
+		ret = NET_RecvFrom( ip6_socket, &ip6RecvBatch, net_message->data, net_message->maxsize, &from, &fromlen );
+#else
 		ret = recvfrom( ip6_socket, ( char * ) net_message->data, net_message->maxsize, 0, ( struct sockaddr * ) &from, &fromlen );
+		recvCalls++;
+		recvPackets += ret != SOCKET_ERROR;
+#endif
 
 		if ( ret == SOCKET_ERROR )
 		{
@@ -771,7 +908,7 @@ qboolean Sys_GetPacket( netadr_t *net_from, msg_t *net_message )
 
 			if ( err != EAGAIN && err != ECONNRESET )
 			{
-				Com_Printf( "NET_GetPacket: %s\n", NET_ErrorString() );
+				NET_RecvPrintf( "NET_GetPacket: %s\n", NET_ErrorString() );
 			}
 		}
 		else
@@ -781,7 +918,7 @@ qboolean Sys_GetPacket( netadr_t *net_from, msg_t *net_message )
 
 			if ( ret == net_message->maxsize )
 			{
-				Com_Printf( "Oversize packet from %s\n", NET_AdrToString( *net_from ) );
+				NET_RecvPrintf( "Oversize packet from %s\n", NET_AdrToString( *net_from ) );
 				return qfalse;
 			}
 
@@ -801,7 +938,7 @@ qboolean Sys_GetPacket( netadr_t *net_from, msg_t *net_message )
 
 			if ( err != EAGAIN && err != ECONNRESET )
 			{
-				Com_Printf( "NET_GetPacket: %s\n", NET_ErrorString() );
+				NET_RecvPrintf( "NET_GetPacket: %s\n", NET_ErrorString() );
 			}
 		}
 		else
@@ -811,7 +948,7 @@ qboolean Sys_GetPacket( netadr_t *net_from, msg_t *net_message )
 
 			if ( ret == net_message->maxsize )
 			{
-				Com_Printf( "Oversize packet from %s\n", NET_AdrToString( *net_from ) );
+				NET_RecvPrintf( "Oversize packet from %s\n", NET_AdrToString( *net_from ) );
 				return qfalse;
 			}
 
@@ -823,10 +960,427 @@ qboolean Sys_GetPacket( netadr_t *net_from, msg_t *net_message )
 	return qfalse;
 }
 
+/*
+==================
+NET_QueuePush
+
+Called by the network thread, drops the packet if the queue is full
+==================
+*/
+static void NET_QueuePush( const netadr_t *from, const byte *data, int length )
+{
+	netQueuedPacket_t header;
+	unsigned          head = netQueue.head.load( std::memory_order_relaxed );
+	unsigned          tail = netQueue.tail.load( std::memory_order_acquire );
+	unsigned          pos = head % NET_QUEUE_SIZE;
+	unsigned          need = ( sizeof( header ) + length + NET_QUEUE_ALIGN - 1 ) & ~( NET_QUEUE_ALIGN - 1 );
+	unsigned          skip = pos + need > NET_QUEUE_SIZE ? NET_QUEUE_SIZE - pos : 0;
+
+	if ( head - tail + skip + need > NET_QUEUE_SIZE )
+	{
+		queueDrops++;
+		return;
+	}
+
+	if ( skip )
+	{
+		header.length = -1;
+		memcpy( netQueue.data + pos, &header.length, sizeof( header.length ) );
+		pos = 0;
+	}
+
+	header.length = length;
+	header.from = *from;
+	memcpy( netQueue.data + pos, &header, sizeof( header ) );
+	memcpy( netQueue.data + pos + sizeof( header ), data, length );
+
+	netQueue.head.store( head + skip + need, std::memory_order_release );
+}
+
+/*
+==================
+NET_QueuePop
+==================
+*/
+static qboolean NET_QueuePop( netadr_t *net_from, msg_t *net_message )
+{
+	netQueuedPacket_t header;
+	unsigned          tail = netQueue.tail.load( std::memory_order_relaxed );
+	unsigned          head = netQueue.head.load( std::memory_order_acquire );
+
+	while ( tail != head )
+	{
+		unsigned pos = tail % NET_QUEUE_SIZE;
+
+		memcpy( &header.length, netQueue.data + pos, sizeof( header.length ) );
+
+		if ( header.length < 0 )
+		{
+			tail += NET_QUEUE_SIZE - pos;
+			continue;
+		}
+
+		memcpy( &header, netQueue.data + pos, sizeof( header ) );
+		*net_from = header.from;
+		memcpy( net_message->data, netQueue.data + pos + sizeof( header ), header.length );
+		net_message->cursize = header.length;
+		net_message->readcount = 0;
+
+		tail += ( sizeof( header ) + header.length + NET_QUEUE_ALIGN - 1 ) & ~( NET_QUEUE_ALIGN - 1 );
+		netQueue.tail.store( tail, std::memory_order_release );
+		return qtrue;
+	}
+
+	netQueue.tail.store( tail, std::memory_order_release );
+	return qfalse;
+}
+
+/*
+==================
+NET_IsQuery
+
+Connectionless packets anyone can send to get an answer
+==================
+*/
+static qboolean NET_IsQuery( const byte *data, int length )
+{
+	const char *s = ( const char * ) data + 4;
+
+	if ( length < 4 || * ( const int * ) data != -1 )
+	{
+		return qfalse;
+	}
+
+	length -= 4;
+
+	return ( length >= 7 && !Q_strnicmp( s, "getinfo", 7 ) ) ||
+	       ( length >= 9 && !Q_strnicmp( s, "getstatus", 9 ) ) ||
+	       ( length >= 12 && !Q_strnicmp( s, "getchallenge", 12 ) );
+}
+
+/*
+==================
+NET_Select
+
+Waits msec or until one of the server sockets can be read
+==================
+*/
+static void NET_Select( int msec )
+{
+	struct timeval timeout;
+
+	fd_set         fdset;
+	SOCKET         highestfd = INVALID_SOCKET;
+
+	FD_ZERO( &fdset );
+
+	if ( ip_socket != INVALID_SOCKET )
+	{
+		FD_SET( ip_socket, &fdset );
+
+		highestfd = ip_socket;
+	}
+
+	if ( ip6_socket != INVALID_SOCKET )
+	{
+		FD_SET( ip6_socket, &fdset );
+
+		if ( highestfd == INVALID_SOCKET || ip6_socket > highestfd )
+		{
+			highestfd = ip6_socket;
+		}
+	}
+
+	timeout.tv_sec = msec / 1000;
+	timeout.tv_usec = ( msec % 1000 ) * 1000;
+	select( highestfd + 1, &fdset, NULL, NULL, &timeout );
+}
+
+/*
+==================
+NET_ThreadMain
+==================
+*/
+static void NET_ThreadMain( int maxQueries )
+{
+	static byte data[ MAX_MSGLEN ];
+	msg_t       msg;
+	netadr_t    from;
+	int         queryTime = 0;
+	int         queries = 0;
+
+	Com_Memset( &msg, 0, sizeof( msg ) );
+	msg.data = data;
+	msg.maxsize = sizeof( data );
+
+	while ( !netThreadQuit.load() )
+	{
+		NET_Select( 100 );
+
+		while ( NET_ReceivePacket( &from, &msg ) )
+		{
+			const byte *packet = msg.data + msg.readcount;
+			int        length = msg.cursize - msg.readcount;
+
+			if ( maxQueries > 0 && NET_IsQuery( packet, length ) )
+			{
+				int now = Sys_Milliseconds();
+
+				if ( now - queryTime >= 1000 )
+				{
+					queryTime = now;
+					queries = 0;
+				}
+
+				if ( ++queries > maxQueries )
+				{
+					queryDrops++;
+					continue;
+				}
+			}
+
+			// push under the lock, otherwise the wakeup can be lost between the
+			// queue check in NET_Sleep and its wait
+			{
+				std::lock_guard<std::mutex> lock( netWakeMutex );
+				NET_QueuePush( &from, packet, length );
+				netWake.notify_one();
+			}
+		}
+	}
+}
+
+/*
+==================
+NET_StartThread
+==================
+*/
+static void NET_StartThread( void )
+{
+	if ( !net_thread->integer || !com_dedicated->integer || usingSocks )
+	{
+		return;
+	}
+
+	if ( ip_socket == INVALID_SOCKET && ip6_socket == INVALID_SOCKET )
+	{
+		return;
+	}
+
+	netQueue.head = netQueue.tail = 0;
+	netThreadQuit = false;
+	netThreadRunning = qtrue;
+	netThread = std::thread( NET_ThreadMain, net_threadQueries->integer );
+}
+
+/*
+==================
+NET_StopThread
+==================
+*/
+static void NET_StopThread( void )
+{
+	if ( !netThreadRunning )
+	{
+		return;
+	}
+
+	netThreadQuit = true;
+	netThread.join();
+	netThreadRunning = qfalse;
+}
+
+/*
+==================
+Sys_GetPacket
+
+Never called by the game logic, just the system event queuing
+==================
+*/
+qboolean Sys_GetPacket( netadr_t *net_from, msg_t *net_message )
+{
+	if ( netThreadRunning )
+	{
+		return NET_QueuePop( net_from, net_message );
+	}
+
+	return NET_ReceivePacket( net_from, net_message );
+}
+
 //=============================================================================
 
 static char socksBuf[ 4096 ];
 
+/*
+==================
+NET_SendError
+==================
+*/
+static void NET_SendError( int err, netadrtype_t type, sa_family_t family )
+{
+	// wouldblock is silent
+	if ( err == EAGAIN )
+	{
+		return;
+	}
+
+	// some PPP links do not allow broadcasts and return an error
+	if ( ( err == EADDRNOTAVAIL ) && ( ( type == NA_BROADCAST ) ) )
+	{
+		return;
+	}
+
+	if ( family == AF_INET )
+	{
+		Com_Printf( "Sys_SendPacket (ipv4): %s\n", NET_ErrorString() );
+	}
+	else if ( family == AF_INET6 )
+	{
+		Com_Printf( "Sys_SendPacket (ipv6): %s\n", NET_ErrorString() );
+	}
+	else
+	{
+		Com_Printf( "Sys_SendPacket (%i): %s\n", family , NET_ErrorString() );
+	}
+}
+
+#ifdef __linux__
+/*
+==================
+NET_FlushSendBatchTo
+==================
+*/
+static void NET_FlushSendBatchTo( SOCKET sock, netSendBatch_t *batch )
+{
+	int sent = 0;
+
+	while ( sent < batch->count )
+	{
+		int ret = sendmmsg( sock, batch->headers + sent, batch->count - sent, 0 );
+
+		batchStats.sendCalls++;
+
+		if ( ret > 0 )
+		{
+			batchStats.sendPackets += ret;
+			sent += ret;
+			continue;
+		}
+
+		// report the packet that failed and go on with the rest
+		NET_SendError( socketError, batch->toType[ sent ], batch->to[ sent ].ss_family );
+		sent++;
+	}
+
+	batch->count = 0;
+}
+
+/*
+==================
+NET_QueueSendBatch
+
+Returns qfalse if the packet has to be sent on its own
+==================
+*/
+static qboolean NET_QueueSendBatch( SOCKET sock, netSendBatch_t *batch, int length, const void *data,
+                                    const struct sockaddr_storage *addr, socklen_t addrlen, netadrtype_t type )
+{
+	int i;
+
+	if ( !sendBatchOpen )
+	{
+		return qfalse;
+	}
+
+	if ( length > NET_SEND_BATCHED )
+	{
+		// keep the packets to the same address in order
+		NET_FlushSendBatchTo( sock, batch );
+		return qfalse;
+	}
+
+	if ( batch->count == NET_SEND_BATCH )
+	{
+		NET_FlushSendBatchTo( sock, batch );
+	}
+
+	i = batch->count++;
+	memcpy( batch->data[ i ], data, length );
+	memcpy( &batch->to[ i ], addr, addrlen );
+	batch->toType[ i ] = type;
+	batch->iovecs[ i ].iov_base = batch->data[ i ];
+	batch->iovecs[ i ].iov_len = length;
+	batch->headers[ i ].msg_hdr.msg_name = &batch->to[ i ];
+	batch->headers[ i ].msg_hdr.msg_namelen = addrlen;
+	batch->headers[ i ].msg_hdr.msg_iov = &batch->iovecs[ i ];
+	batch->headers[ i ].msg_hdr.msg_iovlen = 1;
+	batch->headers[ i ].msg_hdr.msg_control = NULL;
+	batch->headers[ i ].msg_hdr.msg_controllen = 0;
+	batch->headers[ i ].msg_hdr.msg_flags = 0;
+
+	return qtrue;
+}
+#endif
+
+/*
+==================
+NET_BeginSendBatch
+
+Holds back the packets sent until NET_FlushSendBatch
+==================
+*/
+void NET_BeginSendBatch( void )
+{
+	sendBatchOpen = qtrue;
+}
+
+/*
+==================
+NET_FlushSendBatch
+==================
+*/
+void NET_FlushSendBatch( void )
+{
+	sendBatchOpen = qfalse;
+
+#ifdef __linux__
+	if ( ip_socket != INVALID_SOCKET )
+	{
+		NET_FlushSendBatchTo( ip_socket, &ipSendBatch );
+	}
+
+	if ( ip6_socket != INVALID_SOCKET )
+	{
+		NET_FlushSendBatchTo( ip6_socket, &ip6SendBatch );
+	}
+
+	ipSendBatch.count = ip6SendBatch.count = 0;
+#endif
+}
+
+/*
+==================
+NET_GetBatchStats
+
+Packets and system calls since the last reset
+==================
+*/
+void NET_GetBatchStats( netBatchStats_t *stats, qboolean reset )
+{
+	*stats = batchStats;
+	stats->recvCalls = recvCalls;
+	stats->recvPackets = recvPackets;
+	stats->queueDrops = queueDrops;
+	stats->queryDrops = queryDrops;
+
+	if ( reset )
+	{
+		Com_Memset( &batchStats, 0, sizeof( batchStats ) );
+		recvCalls = recvPackets = 0;
+		queueDrops = queryDrops = 0;
+	}
+}
+
 /*
 ==================
 Sys_SendPacket
@@ -873,43 +1427,35 @@ void Sys_SendPacket( int length, const void *data, netadr_t to )
 	{
 		if ( addr.ss_family == AF_INET )
 		{
+#ifdef __linux__
+			if ( NET_QueueSendBatch( ip_socket, &ipSendBatch, length, data, &addr, sizeof( struct sockaddr_in ), to.type ) )
+			{
+				return;
+			}
+#endif
 			ret = sendto( ip_socket, ( const char* )data, length, 0, ( struct sockaddr * ) &addr, sizeof( struct sockaddr_in ) );
 		}
 		else if ( addr.ss_family == AF_INET6 )
 		{
+#ifdef __linux__
+			if ( NET_QueueSendBatch( ip6_socket, &ip6SendBatch, length, data, &addr, sizeof( struct sockaddr_in6 ), to.type ) )
+			{
+				return;
+			}
+#endif
 			ret = sendto( ip6_socket, ( const char* )data, length, 0, ( struct sockaddr * ) &addr, sizeof( struct sockaddr_in6 ) );
 		}
 	}
 
+	batchStats.sendCalls++;
+
 	if ( ret == SOCKET_ERROR )
 	{
-		int err = socketError;
-
-		// wouldblock is silent
-		if ( err == EAGAIN )
-		{
-			return;
-		}
-
-		// some PPP links do not allow broadcasts and return an error
-		if ( ( err == EADDRNOTAVAIL ) && ( ( to.type == NA_BROADCAST ) ) )
-		{
-			return;
-		}
-
-		if ( addr.ss_family == AF_INET )
-		{
-			Com_Printf( "Sys_SendPacket (ipv4): %s\n", NET_ErrorString() );
-		}
-		else if ( addr.ss_family == AF_INET6 )
-		{
-			Com_Printf( "Sys_SendPacket (ipv6): %s\n", NET_ErrorString() );
-		}
-		else
-		{
-			Com_Printf( "Sys_SendPacket (%i): %s\n", addr.ss_family , NET_ErrorString() );
-		}
+		NET_SendError( socketError, to.type, addr.ss_family );
+		return;
 	}
+
+	batchStats.sendPackets++;
 }
 
 //=============================================================================
@@ -1864,6 +2410,14 @@ static qboolean NET_GetCvars( void )
 	modified += net_socksPassword->modified;
 	net_socksPassword->modified = qfalse;
 
+	net_thread = Cvar_Get( "net_thread", "0", CVAR_LATCH );
+	modified += net_thread->modified;
+	net_thread->modified = qfalse;
+
+	net_threadQueries = Cvar_Get( "net_threadQueries", "200", CVAR_LATCH );
+	modified += net_threadQueries->modified;
+	net_threadQueries->modified = qfalse;
+
 	return modified ? qtrue : qfalse;
 }
 
@@ -1933,6 +2487,14 @@ void NET_Config( qboolean enableNetworking )
 
 	if ( stop )
 	{
+		NET_StopThread();
+		NET_FlushSendBatch();
+
+#ifdef __linux__
+		ipRecvBatch.count = ipRecvBatch.next = 0;
+		ip6RecvBatch.count = ip6RecvBatch.next = 0;
+#endif
+
 		if ( ip_socket != INVALID_SOCKET )
 		{
 			closesocket( ip_socket );
@@ -1968,6 +2530,7 @@ void NET_Config( qboolean enableNetworking )
 		{
 			NET_OpenIP();
 			NET_SetMulticast6();
+			NET_StartThread();
 		}
 	}
 }
@@ -2068,11 +2631,6 @@ Sleeps msec or until something happens on the network
 */
 void NET_Sleep( int msec )
 {
-	struct timeval timeout;
-
-	fd_set         fdset;
-	SOCKET         highestfd = INVALID_SOCKET;
-
 	if ( !com_dedicated->integer )
 	{
 		return; // we're not a server, just run full speed
@@ -2088,28 +2646,17 @@ void NET_Sleep( int msec )
 		return;
 	}
 
-	FD_ZERO( &fdset );
-
-	if ( ip_socket != INVALID_SOCKET )
-	{
-		FD_SET( ip_socket, &fdset );
-
-		highestfd = ip_socket;
-	}
-
-	if ( ip6_socket != INVALID_SOCKET )
+	if ( netThreadRunning )
 	{
-		FD_SET( ip6_socket, &fdset );
+		std::unique_lock<std::mutex> lock( netWakeMutex );
 
-		if ( highestfd == INVALID_SOCKET || ip6_socket > highestfd )
-		{
-			highestfd = ip6_socket;
-		}
+		netWake.wait_for( lock, std::chrono::milliseconds( msec ), [] {
+			return netQueue.head.load() != netQueue.tail.load();
+		} );
+		return;
 	}
 
-	timeout.tv_sec = msec / 1000;
-	timeout.tv_usec = ( msec % 1000 ) * 1000;
-	select( highestfd + 1, &fdset, NULL, NULL, &timeout );
+	NET_Select( msec );
 }
 
 /*
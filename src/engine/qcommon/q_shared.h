@@ -155,6 +155,7 @@ typedef int intptr_t;
 #include <numeric>
 #include <thread>
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
 #include <valarray>
 #include <sstream>
@@ -2130,6 +2131,7 @@ void         ByteToDir( int b, vec3_t dir );
 #define SNAPFLAG_RATE_DELAYED 1
 #define SNAPFLAG_NOT_ACTIVE   2 // snapshot used during connection and for zombies
 #define SNAPFLAG_SERVERCOUNT  4 // toggled every map_restart so transitions can be detected
+#define SNAPFLAG_QUANTIZED    8 // entity positions and angles are quantized, for clients with cl_quantizeEntities
 
 //
 // per-level limits
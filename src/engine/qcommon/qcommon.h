@@ -55,6 +55,7 @@ typedef struct
     int      uncompsize; // NERVE - SMF - net debugging
     int      readcount;
     int      bit; // for bitwise reads and writes
+    qboolean quantized; // entity positions and angles are quantized, see MSG_WriteDeltaEntity
 } msg_t;
 
 void MSG_Init( msg_t *buf, byte *data, int length );
@@ -78,6 +79,8 @@ struct entityState_s;
 struct playerState_s;
 
 void  MSG_WriteBits( msg_t *msg, int value, int bits );
+void  MSG_GetCodedBits( const msg_t *msg, int start, byte *data, int bits );
+void  MSG_WriteCodedBits( msg_t *msg, const byte *data, int bits, int uncompbits );
 
 void  MSG_WriteChar( msg_t *sb, int c );
 void  MSG_WriteByte( msg_t *sb, int c );
@@ -112,9 +115,21 @@ void  MSG_ReadDeltaUsercmdKey( msg_t *msg, int key, usercmd_t *from, usercmd_t *
 void  MSG_WriteDeltaEntity( msg_t *msg, struct entityState_s *from, struct entityState_s *to, qboolean force );
 void  MSG_ReadDeltaEntity( msg_t *msg, entityState_t *from, entityState_t *to, int number );
 
-void  MSG_WriteDeltaPlayerstate( msg_t *msg, struct playerState_s *from, struct playerState_s *to );
+void  MSG_WriteDeltaPlayerstate( msg_t *msg, const struct playerState_s *from, struct playerState_s *to );
 void  MSG_ReadDeltaPlayerstate( msg_t *msg, struct playerState_s *from, struct playerState_s *to );
 
+typedef struct
+{
+	const char *name;
+	int        count; // times the field was sent
+	int        bits;
+} msgFieldStats_t;
+
+void  MSG_SetFieldStats( qboolean enable );
+qboolean MSG_FieldStatsEnabled( void );
+int   MSG_GetFieldStats( qboolean playerState, msgFieldStats_t *stats, int maxStats, qboolean reset );
+void  MSG_MeasureQuantization( entityState_t *from, entityState_t *to );
+
 //============================================================================
 
 /*
@@ -210,6 +225,20 @@ void       NET_LeaveMulticast6( void );
 
 void       NET_Sleep( int msec );
 
+typedef struct
+{
+    int recvCalls;
+    int recvPackets;
+    int sendCalls;
+    int sendPackets;
+    int queueDrops; // packets the network thread had no room for
+    int queryDrops; // queries over net_threadQueries
+} netBatchStats_t;
+
+void       NET_BeginSendBatch( void );
+void       NET_FlushSendBatch( void );
+void       NET_GetBatchStats( netBatchStats_t *stats, qboolean reset );
+
 #ifdef HAVE_GEOIP
 const char *NET_GeoIP_Country( const netadr_t *a );
 #endif
@@ -548,6 +577,16 @@ void FS_FreeFile( void *buffer );
 
 // frees the memory returned by FS_ReadFile
 
+int  FS_MapFile( const char *qpath, const void **buffer );
+
+// like FS_ReadFile, but files stored uncompressed in a pak are not copied,
+// the buffer points into the memory mapped pak. The buffer is read-only and
+// is not null terminated.
+
+void FS_UnmapFile( const void *buffer );
+
+// releases the buffer returned by FS_MapFile
+
 void FS_WriteFile( const char *qpath, const void *buffer, int size );
 
 // writes a complete file, creating any subdirectories needed
@@ -1065,6 +1104,16 @@ typedef struct
     huff_t decompressor;
 } huffman_t;
 
+#define HUFF_LOOKUP_BITS 11 /* codes up to this long are decoded with one lookup */
+
+/* code tables compiled from a tree that isn't updated any more */
+typedef struct
+{
+    uint32_t code[ HMAX ]; /* first bit sent in bit 0 */
+    byte     length[ HMAX ]; /* 0 if the tree has to be walked */
+    uint16_t decode[ 1 << HUFF_LOOKUP_BITS ]; /* symbol | length << 8, 0 if longer */
+} huffCodes_t;
+
 void             Huff_Compress( msg_t *buf, int offset );
 void             Huff_Decompress( msg_t *buf, int offset );
 void             Huff_Init( huffman_t *huff );
@@ -1075,6 +1124,11 @@ void             Huff_offsetReceive( node_t *node, int *ch, byte *fin, int *offs
 void             Huff_offsetTransmit( huff_t *huff, int ch, byte *fout, int *offset );
 void             Huff_putBit( int bit, byte *fout, int *offset );
 int              Huff_getBit( byte *fout, int *offset );
+void             Huff_putBits( uint64_t value, int bits, byte *fout, int *offset );
+uint32_t         Huff_getBits( const byte *fin, int *offset, int bits );
+void             Huff_BuildCodes( const huff_t *huff, huffCodes_t *codes );
+void             Huff_tableTransmit( const huffCodes_t *codes, huff_t *huff, int ch, byte *fout, int *offset );
+void             Huff_tableReceive( const huffCodes_t *codes, node_t *tree, int *ch, byte *fin, int *offset, int size );
 
 // don't use if you don't know what you're doing.
 int              Huff_getBloc( void );
@@ -6785,10 +6785,10 @@ Called directly from cgame
 */
 void RE_LoadWorldMap( const char *name )
 {
-	int       i;
-	dheader_t *header;
-	byte      *buffer;
-	byte      *startMarker;
+	int        i;
+	dheader_t  header;
+	const void *buffer;
+	byte       *startMarker;
 
 	if ( tr.worldMapLoaded )
 	{
@@ -6832,7 +6832,7 @@ void RE_LoadWorldMap( const char *name )
 	tr.worldMapLoaded = qtrue;
 
 	// load it
-	ri.FS_ReadFile( name, ( void ** ) &buffer );
+	ri.FS_MapFile( name, &buffer );
 
 	if ( !buffer )
 	{
@@ -6855,14 +6855,15 @@ void RE_LoadWorldMap( const char *name )
 
 	startMarker = (byte*) ri.Hunk_Alloc( 0, h_low );
 
-	header = ( dheader_t * ) buffer;
-	fileBase = ( byte * ) header;
+	// the file may be mapped read-only, so the header is swapped in a copy
+	Com_Memcpy( &header, buffer, sizeof( header ) );
+	fileBase = ( byte * ) buffer;
 
-	i = LittleLong( header->version );
+	i = LittleLong( header.version );
 
 	if ( i != BSP_VERSION && i != BSP_VERSION_Q3 )
 	{
-		ri.FS_FreeFile( buffer );
+		ri.FS_UnmapFile( buffer );
 		ri.Error( ERR_DROP, "RE_LoadWorldMap: %s has wrong version number (%i should be %i for ET or %i for Q3)",
 		          name, i, BSP_VERSION, BSP_VERSION_Q3 );
 	}
@@ -6870,32 +6871,32 @@ void RE_LoadWorldMap( const char *name )
 	// swap all the lumps
 	for ( i = 0; i < sizeof( dheader_t ) / 4; i++ )
 	{
-		( ( int * ) header ) [ i ] = LittleLong( ( ( int * ) header ) [ i ] );
+		( ( int * ) &header ) [ i ] = LittleLong( ( ( int * ) &header ) [ i ] );
 	}
 
 	// load into heap
-	R_LoadEntities( &header->lumps[ LUMP_ENTITIES ] );
+	R_LoadEntities( &header.lumps[ LUMP_ENTITIES ] );
 
-	R_LoadShaders( &header->lumps[ LUMP_SHADERS ] );
+	R_LoadShaders( &header.lumps[ LUMP_SHADERS ] );
 
-	R_LoadLightmaps( &header->lumps[ LUMP_LIGHTMAPS ], name );
+	R_LoadLightmaps( &header.lumps[ LUMP_LIGHTMAPS ], name );
 
-	R_LoadPlanes( &header->lumps[ LUMP_PLANES ] );
+	R_LoadPlanes( &header.lumps[ LUMP_PLANES ] );
 
-	R_LoadSurfaces( &header->lumps[ LUMP_SURFACES ], &header->lumps[ LUMP_DRAWVERTS ], &header->lumps[ LUMP_DRAWINDEXES ] );
+	R_LoadSurfaces( &header.lumps[ LUMP_SURFACES ], &header.lumps[ LUMP_DRAWVERTS ], &header.lumps[ LUMP_DRAWINDEXES ] );
 
-	R_LoadMarksurfaces( &header->lumps[ LUMP_LEAFSURFACES ] );
+	R_LoadMarksurfaces( &header.lumps[ LUMP_LEAFSURFACES ] );
 
-	R_LoadNodesAndLeafs( &header->lumps[ LUMP_NODES ], &header->lumps[ LUMP_LEAFS ] );
+	R_LoadNodesAndLeafs( &header.lumps[ LUMP_NODES ], &header.lumps[ LUMP_LEAFS ] );
 
-	R_LoadSubmodels( &header->lumps[ LUMP_MODELS ] );
+	R_LoadSubmodels( &header.lumps[ LUMP_MODELS ] );
 
 	// moved fog lump loading here, so fogs can be tagged with a model num
-	R_LoadFogs( &header->lumps[ LUMP_FOGS ], &header->lumps[ LUMP_BRUSHES ], &header->lumps[ LUMP_BRUSHSIDES ] );
+	R_LoadFogs( &header.lumps[ LUMP_FOGS ], &header.lumps[ LUMP_BRUSHES ], &header.lumps[ LUMP_BRUSHSIDES ] );
 
-	R_LoadVisibility( &header->lumps[ LUMP_VISIBILITY ] );
+	R_LoadVisibility( &header.lumps[ LUMP_VISIBILITY ] );
 
-	R_LoadLightGrid( &header->lumps[ LUMP_LIGHTGRID ] );
+	R_LoadLightGrid( &header.lumps[ LUMP_LIGHTGRID ] );
 
 	// create a static vbo for the world
 	R_CreateWorldVBO();
@@ -6930,5 +6931,5 @@ void RE_LoadWorldMap( const char *name )
 	ClearLink( &tr.occlusionQueryQueue );
 	ClearLink( &tr.occlusionQueryList );
 
-	ri.FS_FreeFile( buffer );
+	ri.FS_UnmapFile( buffer );
 }
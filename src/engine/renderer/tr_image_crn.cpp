@@ -37,7 +37,7 @@ void LoadCRN( const char *name, byte **data, int *width, int *height,
 
 	*numLayers = 0;
 
-	buffLen = ri.FS_ReadFile( name, ( void ** ) &buff );
+	buffLen = ri.FS_MapFile( name, ( const void ** ) &buff );
 
 	if ( !buff )
 	{
@@ -47,7 +47,7 @@ void LoadCRN( const char *name, byte **data, int *width, int *height,
 	if( !crnd::crnd_get_texture_info( buff, buffLen, &ti ) ||
 	    ( ti.m_faces != 1 && ti.m_faces != 6 ) )
 	{
-		ri.FS_FreeFile( buff );
+		ri.FS_UnmapFile( buff );
 		return;
 	}
 
@@ -65,7 +65,7 @@ void LoadCRN( const char *name, byte **data, int *width, int *height,
 		*bits |= IF_BC5;
 		break;
 	default:
-		ri.FS_FreeFile( buff );
+		ri.FS_UnmapFile( buff );
 		return;
 	}
 
@@ -96,5 +96,5 @@ void LoadCRN( const char *name, byte **data, int *width, int *height,
 	}
 	crnd::crnd_unpack_end( ctx );
 
-	ri.FS_FreeFile( buff );
+	ri.FS_UnmapFile( buff );
 }
@@ -112,7 +112,7 @@ void LoadJPG( const char *filename, unsigned char **pic, int *width, int *height
 	 * requires it in order to read binary files.
 	 */
 
-	len = ri.FS_ReadFile( ( char * ) filename, &fbuffer.v );
+	len = ri.FS_MapFile( filename, ( const void ** ) &fbuffer.v );
 
 	if ( !fbuffer.b || len < 0 )
 	{
@@ -183,7 +183,7 @@ void LoadJPG( const char *filename, unsigned char **pic, int *width, int *height
 	     || pixelcount > 0x1FFFFFFF || cinfo.output_components != 3 )
 	{
 		// Free the memory to make sure we don't leak memory
-		ri.FS_FreeFile( fbuffer.v );
+		ri.FS_UnmapFile( fbuffer.v );
 		jpeg_destroy_decompress( &cinfo );
 #if JPEG_LIB_VERSION < 80
 		fclose( jpegfd );
@@ -256,7 +256,7 @@ void LoadJPG( const char *filename, unsigned char **pic, int *width, int *height
 #if JPEG_LIB_VERSION < 80
 	fclose( jpegfd );
 #endif
-	ri.FS_FreeFile( fbuffer.v );
+	ri.FS_UnmapFile( fbuffer.v );
 
 	/* At this point you may want to check to see whether any corrupt-data
 	 * warnings occurred (test whether jerr.pub.num_warnings is nonzero).
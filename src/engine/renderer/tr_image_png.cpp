@@ -67,7 +67,7 @@ void LoadPNG( const char *name, byte **pic, int *width, int *height,
 	byte         *out;
 
 	// load png
-	ri.FS_ReadFile( name, ( void ** ) &data );
+	ri.FS_MapFile( name, ( const void ** ) &data );
 
 	if ( !data )
 	{
@@ -79,7 +79,7 @@ void LoadPNG( const char *name, byte **pic, int *width, int *height,
 	if ( !png )
 	{
 		ri.Printf( PRINT_WARNING, "LoadPNG: png_create_write_struct() failed for (%s)\n", name );
-		ri.FS_FreeFile( data );
+		ri.FS_UnmapFile( data );
 		return;
 	}
 
@@ -89,7 +89,7 @@ void LoadPNG( const char *name, byte **pic, int *width, int *height,
 	if ( !info )
 	{
 		ri.Printf( PRINT_WARNING, "LoadPNG: png_create_info_struct() failed for (%s)\n", name );
-		ri.FS_FreeFile( data );
+		ri.FS_UnmapFile( data );
 		png_destroy_read_struct( &png, ( png_infopp ) NULL, ( png_infopp ) NULL );
 		return;
 	}
@@ -103,7 +103,7 @@ void LoadPNG( const char *name, byte **pic, int *width, int *height,
 	{
 		// if we get here, we had a problem reading the file
 		ri.Printf( PRINT_WARNING, "LoadPNG: first exception handler called for (%s)\n", name );
-		ri.FS_FreeFile( data );
+		ri.FS_UnmapFile( data );
 		png_destroy_read_struct( &png, ( png_infopp ) & info, ( png_infopp ) NULL );
 		return;
 	}
@@ -170,7 +170,7 @@ void LoadPNG( const char *name, byte **pic, int *width, int *height,
 	{
 		ri.Printf( PRINT_WARNING, "LoadPNG: second exception handler called for (%s)\n", name );
 		ri.Hunk_FreeTempMemory( row_pointers );
-		ri.FS_FreeFile( data );
+		ri.FS_UnmapFile( data );
 		png_destroy_read_struct( &png, ( png_infopp ) & info, ( png_infopp ) NULL );
 		return;
 	}
@@ -190,7 +190,7 @@ void LoadPNG( const char *name, byte **pic, int *width, int *height,
 	png_destroy_read_struct( &png, &info, ( png_infopp ) NULL );
 
 	ri.Hunk_FreeTempMemory( row_pointers );
-	ri.FS_FreeFile( data );
+	ri.FS_UnmapFile( data );
 }
 
 /*
@@ -44,7 +44,7 @@ void LoadTGA( const char *name, byte **pic, int *width, int *height,
 	//
 	// load the file
 	//
-	ri.FS_ReadFile( ( char * ) name, ( void ** ) &buffer );
+	ri.FS_MapFile( name, ( const void ** ) &buffer );
 
 	if ( !buffer )
 	{
@@ -75,19 +75,19 @@ void LoadTGA( const char *name, byte **pic, int *width, int *height,
 
 	if ( targa_header.image_type != 2 && targa_header.image_type != 10 && targa_header.image_type != 3 )
 	{
-		ri.FS_FreeFile( buffer );
+		ri.FS_UnmapFile( buffer );
 		ri.Error( ERR_DROP, "LoadTGA: Only type 2 (RGB), 3 (gray), and 10 (RGB) TGA images supported (%s)", name );
 	}
 
 	if ( targa_header.colormap_type != 0 )
 	{
-		ri.FS_FreeFile( buffer );
+		ri.FS_UnmapFile( buffer );
 		ri.Error( ERR_DROP, "LoadTGA: colormaps not supported (%s)", name );
 	}
 
 	if ( ( targa_header.pixel_size != 32 && targa_header.pixel_size != 24 ) && targa_header.image_type != 3 )
 	{
-		ri.FS_FreeFile( buffer );
+		ri.FS_UnmapFile( buffer );
 		ri.Error( ERR_DROP, "LoadTGA: Only 32 or 24 bit images supported (no colormaps) (%s)", name );
 	}
 
@@ -107,7 +107,7 @@ void LoadTGA( const char *name, byte **pic, int *width, int *height,
 
 	if ( !columns || !rows || numPixels > 0x7FFFFFFF || numPixels / columns / 4 != rows )
 	{
-		ri.FS_FreeFile( buffer );
+		ri.FS_UnmapFile( buffer );
 		ri.Error( ERR_DROP, "LoadTGA: %s has an invalid image size", name );
 	}
 
@@ -166,7 +166,7 @@ void LoadTGA( const char *name, byte **pic, int *width, int *height,
 
 					default:
 						ri.Free( targa_rgba );
-						ri.FS_FreeFile( buffer );
+						ri.FS_UnmapFile( buffer );
 						ri.Error( ERR_DROP, "LoadTGA: illegal pixel_size '%d' in file '%s'", targa_header.pixel_size, name );
 				}
 			}
@@ -212,7 +212,7 @@ void LoadTGA( const char *name, byte **pic, int *width, int *height,
 
 						default:
 							ri.Free( targa_rgba );
-							ri.FS_FreeFile( buffer );
+							ri.FS_UnmapFile( buffer );
 							ri.Error( ERR_DROP, "LoadTGA: illegal pixel_size '%d' in file '%s'", targa_header.pixel_size, name );
 					}
 
@@ -272,7 +272,7 @@ void LoadTGA( const char *name, byte **pic, int *width, int *height,
 
 							default:
 								ri.Free( targa_rgba );
-								ri.FS_FreeFile( buffer );
+								ri.FS_UnmapFile( buffer );
 								ri.Error( ERR_DROP,
 								          "LoadTGA: illegal pixel_size '%d' in file '%s'", targa_header.pixel_size, name );
 						}
@@ -329,5 +329,5 @@ breakOut:
 		ri.Hunk_FreeTempMemory( flip );
 	}
 
-	ri.FS_FreeFile( buffer );
+	ri.FS_UnmapFile( buffer );
 }
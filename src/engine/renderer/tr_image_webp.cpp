@@ -45,7 +45,7 @@ void LoadWEBP( const char *filename, unsigned char **pic, int *width, int *heigh
 	} fbuffer;
 
 	/* read compressed data */
-	len = ri.FS_ReadFile( ( char * ) filename, &fbuffer.v );
+	len = ri.FS_MapFile( filename, ( const void ** ) &fbuffer.v );
 
 	if ( !fbuffer.b || len < 0 )
 	{
@@ -55,7 +55,7 @@ void LoadWEBP( const char *filename, unsigned char **pic, int *width, int *heigh
 	/* validate data and query image size */
 	if ( !WebPGetInfo( fbuffer.b, len, width, height ) )
 	{
-		ri.FS_FreeFile( fbuffer.v );
+		ri.FS_UnmapFile( fbuffer.v );
 		return;
 	}
 
@@ -70,6 +70,6 @@ void LoadWEBP( const char *filename, unsigned char **pic, int *width, int *heigh
 		return;
 	}
 
-	ri.FS_FreeFile( fbuffer.v );
+	ri.FS_UnmapFile( fbuffer.v );
 	*pic = out;
 }
@@ -39,7 +39,7 @@ Maryland 20850 USA.
 #include "tr_types.h"
 #include "../../engine/botlib/bot_debug.h"
 
-#define REF_API_VERSION 10
+#define REF_API_VERSION 11
 
 // *INDENT-OFF*
 
@@ -254,6 +254,8 @@ typedef struct
 	int ( *FS_FileIsInPAK )( const char *name, int *pChecksum );
 	int ( *FS_ReadFile )( const char *name, void **buf );
 	void ( *FS_FreeFile )( void *buf );
+	int ( *FS_MapFile )( const char *name, const void **buf );
+	void ( *FS_UnmapFile )( const void *buf );
 	char           **( *FS_ListFiles )( const char *name, const char *extension, int *numfilesfound );
 	void ( *FS_FreeFileList )( char **filelist );
 	void ( *FS_WriteFile )( const char *qpath, const void *buffer, int size );
@@ -24,7 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../qcommon/vm_traps.h"
 #include "../botlib/bot_api.h"
 
-#define GAME_API_VERSION          1
+#define GAME_API_VERSION          4
 
 #define SVF_NOCLIENT              0x00000001
 #define SVF_CLIENTMASK            0x00000002
@@ -167,11 +167,12 @@ typedef enum gameImport_s
   BOT_DISABLE_AREA,
   BOT_ADD_OBSTACLE,
   BOT_REMOVE_OBSTACLE,
-  BOT_UPDATE_OBSTACLES
+  BOT_UPDATE_OBSTACLES,
+  BOT_UPDATE_PATHS
 } gameImport_t;
 
 // PrintMsg
-typedef IPC::Message<IPC::Id<VM::QVM, G_PRINT>, std::string> PrintMsg;
+typedef IPC::Message<IPC::Id<VM::QVM, G_PRINT>, IPC::StringView> PrintMsg;
 // ErrorMsg
 typedef IPC::Message<IPC::Id<VM::QVM, G_ERROR>, std::string> ErrorMsg;
 // LogMsg TODO
@@ -218,9 +219,9 @@ typedef IPC::Message<IPC::Id<VM::QVM, G_ADJUST_AREA_PORTAL_STATE>, int, bool> Ad
 // DropClientMsg
 typedef IPC::Message<IPC::Id<VM::QVM, G_DROP_CLIENT>, int, std::string> DropClientMsg;
 // SendServerCommandMsg
-typedef IPC::Message<IPC::Id<VM::QVM, G_SEND_SERVER_COMMAND>, int, std::string> SendServerCommandMsg;
+typedef IPC::Message<IPC::Id<VM::QVM, G_SEND_SERVER_COMMAND>, int, IPC::StringView> SendServerCommandMsg;
 // SetConfigStringMsg
-typedef IPC::Message<IPC::Id<VM::QVM, G_SET_CONFIGSTRING>, int, std::string> SetConfigStringMsg;
+typedef IPC::Message<IPC::Id<VM::QVM, G_SET_CONFIGSTRING>, int, IPC::StringView> SetConfigStringMsg;
 // GetConfigStringMsg
 typedef IPC::SyncMessage<
     IPC::Message<IPC::Id<VM::QVM, G_GET_CONFIGSTRING>, int, int>,
@@ -352,6 +353,11 @@ typedef IPC::SyncMessage<
 	IPC::Message<IPC::Id<VM::QVM, BOT_UPDATE_PATH>, int, botRouteTarget_t>,
 	IPC::Reply<botNavCmd_t>
 > BotUpdatePathMsg;
+// BotUpdatePathsMsg
+typedef IPC::SyncMessage<
+	IPC::Message<IPC::Id<VM::QVM, BOT_UPDATE_PATHS>, IPC::ArrayView<int>, IPC::ArrayView<botRouteTarget_t>>,
+	IPC::Reply<IPC::ArrayView<botNavCmd_t>>
+> BotUpdatePathsMsg;
 // BotNavRaycastMsg
 typedef IPC::SyncMessage<
 	IPC::Message<IPC::Id<VM::QVM, BOT_NAV_RAYCAST>, int, std::array<float, 3>, std::array<float, 3>>,
@@ -464,7 +470,7 @@ typedef IPC::SyncMessage<
 > GameClientDisconnectMsg;
 // GameClientCommandMsg
 typedef IPC::SyncMessage<
-	IPC::Message<IPC::Id<VM::QVM, GAME_CLIENT_COMMAND>, int, std::string>
+	IPC::Message<IPC::Id<VM::QVM, GAME_CLIENT_COMMAND>, int, IPC::StringView>
 > GameClientCommandMsg;
 // GameClientThinkMsg
 typedef IPC::SyncMessage<
@@ -66,7 +66,6 @@ typedef struct voipServerPacket_s
 typedef struct svEntity_s
 {
 	entityState_t        baseline; // for delta compression of initial sighting
-	int                  snapshotCounter; // used to prevent double adding from portal views
 } svEntity_t;
 
 typedef enum
@@ -83,7 +82,6 @@ typedef struct
 	int           serverId; // changes each server start
 	int           restartedServerId; // serverId before a map_restart
 	int           checksumFeed; // the feed key that we use to compute the pure checksum strings
-	int             snapshotCounter; // incremented for each snapshot built
 	int             timeResidual; // <= 1000 / sv_frame->value
 	int             nextFrameTime; // when time > nextFrameTime, process world
 	struct cmodel_s *models[ MAX_MODELS ];
@@ -157,6 +155,21 @@ typedef struct netchan_buffer_s
 	struct netchan_buffer_s *next;
 } netchan_buffer_t;
 
+#define NET_STATS_SIZE_BUCKETS 8 // messages below 64, 128, ... 4096 bytes and above
+
+typedef struct
+{
+	int messages;
+	int bytes;
+	int maxSize;
+	int sizeHistogram[ NET_STATS_SIZE_BUCKETS ];
+	int snapshots;
+	int deltaSnapshots; // the others were full snapshots
+	int fragments; // packets sent as fragments of a larger message
+	int drops; // packets from the client that never arrived
+	int chokes; // server frames the next snapshot waited for the rate
+} clientNetStats_t;
+
 typedef struct client_s
 {
 	clientState_t  state;
@@ -214,6 +227,9 @@ typedef struct client_s
 	int              ping;
 	int              rate; // bytes / second
 	int              snapshotMsec; // requests a snapshot every snapshotMsec unless rate choked
+	int              entitySentTime[ MAX_GENTITIES ]; // svs.time each entity's state was last sent, for sv_snapshotBudget
+	clientNetStats_t netStats; // since the last sv_netTelemetry report
+	qboolean         quantizeEntities; // client can read SNAPFLAG_QUANTIZED snapshots
 	netchan_t        netchan;
 	// TTimo
 	// queuing outgoing fragmented messages to send them properly, without udp packet bursts
@@ -272,13 +288,19 @@ typedef struct
 typedef struct
 {
 	netadr_t adr;
-	int      time;
-} receipt_t;
+	int      time; // when tokens was last topped up
+	float    tokens;
+} queryBucket_t;
 
 // MAX_INFO_RECEIPTS is the maximum number of getstatus+getinfo responses that we send
 // in a two second time period.
 #define MAX_INFO_RECEIPTS 48
 
+// and MAX_ADDRESS_RECEIPTS the maximum sent to one address (or /24, /56 subnet)
+#define MAX_ADDRESS_RECEIPTS 3
+
+#define QUERY_BUCKETS 1024 // must be a power of two
+
 #define SERVER_PERFORMANCECOUNTER_FRAMES  600
 #define SERVER_PERFORMANCECOUNTER_SAMPLES 6
 
@@ -297,7 +319,11 @@ typedef struct
 	entityState_t *snapshotEntities; // [numSnapshotEntities]
 	int           nextHeartbeatTime;
 	challenge_t   challenges[ MAX_CHALLENGES ]; // to prevent invalid IP addresses from connecting
-	receipt_t     infoReceipts[ MAX_INFO_RECEIPTS ];
+	queryBucket_t queryBuckets[ QUERY_BUCKETS ]; // token buckets for getstatus+getinfo, by address
+	queryBucket_t queryBucketAll;
+
+	int           queryCacheHits; // getstatus+getinfo answered without building the response
+	int           queryCacheBuilds;
 
 	int       sampleTimes[ SERVER_PERFORMANCECOUNTER_SAMPLES ];
 	int       currentSampleIndex;
@@ -340,6 +366,9 @@ private:
 
 	IPC::SharedMemory shmRegion;
 
+	// Reply of BOT_UPDATE_PATHS, kept so that it doesn't allocate every frame
+	std::vector<botNavCmd_t> botNavCmds;
+
     std::unique_ptr<VM::CommonVMServices> services;
 };
 
@@ -363,6 +392,14 @@ extern cvar_t         *sv_statsURL;
 extern cvar_t         *sv_master[ MAX_MASTER_SERVERS ];
 extern cvar_t         *sv_reconnectlimit;
 extern cvar_t         *sv_padPackets;
+extern cvar_t         *sv_snapshotThreads;
+extern cvar_t         *sv_snapshotBudget;
+extern cvar_t         *sv_deltaCache;
+extern cvar_t         *sv_quantizeEntities;
+extern cvar_t         *sv_netTelemetry;
+extern cvar_t         *sv_netTelemetryInterval;
+extern cvar_t         *sv_netTelemetryFile;
+extern cvar_t         *sv_netTelemetryMaxSize;
 extern cvar_t         *sv_killserver;
 extern cvar_t         *sv_mapname;
 extern cvar_t         *sv_mapChecksum;
@@ -415,6 +452,7 @@ void       SV_RemoveOperatorCommands( void );
 
 void       SV_MasterHeartbeat( const char *hbname );
 void       SV_MasterShutdown( void );
+void       SV_InvalidateQueryCache( void );
 void       SV_MasterGameStat( const char *data );
 
 //bani - bugtraq 12534
@@ -576,6 +614,13 @@ void     SV_Netchan_TransmitNextFragment( client_t *client );
 qboolean SV_Netchan_Process( client_t *client, msg_t *msg );
 void     SV_Netchan_FreeQueue( client_t *client );
 
+//
+// sv_telemetry.c
+//
+qboolean SV_NetTelemetryEnabled( void );
+void     SV_NetTelemetryFrame( void );
+void     SV_ShutdownNetTelemetry( void );
+
 //bani - cl->downloadnotify
 #define DLNOTIFY_REDIRECT 0x00000001 // "Redirecting client ..."
 #define DLNOTIFY_BEGIN    0x00000002 // "clientDownload: 4 : beginning ..."
@@ -277,10 +277,11 @@ static void SV_Status_f( void )
 
 	Com_Printf( "cpu utilization  : %3i%%\n"
 	            "avg response time: %i ms\n"
+	            "query cache      : %i hits, %i builds\n"
 	            "map: %s\n"
 	            "num score ping name            lastmsg address               qport rate\n"
 	            "--- ----- ---- --------------- ------- --------------------- ----- -----\n",
-	           ( int ) cpu, ( int ) avg, sv_mapname->string );
+	           ( int ) cpu, ( int ) avg, svs.queryCacheHits, svs.queryCacheBuilds, sv_mapname->string );
 
 	for ( i = 0, cl = svs.clients; i < sv_maxclients->integer; i++, cl++ )
 	{
@@ -388,6 +389,31 @@ static void SV_Systeminfo_f( void )
 	Info_Print( Cvar_InfoString( CVAR_SYSTEMINFO, qfalse ) );
 }
 
+/*
+===========
+SV_NetStats_f
+
+Shows how many packets each socket system call moved, "reset" starts counting again
+===========
+*/
+static void SV_NetStats_f( void )
+{
+	netBatchStats_t stats;
+	qboolean        reset = Cmd_Argc() > 1 && !Q_stricmp( Cmd_Argv( 1 ), "reset" );
+
+	NET_GetBatchStats( &stats, reset );
+
+	Com_Printf( "received %i packets in %i calls (%.2f per call)\n", stats.recvPackets, stats.recvCalls,
+	            stats.recvCalls ? ( float ) stats.recvPackets / stats.recvCalls : 0.0f );
+	Com_Printf( "sent %i packets in %i calls (%.2f per call)\n", stats.sendPackets, stats.sendCalls,
+	            stats.sendCalls ? ( float ) stats.sendPackets / stats.sendCalls : 0.0f );
+
+	if ( stats.queueDrops || stats.queryDrops )
+	{
+		Com_Printf( "network thread dropped %i packets for a full queue and %i queries\n", stats.queueDrops, stats.queryDrops );
+	}
+}
+
 /*
 =================
 SV_KillServer
@@ -412,6 +438,7 @@ void SV_AddOperatorCommands( void )
 		Cmd_AddCommand( "heartbeat",   SV_Heartbeat_f );
 		Cmd_AddCommand( "killserver",  SV_KillServer_f );
 		Cmd_AddCommand( "map_restart", SV_MapRestart_f );
+		Cmd_AddCommand( "netstats",    SV_NetStats_f );
 		//Cmd_AddCommand( "sectorlist",  SV_SectorList_f );
 		Cmd_AddCommand( "serverinfo",  SV_Serverinfo_f );
 		Cmd_AddCommand( "status",      SV_Status_f );
@@ -431,6 +458,7 @@ void SV_RemoveOperatorCommands( void )
 	Cmd_RemoveCommand( "heartbeat" );
 	Cmd_RemoveCommand( "killserver" );
 	Cmd_RemoveCommand( "map_restart" );
+	Cmd_RemoveCommand( "netstats" );
 	Cmd_RemoveCommand( "say" );
 	Cmd_RemoveCommand( "sectorlist" );
 	Cmd_RemoveCommand( "serverinfo" );
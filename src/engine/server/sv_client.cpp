@@ -1325,6 +1325,10 @@ void SV_UserinfoChanged( client_t *cl )
 		cl->snapshotMsec = 50;
 	}
 
+	// protocol extension, see MSG_WriteQuantizedFloat
+	val = Info_ValueForKey( cl->userinfo, "cl_quantizeEntities" );
+	cl->quantizeEntities = ( atoi( val ) == 1 ) ? qtrue : qfalse;
+
 #ifdef USE_VOIP
 	// in the future, (val) will be a protocol version string, so only
 	//  accept explicitly 1, not generally non-zero.
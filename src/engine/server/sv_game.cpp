@@ -617,7 +617,7 @@ void GameVM::QVMSyscall(int index, IPC::Reader& reader, IPC::Channel& channel)
 {
 	switch (index) {
 	case G_PRINT:
-		IPC::HandleMsg<PrintMsg>(channel, std::move(reader), [this](std::string text) {
+		IPC::HandleMsg<PrintMsg>(channel, std::move(reader), [this](IPC::StringView text) {
 			Com_Printf("%s", text.c_str());
 		});
 		break;
@@ -713,13 +713,13 @@ void GameVM::QVMSyscall(int index, IPC::Reader& reader, IPC::Channel& channel)
 		break;
 
 	case G_SEND_SERVER_COMMAND:
-		IPC::HandleMsg<SendServerCommandMsg>(channel, std::move(reader), [this](int clientNum, std::string text) {
+		IPC::HandleMsg<SendServerCommandMsg>(channel, std::move(reader), [this](int clientNum, IPC::StringView text) {
 			SV_GameSendServerCommand(clientNum, text.c_str());
 		});
 		break;
 
 	case G_SET_CONFIGSTRING:
-		IPC::HandleMsg<SetConfigStringMsg>(channel, std::move(reader), [this](int index, std::string val) {
+		IPC::HandleMsg<SetConfigStringMsg>(channel, std::move(reader), [this](int index, IPC::StringView val) {
 			SV_SetConfigstring(index, val.c_str());
 		});
 		break;
@@ -930,6 +930,15 @@ void GameVM::QVMSyscall(int index, IPC::Reader& reader, IPC::Channel& channel)
 		});
 		break;
 
+	case BOT_UPDATE_PATHS:
+		IPC::HandleMsg<BotUpdatePathsMsg>(channel, std::move(reader), [this](IPC::ArrayView<int> clientNums, IPC::ArrayView<botRouteTarget_t> targets, IPC::ArrayView<botNavCmd_t>& cmds) {
+			size_t count = std::min(clientNums.size(), targets.size());
+			botNavCmds.resize(count);
+			BotUpdateCorridors(count, clientNums.data(), targets.data(), botNavCmds.data());
+			cmds = botNavCmds;
+		});
+		break;
+
 	case BOT_NAV_RAYCAST:
 		IPC::HandleMsg<BotNavRaycastMsg>(channel, std::move(reader), [this](int clientNum, std::array<float, 3> start, std::array<float, 3> end, int& res, botTrace_t& botTrace) {
 			res = BotNavTrace(clientNum, &botTrace, start.data(), end.data());
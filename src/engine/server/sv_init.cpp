@@ -588,9 +588,9 @@ void SV_SpawnServer( const char *server )
 	if (!FS_LoadPak(va("map-%s", server)))
 		Com_Error(ERR_DROP, "Could not load map pak\n");
 
-	void* buffer;
+	const void* buffer;
 	const char* name = va( "maps/%s.bsp", server );
-	FS_ReadFile( name, ( void ** ) &buffer );
+	FS_MapFile( name, &buffer );
 
 	if ( !buffer )
 	{
@@ -599,7 +599,7 @@ void SV_SpawnServer( const char *server )
 
 	CM_LoadMap( name, buffer, qfalse );
 
-	FS_FreeFile( buffer );
+	FS_UnmapFile( buffer );
 
 	// set serverinfo visible name
 	Cvar_Set( "mapname", server );
@@ -703,6 +703,7 @@ void SV_SpawnServer( const char *server )
 
 	SV_SetConfigstring( CS_SERVERINFO, Cvar_InfoString( CVAR_SERVERINFO, qfalse ) );
 	cvar_modifiedFlags &= ~CVAR_SERVERINFO;
+	SV_InvalidateQueryCache();
 
 	// any media configstring setting now should issue a warning
 	// and any configstring changes should be reliably transmitted
@@ -781,6 +782,14 @@ void SV_Init( void )
 	sv_master[ 4 ] = Cvar_Get( "sv_master5", "", 0 );
 	sv_reconnectlimit = Cvar_Get( "sv_reconnectlimit", "3", 0 );
 	sv_padPackets = Cvar_Get( "sv_padPackets", "0", 0 );
+	sv_snapshotThreads = Cvar_Get( "sv_snapshotThreads", "0", 0 );
+	sv_snapshotBudget = Cvar_Get( "sv_snapshotBudget", "0", 0 );
+	sv_deltaCache = Cvar_Get( "sv_deltaCache", "1", 0 );
+	sv_quantizeEntities = Cvar_Get( "sv_quantizeEntities", "0", 0 );
+	sv_netTelemetry = Cvar_Get( "sv_netTelemetry", "0", 0 );
+	sv_netTelemetryInterval = Cvar_Get( "sv_netTelemetryInterval", "60", 0 );
+	sv_netTelemetryFile = Cvar_Get( "sv_netTelemetryFile", "nettelemetry.json", 0 );
+	sv_netTelemetryMaxSize = Cvar_Get( "sv_netTelemetryMaxSize", "4096", 0 );
 	sv_killserver = Cvar_Get( "sv_killserver", "0", 0 );
 
 	sv_lanForceRate = Cvar_Get( "sv_lanForceRate", "1", 0 );
@@ -874,6 +883,7 @@ void SV_Shutdown( const char *finalmsg )
 
 	SV_RemoveOperatorCommands();
 	SV_MasterShutdown();
+	SV_ShutdownNetTelemetry();
 	SV_ShutdownGameProgs();
 
 	// free current level
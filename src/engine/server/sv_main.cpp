@@ -58,6 +58,14 @@ cvar_t         *sv_statsURL;
 cvar_t         *sv_master[ MAX_MASTER_SERVERS ]; // master server IP addresses
 cvar_t         *sv_reconnectlimit; // minimum seconds between connect messages
 cvar_t         *sv_padPackets; // add nop bytes to messages
+cvar_t         *sv_snapshotThreads; // threads building and encoding client snapshots
+cvar_t         *sv_snapshotBudget; // percentage of the rate entity updates may take, 0 for no limit
+cvar_t         *sv_deltaCache; // reuse the coded entity deltas between clients
+cvar_t         *sv_quantizeEntities; // quantize entity positions and angles for the clients supporting it
+cvar_t         *sv_netTelemetry; // 1: write per client network stats, 2: also per field bits
+cvar_t         *sv_netTelemetryInterval; // seconds between reports
+cvar_t         *sv_netTelemetryFile;
+cvar_t         *sv_netTelemetryMaxSize; // KB before the file is rotated
 cvar_t         *sv_killserver; // menu system can set to 1 to shut server down
 cvar_t         *sv_mapname;
 cvar_t         *sv_serverid;
@@ -459,39 +467,167 @@ qboolean SV_VerifyChallenge( const char *challenge )
 	return qtrue;
 }
 
+/*
+=============================================================================
+
+Query cache
+
+Browsers and master servers send many more getstatus and getinfo queries
+than anything changes on a server, so the responses, minus the challenge
+they echo back, are kept until a serverinfo cvar, a player or one of the
+other settings in them changes. Players and settings are compared at most
+once per frame, and pings only in steps of QUERY_PING_STEP msec.
+
+=============================================================================
+*/
+
+#define QUERY_PING_STEP 50
+
+typedef struct
+{
+	qboolean connected;
+	qboolean bot;
+	int      score;
+	int      pingStep;
+	char     name[ MAX_NAME_LENGTH ];
+} queryClient_t;
+
+static struct
+{
+	qboolean      valid;
+	int           checkTime; // svs.time of the last comparison
+
+	// what the responses were built from
+	int           serverLoad;
+	int           pure;
+	int           voip;
+	int           minPing;
+	int           maxPing;
+	int           privateClients;
+	int           hostname;
+	int           statsURL;
+	queryClient_t clients[ MAX_CLIENTS ];
+
+	char          serverInfo[ MAX_INFO_STRING ]; // for statusResponse
+	char          players[ MAX_MSGLEN ];
+	char          info[ MAX_INFO_STRING ]; // infoResponse after the challenges
+} queryCache;
+
 /*
 ================
-SVC_Status
+SV_InvalidateQueryCache
+================
+*/
+void SV_InvalidateQueryCache( void )
+{
+	queryCache.valid = qfalse;
+}
 
-Responds with all the info that qplug or qspy can see about the server
-and all connected players.  Used for getting detailed information after
-the simple info query.
+/*
+================
+SV_QueryCacheKey
 ================
 */
-void SVC_Status( netadr_t from )
+static void SV_QueryCacheKey( int *cached, int value )
+{
+	if ( *cached != value )
+	{
+		*cached = value;
+		queryCache.valid = qfalse;
+	}
+}
+
+/*
+================
+SV_CheckQueryCache
+
+Invalidates the responses if anything in them changed
+================
+*/
+static void SV_CheckQueryCache( void )
 {
-	char          player[ 1024 ];
-	char          status[ MAX_MSGLEN ];
 	int           i;
 	client_t      *cl;
+	queryClient_t *qc;
+
+	if ( cvar_modifiedFlags & CVAR_SERVERINFO )
+	{
+		queryCache.valid = qfalse;
+	}
+
+	if ( queryCache.valid && queryCache.checkTime == svs.time )
+	{
+		return;
+	}
+
+	queryCache.checkTime = svs.time;
+
+	SV_QueryCacheKey( &queryCache.serverLoad, svs.serverLoad );
+	SV_QueryCacheKey( &queryCache.pure, sv_pure->integer );
+#ifdef USE_VOIP
+	SV_QueryCacheKey( &queryCache.voip, sv_voip->integer );
+#endif
+	SV_QueryCacheKey( &queryCache.minPing, sv_minPing->integer );
+	SV_QueryCacheKey( &queryCache.maxPing, sv_maxPing->integer );
+	SV_QueryCacheKey( &queryCache.privateClients, sv_privateClients->integer );
+	SV_QueryCacheKey( &queryCache.hostname, sv_hostname->modificationCount );
+	SV_QueryCacheKey( &queryCache.statsURL, sv_statsURL->modificationCount );
+
+	for ( i = 0; i < sv_maxclients->integer; i++ )
+	{
+		queryClient_t current;
+
+		cl = &svs.clients[ i ];
+		qc = &queryCache.clients[ i ];
+
+		Com_Memset( &current, 0, sizeof( current ) );
+
+		if ( cl->state >= CS_CONNECTED )
+		{
+			current.connected = qtrue;
+			current.bot = cl->gentity && ( cl->gentity->r.svFlags & SVF_BOT );
+			current.score = SV_GameClientNum( i )->persistant[ PERS_SCORE ];
+			current.pingStep = cl->ping / QUERY_PING_STEP;
+			Q_strncpyz( current.name, cl->name, sizeof( current.name ) );
+		}
+
+		if ( memcmp( &current, qc, sizeof( current ) ) )
+		{
+			*qc = current;
+			queryCache.valid = qfalse;
+		}
+	}
+}
+
+/*
+================
+SV_UpdateQueryCache
+================
+*/
+static void SV_UpdateQueryCache( void )
+{
+	char          player[ 1024 ];
+	int           i, count, botCount;
+	client_t      *cl;
 	playerState_t *ps;
 	int           statusLength;
 	int           playerLength;
-	char          infostring[ MAX_INFO_STRING ];
+	char          *infostring = queryCache.info;
 
-	//bani - bugtraq 12534
-	if ( !SV_VerifyChallenge( Cmd_Argv( 1 ) ) )
+	SV_CheckQueryCache();
+
+	if ( queryCache.valid )
 	{
+		svs.queryCacheHits++;
 		return;
 	}
 
-	Q_strncpyz( infostring, Cvar_InfoString( CVAR_SERVERINFO, qfalse ), MAX_INFO_STRING );
+	svs.queryCacheBuilds++;
 
-	// echo back the parameter to status. so master servers can use it as a challenge
-	// to prevent timed spoofed reply packets that add ghost servers
-	Info_SetValueForKey( infostring, "challenge", Cmd_Argv( 1 ), qfalse );
+	// statusResponse
+	Q_strncpyz( queryCache.serverInfo, Cvar_InfoString( CVAR_SERVERINFO, qfalse ), MAX_INFO_STRING );
 
-	status[ 0 ] = 0;
+	queryCache.players[ 0 ] = 0;
 	statusLength = 0;
 
 	for ( i = 0; i < sv_maxclients->integer; i++ )
@@ -504,17 +640,102 @@ void SVC_Status( netadr_t from )
 			Com_sprintf( player, sizeof( player ), "%i %i \"%s\"\n", ps->persistant[ PERS_SCORE ], cl->ping, cl->name );
 			playerLength = strlen( player );
 
-			if ( statusLength + playerLength >= sizeof( status ) )
+			if ( statusLength + playerLength >= sizeof( queryCache.players ) )
 			{
 				break; // can't hold any more
 			}
 
-			strcpy( status + statusLength, player );
+			strcpy( queryCache.players + statusLength, player );
 			statusLength += playerLength;
 		}
 	}
 
-	NET_OutOfBandPrint( NS_SERVER, from, "statusResponse\n%s\n%s", infostring, status );
+	// infoResponse, don't count privateclients
+	botCount = count = 0;
+
+	for ( i = sv_privateClients->integer; i < sv_maxclients->integer; i++ )
+	{
+		if ( svs.clients[ i ].state >= CS_CONNECTED )
+		{
+			if ( svs.clients[ i ].gentity && ( svs.clients[ i ].gentity->r.svFlags & SVF_BOT ) )
+			{
+				++botCount;
+			}
+			else
+			{
+				++count;
+			}
+		}
+	}
+
+	infostring[ 0 ] = 0;
+
+	Info_SetValueForKey( infostring, "protocol", va( "%i", PROTOCOL_VERSION ), qfalse );
+	Info_SetValueForKey( infostring, "hostname", sv_hostname->string, qfalse );
+	Info_SetValueForKey( infostring, "serverload", va( "%i", svs.serverLoad ), qfalse );
+	Info_SetValueForKey( infostring, "mapname", sv_mapname->string, qfalse );
+	Info_SetValueForKey( infostring, "clients", va( "%i", count ), qfalse );
+	Info_SetValueForKey( infostring, "bots", va( "%i", botCount ), qfalse );
+	Info_SetValueForKey( infostring, "sv_maxclients", va( "%i", sv_maxclients->integer - sv_privateClients->integer ), qfalse );
+	Info_SetValueForKey( infostring, "pure", va( "%i", sv_pure->integer ), qfalse );
+
+	if ( sv_statsURL->string[0] )
+	{
+		Info_SetValueForKey( infostring, "stats", sv_statsURL->string, qfalse );
+	}
+
+#ifdef USE_VOIP
+
+	if ( sv_voip->integer )
+	{
+		Info_SetValueForKey( infostring, "voip", va( "%i", sv_voip->integer ), qfalse );
+	}
+
+#endif
+
+	if ( sv_minPing->integer )
+	{
+		Info_SetValueForKey( infostring, "minPing", va( "%i", sv_minPing->integer ), qfalse );
+	}
+
+	if ( sv_maxPing->integer )
+	{
+		Info_SetValueForKey( infostring, "maxPing", va( "%i", sv_maxPing->integer ), qfalse );
+	}
+
+	Info_SetValueForKey( infostring, "gamename", GAMENAME_STRING, qfalse );  // Arnout: to be able to filter out Quake servers
+
+	queryCache.valid = qtrue;
+}
+
+/*
+================
+SVC_Status
+
+Responds with all the info that qplug or qspy can see about the server
+and all connected players.  Used for getting detailed information after
+the simple info query.
+================
+*/
+void SVC_Status( netadr_t from )
+{
+	char infostring[ MAX_INFO_STRING ];
+
+	//bani - bugtraq 12534
+	if ( !SV_VerifyChallenge( Cmd_Argv( 1 ) ) )
+	{
+		return;
+	}
+
+	SV_UpdateQueryCache();
+
+	Q_strncpyz( infostring, queryCache.serverInfo, MAX_INFO_STRING );
+
+	// echo back the parameter to status. so master servers can use it as a challenge
+	// to prevent timed spoofed reply packets that add ghost servers
+	Info_SetValueForKey( infostring, "challenge", Cmd_Argv( 1 ), qfalse );
+
+	NET_OutOfBandPrint( NS_SERVER, from, "statusResponse\n%s\n%s", infostring, queryCache.players );
 }
 
 /*
@@ -527,7 +748,7 @@ if a user is interested in a server to do a full status
 */
 void SVC_Info( netadr_t from )
 {
-	int  i, count, botCount;
+	int  i;
 	char infostring[ MAX_INFO_STRING ];
 
 	const char *challenge;
@@ -552,24 +773,6 @@ void SVC_Info( netadr_t from )
 
 	SV_ResolveMasterServers();
 
-	// don't count privateclients
-	botCount = count = 0;
-
-	for ( i = sv_privateClients->integer; i < sv_maxclients->integer; i++ )
-	{
-		if ( svs.clients[ i ].state >= CS_CONNECTED )
-		{
-			if ( svs.clients[ i ].gentity && ( svs.clients[ i ].gentity->r.svFlags & SVF_BOT ) )
-			{
-				++botCount;
-			}
-			else
-			{
-				++count;
-			}
-		}
-	}
-
 	infostring[ 0 ] = 0;
 
 	// echo back the parameter to status. so servers can use it as a challenge
@@ -603,42 +806,82 @@ void SVC_Info( netadr_t from )
 		strcpy( challenges[ i ].text, challenge );
 	}
 
-	Info_SetValueForKey( infostring, "protocol", va( "%i", PROTOCOL_VERSION ), qfalse );
-	Info_SetValueForKey( infostring, "hostname", sv_hostname->string, qfalse );
-	Info_SetValueForKey( infostring, "serverload", va( "%i", svs.serverLoad ), qfalse );
-	Info_SetValueForKey( infostring, "mapname", sv_mapname->string, qfalse );
-	Info_SetValueForKey( infostring, "clients", va( "%i", count ), qfalse );
-	Info_SetValueForKey( infostring, "bots", va( "%i", botCount ), qfalse );
-	Info_SetValueForKey( infostring, "sv_maxclients", va( "%i", sv_maxclients->integer - sv_privateClients->integer ), qfalse );
-	Info_SetValueForKey( infostring, "pure", va( "%i", sv_pure->integer ), qfalse );
+	SV_UpdateQueryCache();
+	Q_strcat( infostring, sizeof( infostring ), queryCache.info );
 
-	if ( sv_statsURL->string[0] )
-	{
-		Info_SetValueForKey( infostring, "stats", sv_statsURL->string, qfalse );
-	}
+	NET_OutOfBandPrint( NS_SERVER, from, "infoResponse\n%s", infostring );
+}
 
-#ifdef USE_VOIP
+/*
+=================
+SV_TakeQueryToken
 
-	if ( sv_voip->integer )
+Buckets refill completely in two seconds, and start out full
+=================
+*/
+static qboolean SV_TakeQueryToken( queryBucket_t *bucket, int capacity )
+{
+	if ( !bucket->time )
 	{
-		Info_SetValueForKey( infostring, "voip", va( "%i", sv_voip->integer ), qfalse );
+		bucket->tokens = capacity;
+	}
+	else
+	{
+		bucket->tokens = std::min( ( float ) capacity, bucket->tokens + ( svs.time - bucket->time ) * capacity / 2000.0f );
 	}
 
-#endif
+	bucket->time = svs.time;
 
-	if ( sv_minPing->integer )
+	return bucket->tokens >= 1.0f;
+}
+
+/*
+=================
+SV_QueryBucket
+
+Finds the bucket of an address, taking over the least recently used one
+of the slots it may be in if it has none
+=================
+*/
+static queryBucket_t *SV_QueryBucket( netadr_t from )
+{
+	queryBucket_t *bucket, *oldest = NULL;
+	unsigned      hash = from.type;
+	int           i;
+
+	if ( from.type == NA_IP )
 	{
-		Info_SetValueForKey( infostring, "minPing", va( "%i", sv_minPing->integer ), qfalse );
+		for ( i = 0; i < 4; i++ )
+		{
+			hash = hash * 31 + from.ip[ i ];
+		}
 	}
-
-	if ( sv_maxPing->integer )
+	else
 	{
-		Info_SetValueForKey( infostring, "maxPing", va( "%i", sv_maxPing->integer ), qfalse );
+		for ( i = 0; i < 16; i++ )
+		{
+			hash = hash * 31 + from.ip6[ i ];
+		}
 	}
 
-	Info_SetValueForKey( infostring, "gamename", GAMENAME_STRING, qfalse );  // Arnout: to be able to filter out Quake servers
+	for ( i = 0; i < 4; i++ )
+	{
+		bucket = &svs.queryBuckets[ ( hash + i ) & ( QUERY_BUCKETS - 1 ) ];
 
-	NET_OutOfBandPrint( NS_SERVER, from, "infoResponse\n%s", infostring );
+		if ( bucket->time && NET_CompareBaseAdr( from, bucket->adr ) )
+		{
+			return bucket;
+		}
+
+		if ( !oldest || bucket->time < oldest->time )
+		{
+			oldest = bucket;
+		}
+	}
+
+	oldest->adr = from;
+	oldest->time = 0;
+	return oldest;
 }
 
 /*
@@ -650,19 +893,18 @@ See here: http://www.lemuria.org/security/application-drdos.html
 
 Returns qfalse if we're good.  qtrue return value means we need to block.
 If the address isn't NA_IP, it's automatically denied.
+
+Both the server as a whole and every address have a token bucket, so
+answers can come in bursts but not faster than MAX_INFO_RECEIPTS and
+MAX_ADDRESS_RECEIPTS every two seconds.
 =================
 */
 qboolean SV_CheckDRDoS( netadr_t from )
 {
-	int        i;
-	int        globalCount;
-	int        specificCount;
-	receipt_t  *receipt;
-	netadr_t   exactFrom;
-	int        oldest;
-	int        oldestTime;
-	static int lastGlobalLogTime = 0;
-	static int lastSpecificLogTime = 0;
+	queryBucket_t *bucket;
+	netadr_t      exactFrom;
+	static int    lastGlobalLogTime = 0;
+	static int    lastSpecificLogTime = 0;
 
 	// Usually the network is smart enough to not allow incoming UDP packets
 	// with a source address being a spoofed LAN address.  Even if that's not
@@ -688,42 +930,7 @@ qboolean SV_CheckDRDoS( netadr_t from )
 		return qtrue;
 	}
 
-	// Count receipts in last 2 seconds.
-	globalCount = 0;
-	specificCount = 0;
-	receipt = &svs.infoReceipts[ 0 ];
-	oldest = 0;
-	oldestTime = 0x7fffffff;
-
-	for ( i = 0; i < MAX_INFO_RECEIPTS; i++, receipt++ )
-	{
-		if ( receipt->time + 2000 > svs.time )
-		{
-			if ( receipt->time )
-			{
-				// When the server starts, all receipt times are at zero.  Furthermore,
-				// svs.time is close to zero.  We check that the receipt time is already
-				// set so that during the first two seconds after server starts, queries
-				// from the master servers don't get ignored.  As a consequence a potentially
-				// unlimited number of getinfo+getstatus responses may be sent during the
-				// first frame of a server's life.
-				globalCount++;
-			}
-
-			if ( NET_CompareBaseAdr( from, receipt->adr ) )
-			{
-				specificCount++;
-			}
-		}
-
-		if ( receipt->time < oldestTime )
-		{
-			oldestTime = receipt->time;
-			oldest = i;
-		}
-	}
-
-	if ( globalCount == MAX_INFO_RECEIPTS ) // All receipts happened in last 2 seconds.
+	if ( !SV_TakeQueryToken( &svs.queryBucketAll, MAX_INFO_RECEIPTS ) )
 	{
 		if ( lastGlobalLogTime + 1000 <= svs.time ) // Limit one log every second.
 		{
@@ -734,7 +941,9 @@ qboolean SV_CheckDRDoS( netadr_t from )
 		return qtrue;
 	}
 
-	if ( specificCount >= 3 ) // Already sent 3 to this IP address in last 2 seconds.
+	bucket = SV_QueryBucket( from );
+
+	if ( !SV_TakeQueryToken( bucket, MAX_ADDRESS_RECEIPTS ) )
 	{
 		if ( lastSpecificLogTime + 1000 <= svs.time ) // Limit one log every second.
 		{
@@ -746,9 +955,8 @@ qboolean SV_CheckDRDoS( netadr_t from )
 		return qtrue;
 	}
 
-	receipt = &svs.infoReceipts[ oldest ];
-	receipt->adr = from;
-	receipt->time = svs.time;
+	svs.queryBucketAll.tokens -= 1.0f;
+	bucket->tokens -= 1.0f;
 	return qfalse;
 }
 
@@ -855,14 +1063,35 @@ Clients that are in the game can still send
 connectionless packets.
 =================
 */
+static qboolean SV_IsQuery( const msg_t *msg, const char *query )
+{
+	int length = strlen( query );
+
+	if ( msg->cursize < 4 + length || Q_strnicmp( ( const char * ) msg->data + 4, query, length ) )
+	{
+		return qfalse;
+	}
+
+	return msg->cursize == 4 + length || msg->data[ 4 + length ] <= ' ';
+}
+
 void SV_ConnectionlessPacket( netadr_t from, msg_t *msg )
 {
-	char *s;
-	char *c;
+	char     *s;
+	char     *c;
+	qboolean limited = qfalse;
 
 	MSG_BeginReadingOOB( msg );
 	MSG_ReadLong( msg );  // skip the -1 marker
 
+	// rate limit the queries before doing any string work on them
+	if ( SV_IsQuery( msg, "getstatus" ) || SV_IsQuery( msg, "getinfo" ) )
+	{
+		if ( SV_CheckDRDoS( from ) ) { return; }
+
+		limited = qtrue;
+	}
+
 	if ( !Q_strncmp( "connect", ( char * ) &msg->data[ 4 ], 7 ) )
 	{
 		Huff_Decompress( msg, 12 );
@@ -877,13 +1106,13 @@ void SV_ConnectionlessPacket( netadr_t from, msg_t *msg )
 
 	if ( !Q_stricmp( c, "getstatus" ) )
 	{
-		if ( SV_CheckDRDoS( from ) ) { return; }
+		if ( !limited && SV_CheckDRDoS( from ) ) { return; }
 
 		SVC_Status( from );
 	}
 	else if ( !Q_stricmp( c, "getinfo" ) )
 	{
-		if ( SV_CheckDRDoS( from ) ) { return; }
+		if ( !limited && SV_CheckDRDoS( from ) ) { return; }
 
 		SVC_Info( from );
 	}
@@ -1292,6 +1521,7 @@ void SV_Frame( int msec )
 	{
 		SV_SetConfigstring( CS_SERVERINFO, Cvar_InfoString( CVAR_SERVERINFO, qfalse ) );
 		cvar_modifiedFlags &= ~CVAR_SERVERINFO;
+		SV_InvalidateQueryCache();
 	}
 
 	if ( cvar_modifiedFlags & CVAR_SYSTEMINFO )
@@ -1321,6 +1551,9 @@ void SV_Frame( int msec )
 
 		// let everything in the world think and move
 		gvm->GameRunFrame( sv.time );
+
+		// search the bot routes asked for in that frame
+		BotUpdateRouteQueue();
 	}
 
 	if ( com_speeds->integer )
@@ -1334,6 +1567,8 @@ void SV_Frame( int msec )
 	// send messages back to the clients
 	SV_SendClientMessages();
 
+	SV_NetTelemetryFrame();
+
 	// send a heartbeat to the master if needed
 	SV_MasterHeartbeat( HEARTBEAT_GAME );
 
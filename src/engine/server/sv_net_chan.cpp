@@ -189,6 +189,11 @@ void SV_Netchan_TransmitNextFragment( client_t *client )
 {
 	Netchan_TransmitNextFragment( &client->netchan );
 
+	if ( SV_NetTelemetryEnabled() )
+	{
+		client->netStats.fragments++;
+	}
+
 	while ( !client->netchan.unsentFragments && client->netchan_start_queue )
 	{
 		// make sure the netchan queue has been properly initialized (you never know)
@@ -210,6 +215,11 @@ void SV_Netchan_TransmitNextFragment( client_t *client )
 
 		Netchan_Transmit( &client->netchan, netbuf->msg.cursize, netbuf->msg.data );
 
+		if ( client->netchan.unsentFragments && SV_NetTelemetryEnabled() )
+		{
+			client->netStats.fragments++;
+		}
+
 		Z_Free( netbuf );
 	}
 }
@@ -289,11 +299,21 @@ void SV_Netchan_Transmit( client_t *client, msg_t *msg )
 
 		// emit the next fragment of the current message for now
 		Netchan_TransmitNextFragment( &client->netchan );
+
+		if ( SV_NetTelemetryEnabled() )
+		{
+			client->netStats.fragments++;
+		}
 	}
 	else
 	{
 		SV_Netchan_Encode( client, msg, client->lastClientCommandString );
 		Netchan_Transmit( &client->netchan, msg->cursize, msg->data );
+
+		if ( client->netchan.unsentFragments && SV_NetTelemetryEnabled() )
+		{
+			client->netStats.fragments++;
+		}
 	}
 }
 
@@ -313,6 +333,11 @@ qboolean SV_Netchan_Process( client_t *client, msg_t *msg )
 		return qfalse;
 	}
 
+	if ( SV_NetTelemetryEnabled() )
+	{
+		client->netStats.drops += client->netchan.dropped;
+	}
+
 	SV_Netchan_Decode( client, msg );
 
 	return qtrue;
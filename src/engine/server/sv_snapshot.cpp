@@ -33,6 +33,128 @@ Maryland 20850 USA.
 */
 
 #include "server.h"
+#include "../framework/WorkerPool.h"
+
+/*
+=============================================================================
+
+Entity delta cache
+
+Clients seeing the same entity usually delta it from the same state, so
+the coded bits of each delta are kept and copied into the messages of the
+next clients needing it.  The huffman codes are fixed, so the bits don't
+depend on where they end up in the message.  Entries are keyed by the whole
+from and to states, which keeps them valid from one frame to the next.
+
+=============================================================================
+*/
+
+#define DELTA_CACHE_SIZE  4096 // power of two
+#define DELTA_CACHE_BYTES 96 // longer deltas are not cached
+#define DELTA_CACHE_LOCKS 64
+
+typedef struct
+{
+	uint32_t      hash;
+	qboolean      used;
+	qboolean      force;
+	qboolean      quantized;
+	entityState_t from;
+	entityState_t to;
+	int           bits;
+	int           uncompbits;
+	byte          data[ DELTA_CACHE_BYTES + 8 ]; // Huff_getBits may read a little further
+} deltaCacheEntry_t;
+
+static deltaCacheEntry_t deltaCache[ DELTA_CACHE_SIZE ];
+static std::mutex        deltaCacheLocks[ DELTA_CACHE_LOCKS ];
+static std::atomic<int>  deltaCacheLookups;
+static std::atomic<int>  deltaCacheHits;
+
+/*
+=============
+SV_QuantizeEntities
+
+Whether the client gets SNAPFLAG_QUANTIZED snapshots
+=============
+*/
+static qboolean SV_QuantizeEntities( const client_t *client )
+{
+	return sv_quantizeEntities->integer && client->quantizeEntities;
+}
+
+static uint32_t SV_HashEntityState( const entityState_t *s, uint32_t hash )
+{
+	const uint32_t *words = ( const uint32_t * ) s;
+	size_t         i;
+
+	for ( i = 0; i < sizeof( *s ) / 4; i++ )
+	{
+		hash = ( hash ^ words[ i ] ) * 16777619u;
+	}
+
+	return hash;
+}
+
+/*
+=============
+SV_WriteDeltaEntity
+
+MSG_WriteDeltaEntity going through the delta cache
+=============
+*/
+static void SV_WriteDeltaEntity( msg_t *msg, entityState_t *from, entityState_t *to, qboolean force )
+{
+	deltaCacheEntry_t *entry;
+	uint32_t          hash;
+	int               start, uncompstart;
+
+	// nothing is written for unchanged entities, which is cheaper to find out
+	if ( !sv_deltaCache->integer || sv_netTelemetry->integer >= 2 || ( !force && !memcmp( from, to, sizeof( *to ) ) ) )
+	{
+		MSG_WriteDeltaEntity( msg, from, to, force );
+		return;
+	}
+
+	hash = SV_HashEntityState( to, SV_HashEntityState( from, 2166136261u + force + 2 * msg->quantized ) );
+	entry = &deltaCache[ hash & ( DELTA_CACHE_SIZE - 1 ) ];
+
+	deltaCacheLookups++;
+
+	{
+		std::lock_guard<std::mutex> lock( deltaCacheLocks[ hash & ( DELTA_CACHE_LOCKS - 1 ) ] );
+
+		if ( entry->used && entry->hash == hash && entry->force == force && entry->quantized == msg->quantized &&
+		     !memcmp( &entry->to, to, sizeof( *to ) ) && !memcmp( &entry->from, from, sizeof( *from ) ) )
+		{
+			MSG_WriteCodedBits( msg, entry->data, entry->bits, entry->uncompbits );
+			deltaCacheHits++;
+			return;
+		}
+	}
+
+	start = msg->bit;
+	uncompstart = msg->uncompsize;
+
+	MSG_WriteDeltaEntity( msg, from, to, force );
+
+	if ( msg->overflowed || msg->bit - start > DELTA_CACHE_BYTES * 8 )
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock( deltaCacheLocks[ hash & ( DELTA_CACHE_LOCKS - 1 ) ] );
+
+	entry->used = qtrue;
+	entry->hash = hash;
+	entry->force = force;
+	entry->quantized = msg->quantized;
+	entry->from = *from;
+	entry->to = *to;
+	entry->bits = msg->bit - start;
+	entry->uncompbits = msg->uncompsize - uncompstart;
+	MSG_GetCodedBits( msg, start, entry->data, entry->bits );
+}
 
 /*
 =============================================================================
@@ -63,7 +185,7 @@ SV_EmitPacketEntities
 Writes a delta update of an entityState_t list to the message.
 =============
 */
-static void SV_EmitPacketEntities( const clientSnapshot_t *from, clientSnapshot_t *to, msg_t *msg )
+static void SV_EmitPacketEntities( const clientSnapshot_t *from, const clientSnapshot_t *to, msg_t *msg )
 {
 	entityState_t *oldent, *newent;
 	int           oldindex, newindex;
@@ -115,7 +237,7 @@ static void SV_EmitPacketEntities( const clientSnapshot_t *from, clientSnapshot_
 			// delta update from old position
 			// because the force parm is qfalse, this will not result
 			// in any bytes being emited if the entity has not changed at all
-			MSG_WriteDeltaEntity( msg, oldent, newent, qfalse );
+			SV_WriteDeltaEntity( msg, oldent, newent, qfalse );
 			oldindex++;
 			newindex++;
 			continue;
@@ -124,7 +246,7 @@ static void SV_EmitPacketEntities( const clientSnapshot_t *from, clientSnapshot_
 		if ( newnum < oldnum )
 		{
 			// this is a new entity, send it from the baseline
-			MSG_WriteDeltaEntity( msg, &sv.svEntities[ newnum ].baseline, newent, qtrue );
+			SV_WriteDeltaEntity( msg, &sv.svEntities[ newnum ].baseline, newent, qtrue );
 			newindex++;
 			continue;
 		}
@@ -143,18 +265,16 @@ static void SV_EmitPacketEntities( const clientSnapshot_t *from, clientSnapshot_
 
 /*
 ==================
-SV_WriteSnapshotToClient
+SV_SnapshotDeltaFrame
+
+Picks the frame the current snapshot is delta compressed against, snapshotEnd
+is svs.nextSnapshotEntities right after the current snapshot has been built
 ==================
 */
-static void SV_WriteSnapshotToClient( client_t *client, msg_t *msg )
+static clientSnapshot_t *SV_SnapshotDeltaFrame( client_t *client, int snapshotEnd, int *deltaFrame )
 {
-	clientSnapshot_t *frame, *oldframe;
+	clientSnapshot_t *oldframe;
 	int              lastframe;
-	int              i;
-	int              snapFlags;
-
-	// this is the snapshot we are creating
-	frame = &client->frames[ client->netchan.outgoingSequence & PACKET_MASK ];
 
 	// try to use a previous frame as the source for delta compressing the snapshot
 	if ( client->deltaMessage <= 0 || client->state != CS_ACTIVE )
@@ -177,7 +297,7 @@ static void SV_WriteSnapshotToClient( client_t *client, msg_t *msg )
 		lastframe = client->netchan.outgoingSequence - client->deltaMessage;
 
 		// the snapshot's entities may still have rolled off the buffer, though
-		if ( oldframe->first_entity <= svs.nextSnapshotEntities - svs.numSnapshotEntities )
+		if ( oldframe->first_entity <= snapshotEnd - svs.numSnapshotEntities )
 		{
 			Com_DPrintf( "%s^7: Delta request from out of date entities.\n", client->name );
 			oldframe = NULL;
@@ -185,6 +305,24 @@ static void SV_WriteSnapshotToClient( client_t *client, msg_t *msg )
 		}
 	}
 
+	*deltaFrame = lastframe;
+	return oldframe;
+}
+
+/*
+==================
+SV_WriteSnapshotToClient
+==================
+*/
+static void SV_WriteSnapshotToClient( client_t *client, const clientSnapshot_t *oldframe, int lastframe, msg_t *msg )
+{
+	clientSnapshot_t *frame;
+	int              i;
+	int              snapFlags;
+
+	// this is the snapshot we are creating
+	frame = &client->frames[ client->netchan.outgoingSequence & PACKET_MASK ];
+
 	MSG_WriteByte( msg, svc_snapshot );
 
 	// NOTE, MRE: now sent at the start of every message from server to client
@@ -198,6 +336,16 @@ static void SV_WriteSnapshotToClient( client_t *client, msg_t *msg )
 	// what we are delta'ing from
 	MSG_WriteByte( msg, lastframe );
 
+	if ( SV_NetTelemetryEnabled() )
+	{
+		client->netStats.snapshots++;
+
+		if ( oldframe )
+		{
+			client->netStats.deltaSnapshots++;
+		}
+	}
+
 	snapFlags = svs.snapFlagServerBit;
 
 	if ( client->rateDelayed )
@@ -210,6 +358,11 @@ static void SV_WriteSnapshotToClient( client_t *client, msg_t *msg )
 		snapFlags |= SNAPFLAG_NOT_ACTIVE;
 	}
 
+	if ( SV_QuantizeEntities( client ) )
+	{
+		snapFlags |= SNAPFLAG_QUANTIZED;
+	}
+
 	MSG_WriteByte( msg, snapFlags );
 
 	// send over the areabits
@@ -229,7 +382,9 @@ static void SV_WriteSnapshotToClient( client_t *client, msg_t *msg )
 	}
 
 	// delta encode the entities
+	msg->quantized = ( snapFlags & SNAPFLAG_QUANTIZED ) ? qtrue : qfalse;
 	SV_EmitPacketEntities( oldframe, frame, msg );
+	msg->quantized = qfalse;
 
 	// padding for rate debugging
 	if ( sv_padPackets->integer )
@@ -276,10 +431,21 @@ Build a client snapshot structure
 
 typedef struct
 {
-	int numSnapshotEntities;
-	int snapshotEntities[ MAX_SNAPSHOT_ENTITIES ];
+	int  numSnapshotEntities;
+	int  snapshotEntities[ MAX_SNAPSHOT_ENTITIES ];
+	byte added[ MAX_GENTITIES / 8 ]; // prevents double adding from portal views
 } snapshotEntityNumbers_t;
 
+static bool SV_SnapshotHasEntity( const snapshotEntityNumbers_t *eNums, int num )
+{
+	return ( eNums->added[ num >> 3 ] & ( 1 << ( num & 7 ) ) ) != 0;
+}
+
+static void SV_SnapshotMarkEntity( snapshotEntityNumbers_t *eNums, int num )
+{
+	eNums->added[ num >> 3 ] |= 1 << ( num & 7 );
+}
+
 /*
 =======================
 SV_QsortEntityNumbers
@@ -310,16 +476,15 @@ static int QDECL SV_QsortEntityNumbers( const void *a, const void *b )
 SV_AddEntToSnapshot
 ===============
 */
-static void SV_AddEntToSnapshot( sharedEntity_t *clientEnt, svEntity_t *svEnt, sharedEntity_t *gEnt,
-                                 snapshotEntityNumbers_t *eNums )
+static void SV_AddEntToSnapshot( sharedEntity_t *clientEnt, sharedEntity_t *gEnt, snapshotEntityNumbers_t *eNums )
 {
 	// if we have already added this entity to this snapshot, don't add again
-	if ( svEnt->snapshotCounter == sv.snapshotCounter )
+	if ( SV_SnapshotHasEntity( eNums, gEnt->s.number ) )
 	{
 		return;
 	}
 
-	svEnt->snapshotCounter = sv.snapshotCounter;
+	SV_SnapshotMarkEntity( eNums, gEnt->s.number );
 
 	// if we are full, silently discard entities
 	if ( eNums->numSnapshotEntities == MAX_SNAPSHOT_ENTITIES )
@@ -340,51 +505,80 @@ static void SV_AddEntToSnapshot( sharedEntity_t *clientEnt, svEntity_t *svEnt, s
 }
 
 /*
-===============
-SV_AddEntitiesVisibleFromPoint
-===============
+=============================================================================
+
+Snapshot visibility cache
+
+Most entities are sent to whoever can see them, which only depends on the
+area and PVS cluster the client is looking from. SV_SendClientMessages
+sorts the linked entities once per frame into those and the ones needing
+per-client checks (broadcast, in range, visibility dummies and portals),
+and the set of the plain ones visible from a cluster is worked out once for
+all the clients looking from it.
+
+The cache is only valid while SV_SendClientMessages runs, when the game
+can't move anything around; snapshots built at any other time go through
+all the entities.
+
+=============================================================================
 */
-static void SV_AddEntitiesVisibleFromPoint( vec3_t origin, clientSnapshot_t *frame,
-//                                  snapshotEntityNumbers_t *eNums, qboolean portal, clientSnapshot_t *oldframe, qboolean localClient ) {
-//                                  snapshotEntityNumbers_t *eNums, qboolean portal ) {
-    snapshotEntityNumbers_t *eNums /*, qboolean portal, qboolean localClient */ )
+
+#define MAX_SNAPSHOT_VIS_CLUSTERS ( MAX_CLIENTS * 2 )
+
+// handled per client rather than through the cluster cache
+#define SVF_SNAPSHOT_SPECIAL ( SVF_BROADCAST | SVF_CLIENTS_IN_RANGE | SVF_VISDUMMY | SVF_VISDUMMY_MULTIPLE | SVF_PORTAL )
+
+// sent to only some of the clients looking from a cluster
+#define SVF_SNAPSHOT_CLIENTS ( SVF_SINGLECLIENT | SVF_NOTSINGLECLIENT | SVF_CLIENTMASK )
+
+typedef struct
 {
-	int            e, i;
-	sharedEntity_t *ent, *playerEnt;
-	svEntity_t     *svEnt;
-	int            l;
-	int            clientarea, clientcluster;
-	int            leafnum;
-//	int             c_fullsend;
-	byte           *clientpvs;
-	byte           *bitvector;
+	int  cluster;
+	int  area;
+	byte entities[ MAX_GENTITIES / 8 ];
+} snapshotClusterVis_t;
 
-	// during an error shutdown message we may need to transmit
-	// the shutdown message after the server has shutdown, so
-	// specfically check for it
-	if ( !sv.state )
-	{
-		return;
-	}
+static struct
+{
+	qboolean             valid;
+	qboolean             haveCallbacks; // some entity needs the game to decide whether it is sent
 
-	leafnum = CM_PointLeafnum( origin );
-	clientarea = CM_LeafArea( leafnum );
-	clientcluster = CM_LeafCluster( leafnum );
+	int                  numPlain;
+	int                  plain[ MAX_GENTITIES ];
+	int                  numSpecial;
+	int                  special[ MAX_GENTITIES ];
 
-	// calculate the visible areas
-	frame->areabytes = CM_WriteAreaBits( frame->areabits, clientarea );
+	std::mutex           mutex; // guards numClusters, entries are never changed once added
+	int                  numClusters;
+	snapshotClusterVis_t clusters[ MAX_SNAPSHOT_VIS_CLUSTERS ];
+} snapshotVis;
 
-	clientpvs = CM_ClusterPVS( clientcluster );
+/*
+===============
+SV_PrepareSnapshotVisibility
 
-//	c_fullsend = 0;
+Sorts the entities that can be sent this frame
+===============
+*/
+static void SV_PrepareSnapshotVisibility( void )
+{
+	sharedEntity_t *ent;
+	int            e;
 
-	playerEnt = SV_GentityNum( frame->ps.clientNum );
+	snapshotVis.valid = qfalse;
 
-	if ( playerEnt->r.svFlags & SVF_SELF_PORTAL )
+	// during an error shutdown message we may need to transmit
+	// the shutdown message after the server has shutdown
+	if ( !sv.state )
 	{
-		SV_AddEntitiesVisibleFromPoint( playerEnt->s.origin2, frame, eNums );
+		return;
 	}
 
+	snapshotVis.haveCallbacks = qfalse;
+	snapshotVis.numPlain = 0;
+	snapshotVis.numSpecial = 0;
+	snapshotVis.numClusters = 0;
+
 	for ( e = 0; e < sv.num_entities; e++ )
 	{
 		ent = SV_GentityNum( e );
@@ -401,359 +595,925 @@ static void SV_AddEntitiesVisibleFromPoint( vec3_t origin, clientSnapshot_t *fra
 			ent->s.number = e;
 		}
 
+		if ( ent->r.snapshotCallback )
+		{
+			snapshotVis.haveCallbacks = qtrue;
+		}
+
 		// entities can be flagged to explicitly not be sent to the client
 		if ( ent->r.svFlags & SVF_NOCLIENT )
 		{
 			continue;
 		}
 
-		// entities can be flagged to be sent to only one client
-		if ( ent->r.svFlags & SVF_SINGLECLIENT )
+		if ( ent->r.svFlags & SVF_SNAPSHOT_SPECIAL )
 		{
-			if ( ent->r.singleClient != frame->ps.clientNum )
-			{
-				continue;
-			}
+			snapshotVis.special[ snapshotVis.numSpecial++ ] = e;
 		}
-
-		// entities can be flagged to be sent to everyone but one client
-		if ( ent->r.svFlags & SVF_NOTSINGLECLIENT )
+		else
 		{
-			if ( ent->r.singleClient == frame->ps.clientNum )
-			{
-				continue;
-			}
+			snapshotVis.plain[ snapshotVis.numPlain++ ] = e;
 		}
+	}
 
-		// entities can be flagged to be sent to only a given mask of clients
-		if ( ent->r.svFlags & SVF_CLIENTMASK )
-		{
-			if ( frame->ps.clientNum >= 32 )
-			{
-				if ( ~ent->r.hiMask & ( 1 << ( frame->ps.clientNum - 32 ) ) )
-				{
-					continue;
-				}
-			}
-			else
-			{
-				if ( ~ent->r.loMask & ( 1 << frame->ps.clientNum ) )
-				{
-					continue;
-				}
-			}
-		}
+	snapshotVis.valid = qtrue;
+}
 
-		svEnt = SV_SvEntityForGentity( ent );
+/*
+===============
+SV_ClearSnapshotVisibility
 
-		// don't double add an entity through portals
-		if ( svEnt->snapshotCounter == sv.snapshotCounter )
-		{
-			continue;
-		}
+Called when the entities may have changed
+===============
+*/
+static void SV_ClearSnapshotVisibility( void )
+{
+	snapshotVis.valid = qfalse;
+}
+
+/*
+===============
+SV_EntitySentToClient
 
-		// broadcast entities are always sent
-		if ( ent->r.svFlags & SVF_BROADCAST )
+Checks the flags limiting an entity to some of the clients
+===============
+*/
+static bool SV_EntitySentToClient( const sharedEntity_t *ent, int clientNum )
+{
+	// entities can be flagged to be sent to only one client
+	if ( ent->r.svFlags & SVF_SINGLECLIENT )
+	{
+		if ( ent->r.singleClient != clientNum )
 		{
-			SV_AddEntToSnapshot( playerEnt, svEnt, ent, eNums );
-			continue;
+			return false;
 		}
+	}
 
-		// send entity if the client is in range
-		if ( (ent->r.svFlags & SVF_CLIENTS_IN_RANGE) &&
-		     Distance( ent->s.origin, playerEnt->s.origin ) <= ent->r.clientRadius )
+	// entities can be flagged to be sent to everyone but one client
+	if ( ent->r.svFlags & SVF_NOTSINGLECLIENT )
+	{
+		if ( ent->r.singleClient == clientNum )
 		{
-			SV_AddEntToSnapshot( playerEnt, svEnt, ent, eNums );
-			continue;
+			return false;
 		}
+	}
 
-		bitvector = clientpvs;
-
-		// Gordon: just check origin for being in pvs, ignore bmodel extents
-		if ( ent->r.svFlags & SVF_IGNOREBMODELEXTENTS )
+	// entities can be flagged to be sent to only a given mask of clients
+	if ( ent->r.svFlags & SVF_CLIENTMASK )
+	{
+		if ( clientNum >= 32 )
 		{
-			if ( bitvector[ ent->r.originCluster >> 3 ] & ( 1 << ( ent->r.originCluster & 7 ) ) )
+			if ( ~ent->r.hiMask & ( 1 << ( clientNum - 32 ) ) )
 			{
-				SV_AddEntToSnapshot( playerEnt, svEnt, ent, eNums );
+				return false;
 			}
-
-			continue;
 		}
-
-		// ignore if not touching a PV leaf
-		// check area
-		if ( !CM_AreasConnected( clientarea, ent->r.areanum ) )
+		else
 		{
-			// doors can legally straddle two areas, so
-			// we may need to check another one
-			if ( !CM_AreasConnected( clientarea, ent->r.areanum2 ) )
+			if ( ~ent->r.loMask & ( 1 << clientNum ) )
 			{
-				continue;
+				return false;
 			}
 		}
+	}
+
+	return true;
+}
+
+/*
+===============
+SV_EntityInPVS
+===============
+*/
+static bool SV_EntityInPVS( const sharedEntity_t *ent, int clientarea, const byte *bitvector )
+{
+	int i, l;
+
+	// Gordon: just check origin for being in pvs, ignore bmodel extents
+	if ( ent->r.svFlags & SVF_IGNOREBMODELEXTENTS )
+	{
+		return ( bitvector[ ent->r.originCluster >> 3 ] & ( 1 << ( ent->r.originCluster & 7 ) ) ) != 0;
+	}
 
-		// check individual leafs
-		if ( !ent->r.numClusters )
+	// ignore if not touching a PV leaf
+	// check area
+	if ( !CM_AreasConnected( clientarea, ent->r.areanum ) )
+	{
+		// doors can legally straddle two areas, so
+		// we may need to check another one
+		if ( !CM_AreasConnected( clientarea, ent->r.areanum2 ) )
 		{
-			continue;
+			return false;
 		}
+	}
+
+	// check individual leafs
+	if ( !ent->r.numClusters )
+	{
+		return false;
+	}
 
-		l = 0;
+	l = 0;
 
-		for ( i = 0; i < ent->r.numClusters; i++ )
+	for ( i = 0; i < ent->r.numClusters; i++ )
+	{
+		l = ent->r.clusternums[ i ];
+
+		if ( bitvector[ l >> 3 ] & ( 1 << ( l & 7 ) ) )
 		{
-			l = ent->r.clusternums[ i ];
+			return true;
+		}
+	}
 
+	// if we haven't found it to be visible,
+	// check the overflow clusters that couldn't be stored
+	if ( ent->r.lastCluster )
+	{
+		for ( ; l <= ent->r.lastCluster; l++ )
+		{
 			if ( bitvector[ l >> 3 ] & ( 1 << ( l & 7 ) ) )
 			{
 				break;
 			}
 		}
 
-		// if we haven't found it to be visible,
-		// check the overflow clusters that couldn't be stored
-		if ( i == ent->r.numClusters )
+		if ( l != ent->r.lastCluster )
 		{
-			if ( ent->r.lastCluster )
-			{
-				for ( ; l <= ent->r.lastCluster; l++ )
-				{
-					if ( bitvector[ l >> 3 ] & ( 1 << ( l & 7 ) ) )
-					{
-						break;
-					}
-				}
-
-				if ( l == ent->r.lastCluster )
-				{
-					continue;
-				}
-			}
-			else
-			{
-				continue;
-			}
+			return true;
 		}
+	}
 
-		//----(SA) added "visibility dummies"
-		if ( ent->r.svFlags & SVF_VISDUMMY )
-		{
-			sharedEntity_t *ment = 0;
+	return false;
+}
 
-			//find master;
-			ment = SV_GentityNum( ent->s.otherEntityNum );
+/*
+===============
+SV_ClusterVisibleEntities
 
-			if ( ment )
-			{
-				svEntity_t *master = 0;
+Returns the plain entities visible from a cluster, as a bit vector. Safe to
+call from the snapshot workers.
+===============
+*/
+static const byte *SV_ClusterVisibleEntities( int clientcluster, int clientarea, const byte *clientpvs, byte *scratch )
+{
+	snapshotClusterVis_t *vis;
+	int                  i;
 
-				master = SV_SvEntityForGentity( ment );
+	{
+		std::lock_guard<std::mutex> lock( snapshotVis.mutex );
 
-				if ( master->snapshotCounter == sv.snapshotCounter || !ment->r.linked )
-				{
-					continue;
-				}
+		for ( i = 0; i < snapshotVis.numClusters; i++ )
+		{
+			vis = &snapshotVis.clusters[ i ];
 
-				SV_AddEntToSnapshot( playerEnt, master, ment, eNums );
+			if ( vis->cluster == clientcluster && vis->area == clientarea )
+			{
+				return vis->entities;
 			}
-
-			continue; // master needs to be added, but not this dummy ent
 		}
-		//----(SA) end
-		else if ( ent->r.svFlags & SVF_VISDUMMY_MULTIPLE )
-		{
-			{
-				int            h;
-				sharedEntity_t *ment = 0;
-				svEntity_t     *master = 0;
+	}
 
-				for ( h = 0; h < sv.num_entities; h++ )
-				{
-					ment = SV_GentityNum( h );
-
-					if ( ment == ent )
-					{
-						continue;
-					}
-
-					if ( ment )
-					{
-						master = SV_SvEntityForGentity( ment );
-					}
-					else
-					{
-						continue;
-					}
-
-					if ( !( ment->r.linked ) )
-					{
-						continue;
-					}
-
-					if ( ment->s.number != h )
-					{
-						Com_DPrintf( "FIXING vis dummy multiple ment->S.NUMBER!!!\n" );
-						ment->s.number = h;
-					}
-
-					if ( ment->r.svFlags & SVF_NOCLIENT )
-					{
-						continue;
-					}
-
-					if ( master->snapshotCounter == sv.snapshotCounter )
-					{
-						continue;
-					}
-
-					if ( ment->s.otherEntityNum == ent->s.number )
-					{
-						SV_AddEntToSnapshot( playerEnt, master, ment, eNums );
-					}
-				}
+	Com_Memset( scratch, 0, MAX_GENTITIES / 8 );
 
-				continue;
-			}
+	for ( i = 0; i < snapshotVis.numPlain; i++ )
+	{
+		int e = snapshotVis.plain[ i ];
+
+		if ( SV_EntityInPVS( SV_GentityNum( e ), clientarea, clientpvs ) )
+		{
+			scratch[ e >> 3 ] |= 1 << ( e & 7 );
 		}
+	}
 
-		// add it
-		SV_AddEntToSnapshot( playerEnt, svEnt, ent, eNums );
+	std::lock_guard<std::mutex> lock( snapshotVis.mutex );
 
-		// if it's a portal entity, add everything visible from its camera position
-		if ( ent->r.svFlags & SVF_PORTAL )
-		{
-			if ( ent->s.generic1 )
-			{
-				vec3_t dir;
-				VectorSubtract( ent->s.origin, origin, dir );
+	// another worker may have got there first
+	for ( i = 0; i < snapshotVis.numClusters; i++ )
+	{
+		vis = &snapshotVis.clusters[ i ];
 
-				if ( VectorLengthSquared( dir ) > ( float ) ent->s.generic1 * ent->s.generic1 )
-				{
-					continue;
-				}
+		if ( vis->cluster == clientcluster && vis->area == clientarea )
+		{
+			return vis->entities;
+		}
+	}
+
+	if ( snapshotVis.numClusters == MAX_SNAPSHOT_VIS_CLUSTERS )
+	{
+		return scratch;
+	}
+
+	vis = &snapshotVis.clusters[ snapshotVis.numClusters ];
+	vis->cluster = clientcluster;
+	vis->area = clientarea;
+	Com_Memcpy( vis->entities, scratch, sizeof( vis->entities ) );
+	snapshotVis.numClusters++;
+
+	return vis->entities;
+}
+
+/*
+===============
+SV_AddEntitiesVisibleFromPoint
+===============
+*/
+static void SV_AddEntitiesVisibleFromPoint( vec3_t origin, clientSnapshot_t *frame, snapshotEntityNumbers_t *eNums );
+
+/*
+===============
+SV_AddEntityIfVisible
+
+Runs all the checks for a linked entity that isn't flagged SVF_NOCLIENT
+===============
+*/
+static void SV_AddEntityIfVisible( vec3_t origin, clientSnapshot_t *frame, snapshotEntityNumbers_t *eNums,
+                                   sharedEntity_t *playerEnt, sharedEntity_t *ent, int clientarea, const byte *clientpvs )
+{
+	if ( !SV_EntitySentToClient( ent, frame->ps.clientNum ) )
+	{
+		return;
+	}
+
+	// don't double add an entity through portals
+	if ( SV_SnapshotHasEntity( eNums, ent->s.number ) )
+	{
+		return;
+	}
+
+	// broadcast entities are always sent
+	if ( ent->r.svFlags & SVF_BROADCAST )
+	{
+		SV_AddEntToSnapshot( playerEnt, ent, eNums );
+		return;
+	}
+
+	// send entity if the client is in range
+	if ( (ent->r.svFlags & SVF_CLIENTS_IN_RANGE) &&
+	     Distance( ent->s.origin, playerEnt->s.origin ) <= ent->r.clientRadius )
+	{
+		SV_AddEntToSnapshot( playerEnt, ent, eNums );
+		return;
+	}
+
+	if ( !SV_EntityInPVS( ent, clientarea, clientpvs ) )
+	{
+		return;
+	}
+
+	// entities only checked by origin are never dummies or portals
+	if ( ent->r.svFlags & SVF_IGNOREBMODELEXTENTS )
+	{
+		SV_AddEntToSnapshot( playerEnt, ent, eNums );
+		return;
+	}
+
+	//----(SA) added "visibility dummies"
+	if ( ent->r.svFlags & SVF_VISDUMMY )
+	{
+		sharedEntity_t *ment = 0;
+
+		//find master;
+		ment = SV_GentityNum( ent->s.otherEntityNum );
+
+		if ( ment )
+		{
+			if ( SV_SnapshotHasEntity( eNums, ment->s.number ) || !ment->r.linked )
+			{
+				return;
+			}
+
+			SV_AddEntToSnapshot( playerEnt, ment, eNums );
+		}
+
+		return; // master needs to be added, but not this dummy ent
+	}
+	//----(SA) end
+	else if ( ent->r.svFlags & SVF_VISDUMMY_MULTIPLE )
+	{
+		int            h;
+		sharedEntity_t *ment = 0;
+
+		for ( h = 0; h < sv.num_entities; h++ )
+		{
+			ment = SV_GentityNum( h );
+
+			if ( ment == ent || !ment )
+			{
+				continue;
+			}
+
+			if ( !( ment->r.linked ) )
+			{
+				continue;
+			}
+
+			if ( ment->s.number != h )
+			{
+				Com_DPrintf( "FIXING vis dummy multiple ment->S.NUMBER!!!\n" );
+				ment->s.number = h;
+			}
+
+			if ( ment->r.svFlags & SVF_NOCLIENT )
+			{
+				continue;
+			}
+
+			if ( SV_SnapshotHasEntity( eNums, h ) )
+			{
+				continue;
+			}
+
+			if ( ment->s.otherEntityNum == ent->s.number )
+			{
+				SV_AddEntToSnapshot( playerEnt, ment, eNums );
+			}
+		}
+
+		return;
+	}
+
+	// add it
+	SV_AddEntToSnapshot( playerEnt, ent, eNums );
+
+	// if it's a portal entity, add everything visible from its camera position
+	if ( ent->r.svFlags & SVF_PORTAL )
+	{
+		if ( ent->s.generic1 )
+		{
+			vec3_t dir;
+			VectorSubtract( ent->s.origin, origin, dir );
+
+			if ( VectorLengthSquared( dir ) > ( float ) ent->s.generic1 * ent->s.generic1 )
+			{
+				return;
+			}
+		}
+
+		SV_AddEntitiesVisibleFromPoint( ent->s.origin2, frame, eNums );
+	}
+}
+
+static void SV_AddEntitiesVisibleFromPoint( vec3_t origin, clientSnapshot_t *frame, snapshotEntityNumbers_t *eNums )
+{
+	int            e, i, b;
+	sharedEntity_t *ent, *playerEnt;
+	int            clientarea, clientcluster;
+	int            leafnum;
+	byte           *clientpvs;
+	const byte     *visible;
+	byte           scratch[ MAX_GENTITIES / 8 ];
+
+	// during an error shutdown message we may need to transmit
+	// the shutdown message after the server has shutdown, so
+	// specfically check for it
+	if ( !sv.state )
+	{
+		return;
+	}
+
+	leafnum = CM_PointLeafnum( origin );
+	clientarea = CM_LeafArea( leafnum );
+	clientcluster = CM_LeafCluster( leafnum );
+
+	// calculate the visible areas
+	frame->areabytes = CM_WriteAreaBits( frame->areabits, clientarea );
+
+	clientpvs = CM_ClusterPVS( clientcluster );
+
+	playerEnt = SV_GentityNum( frame->ps.clientNum );
+
+	if ( playerEnt->r.svFlags & SVF_SELF_PORTAL )
+	{
+		SV_AddEntitiesVisibleFromPoint( playerEnt->s.origin2, frame, eNums );
+	}
+
+	if ( !snapshotVis.valid )
+	{
+		for ( e = 0; e < sv.num_entities; e++ )
+		{
+			ent = SV_GentityNum( e );
+
+			// never send entities that aren't linked in
+			if ( !ent->r.linked )
+			{
+				continue;
+			}
+
+			if ( ent->s.number != e )
+			{
+				Com_DPrintf( "FIXING ENT->S.NUMBER!!!\n" );
+				ent->s.number = e;
 			}
 
-//          SV_AddEntitiesVisibleFromPoint( ent->s.origin2, frame, eNums, qtrue, oldframe, localClient );
-			SV_AddEntitiesVisibleFromPoint( ent->s.origin2, frame, eNums /*, qtrue, localClient */ );
+			// entities can be flagged to explicitly not be sent to the client
+			if ( ent->r.svFlags & SVF_NOCLIENT )
+			{
+				continue;
+			}
+
+			SV_AddEntityIfVisible( origin, frame, eNums, playerEnt, ent, clientarea, clientpvs );
 		}
 
-		continue;
+		return;
+	}
+
+	for ( i = 0; i < snapshotVis.numSpecial; i++ )
+	{
+		ent = SV_GentityNum( snapshotVis.special[ i ] );
+		SV_AddEntityIfVisible( origin, frame, eNums, playerEnt, ent, clientarea, clientpvs );
+	}
+
+	visible = SV_ClusterVisibleEntities( clientcluster, clientarea, clientpvs, scratch );
+
+	for ( i = 0; i < MAX_GENTITIES / 8; i++ )
+	{
+		// skip what's not visible or already added through a portal
+		int bits = visible[ i ] & ~eNums->added[ i ];
+
+		for ( b = 0; bits; b++, bits >>= 1 )
+		{
+			if ( !( bits & 1 ) )
+			{
+				continue;
+			}
+
+			ent = SV_GentityNum( i * 8 + b );
+
+			if ( ( ent->r.svFlags & SVF_SNAPSHOT_CLIENTS ) && !SV_EntitySentToClient( ent, frame->ps.clientNum ) )
+			{
+				continue;
+			}
+
+			SV_AddEntToSnapshot( playerEnt, ent, eNums );
+		}
 	}
 }
 
 /*
 =============
-SV_BuildClientSnapshot
+SV_CollectSnapshotEntities
 
 Decides which entities are going to be visible to the client, and
-copies off the playerstate and areabits.
+copies off the playerstate and areabits.  Returns qfalse if the client
+has nothing to look at.
 
 This properly handles multiple recursive portals, but the render
 currently doesn't.
 
 For viewing through other player's eyes, clent can be something other than client->gentity
+
+Only reads shared state, so it can run for several clients at once as long as
+no entity needs a snapshot callback and the entity numbers are consistent.
 =============
 */
-static void SV_BuildClientSnapshot( client_t *client )
+static qboolean SV_CollectSnapshotEntities( client_t *client, snapshotEntityNumbers_t *entityNumbers )
 {
 	vec3_t                  org;
-
-//  clientSnapshot_t            *frame, *oldframe;
 	clientSnapshot_t        *frame;
-	snapshotEntityNumbers_t entityNumbers;
 	int                     i;
-	sharedEntity_t          *ent;
-	entityState_t           *state;
-	svEntity_t              *svEnt;
 	sharedEntity_t          *clent;
 	int                     clientNum;
 	playerState_t           *ps;
 
-	// bump the counter used to prevent double adding
-	sv.snapshotCounter++;
-
 	// this is the frame we are creating
 	frame = &client->frames[ client->netchan.outgoingSequence & PACKET_MASK ];
 
 	// clear everything in this snapshot
-	entityNumbers.numSnapshotEntities = 0;
+	entityNumbers->numSnapshotEntities = 0;
+	Com_Memset( entityNumbers->added, 0, sizeof( entityNumbers->added ) );
 	Com_Memset( frame->areabits, 0, sizeof( frame->areabits ) );
 
-	// show_bug.cgi?id=62
-	frame->num_entities = 0;
+	// show_bug.cgi?id=62
+	frame->num_entities = 0;
+
+	clent = client->gentity;
+
+	if ( !clent || client->state == CS_ZOMBIE )
+	{
+		return qfalse;
+	}
+
+	// grab the current playerState_t
+	ps = SV_GameClientNum( client - svs.clients );
+	frame->ps = *ps;
+
+	// never send client's own entity, because it can
+	// be regenerated from the playerstate
+	clientNum = frame->ps.clientNum;
+
+	if ( clientNum < 0 || clientNum >= MAX_GENTITIES )
+	{
+		Com_Error( ERR_DROP, "SV_SvEntityForGentity: bad gEnt" );
+	}
+
+	SV_SnapshotMarkEntity( entityNumbers, clientNum );
+
+	if ( clent->r.svFlags & SVF_SELF_PORTAL_EXCLUSIVE )
+	{
+		// find the client's viewpoint
+		VectorCopy( clent->s.origin2, org );
+	}
+	else
+	{
+		VectorCopy( ps->origin, org );
+	}
+
+	org[ 2 ] += ps->viewheight;
+
+	// add all the entities directly visible to the eye, which
+	// may include portal entities that merge other viewpoints
+	SV_AddEntitiesVisibleFromPoint( org, frame, entityNumbers /*, qfalse, client->netchan.remoteAddress.type == NA_LOOPBACK */ );
+
+	// if there were portals visible, there may be out of order entities
+	// in the list which will need to be resorted for the delta compression
+	// to work correctly.  This also catches the error condition
+	// of an entity being included twice.
+	qsort( entityNumbers->snapshotEntities, entityNumbers->numSnapshotEntities,
+	       sizeof( entityNumbers->snapshotEntities[ 0 ] ), SV_QsortEntityNumbers );
+
+	// now that all viewpoint's areabits have been OR'd together, invert
+	// all of them to make it a mask vector, which is what the renderer wants
+	for ( i = 0; i < MAX_MAP_AREA_BYTES / 4; i++ )
+	{
+		( ( int * ) frame->areabits ) [ i ] = ( ( int * ) frame->areabits ) [ i ] ^ -1;
+	}
+
+	return qtrue;
+}
+
+/*
+=============
+SV_AllocSnapshotEntities
+
+Reserves the snapshot's slice of svs.snapshotEntities
+=============
+*/
+static void SV_AllocSnapshotEntities( client_t *client, const snapshotEntityNumbers_t *entityNumbers )
+{
+	clientSnapshot_t *frame = &client->frames[ client->netchan.outgoingSequence & PACKET_MASK ];
+
+	frame->num_entities = entityNumbers->numSnapshotEntities;
+	frame->first_entity = svs.nextSnapshotEntities;
+	svs.nextSnapshotEntities += entityNumbers->numSnapshotEntities;
+
+	// this should never hit, map should always be restarted first in SV_Frame
+	if ( svs.nextSnapshotEntities >= 0x7FFFFFFE )
+	{
+		Com_Error( ERR_FATAL, "svs.nextSnapshotEntities wrapped" );
+	}
+}
+
+/*
+=============================================================================
+
+Snapshot budget
+
+With sv_snapshotBudget set, the entity updates of a snapshot are limited to
+that percentage of what the client's rate allows per snapshot.  When the
+changes don't fit, the entities are ranked by distance, relevance and the
+time since the client last got them, and the ones left over keep the state
+of the delta frame, so they cost nothing and are sent in a later snapshot.
+Entities new to the client are simply left out until there is room.
+Entities carrying a new event, and temp event entities, are always sent since
+the event would be gone by the time there is room.
+
+=============================================================================
+*/
+
+#define SNAPSHOT_STALE_MSEC     1000 // staleness stops adding priority after that
+#define SNAPSHOT_EVENT_PRIORITY FLT_MAX // never deferred
+
+typedef struct
+{
+	int   index;
+	int   cost; // bits
+	float priority;
+} snapshotRank_t;
+
+/*
+=============
+SV_ClientRate
+
+The rate the client's messages are limited to, in bytes per second
+=============
+*/
+static int SV_ClientRate( const client_t *client )
+{
+	int rate = client->rate;
+	int maxRate;
+
+	// work on the appropriate max rate (client or download)
+	if ( !*client->downloadName )
+	{
+		maxRate = sv_maxRate->integer;
+	}
+	else
+	{
+		maxRate = sv_dl_maxRate->integer;
+	}
+
+	if ( maxRate && maxRate < rate )
+	{
+		rate = maxRate;
+	}
+
+	return rate;
+}
+
+/*
+=============
+SV_SnapshotBudget
+
+Bits the entity updates of a snapshot may take, 0 for no limit
+=============
+*/
+static int SV_SnapshotBudget( const client_t *client )
+{
+	int snapshotMsec;
+
+	if ( sv_snapshotBudget->integer <= 0 || sv_snapshotBudget->integer >= 100 )
+	{
+		return 0;
+	}
+
+	snapshotMsec = std::max( client->snapshotMsec, 1 );
+
+	return ( int )( ( int64_t ) SV_ClientRate( client ) * snapshotMsec * 8 / 1000 * sv_snapshotBudget->integer / 100 );
+}
+
+static int QDECL SV_QsortSnapshotRanks( const void *a, const void *b )
+{
+	const snapshotRank_t *ra = ( const snapshotRank_t * ) a;
+	const snapshotRank_t *rb = ( const snapshotRank_t * ) b;
+
+	if ( ra->priority != rb->priority )
+	{
+		return ra->priority > rb->priority ? -1 : 1;
+	}
+
+	return ra->index - rb->index;
+}
+
+/*
+=============
+SV_SnapshotEntityPriority
+=============
+*/
+static float SV_SnapshotEntityPriority( const client_t *client, const clientSnapshot_t *frame,
+                                        const entityState_t *state, const entityState_t *from )
+{
+	int            num = state->number;
+	sharedEntity_t *ent = SV_GentityNum( num );
+	vec3_t         origin;
+	float          relevance, distance;
+	int            stale;
+
+	// one-shot events only live for a short while
+	if ( state->eType > ET_EVENTS || state->event != from->event )
+	{
+		return SNAPSHOT_EVENT_PRIORITY;
+	}
+
+	if ( ent->r.bmodel )
+	{
+		VectorAdd( ent->r.absmin, ent->r.absmax, origin );
+		VectorScale( origin, 0.5f, origin );
+	}
+	else
+	{
+		VectorCopy( ent->r.currentOrigin, origin );
+	}
+
+	distance = Distance( origin, frame->ps.origin );
+
+	// other players matter the most, then anything everybody gets
+	if ( num < sv_maxclients->integer )
+	{
+		relevance = 4.0f;
+	}
+	else if ( ent->r.svFlags & SVF_BROADCAST )
+	{
+		relevance = 2.0f;
+	}
+	else
+	{
+		relevance = 1.0f;
+	}
+
+	stale = svs.time - client->entitySentTime[ num ];
+
+	if ( stale < 0 || stale > SNAPSHOT_STALE_MSEC )
+	{
+		stale = SNAPSHOT_STALE_MSEC;
+	}
+
+	return relevance * ( 1.0f + ( float ) stale / std::max( client->snapshotMsec, 1 ) ) / ( 1.0f + distance / 256.0f );
+}
+
+/*
+=============
+SV_BudgetSnapshotEntities
+
+Defers the entity updates that don't fit in the client's budget, see above.
+Only touches the client's own frame, so it is fine for parallel snapshots.
+=============
+*/
+static void SV_BudgetSnapshotEntities( client_t *client, const clientSnapshot_t *oldframe, int budget )
+{
+	clientSnapshot_t *frame = &client->frames[ client->netchan.outgoingSequence & PACKET_MASK ];
+	int              oldIndex[ MAX_GENTITIES ];
+	int              cost[ MAX_GENTITIES ];
+	bool             send[ MAX_GENTITIES ];
+	snapshotRank_t   ranks[ MAX_GENTITIES ];
+	int              numRanks;
+	byte             scratchBuf[ 1024 ];
+	msg_t            scratch;
+	int              oldNumEntities;
+	int              total, remaining;
+	int              i, j, kept;
+	qboolean         fieldStats;
+
+	if ( frame->num_entities > MAX_GENTITIES )
+	{
+		return;
+	}
+
+	oldNumEntities = oldframe ? oldframe->num_entities : 0;
+
+	MSG_Init( &scratch, scratchBuf, sizeof( scratchBuf ) );
+	scratch.allowoverflow = qtrue;
+	scratch.quantized = SV_QuantizeEntities( client );
+
+	// the huffman codes are fixed, so each delta costs the same on its own
+	// as it will in the message
+	total = 0;
+	numRanks = 0;
+
+	// the probes are never sent, so keep them out of the telemetry field
+	// stats. Those force serial snapshots, so this can't race another client
+	fieldStats = MSG_FieldStatsEnabled();
+
+	if ( fieldStats )
+	{
+		MSG_SetFieldStats( qfalse );
+	}
+
+	for ( i = 0, j = 0; i < frame->num_entities; i++ )
+	{
+		entityState_t *ent = &svs.snapshotEntities[( frame->first_entity + i ) % svs.numSnapshotEntities ];
+		entityState_t *oldent = NULL;
+
+		for ( ; j < oldNumEntities; j++ )
+		{
+			oldent = &svs.snapshotEntities[( oldframe->first_entity + j ) % svs.numSnapshotEntities ];
+
+			if ( oldent->number >= ent->number )
+			{
+				break;
+			}
+
+			// removed from the snapshot, which is always sent
+			total += GENTITYNUM_BITS + 1;
+		}
+
+		scratch.bit = 0;
+		scratch.cursize = 0;
+
+		if ( j < oldNumEntities && oldent->number == ent->number )
+		{
+			oldIndex[ i ] = j++;
+			MSG_WriteDeltaEntity( &scratch, oldent, ent, qfalse );
+		}
+		else
+		{
+			oldIndex[ i ] = -1;
+			MSG_WriteDeltaEntity( &scratch, &sv.svEntities[ ent->number ].baseline, ent, qtrue );
+		}
+
+		cost[ i ] = scratch.bit;
+		total += cost[ i ];
+		send[ i ] = true;
+
+		if ( cost[ i ] )
+		{
+			ranks[ numRanks ].index = i;
+			ranks[ numRanks ].cost = cost[ i ];
+			numRanks++;
+		}
+	}
+
+	total += ( oldNumEntities - j ) * ( GENTITYNUM_BITS + 1 );
+
+	if ( fieldStats )
+	{
+		MSG_SetFieldStats( qtrue );
+	}
+
+	if ( total > budget )
+	{
+		remaining = budget - total;
+
+		for ( i = 0; i < numRanks; i++ )
+		{
+			const entityState_t *ent = &svs.snapshotEntities[( frame->first_entity + ranks[ i ].index ) % svs.numSnapshotEntities ];
+			const entityState_t *from;
+
+			if ( oldIndex[ ranks[ i ].index ] >= 0 )
+			{
+				from = &svs.snapshotEntities[( oldframe->first_entity + oldIndex[ ranks[ i ].index ] ) % svs.numSnapshotEntities ];
+			}
+			else
+			{
+				from = &sv.svEntities[ ent->number ].baseline;
+			}
+
+			remaining += ranks[ i ].cost;
+			ranks[ i ].priority = SV_SnapshotEntityPriority( client, frame, ent, from );
+		}
 
-	clent = client->gentity;
+		qsort( ranks, numRanks, sizeof( ranks[ 0 ] ), SV_QsortSnapshotRanks );
 
-	if ( !clent || client->state == CS_ZOMBIE )
-	{
-		return;
-	}
+		// the most important one always goes, so nothing waits forever, and
+		// so do events
+		for ( i = 0; i < numRanks; i++ )
+		{
+			if ( i == 0 || ranks[ i ].priority == SNAPSHOT_EVENT_PRIORITY || ranks[ i ].cost <= remaining )
+			{
+				remaining -= ranks[ i ].cost;
+			}
+			else
+			{
+				send[ ranks[ i ].index ] = false;
+			}
+		}
 
-	// grab the current playerState_t
-	ps = SV_GameClientNum( client - svs.clients );
-	frame->ps = *ps;
+		// keep the delta frame's state of the deferred entities, and leave
+		// out the new ones
+		for ( i = 0, kept = 0; i < frame->num_entities; i++ )
+		{
+			entityState_t *ent = &svs.snapshotEntities[( frame->first_entity + i ) % svs.numSnapshotEntities ];
 
-	// never send client's own entity, because it can
-	// be regenerated from the playerstate
-	clientNum = frame->ps.clientNum;
+			if ( !send[ i ] )
+			{
+				if ( oldIndex[ i ] < 0 )
+				{
+					continue;
+				}
 
-	if ( clientNum < 0 || clientNum >= MAX_GENTITIES )
-	{
-		Com_Error( ERR_DROP, "SV_SvEntityForGentity: bad gEnt" );
-	}
+				*ent = svs.snapshotEntities[( oldframe->first_entity + oldIndex[ i ] ) % svs.numSnapshotEntities ];
+			}
 
-	svEnt = &sv.svEntities[ clientNum ];
+			if ( kept != i )
+			{
+				svs.snapshotEntities[( frame->first_entity + kept ) % svs.numSnapshotEntities ] = *ent;
+			}
 
-	svEnt->snapshotCounter = sv.snapshotCounter;
+			send[ kept ] = send[ i ];
+			kept++;
+		}
 
-	if ( clent->r.svFlags & SVF_SELF_PORTAL_EXCLUSIVE )
-	{
-		// find the client's viewpoint
-		VectorCopy( clent->s.origin2, org );
+		frame->num_entities = kept;
 	}
-	else
+
+	for ( i = 0; i < frame->num_entities; i++ )
 	{
-		VectorCopy( ps->origin, org );
+		if ( send[ i ] )
+		{
+			client->entitySentTime[ svs.snapshotEntities[( frame->first_entity + i ) % svs.numSnapshotEntities ].number ] = svs.time;
+		}
 	}
+}
 
-	org[ 2 ] += ps->viewheight;
-
-	// add all the entities directly visible to the eye, which
-	// may include portal entities that merge other viewpoints
-	SV_AddEntitiesVisibleFromPoint( org, frame, &entityNumbers /*, qfalse, client->netchan.remoteAddress.type == NA_LOOPBACK */ );
+/*
+=============
+SV_CopySnapshotEntities
 
-	// if there were portals visible, there may be out of order entities
-	// in the list which will need to be resorted for the delta compression
-	// to work correctly.  This also catches the error condition
-	// of an entity being included twice.
-	qsort( entityNumbers.snapshotEntities, entityNumbers.numSnapshotEntities,
-	       sizeof( entityNumbers.snapshotEntities[ 0 ] ), SV_QsortEntityNumbers );
+Copies the entity states into the slice reserved by SV_AllocSnapshotEntities,
+oldframe is the frame the snapshot will be delta compressed from
+=============
+*/
+static void SV_CopySnapshotEntities( client_t *client, const snapshotEntityNumbers_t *entityNumbers, const clientSnapshot_t *oldframe )
+{
+	const clientSnapshot_t *frame = &client->frames[ client->netchan.outgoingSequence & PACKET_MASK ];
+	int                    i, budget;
 
-	// now that all viewpoint's areabits have been OR'd together, invert
-	// all of them to make it a mask vector, which is what the renderer wants
-	for ( i = 0; i < MAX_MAP_AREA_BYTES / 4; i++ )
+	for ( i = 0; i < entityNumbers->numSnapshotEntities; i++ )
 	{
-		( ( int * ) frame->areabits ) [ i ] = ( ( int * ) frame->areabits ) [ i ] ^ -1;
+		svs.snapshotEntities[( frame->first_entity + i ) % svs.numSnapshotEntities ] =
+		  SV_GentityNum( entityNumbers->snapshotEntities[ i ] )->s;
 	}
 
-	// copy the entity states out
-	frame->num_entities = 0;
-	frame->first_entity = svs.nextSnapshotEntities;
-
-	for ( i = 0; i < entityNumbers.numSnapshotEntities; i++ )
+	// bots get their snapshots directly
+	if ( client->gentity && client->gentity->r.svFlags & SVF_BOT )
 	{
-		ent = SV_GentityNum( entityNumbers.snapshotEntities[ i ] );
-		state = &svs.snapshotEntities[ svs.nextSnapshotEntities % svs.numSnapshotEntities ];
-		*state = ent->s;
-		svs.nextSnapshotEntities++;
+		return;
+	}
 
-		// this should never hit, map should always be restarted first in SV_Frame
-		if ( svs.nextSnapshotEntities >= 0x7FFFFFFE )
-		{
-			Com_Error( ERR_FATAL, "svs.nextSnapshotEntities wrapped" );
-		}
+	budget = SV_SnapshotBudget( client );
 
-		frame->num_entities++;
+	if ( budget > 0 )
+	{
+		SV_BudgetSnapshotEntities( client, oldframe, budget );
 	}
 }
 
@@ -823,7 +1583,6 @@ static int SV_RateMsec( client_t *client, int messageSize )
 {
 	int rate;
 	int rateMsec;
-	int maxRate;
 
 	// individual messages will never be larger than fragment size
 	if ( messageSize > 1500 )
@@ -837,25 +1596,7 @@ static int SV_RateMsec( client_t *client, int messageSize )
 		Cvar_Set( "sv_MaxRate", "1000" );
 	}
 
-	rate = client->rate;
-
-	// work on the appropriate max rate (client or download)
-	if ( !*client->downloadName )
-	{
-		maxRate = sv_maxRate->integer;
-	}
-	else
-	{
-		maxRate = sv_dl_maxRate->integer;
-	}
-
-	if ( maxRate )
-	{
-		if ( maxRate < rate )
-		{
-			rate = maxRate;
-		}
-	}
+	rate = SV_ClientRate( client );
 
 	rateMsec = ( messageSize + HEADER_RATE_BYTES ) * 1000 / rate;
 
@@ -878,6 +1619,14 @@ void SV_SendMessageToClient( msg_t *msg, client_t *client )
 	client->frames[ client->netchan.outgoingSequence & PACKET_MASK ].messageSent = svs.time;
 	client->frames[ client->netchan.outgoingSequence & PACKET_MASK ].messageAcked = -1;
 
+	if ( SV_NetTelemetryEnabled() )
+	{
+		client->netStats.messages++;
+		client->netStats.bytes += msg->cursize;
+		client->netStats.maxSize = std::max( client->netStats.maxSize, msg->cursize );
+		client->netStats.sizeHistogram[ std::min( std::max( Q_log2( msg->cursize ) - 5, 0 ), NET_STATS_SIZE_BUCKETS - 1 ) ]++;
+	}
+
 	// send the datagram
 	SV_Netchan_Transmit( client, msg );
 
@@ -981,10 +1730,54 @@ Also called by SV_FinalCommand
 
 =======================
 */
+static void SV_BeginClientSnapshotMessage( client_t *client, const clientSnapshot_t *oldframe, int lastframe, msg_t *msg )
+{
+	msg->allowoverflow = qtrue;
+
+	// NOTE, MRE: all server->client messages now acknowledge
+	// let the client know which reliable clientCommands we have received
+	MSG_WriteLong( msg, client->lastClientCommand );
+
+	// (re)send any reliable server commands
+	SV_UpdateServerCommandsToClient( client, msg );
+
+	// send over all the relevant entityState_t
+	// and the playerState_t
+	SV_WriteSnapshotToClient( client, oldframe, lastframe, msg );
+}
+
+static void SV_FinishClientSnapshotMessage( client_t *client, msg_t *msg )
+{
+	// Add any download data if the client is downloading
+	SV_WriteDownloadToClient( client, msg );
+#ifdef USE_VOIP
+	SV_WriteVoipToClient( client, msg );
+#endif
+
+	// check for overflow
+	if ( msg->overflowed )
+	{
+		Com_Logf(LOG_WARN, "msg overflowed for %s", client->name );
+		MSG_Clear( msg );
+
+		SV_DropClient( client, "Msg overflowed" );
+		return;
+	}
+
+	SV_SendMessageToClient( msg, client );
+
+	sv.bpsTotalBytes += msg->cursize; // NERVE - SMF - net debugging
+	sv.ubpsTotalBytes += msg->uncompsize / 8; // NERVE - SMF - net debugging
+}
+
 void SV_SendClientSnapshot( client_t *client )
 {
-	byte  msg_buf[ MAX_MSGLEN ];
-	msg_t msg;
+	byte                    msg_buf[ MAX_MSGLEN ];
+	msg_t                   msg;
+	snapshotEntityNumbers_t entityNumbers;
+	qboolean                haveEntities;
+	clientSnapshot_t        *oldframe;
+	int                     lastframe;
 
 	//bani
 	if ( client->state < CS_ACTIVE )
@@ -999,49 +1792,201 @@ void SV_SendClientSnapshot( client_t *client )
 	}
 
 	// build the snapshot
-	SV_BuildClientSnapshot( client );
+	haveEntities = SV_CollectSnapshotEntities( client, &entityNumbers );
+
+	if ( haveEntities )
+	{
+		SV_AllocSnapshotEntities( client, &entityNumbers );
+	}
 
 	// bots need to have their snapshots built, but
 	// those are queried directly without needing to be sent
 	if ( client->gentity && client->gentity->r.svFlags & SVF_BOT )
 	{
+		if ( haveEntities )
+		{
+			SV_CopySnapshotEntities( client, &entityNumbers, NULL );
+		}
+
 		return;
 	}
 
+	oldframe = SV_SnapshotDeltaFrame( client, svs.nextSnapshotEntities, &lastframe );
+
+	if ( haveEntities )
+	{
+		SV_CopySnapshotEntities( client, &entityNumbers, oldframe );
+	}
+
 	MSG_Init( &msg, msg_buf, sizeof( msg_buf ) );
-	msg.allowoverflow = qtrue;
+	SV_BeginClientSnapshotMessage( client, oldframe, lastframe, &msg );
+	SV_FinishClientSnapshotMessage( client, &msg );
+}
 
-	// NOTE, MRE: all server->client messages now acknowledge
-	// let the client know which reliable clientCommands we have received
-	MSG_WriteLong( &msg, client->lastClientCommand );
+/*
+=============================================================================
 
-	// (re)send any reliable server commands
-	SV_UpdateServerCommandsToClient( client, &msg );
+Parallel snapshots
 
-	// send over all the relevant entityState_t
-	// and the playerState_t
-	SV_WriteSnapshotToClient( client, &msg );
+Collecting the visible entities and encoding the message of each client
+only reads shared state, so SV_SendClientMessages does it for all clients
+at once on a worker pool, with its own message buffer for every client.
+The rest (reserving the slices of svs.snapshotEntities, downloads, VoIP and
+sending) is done serially in client order, so the messages are byte for byte
+the ones built one client at a time.
 
-	// Add any download data if the client is downloading
-	SV_WriteDownloadToClient( client, &msg );
-#ifdef USE_VOIP
-	SV_WriteVoipToClient( client, &msg );
-#endif
+Anything that would make a client's message depend on another client's
+having been sent falls back to building it serially: a client getting
+dropped halfway through (which runs game code and queues reliable commands
+for everybody), or the slices of this frame overwriting a frame that is
+still needed for delta compression.
 
-	// check for overflow
-	if ( msg.overflowed )
+=============================================================================
+*/
+
+typedef struct
+{
+	client_t                *client;
+	snapshotEntityNumbers_t entityNumbers;
+	qboolean                haveEntities;
+	const clientSnapshot_t  *oldframe;
+	int                     lastframe;
+	int                     snapshotEnd; // svs.nextSnapshotEntities after this snapshot
+	msg_t                   msg;
+	byte                    msgBuf[ MAX_MSGLEN ];
+} snapshotJob_t;
+
+static Parallel::WorkerPool snapshotWorkers;
+static std::vector<snapshotJob_t> snapshotJobs;
+
+/*
+=======================
+SV_CanBuildSnapshotsInParallel
+
+Needs the visibility cache, which also fixes the entity numbers, and no
+entity needing the game for deciding whether it is sent.
+=======================
+*/
+static qboolean SV_CanBuildSnapshotsInParallel( void )
+{
+	// the per field statistics are not thread safe
+	if ( sv_snapshotThreads->integer == 1 || sv_netTelemetry->integer >= 2 )
 	{
-		Com_Logf(LOG_WARN, "msg overflowed for %s", client->name );
-		MSG_Clear( &msg );
+		return qfalse;
+	}
 
-		SV_DropClient( client, "Msg overflowed" );
-		return;
+	return snapshotVis.valid && !snapshotVis.haveCallbacks;
+}
+
+/*
+=======================
+SV_BuildClientSnapshotsInParallel
+
+Prepares the messages of all the clients in the list, returns qfalse if they
+have to be built serially instead
+=======================
+*/
+static qboolean SV_BuildClientSnapshotsInParallel( client_t **clients, int numClients )
+{
+	int i, start;
+
+	if ( (int) snapshotJobs.size() < numClients )
+	{
+		snapshotJobs.resize( numClients );
 	}
 
-	SV_SendMessageToClient( &msg, client );
+	snapshotWorkers.SetNumThreads( sv_snapshotThreads->integer );
 
-	sv.bpsTotalBytes += msg.cursize; // NERVE - SMF - net debugging
-	sv.ubpsTotalBytes += msg.uncompsize / 8; // NERVE - SMF - net debugging
+	for ( i = 0; i < numClients; i++ )
+	{
+		snapshotJobs[ i ].client = clients[ i ];
+	}
+
+	snapshotWorkers.ParallelFor( numClients, []( int i )
+	{
+		snapshotJob_t *job = &snapshotJobs[ i ];
+
+		job->haveEntities = SV_CollectSnapshotEntities( job->client, &job->entityNumbers );
+	} );
+
+	// hand out the slices in client order
+	start = svs.nextSnapshotEntities;
+
+	for ( i = 0; i < numClients; i++ )
+	{
+		snapshotJob_t *job = &snapshotJobs[ i ];
+
+		if ( job->haveEntities )
+		{
+			SV_AllocSnapshotEntities( job->client, &job->entityNumbers );
+		}
+
+		job->snapshotEnd = svs.nextSnapshotEntities;
+		job->oldframe = SV_SnapshotDeltaFrame( job->client, job->snapshotEnd, &job->lastframe );
+	}
+
+	// the slices written this frame must neither overlap each other nor
+	// overwrite any frame used for delta compression
+	if ( svs.nextSnapshotEntities - start > svs.numSnapshotEntities )
+	{
+		svs.nextSnapshotEntities = start;
+		return qfalse;
+	}
+
+	for ( i = 0; i < numClients; i++ )
+	{
+		const clientSnapshot_t *oldframe = snapshotJobs[ i ].oldframe;
+
+		if ( oldframe && oldframe->num_entities && oldframe->first_entity < svs.nextSnapshotEntities - svs.numSnapshotEntities )
+		{
+			svs.nextSnapshotEntities = start;
+			return qfalse;
+		}
+	}
+
+	snapshotWorkers.ParallelFor( numClients, []( int i )
+	{
+		snapshotJob_t *job = &snapshotJobs[ i ];
+
+		if ( job->haveEntities )
+		{
+			SV_CopySnapshotEntities( job->client, &job->entityNumbers, job->oldframe );
+		}
+
+		MSG_Init( &job->msg, job->msgBuf, sizeof( job->msgBuf ) );
+		SV_BeginClientSnapshotMessage( job->client, job->oldframe, job->lastframe, &job->msg );
+	} );
+
+	return qtrue;
+}
+
+/*
+=======================
+SV_ClientMessageDue
+=======================
+*/
+static qboolean SV_ClientMessageDue( client_t *c )
+{
+	// rain - changed <= CS_ZOMBIE to < CS_ZOMBIE so that the
+	// disconnect reason is properly sent in the network stream
+	if ( c->state < CS_ZOMBIE )
+	{
+		return qfalse; // not connected
+	}
+
+	// RF, needed to insert this otherwise bots would cause error drops in sv_net_chan.c:
+	// --> "netchan queue is not properly initialized in SV_Netchan_TransmitNextFragment\n"
+	if ( c->gentity && c->gentity->r.svFlags & SVF_BOT )
+	{
+		return qfalse;
+	}
+
+	if ( svs.time < c->nextSnapshotTime )
+	{
+		return qfalse; // not time yet
+	}
+
+	return qtrue;
 }
 
 /*
@@ -1052,9 +1997,15 @@ SV_SendClientMessages
 
 void SV_SendClientMessages( void )
 {
-	int      i;
-	client_t *c;
-	int      numclients = 0; // NERVE - SMF - net debugging
+	int           i;
+	client_t      *c;
+	int           numclients = 0; // NERVE - SMF - net debugging
+	client_t      *snapshotClients[ MAX_CLIENTS ];
+	int           numSnapshotClients = 0;
+	int           nextJob = 0;
+	int           serialNext;
+	qboolean      parallel;
+	clientState_t state;
 
 	sv.bpsTotalBytes = 0; // NERVE - SMF - net debugging
 	sv.ubpsTotalBytes = 0; // NERVE - SMF - net debugging
@@ -1062,28 +2013,46 @@ void SV_SendClientMessages( void )
 	// Gordon: update any changed configstrings from this frame
 	SV_UpdateConfigStrings();
 
-	// send a message to each connected client
+	SV_PrepareSnapshotVisibility();
+
+	// find the clients getting a new snapshot this frame
 	for ( i = 0; i < sv_maxclients->integer; i++ )
 	{
 		c = &svs.clients[ i ];
 
-		// rain - changed <= CS_ZOMBIE to < CS_ZOMBIE so that the
-		// disconnect reason is properly sent in the network stream
-		if ( c->state < CS_ZOMBIE )
+		if ( !SV_ClientMessageDue( c ) || c->netchan.unsentFragments )
 		{
-			continue; // not connected
+			continue;
 		}
 
-		// RF, needed to insert this otherwise bots would cause error drops in sv_net_chan.c:
-		// --> "netchan queue is not properly initialized in SV_Netchan_TransmitNextFragment\n"
-		if ( c->gentity && c->gentity->r.svFlags & SVF_BOT )
+		if ( c->state < CS_ACTIVE && c->state != CS_ZOMBIE )
 		{
-			continue;
+			continue; // gets an idle packet
 		}
 
-		if ( svs.time < c->nextSnapshotTime )
+		snapshotClients[ numSnapshotClients++ ] = c;
+	}
+
+	serialNext = svs.nextSnapshotEntities;
+	parallel = numSnapshotClients > 1 && SV_CanBuildSnapshotsInParallel() &&
+	           SV_BuildClientSnapshotsInParallel( snapshotClients, numSnapshotClients );
+
+	// send a message to each connected client, all in as few system calls as possible
+	NET_BeginSendBatch();
+
+	for ( i = 0; i < sv_maxclients->integer; i++ )
+	{
+		c = &svs.clients[ i ];
+
+		if ( !SV_ClientMessageDue( c ) )
 		{
-			continue; // not time yet
+			// held back by its rate
+			if ( c->rateDelayed && c->state >= CS_ZOMBIE && svs.time < c->nextSnapshotTime && SV_NetTelemetryEnabled() )
+			{
+				c->netStats.chokes++;
+			}
+
+			continue;
 		}
 
 		numclients++; // NERVE - SMF - net debugging
@@ -1098,9 +2067,41 @@ void SV_SendClientMessages( void )
 		}
 
 		// generate and send a new message
-		SV_SendClientSnapshot( c );
+		state = c->state;
+
+		if ( !parallel )
+		{
+			SV_SendClientSnapshot( c );
+		}
+		else if ( nextJob < numSnapshotClients && snapshotJobs[ nextJob ].client == c )
+		{
+			snapshotJob_t *job = &snapshotJobs[ nextJob++ ];
+
+			SV_FinishClientSnapshotMessage( c, &job->msg );
+			serialNext = job->snapshotEnd;
+		}
+		else
+		{
+			SV_SendClientIdle( c );
+		}
+
+		// dropping a client runs the game, which changes what the remaining
+		// messages would contain, so build those again one at a time
+		if ( c->state != state )
+		{
+			if ( parallel )
+			{
+				svs.nextSnapshotEntities = serialNext;
+				parallel = qfalse;
+			}
+
+			SV_ClearSnapshotVisibility();
+		}
 	}
 
+	NET_FlushSendBatch();
+	SV_ClearSnapshotVisibility();
+
 	// NERVE - SMF - net debugging
 	if ( sv_showAverageBPS->integer && numclients > 0 )
 	{
@@ -1146,9 +2147,12 @@ void SV_SendClientMessages( void )
 			sv.ucompAve += comp_ratio;
 			sv.ucompNum++;
 
-			Com_DPrintf( "bpspc(%2.0f) bps(%2.0f) pk(%i) ubps(%2.0f) upk(%i) cr(%2.2f) acr(%2.2f)\n",
+			Com_DPrintf( "bpspc(%2.0f) bps(%2.0f) pk(%i) ubps(%2.0f) upk(%i) cr(%2.2f) acr(%2.2f) dch(%i/%i)\n",
 			             ave / ( float ) numclients, ave, sv.bpsMaxBytes, uave, sv.ubpsMaxBytes, comp_ratio,
-			             sv.ucompAve / sv.ucompNum );
+			             sv.ucompAve / sv.ucompNum, deltaCacheHits.load(), deltaCacheLookups.load() );
+
+			deltaCacheHits = 0;
+			deltaCacheLookups = 0;
 		}
 	}
 
@@ -0,0 +1,286 @@
+/*
+===========================================================================
+
+Daemon GPL Source Code
+Copyright (C) 1999-2010 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Daemon GPL Source Code (Daemon Source Code).
+
+Daemon Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Daemon Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Daemon Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Daemon Source Code is also subject to certain additional terms.
+You should have received a copy of these additional terms immediately following the
+terms and conditions of the GNU General Public License which accompanied the Daemon
+Source Code.  If not, please request a copy in writing from id Software at the address
+below.
+
+If you have questions concerning this license or the applicable additional terms, you
+may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville,
+Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "../qcommon/q_shared.h"
+#include "../qcommon/qcommon.h"
+#include "server.h"
+
+/*
+=============================================================================
+
+Network telemetry
+
+With sv_netTelemetry set, the network stats of every client since the last
+report are appended to sv_netTelemetryFile every sv_netTelemetryInterval
+seconds, as one JSON object per line.  Once the file grows past
+sv_netTelemetryMaxSize KB it is moved to <file>.1 and a new one started.
+
+sv_netTelemetry 2 also reports how many bits every entity and player state
+field took, which builds the snapshots serially and skips the delta cache.
+
+=============================================================================
+*/
+
+static fileHandle_t telemetryFile;
+static char         telemetryFileName[ MAX_QPATH ];
+static int          telemetryNextTime;
+
+/*
+===============
+SV_TelemetryString
+
+Writes s as a JSON string
+===============
+*/
+static void SV_TelemetryString( const char *s )
+{
+	char buffer[ 2 * MAX_STRING_CHARS ];
+	int  length = 0;
+
+	buffer[ length++ ] = '"';
+
+	for ( ; *s && length < (int) sizeof( buffer ) - 8; s++ )
+	{
+		unsigned char c = *s;
+
+		if ( c == '"' || c == '\\' )
+		{
+			buffer[ length++ ] = '\\';
+			buffer[ length++ ] = c;
+		}
+		else if ( c < ' ' )
+		{
+			length += Com_sprintf( buffer + length, sizeof( buffer ) - length, "\\u%04x", c );
+		}
+		else
+		{
+			buffer[ length++ ] = c;
+		}
+	}
+
+	buffer[ length++ ] = '"';
+
+	FS_Write( buffer, length, telemetryFile );
+}
+
+/*
+===============
+SV_OpenNetTelemetry
+
+Opens or rotates the file, returns qfalse if it can't be written
+===============
+*/
+static qboolean SV_OpenNetTelemetry( void )
+{
+	if ( telemetryFile && ( Q_stricmp( telemetryFileName, sv_netTelemetryFile->string ) ||
+	                        FS_FTell( telemetryFile ) >= sv_netTelemetryMaxSize->integer * 1024 ) )
+	{
+		FS_FCloseFile( telemetryFile );
+		telemetryFile = 0;
+
+		if ( !Q_stricmp( telemetryFileName, sv_netTelemetryFile->string ) )
+		{
+			FS_Rename( telemetryFileName, va( "%s.1", telemetryFileName ) );
+		}
+	}
+
+	if ( !telemetryFile )
+	{
+		Q_strncpyz( telemetryFileName, sv_netTelemetryFile->string, sizeof( telemetryFileName ) );
+		telemetryFile = FS_FOpenFileAppend( telemetryFileName );
+	}
+
+	return telemetryFile != 0;
+}
+
+/*
+===============
+SV_WriteFieldTelemetry
+===============
+*/
+static void SV_WriteFieldTelemetry( qboolean playerState )
+{
+	msgFieldStats_t stats[ 128 ];
+	int             numStats, i;
+
+	numStats = MSG_GetFieldStats( playerState, stats, ARRAY_LEN( stats ), qtrue );
+
+	FS_Printf( telemetryFile, ",\"%s\":{", playerState ? "playerFields" : "entityFields" );
+
+	for ( i = 0; i < numStats; i++ )
+	{
+		FS_Printf( telemetryFile, "%s\"%s\":[%i,%i]", i ? "," : "", stats[ i ].name, stats[ i ].count, stats[ i ].bits );
+	}
+
+	FS_Printf( telemetryFile, "}" );
+}
+
+/*
+===============
+SV_WriteNetTelemetry
+===============
+*/
+static void SV_WriteNetTelemetry( void )
+{
+	client_t *cl;
+	int      i, j;
+	qboolean first = qtrue;
+
+	FS_Printf( telemetryFile, "{\"time\":%i,\"map\":", svs.time );
+	SV_TelemetryString( sv_mapname->string );
+	FS_Printf( telemetryFile, ",\"maxRate\":%i,\"clients\":[", sv_maxRate->integer );
+
+	for ( i = 0, cl = svs.clients; i < sv_maxclients->integer; i++, cl++ )
+	{
+		const clientNetStats_t *stats = &cl->netStats;
+
+		if ( cl->state < CS_CONNECTED || ( cl->gentity && cl->gentity->r.svFlags & SVF_BOT ) )
+		{
+			continue;
+		}
+
+		FS_Printf( telemetryFile, "%s{\"client\":%i,\"name\":", first ? "" : ",", i );
+		SV_TelemetryString( cl->name );
+		FS_Printf( telemetryFile, ",\"address\":" );
+		SV_TelemetryString( NET_AdrToString( cl->netchan.remoteAddress ) );
+		FS_Printf( telemetryFile, ",\"ping\":%i,\"rate\":%i,\"snapshotMsec\":%i,\"messages\":%i,\"bytes\":%i,\"maxSize\":%i,\"sizes\":[",
+		           cl->ping, cl->rate, cl->snapshotMsec, stats->messages, stats->bytes, stats->maxSize );
+
+		for ( j = 0; j < NET_STATS_SIZE_BUCKETS; j++ )
+		{
+			FS_Printf( telemetryFile, "%s%i", j ? "," : "", stats->sizeHistogram[ j ] );
+		}
+
+		FS_Printf( telemetryFile, "],\"snapshots\":%i,\"deltaSnapshots\":%i,\"fragments\":%i,\"drops\":%i,\"chokes\":%i}",
+		           stats->snapshots, stats->deltaSnapshots, stats->fragments, stats->drops, stats->chokes );
+
+		Com_Memset( &cl->netStats, 0, sizeof( cl->netStats ) );
+		first = qfalse;
+	}
+
+	FS_Printf( telemetryFile, "]" );
+
+	if ( sv_netTelemetry->integer >= 2 )
+	{
+		SV_WriteFieldTelemetry( qfalse );
+		SV_WriteFieldTelemetry( qtrue );
+	}
+
+	FS_Printf( telemetryFile, "}\n" );
+}
+
+/*
+===============
+SV_NetTelemetryEnabled
+
+The client network stats are only kept while this is true
+===============
+*/
+qboolean SV_NetTelemetryEnabled( void )
+{
+	return sv_netTelemetry->integer > 0;
+}
+
+/*
+===============
+SV_ClearNetStats
+
+Drops whatever was left from before the telemetry was enabled
+===============
+*/
+static void SV_ClearNetStats( void )
+{
+	client_t *cl;
+	int      i;
+
+	for ( i = 0, cl = svs.clients; i < sv_maxclients->integer; i++, cl++ )
+	{
+		Com_Memset( &cl->netStats, 0, sizeof( cl->netStats ) );
+	}
+}
+
+/*
+===============
+SV_NetTelemetryFrame
+
+Called every server frame after the client messages were sent
+===============
+*/
+void SV_NetTelemetryFrame( void )
+{
+	MSG_SetFieldStats( sv_netTelemetry->integer >= 2 );
+
+	if ( sv_netTelemetry->integer <= 0 )
+	{
+		SV_ShutdownNetTelemetry();
+		return;
+	}
+
+	if ( !telemetryNextTime )
+	{
+		SV_ClearNetStats();
+		telemetryNextTime = svs.time + std::max( sv_netTelemetryInterval->integer, 1 ) * 1000;
+		return;
+	}
+
+	// svs.time starts over with the server
+	if ( svs.time < telemetryNextTime && telemetryNextTime - svs.time <= std::max( sv_netTelemetryInterval->integer, 1 ) * 1000 )
+	{
+		return;
+	}
+
+	telemetryNextTime = svs.time + std::max( sv_netTelemetryInterval->integer, 1 ) * 1000;
+
+	if ( SV_OpenNetTelemetry() )
+	{
+		SV_WriteNetTelemetry();
+	}
+}
+
+/*
+===============
+SV_ShutdownNetTelemetry
+===============
+*/
+void SV_ShutdownNetTelemetry( void )
+{
+	if ( telemetryFile )
+	{
+		FS_FCloseFile( telemetryFile );
+		telemetryFile = 0;
+	}
+
+	telemetryNextTime = 0;
+	MSG_SetFieldStats( qfalse );
+}
@@ -646,7 +646,9 @@ void SpectatorThink( gentity_t *ent, usercmd_t *ucmd )
 		pm.pointcontents = trap_PointContents;
 
 		// Perform a pmove
+		G_PmoveRecordBegin( &pm );
 		Pmove( &pm );
+		G_PmoveRecordEnd( &pm );
 
 		// Save results of pmove
 		VectorCopy( client->ps.origin, ent->s.origin );
@@ -1982,7 +1984,9 @@ void ClientThink_real( gentity_t *self )
 	// moved from after Pmove -- potentially the cause of future triggering bugs
 	G_TouchTriggers( self );
 
+	G_PmoveRecordBegin( &pm );
 	Pmove( &pm );
+	G_PmoveRecordEnd( &pm );
 
 	G_UnlaggedDetectCollisions( self );
 
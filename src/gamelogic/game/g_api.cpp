@@ -175,8 +175,8 @@ void VM::VMMain(uint32_t id, IPC::Reader reader)
 			break;
 
 		case GAME_CLIENT_COMMAND:
-			IPC::HandleMsg<GameClientCommandMsg>(VM::rootChannel, std::move(reader), [](int clientNum, std::string command) {
-				Cmd::PushArgs(command);
+			IPC::HandleMsg<GameClientCommandMsg>(VM::rootChannel, std::move(reader), [](int clientNum, IPC::StringView command) {
+				Cmd::PushArgs(command.c_str());
 				ClientCommand(clientNum);
 				Cmd::PopArgs();
 			});
@@ -612,6 +612,14 @@ qboolean trap_BotUpdatePath(int botClientNum, const botRouteTarget_t *target, bo
 	return 0; // Amanieu: This always returns 0, but the value isn't used
 }
 
+void trap_BotUpdatePaths(int numBots, const int *botClientNums, const botRouteTarget_t *targets, botNavCmd_t *cmds)
+{
+	std::vector<botNavCmd_t> cmds2;
+	cmds2.reserve(numBots);
+	VM::SendMsg<BotUpdatePathsMsg>(IPC::ArrayView<int>(botClientNums, numBots), IPC::ArrayView<botRouteTarget_t>(targets, numBots), cmds2);
+	std::copy(cmds2.begin(), cmds2.begin() + std::min<size_t>(numBots, cmds2.size()), cmds);
+}
+
 qboolean trap_BotNavTrace(int botClientNum, botTrace_t *botTrace, const vec3_t start, const vec3_t end)
 {
 	std::array<float, 3> start2, end2;
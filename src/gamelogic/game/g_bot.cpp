@@ -342,6 +342,68 @@ void G_BotDelAllBots( void )
  =======================
  */
 
+/*
+================
+G_BotUpdatePaths
+
+Updates the path corridor of every bot that will think this frame in a
+single call to the bot library, rather than one call per bot.
+================
+*/
+void G_BotUpdatePaths( void )
+{
+	int              clientNums[ MAX_CLIENTS ];
+	botRouteTarget_t targets[ MAX_CLIENTS ];
+	botNavCmd_t      cmds[ MAX_CLIENTS ];
+	int              numBots = 0;
+	gentity_t        *self;
+	int              i;
+
+	if ( level.intermissiontime )
+	{
+		return;
+	}
+
+	for ( i = 0; i < level.maxclients; i++ )
+	{
+		self = &g_entities[ i ];
+
+		if ( !self->inuse || !( self->r.svFlags & SVF_BOT ) || !self->botMind )
+		{
+			continue;
+		}
+
+		if ( self->client->pers.connected != CON_CONNECTED ||
+		     self->client->sess.spectatorState != SPECTATOR_NOT )
+		{
+			continue;
+		}
+
+		if ( !self->botMind->behaviorTree || !self->botMind->goal.inuse )
+		{
+			continue;
+		}
+
+		clientNums[ numBots ] = self->s.number;
+		BotTargetToRouteTarget( self, self->botMind->goal, &targets[ numBots ] );
+		numBots++;
+	}
+
+	if ( !numBots )
+	{
+		return;
+	}
+
+	trap_BotUpdatePaths( numBots, clientNums, targets, cmds );
+
+	for ( i = 0; i < numBots; i++ )
+	{
+		self = &g_entities[ clientNums[ i ] ];
+		self->botMind->nav = cmds[ i ];
+		self->botMind->navTime = level.time;
+	}
+}
+
 void G_BotThink( gentity_t *self )
 {
 	char buf[MAX_STRING_CHARS];
@@ -394,8 +456,8 @@ void G_BotThink( gentity_t *self )
 		return;
 	}
 
-	// always update the path corridor
-	if ( self->botMind->goal.inuse )
+	// always update the path corridor, unless G_BotUpdatePaths already has
+	if ( self->botMind->goal.inuse && self->botMind->navTime != level.time )
 	{
 		BotTargetToRouteTarget( self, self->botMind->goal, &routeTarget );
 		trap_BotUpdatePath( self->s.number, &routeTarget, &self->botMind->nav );
@@ -85,6 +85,7 @@ typedef struct
 	vec3_t      futureAim;
 	usercmd_t   cmdBuffer;
 	botNavCmd_t nav;
+	int         navTime; // level.time of the last batched corridor update
 } botMemory_t;
 
 qboolean G_BotAdd( char *name, team_t team, int skill, const char* behavior );
@@ -92,6 +93,7 @@ qboolean G_BotSetDefaults( int clientNum, team_t team, int skill, const char* be
 void     G_BotDel( int clientNum );
 void     G_BotDelAllBots( void );
 void     G_BotThink( gentity_t *self );
+void     G_BotUpdatePaths( void );
 void     G_BotSpectatorThink( gentity_t *self );
 void     G_BotIntermissionThink( gclient_t *client );
 void     G_BotListNames( gentity_t *ent );
@@ -99,6 +101,7 @@ qboolean G_BotClearNames( void );
 int      G_BotAddNames(team_t team, int arg, int last);
 void     G_BotDisableArea( vec3_t origin, vec3_t mins, vec3_t maxs );
 void     G_BotEnableArea( vec3_t origin, vec3_t mins, vec3_t maxs );
+void     G_BotPerceptionInfo( void );
 void     G_BotInit( void );
 void     G_BotCleanup(int restart);
 #endif
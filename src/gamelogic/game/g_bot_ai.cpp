@@ -467,7 +467,16 @@ This should always be used instead of the node->run function pointer
 */
 AINodeStatus_t BotEvaluateNode( gentity_t *self, AIGenericNode_t *node )
 {
-	AINodeStatus_t status = node->run( self, node );
+	AINodeStatus_t status;
+
+	// the route search to the goal this node picked found no path
+	if ( self->botMind->currentNode == node && self->botMind->nav.routeFailed )
+	{
+		self->botMind->currentNode = NULL;
+		return STATUS_FAILURE;
+	}
+
+	status = node->run( self, node );
 
 	// reset the current node if it finishes
 	// we do this so we can re-pathfind on the next entrance
@@ -688,7 +697,7 @@ AINodeStatus_t BotActionFight( gentity_t *self, AIGenericNode_t *node )
 		return STATUS_SUCCESS;
 	}
 
-	if ( !self->botMind->nav.havePath )
+	if ( !self->botMind->nav.havePath && !self->botMind->nav.routePending )
 	{
 		return STATUS_FAILURE;
 	}
@@ -452,6 +452,201 @@ void BotGetDesiredBuy( gentity_t *self, weapon_t *weapon, upgrade_t *upgrades, i
 		}
 	}
 }
+/*
+ = *======================
+ Perception Cache
+ =======================
+ */
+
+// bots on the same team share one list of possible enemies per frame
+typedef struct
+{
+	int time;
+	int numCandidates;
+	int candidates[ MAX_GENTITIES ];
+} botEnemyCandidates_t;
+
+// line of sight results of the frame, shared by every bot whose muzzle is in
+// the same cell looking at the same target
+#define VISIBILITY_CACHE_SIZE   4096
+#define VISIBILITY_CACHE_PROBES 8
+#define VISIBILITY_CELL_SIZE    32
+
+typedef struct
+{
+	int      time;
+	int      target;
+	int      mask;
+	int      muzzleCell[ 3 ];
+	int      targetCell[ 3 ];
+	int      blocker; // entity the trace stopped at
+	qboolean visible;
+} botVisibility_t;
+
+static botEnemyCandidates_t botEnemyCandidates[ NUM_TEAMS ];
+static botVisibility_t      botVisibilityCache[ VISIBILITY_CACHE_SIZE ];
+
+static struct
+{
+	int time;
+	int hits, misses;
+	int frameHits, frameMisses;
+	int lastFrameHits, lastFrameMisses;
+	int candidateBuilds;
+} botPerceptionStats;
+
+static void BotPerceptionFrame( void )
+{
+	if ( botPerceptionStats.time == level.time )
+	{
+		return;
+	}
+
+	botPerceptionStats.lastFrameHits = botPerceptionStats.frameHits;
+	botPerceptionStats.lastFrameMisses = botPerceptionStats.frameMisses;
+	botPerceptionStats.frameHits = 0;
+	botPerceptionStats.frameMisses = 0;
+	botPerceptionStats.time = level.time;
+}
+
+static int BotCompareEntityNumbers( const void *a, const void *b )
+{
+	return *( const int * ) a - *( const int * ) b;
+}
+
+/*
+================
+BotEnemyCandidates
+
+Returns the entity numbers, in ascending order, of every client and
+buildable not on the given team or TEAM_NONE. Built once per frame for
+each team; callers still have to check BotEnemyIsValid.
+================
+*/
+static const botEnemyCandidates_t *BotEnemyCandidates( team_t team )
+{
+	botEnemyCandidates_t *list = &botEnemyCandidates[ team ];
+	gentity_t            *ent;
+	team_t               enemyTeam;
+	int                  i;
+
+	if ( list->time == level.time )
+	{
+		return list;
+	}
+
+	list->time = level.time;
+	list->numCandidates = 0;
+	botPerceptionStats.candidateBuilds++;
+
+	for ( i = 0; i < level.maxclients; i++ )
+	{
+		ent = &g_entities[ i ];
+
+		if ( ent->inuse && ent->client && BotGetEntityTeam( ent ) != TEAM_NONE && BotGetEntityTeam( ent ) != team )
+		{
+			list->candidates[ list->numCandidates++ ] = i;
+		}
+	}
+
+	for ( enemyTeam = ( team_t )( TEAM_NONE + 1 ); enemyTeam < NUM_TEAMS; enemyTeam = ( team_t )( enemyTeam + 1 ) )
+	{
+		if ( enemyTeam == team )
+		{
+			continue;
+		}
+
+		for ( ent = NULL; ( ent = G_IterateTeamBuildables( ent, enemyTeam ) ); )
+		{
+			list->candidates[ list->numCandidates++ ] = ent->s.number;
+		}
+	}
+
+	// keep the old g_entities order so ties are broken the same way
+	qsort( list->candidates, list->numCandidates, sizeof( int ), BotCompareEntityNumbers );
+
+	return list;
+}
+
+static void BotVisibilityCell( const vec3_t point, int cell[ 3 ] )
+{
+	int i;
+
+	for ( i = 0; i < 3; i++ )
+	{
+		cell[ i ] = ( int ) floorf( point[ i ] / VISIBILITY_CELL_SIZE );
+	}
+}
+
+/*
+================
+BotFindVisibility
+
+Looks up the line of sight from a muzzle cell to a target. The trace was
+made by whichever bot asked first, so a result whose trace was stopped by
+the asking bot doesn't count, it would have been ignored by its own trace.
+================
+*/
+static botVisibility_t *BotFindVisibility( int self, int target, int mask,
+                                           const int muzzleCell[ 3 ], const int targetCell[ 3 ], qboolean *found )
+{
+	unsigned int    hash = ( unsigned int ) target * 31 + ( unsigned int ) mask;
+	botVisibility_t *entry, *free = NULL;
+	int             i;
+
+	for ( i = 0; i < 3; i++ )
+	{
+		hash = ( hash * 31 + ( unsigned int ) muzzleCell[ i ] ) * 31 + ( unsigned int ) targetCell[ i ];
+	}
+
+	for ( i = 0; i < VISIBILITY_CACHE_PROBES; i++ )
+	{
+		entry = &botVisibilityCache[ ( hash + i ) & ( VISIBILITY_CACHE_SIZE - 1 ) ];
+
+		if ( entry->time != level.time )
+		{
+			if ( !free )
+			{
+				free = entry;
+			}
+
+			continue;
+		}
+
+		if ( entry->target == target && entry->mask == mask &&
+		     !memcmp( entry->muzzleCell, muzzleCell, sizeof( entry->muzzleCell ) ) &&
+		     !memcmp( entry->targetCell, targetCell, sizeof( entry->targetCell ) ) )
+		{
+			*found = entry->blocker != self;
+			return entry;
+		}
+	}
+
+	*found = qfalse;
+
+	// table is crowded this frame, evict the home slot
+	return free ? free : &botVisibilityCache[ hash & ( VISIBILITY_CACHE_SIZE - 1 ) ];
+}
+
+/*
+================
+G_BotPerceptionInfo
+
+Prints how many line of sight traces the perception cache has saved
+================
+*/
+void G_BotPerceptionInfo( void )
+{
+	int total = botPerceptionStats.hits + botPerceptionStats.misses;
+
+	G_Printf( "bot visibility cache: %d hits, %d misses (%d%% saved)\n",
+	          botPerceptionStats.hits, botPerceptionStats.misses,
+	          total ? botPerceptionStats.hits * 100 / total : 0 );
+	G_Printf( "last frame: %d hits, %d misses\n",
+	          botPerceptionStats.lastFrameHits, botPerceptionStats.lastFrameMisses );
+	G_Printf( "enemy candidate lists built: %d\n", botPerceptionStats.candidateBuilds );
+}
+
 /*
  = *======================
  Entity Querys
@@ -463,16 +658,11 @@ gentity_t* BotFindBuilding( gentity_t *self, int buildingType, int range )
 	gentity_t* closestBuilding = NULL;
 	float newDistance;
 	float rangeSquared = Square( range );
-	gentity_t *target = &g_entities[MAX_CLIENTS];
-	int i;
+	gentity_t *target = NULL;
 
-	for ( i = MAX_CLIENTS; i < level.num_entities; i++, target++ )
+	while ( ( target = G_IterateBuildables( target, ( buildable_t ) buildingType ) ) )
 	{
-		if ( !target->inuse )
-		{
-			continue;
-		}
-		if ( target->s.eType == ET_BUILDABLE && target->s.modelindex == buildingType && ( target->buildableTeam == TEAM_ALIENS || ( target->powered && target->spawned ) ) && target->health > 0 )
+		if ( ( target->buildableTeam == TEAM_ALIENS || ( target->powered && target->spawned ) ) && target->health > 0 )
 		{
 			newDistance = DistanceSquared( self->s.origin, target->s.origin );
 			if ( range && newDistance > rangeSquared )
@@ -502,41 +692,33 @@ void BotFindClosestBuildings( gentity_t *self )
 		self->botMind->closestBuildings[ i ].distance = INT_MAX;
 	}
 
-	for ( testEnt = &g_entities[MAX_CLIENTS]; testEnt < &g_entities[level.num_entities - 1]; testEnt++ )
+	for ( i = BA_NONE + 1; i < BA_NUM_BUILDABLES; i++ )
 	{
-		float newDist;
-		//ignore entities that arnt in use
-		if ( !testEnt->inuse )
-		{
-			continue;
-		}
-
-		//ignore dead targets
-		if ( testEnt->health <= 0 )
-		{
-			continue;
-		}
+		ent = &self->botMind->closestBuildings[ i ];
 
-		//skip non buildings
-		if ( testEnt->s.eType != ET_BUILDABLE )
+		for ( testEnt = NULL; ( testEnt = G_IterateBuildables( testEnt, ( buildable_t ) i ) ); )
 		{
-			continue;
-		}
+			float newDist;
 
-		//skip human buildings that are currently building or arn't powered
-		if ( testEnt->buildableTeam == TEAM_HUMANS && ( !testEnt->powered || !testEnt->spawned ) )
-		{
-			continue;
-		}
+			//ignore dead targets
+			if ( testEnt->health <= 0 )
+			{
+				continue;
+			}
 
-		newDist = Distance( self->s.origin, testEnt->s.origin );
+			//skip human buildings that are currently building or arn't powered
+			if ( testEnt->buildableTeam == TEAM_HUMANS && ( !testEnt->powered || !testEnt->spawned ) )
+			{
+				continue;
+			}
 
-		ent = &self->botMind->closestBuildings[ testEnt->s.modelindex ];
+			newDist = Distance( self->s.origin, testEnt->s.origin );
 
-		if ( newDist < ent->distance )
-		{
-			ent->ent = testEnt;
-			ent->distance = newDist;
+			if ( newDist < ent->distance )
+			{
+				ent->ent = testEnt;
+				ent->distance = newDist;
+			}
 		}
 	}
 }
@@ -551,25 +733,10 @@ void BotFindDamagedFriendlyStructure( gentity_t *self )
 
 	minDistSqr = Square( self->botMind->closestDamagedBuilding.distance );
 
-	for ( target = &g_entities[MAX_CLIENTS]; target < &g_entities[level.num_entities - 1]; target++ )
+	for ( target = NULL; ( target = G_IterateTeamBuildables( target, ( team_t ) self->client->pers.team ) ); )
 	{
 		float distSqr;
 
-		if ( !target->inuse )
-		{
-			continue;
-		}
-
-		if ( target->s.eType != ET_BUILDABLE )
-		{
-			continue;
-		}
-
-		if ( target->buildableTeam != self->client->pers.team )
-		{
-			continue;
-		}
-
 		if ( target->health >= BG_Buildable( ( buildable_t )target->s.modelindex )->health )
 		{
 			continue;
@@ -612,11 +779,15 @@ gentity_t* BotFindBestEnemy( gentity_t *self )
 	team_t    team = BotGetEntityTeam( self );
 	qboolean  hasRadar = ( team == TEAM_ALIENS ) ||
 	                     ( team == TEAM_HUMANS && BG_InventoryContainsUpgrade( UP_RADAR, self->client->ps.stats ) );
+	const botEnemyCandidates_t *list = BotEnemyCandidates( team );
+	int       i;
 
-	for ( target = g_entities; target < &g_entities[level.num_entities - 1]; target++ )
+	for ( i = 0; i < list->numCandidates; i++ )
 	{
 		float newScore;
 
+		target = &g_entities[ list->candidates[ i ] ];
+
 		if ( !BotEnemyIsValid( self, target ) )
 		{
 			continue;
@@ -667,10 +838,15 @@ gentity_t* BotFindClosestEnemy( gentity_t *self )
 	gentity_t* closestEnemy = NULL;
 	float minDistance = Square( ALIENSENSE_RANGE );
 	gentity_t *target;
+	const botEnemyCandidates_t *list = BotEnemyCandidates( BotGetEntityTeam( self ) );
+	int i;
 
-	for ( target = g_entities; target < &g_entities[level.num_entities - 1]; target++ )
+	for ( i = 0; i < list->numCandidates; i++ )
 	{
 		float newDistance;
+
+		target = &g_entities[ list->candidates[ i ] ];
+
 		//ignore entities that arnt in use
 		if ( !target->inuse )
 		{
@@ -991,6 +1167,9 @@ qboolean BotChangeGoal( gentity_t *self, botTarget_t target )
 		return qfalse;
 	}
 
+	// only fails if the goal is known to be unreachable, otherwise the route
+	// is searched over the next frames and BotEvaluateNode fails the node
+	// that picked the goal if no path is found
 	if ( !FindRouteToTarget( self, target, qfalse ) )
 	{
 		return qfalse;
@@ -998,6 +1177,8 @@ qboolean BotChangeGoal( gentity_t *self, botTarget_t target )
 
 	self->botMind->goal = target;
 	self->botMind->nav.directPathToGoal = qfalse;
+	self->botMind->nav.routePending = qtrue;
+	self->botMind->nav.routeFailed = qfalse;
 	return qtrue;
 }
 
@@ -1182,14 +1363,42 @@ qboolean BotTargetInAttackRange( gentity_t *self, botTarget_t target )
 
 qboolean BotTargetIsVisible( gentity_t *self, botTarget_t target, int mask )
 {
-	trace_t trace;
-	vec3_t  muzzle, targetPos;
-	vec3_t  forward, right, up;
+	trace_t         trace;
+	vec3_t          muzzle, targetPos;
+	vec3_t          forward, right, up;
+	int             muzzleCell[ 3 ], targetCell[ 3 ];
+	botVisibility_t *cached;
+	qboolean        found;
+	int             targetNum = BotGetTargetEntityNumber( target );
 
 	AngleVectors( self->client->ps.viewangles, forward, right, up );
 	G_CalcMuzzlePoint( self, forward, right, up, muzzle );
 	BotGetTargetPos( target, targetPos );
 
+	BotVisibilityCell( muzzle, muzzleCell );
+	BotVisibilityCell( targetPos, targetCell );
+
+	BotPerceptionFrame();
+	cached = BotFindVisibility( self->s.number, targetNum, mask, muzzleCell, targetCell, &found );
+
+	if ( found )
+	{
+		botPerceptionStats.hits++;
+		botPerceptionStats.frameHits++;
+		return cached->visible;
+	}
+
+	botPerceptionStats.misses++;
+	botPerceptionStats.frameMisses++;
+
+	cached->time = level.time;
+	cached->target = targetNum;
+	cached->mask = mask;
+	VectorCopy( muzzleCell, cached->muzzleCell );
+	VectorCopy( targetCell, cached->targetCell );
+	cached->blocker = ENTITYNUM_NONE;
+	cached->visible = qfalse;
+
 	if ( !trap_InPVS( muzzle, targetPos ) )
 	{
 		return qfalse;
@@ -1204,14 +1413,17 @@ qboolean BotTargetIsVisible( gentity_t *self, botTarget_t target, int mask )
 		trap_Trace( &trace, muzzle, NULL, NULL, targetPos, self->s.number, mask );
 	}
 
+	cached->blocker = trace.entityNum;
+
 	if ( trace.surfaceFlags & SURF_NOIMPACT )
 	{
 		return qfalse;
 	}
 
 	//target is in range
-	if ( ( trace.entityNum == BotGetTargetEntityNumber( target ) || trace.fraction == 1.0f ) && !trace.startsolid )
+	if ( ( trace.entityNum == targetNum || trace.fraction == 1.0f ) && !trace.startsolid )
 	{
+		cached->visible = qtrue;
 		return qtrue;
 	}
 	return qfalse;
@@ -2185,6 +2185,293 @@ static float OutgoingInterference( buildable_t buildable, gentity_t *neighbor, f
 	return power * MAX( 0.0f, 1.0f - ( distance / range ) );
 }
 
+/*
+================================================================================
+
+POWER GRAPH
+
+Human buildables are kept as nodes of a graph whose edges store the distances
+to the other human buildables in power relevant range, so that power
+calculations don't have to search the entity list for neighbors.  Every edge is
+listed with both the buildable it influences and the buildable it comes from,
+so that the buildables affected by a change of power state can be found, too.
+
+The graph is synchronized with the entity list before it is used, which only
+has to rebuild the edges of buildables that appeared, disappeared or moved.
+
+================================================================================
+*/
+
+typedef struct
+{
+	int   owner;         // buildable whose power is influenced
+	int   neighbor;      // buildable that influences it
+	float distance;
+	int   nextNeighbor;  // next edge with the same owner, sorted by neighbor
+	int   nextDependent; // next edge with the same neighbor
+} powerEdge_t;
+
+typedef struct
+{
+	qboolean member;
+	qboolean incomplete;     // ran out of edges, search neighbors the slow way
+	vec3_t   origin;         // origin the edges to this node were built for
+	vec3_t   center;         // bounding box center the edges from this node were built for
+	int      firstNeighbor;
+	int      firstDependent;
+} powerNode_t;
+
+// edge 0 terminates lists
+#define MAX_POWER_EDGES ( MAX_GENTITIES * 64 )
+
+static powerNode_t powerNodes[ MAX_GENTITIES ];
+static powerEdge_t powerEdges[ MAX_POWER_EDGES ];
+static int         powerFreeEdge;
+static int         powerNumEdges;
+static int         powerNumIncomplete;
+static int         powerGraphRange;
+
+static qboolean IsPowerGraphMember( gentity_t *ent )
+{
+	return ( ent->inuse && ent->s.eType == ET_BUILDABLE && ent->buildableTeam == TEAM_HUMANS );
+}
+
+static void PowerGraphCenter( gentity_t *ent, vec3_t center )
+{
+	VectorAdd( ent->r.mins, ent->r.maxs, center );
+	VectorMA( ent->r.currentOrigin, 0.5f, center, center );
+}
+
+static void ClearPowerGraph( void )
+{
+	memset( powerNodes, 0, sizeof( powerNodes ) );
+	powerFreeEdge = 0;
+	powerNumEdges = 0;
+	powerNumIncomplete = 0;
+}
+
+static void AddPowerEdge( int owner, int neighbor, float distance )
+{
+	powerEdge_t *edge;
+	int         edgeNum, *link;
+
+	if ( powerFreeEdge )
+	{
+		edgeNum = powerFreeEdge;
+		powerFreeEdge = powerEdges[ edgeNum ].nextNeighbor;
+	}
+	else if ( powerNumEdges < MAX_POWER_EDGES - 1 )
+	{
+		edgeNum = ++powerNumEdges;
+	}
+	else
+	{
+		if ( !powerNodes[ owner ].incomplete )
+		{
+			G_Printf( S_WARNING "AddPowerEdge: MAX_POWER_EDGES reached\n" );
+			powerNodes[ owner ].incomplete = qtrue;
+			powerNumIncomplete++;
+		}
+
+		return;
+	}
+
+	edge = &powerEdges[ edgeNum ];
+	edge->owner = owner;
+	edge->neighbor = neighbor;
+	edge->distance = distance;
+
+	// keep neighbors in entity order, so power is summed up as by an entity search
+	for ( link = &powerNodes[ owner ].firstNeighbor;
+	      *link && powerEdges[ *link ].neighbor < neighbor;
+	      link = &powerEdges[ *link ].nextNeighbor );
+
+	edge->nextNeighbor = *link;
+	*link = edgeNum;
+
+	edge->nextDependent = powerNodes[ neighbor ].firstDependent;
+	powerNodes[ neighbor ].firstDependent = edgeNum;
+}
+
+static void RemovePowerNode( int nodeNum )
+{
+	powerNode_t *node = &powerNodes[ nodeNum ];
+	int         edgeNum, nextEdgeNum, *link;
+
+	// unlink the edges from the other ends of the lists
+	for ( edgeNum = node->firstNeighbor; edgeNum; edgeNum = powerEdges[ edgeNum ].nextNeighbor )
+	{
+		for ( link = &powerNodes[ powerEdges[ edgeNum ].neighbor ].firstDependent;
+		      *link != edgeNum; link = &powerEdges[ *link ].nextDependent );
+
+		*link = powerEdges[ edgeNum ].nextDependent;
+	}
+
+	for ( edgeNum = node->firstDependent; edgeNum; edgeNum = powerEdges[ edgeNum ].nextDependent )
+	{
+		for ( link = &powerNodes[ powerEdges[ edgeNum ].owner ].firstNeighbor;
+		      *link != edgeNum; link = &powerEdges[ *link ].nextNeighbor );
+
+		*link = powerEdges[ edgeNum ].nextNeighbor;
+	}
+
+	// release the edges
+	for ( edgeNum = node->firstNeighbor; edgeNum; edgeNum = nextEdgeNum )
+	{
+		nextEdgeNum = powerEdges[ edgeNum ].nextNeighbor;
+		powerEdges[ edgeNum ].nextNeighbor = powerFreeEdge;
+		powerFreeEdge = edgeNum;
+	}
+
+	for ( edgeNum = node->firstDependent; edgeNum; edgeNum = nextEdgeNum )
+	{
+		nextEdgeNum = powerEdges[ edgeNum ].nextDependent;
+		powerEdges[ edgeNum ].nextNeighbor = powerFreeEdge;
+		powerFreeEdge = edgeNum;
+	}
+
+	if ( node->incomplete )
+	{
+		powerNumIncomplete--;
+	}
+
+	memset( node, 0, sizeof( *node ) );
+}
+
+static void AddPowerNode( int nodeNum )
+{
+	powerNode_t *node = &powerNodes[ nodeNum ];
+	gentity_t   *ent = &g_entities[ nodeNum ], *other;
+	int         otherNum;
+	float       distance;
+
+	node->member = qtrue;
+	VectorCopy( ent->s.origin, node->origin );
+	PowerGraphCenter( ent, node->center );
+
+	// use the same neighborhood as G_IterateEntitiesWithinRadius would
+	for ( otherNum = MAX_CLIENTS; otherNum < level.num_entities; otherNum++ )
+	{
+		if ( otherNum == nodeNum || !powerNodes[ otherNum ].member )
+		{
+			continue;
+		}
+
+		other = &g_entities[ otherNum ];
+		distance = Distance( ent->s.origin, other->s.origin );
+
+		if ( G_EntityWithinRadius( other, ent->s.origin, powerGraphRange ) )
+		{
+			AddPowerEdge( nodeNum, otherNum, distance );
+		}
+
+		if ( G_EntityWithinRadius( ent, other->s.origin, powerGraphRange ) )
+		{
+			AddPowerEdge( otherNum, nodeNum, distance );
+		}
+	}
+}
+
+/*
+================
+UpdatePowerGraph
+
+Adds, removes and reconnects the nodes of buildables that changed since the last update.
+================
+*/
+static void UpdatePowerGraph( void )
+{
+	gentity_t   *ent;
+	powerNode_t *node;
+	vec3_t      center;
+	int         entNum, numAdded, added[ MAX_GENTITIES ];
+
+	if ( powerGraphRange != PowerRelevantRange() )
+	{
+		ClearPowerGraph();
+		powerGraphRange = PowerRelevantRange();
+	}
+
+	numAdded = 0;
+
+	// also visit slots past level.num_entities, which shrinks on restarts
+	for ( entNum = MAX_CLIENTS; entNum < MAX_GENTITIES; entNum++ )
+	{
+		ent = &g_entities[ entNum ];
+		node = &powerNodes[ entNum ];
+
+		if ( !IsPowerGraphMember( ent ) )
+		{
+			if ( node->member )
+			{
+				RemovePowerNode( entNum );
+			}
+
+			continue;
+		}
+
+		if ( node->member )
+		{
+			PowerGraphCenter( ent, center );
+
+			if ( VectorCompare( node->origin, ent->s.origin ) && VectorCompare( node->center, center ) )
+			{
+				continue;
+			}
+
+			RemovePowerNode( entNum );
+		}
+
+		added[ numAdded++ ] = entNum;
+	}
+
+	// add nodes only after all stale ones have been removed
+	for ( entNum = 0; entNum < numAdded; entNum++ )
+	{
+		AddPowerNode( added[ entNum ] );
+	}
+}
+
+/*
+================
+PowerNeighbors
+
+Fills in a list of the human buildables in power relevant range of a buildable,
+in entity order, along with their distances.
+================
+*/
+static int PowerNeighbors( gentity_t *self, gentity_t **neighbors, float *distances )
+{
+	powerNode_t *node = &powerNodes[ self->s.number ];
+	gentity_t   *neighbor;
+	int         edgeNum, numNeighbors = 0;
+
+	if ( node->member && !node->incomplete )
+	{
+		for ( edgeNum = node->firstNeighbor; edgeNum; edgeNum = powerEdges[ edgeNum ].nextNeighbor )
+		{
+			neighbors[ numNeighbors ] = &g_entities[ powerEdges[ edgeNum ].neighbor ];
+			distances[ numNeighbors++ ] = powerEdges[ edgeNum ].distance;
+		}
+
+		return numNeighbors;
+	}
+
+	neighbor = NULL;
+	while ( ( neighbor = G_IterateEntitiesWithinRadius( neighbor, self->s.origin, PowerRelevantRange() ) ) )
+	{
+		if ( neighbor == self || !IsPowerGraphMember( neighbor ) )
+		{
+			continue;
+		}
+
+		neighbors[ numNeighbors ] = neighbor;
+		distances[ numNeighbors++ ] = Distance( self->s.origin, neighbor->s.origin );
+	}
+
+	return numNeighbors;
+}
+
 /*
 =================
 CalculateSparePower
@@ -2194,8 +2481,9 @@ Calculates the current and expected amount of spare power of a buildable.
 */
 static void CalculateSparePower( gentity_t *self )
 {
-	gentity_t *neighbor;
-	float     distance;
+	gentity_t *neighbor, *neighbors[ MAX_GENTITIES ];
+	float     distance, distances[ MAX_GENTITIES ];
+	int       neighborNum, numNeighbors;
 	int       powerConsumption, currentBaseSupply, expectedBaseSupply;
 
 	if ( self->s.eType != ET_BUILDABLE || self->buildableTeam != TEAM_HUMANS )
@@ -2236,15 +2524,12 @@ static void CalculateSparePower( gentity_t *self )
 		self->currentSparePower = 0;
 	}
 
-	neighbor = NULL;
-	while ( ( neighbor = G_IterateEntitiesWithinRadius( neighbor, self->s.origin, PowerRelevantRange() ) ) )
-	{
-		if ( self == neighbor )
-		{
-			continue;
-		}
+	numNeighbors = PowerNeighbors( self, neighbors, distances );
 
-		distance = Distance( self->s.origin, neighbor->s.origin );
+	for ( neighborNum = 0; neighborNum < numNeighbors; neighborNum++ )
+	{
+		neighbor = neighbors[ neighborNum ];
+		distance = distances[ neighborNum ];
 
 		self->expectedSparePower += IncomingInterference( (buildable_t) self->s.modelindex, neighbor, distance, qtrue );
 
@@ -2268,21 +2553,43 @@ static void CalculateSparePower( gentity_t *self )
 }
 
 
+/*
+=================
+CanBePoweredDown
+
+Whether a buildable takes part in the search for the highest power deficit.
+=================
+*/
+static qboolean CanBePoweredDown( gentity_t *ent )
+{
+	// ignore buildables that haven't yet spawned or are already powered down
+	if ( !ent->spawned || !ent->powered )
+	{
+		return qfalse;
+	}
+
+	// ignore buildables that need no power
+	if ( !BG_Buildable( ent->s.modelindex )->powerConsumption )
+	{
+		return qfalse;
+	}
+
+	return qtrue;
+}
+
 /*
 =================
 G_SetHumanBuildablePowerState
 
 Powers human buildables up and down based on available power and reactor status.
 Updates expected spare power for all human buildables.
-
-TODO: Assemble a list of relevant entities first.
 =================
 */
 void G_SetHumanBuildablePowerState()
 {
-	qboolean  done;
 	float     lowestSparePower;
-	gentity_t *ent = NULL, *lowestSparePowerEnt;
+	gentity_t *ent, *lowestSparePowerEnt;
+	int       entNum, edgeNum;
 
 	static int nextCalculation = 0;
 
@@ -2291,16 +2598,19 @@ void G_SetHumanBuildablePowerState()
 		return;
 	}
 
+	UpdatePowerGraph();
+
 	// first pass: predict spare power for all buildables,
 	//             power up buildables that have enough power
-	while ( ( ent = G_IterateEntities( ent, NULL, qfalse, 0, NULL ) ) )
+	for ( entNum = MAX_CLIENTS; entNum < level.num_entities; entNum++ )
 	{
-		// discard irrelevant entities
-		if ( ent->s.eType != ET_BUILDABLE || ent->buildableTeam != TEAM_HUMANS )
+		if ( !powerNodes[ entNum ].member )
 		{
 			continue;
 		}
 
+		ent = &g_entities[ entNum ];
+
 		CalculateSparePower( ent );
 
 		if ( ent->currentSparePower >= 0.0f )
@@ -2309,35 +2619,33 @@ void G_SetHumanBuildablePowerState()
 		}
 	}
 
+	// second pass: update spare power with regard to the new power states
+	for ( entNum = MAX_CLIENTS; entNum < level.num_entities; entNum++ )
+	{
+		ent = &g_entities[ entNum ];
+
+		if ( powerNodes[ entNum ].member && CanBePoweredDown( ent ) )
+		{
+			CalculateSparePower( ent );
+		}
+	}
+
 	// power down buildables that lack power, highest deficit first
-	do
+	for ( ;; )
 	{
 		lowestSparePowerEnt = NULL;
 		lowestSparePower = MAX_QINT;
 
 		// find buildable with highest power deficit
-		while ( ( ent = G_IterateEntities( ent, NULL, qfalse, 0, NULL ) ) )
+		for ( entNum = MAX_CLIENTS; entNum < level.num_entities; entNum++ )
 		{
-			// discard irrelevant entities
-			if ( ent->s.eType != ET_BUILDABLE || ent->buildableTeam != TEAM_HUMANS )
-			{
-				continue;
-			}
+			ent = &g_entities[ entNum ];
 
-			// ignore buildables that haven't yet spawned or are already powered down
-			if ( !ent->spawned || !ent->powered )
+			if ( !powerNodes[ entNum ].member || !CanBePoweredDown( ent ) )
 			{
 				continue;
 			}
 
-			// ignore buildables that need no power
-			if ( !BG_Buildable( ent->s.modelindex )->powerConsumption )
-			{
-				continue;
-			}
-
-			CalculateSparePower( ent );
-
 			// never shut down the telenode, even if it was set to consume power and operates below
 			// its threshold
 			if ( ent->s.modelindex == BA_H_SPAWN )
@@ -2352,17 +2660,36 @@ void G_SetHumanBuildablePowerState()
 			}
 		}
 
-		if ( lowestSparePower < 0.0f )
+		if ( lowestSparePower >= 0.0f )
 		{
-			lowestSparePowerEnt->powered = qfalse;
-			done = qfalse;
+			break;
 		}
-		else
+
+		lowestSparePowerEnt->powered = qfalse;
+
+		// only the buildables in range of the one powered down are affected
+		for ( edgeNum = powerNodes[ lowestSparePowerEnt->s.number ].firstDependent; edgeNum;
+		      edgeNum = powerEdges[ edgeNum ].nextDependent )
+		{
+			ent = &g_entities[ powerEdges[ edgeNum ].owner ];
+
+			if ( CanBePoweredDown( ent ) )
+			{
+				CalculateSparePower( ent );
+			}
+		}
+
+		// buildables with incomplete edges might be affected without knowing
+		for ( entNum = MAX_CLIENTS; powerNumIncomplete && entNum < level.num_entities; entNum++ )
 		{
-			done = qtrue;
+			ent = &g_entities[ entNum ];
+
+			if ( powerNodes[ entNum ].incomplete && CanBePoweredDown( ent ) )
+			{
+				CalculateSparePower( ent );
+			}
 		}
 	}
-	while ( !done );
 
 	nextCalculation = level.time + 500;
 }
@@ -2391,7 +2718,8 @@ void HGeneric_Blast( gentity_t *self )
 	// begin freeing build points
 	G_RewardAttackers( self );
 
-	// turn into an explosion
+	// turn into an explosion, which is no longer a buildable
+	G_UnregisterBuildable( self );
 	self->s.eType = (entityType_t) ( ET_EVENTS + EV_HUMAN_BUILDABLE_EXPLOSION );
 	self->freeAfterEvent = qtrue;
 	G_AddEvent( self, EV_HUMAN_BUILDABLE_EXPLOSION, DirToByte( dir ) );
@@ -3601,15 +3929,15 @@ qboolean G_BuildableInRange( vec3_t origin, float radius, buildable_t buildable
 {
 	gentity_t *neighbor = NULL;
 
-	while ( ( neighbor = G_IterateEntitiesWithinRadius( neighbor, origin, radius ) ) )
+	while ( ( neighbor = G_IterateBuildables( neighbor, buildable ) ) )
 	{
-		if ( neighbor->s.eType != ET_BUILDABLE || !neighbor->spawned || neighbor->health <= 0 ||
+		if ( !neighbor->spawned || neighbor->health <= 0 ||
 		     ( neighbor->buildableTeam == TEAM_HUMANS && !neighbor->powered ) )
 		{
 			continue;
 		}
 
-		if ( neighbor->s.modelindex == buildable )
+		if ( G_EntityWithinRadius( neighbor, origin, radius ) )
 		{
 			return qtrue;
 		}
@@ -3627,20 +3955,131 @@ Finds a buildable of the specified type
 */
 static gentity_t *FindBuildable( buildable_t buildable )
 {
-	int       i;
-	gentity_t *ent;
+	gentity_t *ent = NULL;
 
-	for ( i = MAX_CLIENTS, ent = g_entities + i;
-	      i < level.num_entities; i++, ent++ )
+	while ( ( ent = G_IterateBuildables( ent, buildable ) ) )
 	{
-		if ( ent->s.eType != ET_BUILDABLE )
+		if ( !( ent->s.eFlags & EF_DEAD ) )
 		{
-			continue;
+			return ent;
 		}
+	}
 
-		if ( ent->s.modelindex == buildable && !( ent->s.eFlags & EF_DEAD ) )
+	return NULL;
+}
+
+/*
+================
+RegisterBuildable
+
+Adds a new buildable to the list of its type, keeping the list in entity order
+================
+*/
+static void RegisterBuildable( gentity_t *ent )
+{
+	gentity_t **link, *prev = NULL;
+
+	for ( link = &level.buildables[ ent->s.modelindex ]; *link && *link < ent; link = &( *link )->nextBuildableOfType )
+	{
+		prev = *link;
+	}
+
+	ent->prevBuildableOfType = prev;
+	ent->nextBuildableOfType = *link;
+
+	if ( *link )
+	{
+		( *link )->prevBuildableOfType = ent;
+	}
+
+	*link = ent;
+}
+
+/*
+================
+G_UnregisterBuildable
+
+Removes a buildable from the list of its type, called when it is freed or
+stops being a buildable. Entities that are not in a list are left alone.
+================
+*/
+void G_UnregisterBuildable( gentity_t *ent )
+{
+	if ( ent->s.modelindex <= BA_NONE || ent->s.modelindex >= BA_NUM_BUILDABLES )
+	{
+		return;
+	}
+
+	if ( ent->prevBuildableOfType )
+	{
+		ent->prevBuildableOfType->nextBuildableOfType = ent->nextBuildableOfType;
+	}
+	else if ( level.buildables[ ent->s.modelindex ] == ent )
+	{
+		level.buildables[ ent->s.modelindex ] = ent->nextBuildableOfType;
+	}
+	else
+	{
+		return; // not registered
+	}
+
+	if ( ent->nextBuildableOfType )
+	{
+		ent->nextBuildableOfType->prevBuildableOfType = ent->prevBuildableOfType;
+	}
+
+	ent->prevBuildableOfType = ent->nextBuildableOfType = NULL;
+}
+
+/*
+================
+G_IterateBuildables
+
+Iterates through all buildables of a type in entity order, including dead ones.
+Set NULL as previous buildable to start the iteration from the beginning.
+================
+*/
+gentity_t *G_IterateBuildables( gentity_t *ent, buildable_t buildable )
+{
+	ent = ent ? ent->nextBuildableOfType : level.buildables[ buildable ];
+
+	// freed entities and ones that turned into something else must have left the list
+	assert( !ent || ( ent->inuse && ent->s.eType == ET_BUILDABLE && ent->s.modelindex == buildable ) );
+
+	return ent;
+}
+
+/*
+================
+G_IterateTeamBuildables
+
+Iterates through all buildables of a team, one type after another.
+Set NULL as previous buildable to start the iteration from the beginning.
+================
+*/
+gentity_t *G_IterateTeamBuildables( gentity_t *ent, team_t team )
+{
+	int buildable;
+
+	if ( ent )
+	{
+		if ( ent->nextBuildableOfType )
 		{
-			return ent;
+			return ent->nextBuildableOfType;
+		}
+
+		buildable = ent->s.modelindex + 1;
+	}
+	else
+	{
+		buildable = BA_NONE + 1;
+	}
+
+	for ( ; buildable < BA_NUM_BUILDABLES; buildable++ )
+	{
+		if ( level.buildables[ buildable ] && BG_Buildable( buildable )->team == team )
+		{
+			return level.buildables[ buildable ];
 		}
 	}
 
@@ -3962,9 +4401,9 @@ Takes buildables prepared for deconstruction into account.
 */
 static qboolean PredictBuildablePower( buildable_t buildable, vec3_t origin )
 {
-	gentity_t       *neighbor, *buddy;
-	float           distance, ownPrediction, neighborPrediction;
-	int             powerConsumption, baseSupply;
+	gentity_t       *neighbor, *buddies[ MAX_GENTITIES ];
+	float           distance, distances[ MAX_GENTITIES ], ownPrediction, neighborPrediction;
+	int             buddyNum, numBuddies, powerConsumption, baseSupply;
 
 	powerConsumption = BG_Buildable( buildable )->powerConsumption;
 
@@ -3985,6 +4424,9 @@ static qboolean PredictBuildablePower( buildable_t buildable, vec3_t origin )
 
 	ownPrediction = baseSupply - powerConsumption;
 
+	// the neighbors of existing buildables are looked up in the power graph
+	UpdatePowerGraph();
+
 	neighbor = NULL;
 	while ( ( neighbor = G_IterateEntitiesWithinRadius( neighbor, origin, PowerRelevantRange() ) ) )
 	{
@@ -4008,13 +4450,14 @@ static qboolean PredictBuildablePower( buildable_t buildable, vec3_t origin )
 		// check power of neighbor, with regards to pending deconstruction
 		if ( neighborPrediction < 0.0f && distance < g_powerCompetitionRange.integer )
 		{
-			buddy = NULL;
-			while ( ( buddy = G_IterateEntitiesWithinRadius( buddy, neighbor->s.origin, PowerRelevantRange() ) ) )
+			numBuddies = PowerNeighbors( neighbor, buddies, distances );
+
+			for ( buddyNum = 0; buddyNum < numBuddies; buddyNum++ )
 			{
-				if ( IsSetForDeconstruction( buddy ) )
+				if ( IsSetForDeconstruction( buddies[ buddyNum ] ) )
 				{
-					distance = Distance( neighbor->s.origin, buddy->s.origin );
-					neighborPrediction -= IncomingInterference( (buildable_t) neighbor->s.modelindex, buddy, distance, qtrue );
+					neighborPrediction -= IncomingInterference( (buildable_t) neighbor->s.modelindex, buddies[ buddyNum ],
+					                                            distances[ buddyNum ], qtrue );
 				}
 			}
 
@@ -4559,6 +5002,7 @@ static gentity_t *Build( gentity_t *builder, buildable_t buildable,
 	built->s.modelindex = buildable;
 	built->s.modelindex2 = attr->team;
 	built->buildableTeam = (team_t) built->s.modelindex2;
+	RegisterBuildable( built );
 	BG_BuildableBoundingBox( buildable, built->r.mins, built->r.maxs );
 
 	built->health = ( int )ceil( attr->health * BUILDABLE_START_HEALTH_FRAC );
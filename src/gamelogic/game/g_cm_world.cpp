@@ -39,8 +39,14 @@ Maryland 20850 USA.
 
 typedef struct worldEntity_s
 {
-	struct worldSector_s *worldSector;
-	struct worldEntity_s *nextEntityInWorldSector;
+	struct worldNode_s   *worldNode;
+	struct worldEntity_s *prevEntityInWorldNode;
+	struct worldEntity_s *nextEntityInWorldNode;
+	vec3_t               fatMins, fatMaxs; // the box the node was chosen for
+
+	struct worldEntity_s **gridBucket;
+	struct worldEntity_s *prevEntityInGridBucket;
+	struct worldEntity_s *nextEntityInGridBucket;
 } worldEntity_t;
 
 worldEntity_t wentities[ MAX_GENTITIES ];
@@ -231,54 +237,318 @@ qboolean G_CM_EntityContact( const vec3_t mins, const vec3_t maxs, const gentity
 ENTITY CHECKING
 
 To avoid linearly searching through lists of entities during environment testing,
-the world is carved up with an evenly spaced, axially aligned bsp tree.  Entities
-are kept in chains either at the final leafs, or at the first node that splits
-them, which prevents having to deal with multiple fragments of a single entity.
+linked entities are kept in a loose octree covering the world.  The bounds of a
+node are twice the size of its cell, so an entity never has to be split: it is
+stored at the deepest node whose cell contains the center of its box and whose
+cell half size is at least as large as the box's largest half extent.  Unlike
+a plain bsp tree this does not pile everything straddling a split onto the
+upper nodes, which matters on large open maps with many buildables.
+
+Nodes are chosen using a fat box, the entity's absolute box grown by
+OCTREE_FAT_MARGIN.  Relinking an entity whose box still fits into its fat box
+keeps it in place, so moving entities only change nodes every so often.  Nodes
+are allocated when an entity first needs them and released once their whole
+subtree is empty.
 
 ===============================================================================
 */
 
-typedef struct worldSector_s
+#define OCTREE_DEPTH      6
+#define OCTREE_NODES      4096
+#define OCTREE_FAT_MARGIN 16.0f
+
+typedef struct worldNode_s
 {
-	int                  axis; // -1 = leaf node
-	float                dist;
-	struct worldSector_s *children[ 2 ];
+	vec3_t             center;
+	float              halfSize; // of the cell, the loose bounds are twice as large
+	vec3_t             mins, maxs; // loose bounds
+	int                depth;
+
+	struct worldNode_s *parent; // next free node while unused
+	struct worldNode_s *children[ 8 ];
+
+	worldEntity_t      *entities;
+	int                numEntities;
+	int                numSubtreeEntities; // including those of all children
+} worldNode_t;
+
+static worldNode_t worldNodes[ OCTREE_NODES ]; // the first one is the root
+static worldNode_t *freeWorldNodes;
+static int         numWorldNodes;
+static int         worldNodeKeeps; // relinks that stayed within the fat box
+static int         worldNodeMoves; // relinks that had to find a new node
+
+static worldNode_t *G_CM_AllocWorldNode( worldNode_t *parent, int childNum )
+{
+	worldNode_t *node;
+	int         i;
 
-	worldEntity_t        *entities;
-} worldSector_t;
+	if ( !freeWorldNodes )
+	{
+		return NULL;
+	}
 
-#define AREA_DEPTH 4
-#define AREA_NODES 64
+	node = freeWorldNodes;
+	freeWorldNodes = node->parent;
+	numWorldNodes++;
+
+	memset( node, 0, sizeof( *node ) );
+	node->parent = parent;
+	node->depth = parent->depth + 1;
+	node->halfSize = parent->halfSize * 0.5f;
+
+	for ( i = 0; i < 3; i++ )
+	{
+		node->center[ i ] = parent->center[ i ] + ( ( childNum & ( 1 << i ) ) ? node->halfSize : -node->halfSize );
+		node->mins[ i ] = node->center[ i ] - 2.0f * node->halfSize;
+		node->maxs[ i ] = node->center[ i ] + 2.0f * node->halfSize;
+	}
+
+	parent->children[ childNum ] = node;
+
+	return node;
+}
 
-worldSector_t sv_worldSectors[ AREA_NODES ];
-int           sv_numworldSectors;
+static void G_CM_FreeWorldNode( worldNode_t *node )
+{
+	int i;
+
+	for ( i = 0; i < 8; i++ )
+	{
+		if ( node->children[ i ] )
+		{
+			G_CM_FreeWorldNode( node->children[ i ] );
+		}
+	}
+
+	node->parent = freeWorldNodes;
+	freeWorldNodes = node;
+	numWorldNodes--;
+}
 
 /*
 ===============
-G_CM_SectorList_f
+G_CM_InsertWorldEntity
+
+Recomputes the fat box and stores the entity at the matching node
 ===============
 */
-void G_CM_SectorList_f( void )
+static void G_CM_InsertWorldEntity( worldEntity_t *went, const gentity_t *gEnt )
 {
-	int           i, c;
-	worldSector_t *sec;
-	worldEntity_t    *ent;
+	worldNode_t *node, *child;
+	vec3_t      center;
+	float       radius;
+	qboolean    inside;
+	int         i, childNum;
 
-	for ( i = 0; i < AREA_NODES; i++ )
+	radius = 0.0f;
+	inside = qtrue;
+
+	for ( i = 0; i < 3; i++ )
 	{
-		sec = &sv_worldSectors[ i ];
+		went->fatMins[ i ] = gEnt->r.absmin[ i ] - OCTREE_FAT_MARGIN;
+		went->fatMaxs[ i ] = gEnt->r.absmax[ i ] + OCTREE_FAT_MARGIN;
+
+		center[ i ] = 0.5f * ( went->fatMins[ i ] + went->fatMaxs[ i ] );
+		radius = MAX( radius, 0.5f * ( went->fatMaxs[ i ] - went->fatMins[ i ] ) );
+
+		if ( fabs( center[ i ] - worldNodes[ 0 ].center[ i ] ) > worldNodes[ 0 ].halfSize )
+		{
+			inside = qfalse;
+		}
+	}
+
+	node = worldNodes;
+
+	// entities centered outside of the world stay at the root, which is always searched
+	while ( inside && node->depth < OCTREE_DEPTH && radius <= node->halfSize * 0.5f )
+	{
+		childNum = 0;
+
+		for ( i = 0; i < 3; i++ )
+		{
+			if ( center[ i ] > node->center[ i ] )
+			{
+				childNum |= 1 << i;
+			}
+		}
 
-		c = 0;
+		child = node->children[ childNum ];
 
-		for ( ent = sec->entities; ent; ent = ent->nextEntityInWorldSector )
+		if ( !child && !( child = G_CM_AllocWorldNode( node, childNum ) ) )
 		{
-			c++;
+			break; // out of nodes, but the current one still bounds the entity
 		}
 
-		Com_Printf( "sector %i: %i entities\n", i, c );
+		node = child;
+	}
+
+	went->worldNode = node;
+	went->prevEntityInWorldNode = NULL;
+	went->nextEntityInWorldNode = node->entities;
+
+	if ( node->entities )
+	{
+		node->entities->prevEntityInWorldNode = went;
+	}
+
+	node->entities = went;
+	node->numEntities++;
+
+	for ( ; node; node = node->parent )
+	{
+		node->numSubtreeEntities++;
+	}
+}
+
+/*
+===============
+G_CM_RemoveWorldEntity
+===============
+*/
+static void G_CM_RemoveWorldEntity( worldEntity_t *went )
+{
+	worldNode_t *node, *empty;
+	int         i;
+
+	node = went->worldNode;
+
+	if ( !node )
+	{
+		return;
+	}
+
+	if ( went->prevEntityInWorldNode )
+	{
+		went->prevEntityInWorldNode->nextEntityInWorldNode = went->nextEntityInWorldNode;
+	}
+	else
+	{
+		node->entities = went->nextEntityInWorldNode;
+	}
+
+	if ( went->nextEntityInWorldNode )
+	{
+		went->nextEntityInWorldNode->prevEntityInWorldNode = went->prevEntityInWorldNode;
+	}
+
+	went->worldNode = NULL;
+	went->prevEntityInWorldNode = went->nextEntityInWorldNode = NULL;
+	node->numEntities--;
+
+	for ( empty = node; empty; empty = empty->parent )
+	{
+		empty->numSubtreeEntities--;
+	}
+
+	// release the largest subtree that has become empty
+	for ( empty = NULL; node->parent && !node->numSubtreeEntities; node = node->parent )
+	{
+		empty = node;
+	}
+
+	if ( empty )
+	{
+		for ( i = 0; i < 8; i++ )
+		{
+			if ( empty->parent->children[ i ] == empty )
+			{
+				empty->parent->children[ i ] = NULL;
+			}
+		}
+
+		G_CM_FreeWorldNode( empty );
+	}
+}
+
+#define MAX_NODE_STATS_DEPTH ( OCTREE_DEPTH + 1 )
+
+typedef struct
+{
+	int nodes[ MAX_NODE_STATS_DEPTH ];
+	int occupied[ MAX_NODE_STATS_DEPTH ];
+	int entities[ MAX_NODE_STATS_DEPTH ];
+	int longest[ MAX_NODE_STATS_DEPTH ];
+} nodeStats_t;
+
+static void G_CM_WorldNodeStats_r( const worldNode_t *node, nodeStats_t *stats )
+{
+	int i;
+
+	stats->nodes[ node->depth ]++;
+	stats->entities[ node->depth ] += node->numEntities;
+	stats->longest[ node->depth ] = MAX( stats->longest[ node->depth ], node->numEntities );
+
+	if ( node->numEntities )
+	{
+		stats->occupied[ node->depth ]++;
+	}
+
+	for ( i = 0; i < 8; i++ )
+	{
+		if ( node->children[ i ] )
+		{
+			G_CM_WorldNodeStats_r( node->children[ i ], stats );
+		}
+	}
+}
+
+/*
+===============
+G_CM_SectorList_f
+
+Prints how the linked entities are spread over the octree
+===============
+*/
+void G_CM_SectorList_f( void )
+{
+	nodeStats_t stats;
+	int         i;
+
+	memset( &stats, 0, sizeof( stats ) );
+	G_CM_WorldNodeStats_r( worldNodes, &stats );
+
+	for ( i = 0; i < MAX_NODE_STATS_DEPTH; i++ )
+	{
+		Com_Printf( "depth %i (%5.0fu): %4i nodes, %4i occupied, %4i entities, %3i at most\n", i,
+		            worldNodes[ 0 ].halfSize * 2.0f / ( 1 << i ), stats.nodes[ i ], stats.occupied[ i ],
+		            stats.entities[ i ], stats.longest[ i ] );
 	}
+
+	Com_Printf( "%i of %i nodes in use, %i entities\n", numWorldNodes, OCTREE_NODES,
+	            worldNodes[ 0 ].numSubtreeEntities );
+	Com_Printf( "%i relinks kept their node, %i moved\n", worldNodeKeeps, worldNodeMoves );
 }
 
+/*
+===============================================================================
+
+SECTOR TREE
+
+The evenly spaced, axially aligned bsp tree that used to hold the linked
+entities.  It is only built on demand by G_CM_SectorBenchmark_f to compare
+against the octree.
+
+===============================================================================
+*/
+
+typedef struct worldSector_s
+{
+	int                  axis; // -1 = leaf node
+	float                dist;
+	struct worldSector_s *children[ 2 ];
+
+	int                  entities; // -1 terminated, chained through nextEntityInSector
+} worldSector_t;
+
+#define AREA_DEPTH 4
+#define AREA_NODES 64
+
+static worldSector_t sv_worldSectors[ AREA_NODES ];
+static int           sv_numworldSectors;
+static int           nextEntityInSector[ MAX_GENTITIES ];
+static qboolean      areaUseSectors;
+
 /*
 ===============
 G_CM_CreateworldSector
@@ -286,7 +556,7 @@ G_CM_CreateworldSector
 Builds a uniformly subdivided tree for the given world size
 ===============
 */
-worldSector_t  *G_CM_CreateworldSector( int depth, vec3_t mins, vec3_t maxs )
+static worldSector_t *G_CM_CreateworldSector( int depth, vec3_t mins, vec3_t maxs )
 {
 	worldSector_t *anode;
 	vec3_t        size;
@@ -295,6 +565,8 @@ worldSector_t  *G_CM_CreateworldSector( int depth, vec3_t mins, vec3_t maxs )
 	anode = &sv_worldSectors[ sv_numworldSectors ];
 	sv_numworldSectors++;
 
+	anode->entities = -1;
+
 	if ( depth == AREA_DEPTH )
 	{
 		anode->axis = -1;
@@ -329,65 +601,396 @@ worldSector_t  *G_CM_CreateworldSector( int depth, vec3_t mins, vec3_t maxs )
 
 /*
 ===============
-G_CM_ClearWorld
+G_CM_BuildSectorTree
 
+Puts every entity that is currently in the octree into a fresh sector tree
 ===============
 */
-void G_CM_ClearWorld( void )
+static void G_CM_BuildSectorTree( void )
 {
-	clipHandle_t h;
-	vec3_t       mins, maxs;
+	worldSector_t *node;
+	gentity_t     *gEnt;
+	vec3_t        mins, maxs;
+	int           i;
 
 	memset( sv_worldSectors, 0, sizeof( sv_worldSectors ) );
-	memset( wentities, 0, sizeof( wentities ) );
 	sv_numworldSectors = 0;
 
-	// get world map bounds
-	h = CM_InlineModel( 0 );
-	CM_ModelBounds( h, mins, maxs );
+	CM_ModelBounds( CM_InlineModel( 0 ), mins, maxs );
 	G_CM_CreateworldSector( 0, mins, maxs );
+
+	for ( i = 0; i < MAX_GENTITIES; i++ )
+	{
+		if ( !wentities[ i ].worldNode )
+		{
+			continue;
+		}
+
+		gEnt = &g_entities[ i ];
+
+		// find the first world sector node that the ent's box crosses
+		node = sv_worldSectors;
+
+		while ( node->axis != -1 )
+		{
+			if ( gEnt->r.absmin[ node->axis ] > node->dist )
+			{
+				node = node->children[ 0 ];
+			}
+			else if ( gEnt->r.absmax[ node->axis ] < node->dist )
+			{
+				node = node->children[ 1 ];
+			}
+			else
+			{
+				break; // crosses the node
+			}
+		}
+
+		nextEntityInSector[ i ] = node->entities;
+		node->entities = i;
+	}
+}
+
+/*
+===============================================================================
+
+ENTITY RADIUS GRID
+
+Radius queries only look at the center of an entity's bounding box, so every
+entity that has been linked is additionally hashed by that point into a grid
+of vertical columns.  A query only has to walk the buckets of the columns
+overlapping the horizontal extent of its sphere instead of every entity in
+the level.
+
+Unlinking an entity does not remove it from the grid, since buildables are
+temporarily unlinked to hide them from traces while they still have to be
+found by radius searches.  Entities leave the grid when they are freed.
+
+An entity is only rehashed when it is linked, so anything that moves has to be
+relinked before it is searched for again, as it already has to be for traces.
+g_debugEntityGrid reports entities that were missed because they weren't.
+
+Every bucket remembers when an entity last entered or left it, so that cached
+query results only have to be thrown away when one of their buckets changed.
+
+===============================================================================
+*/
+
+#define GRID_CELL_SHIFT 8 // 256 units per column
+#define GRID_HASH_SIZE  1024
+
+static worldEntity_t *gridBuckets[ GRID_HASH_SIZE ];
+static int           gridBucketCheck[ GRID_HASH_SIZE ];
+static int           gridBucketChanged[ GRID_HASH_SIZE ]; // gridChangeCount of the last change
+static int           gridCheckCount;
+static int           gridChangeCount;
+
+static int G_CM_GridCell( float value )
+{
+	return ( int ) floor( value ) >> GRID_CELL_SHIFT;
+}
+
+static worldEntity_t **G_CM_GridBucket( int x, int y )
+{
+	unsigned int hash = ( ( unsigned int ) x * 73856093u ) ^ ( ( unsigned int ) y * 19349663u );
+
+	return &gridBuckets[ hash & ( GRID_HASH_SIZE - 1 ) ];
+}
+
+static void G_CM_GridUnlink( worldEntity_t *went )
+{
+	if ( !went->gridBucket )
+	{
+		return;
+	}
+
+	if ( went->prevEntityInGridBucket )
+	{
+		went->prevEntityInGridBucket->nextEntityInGridBucket = went->nextEntityInGridBucket;
+	}
+	else
+	{
+		*went->gridBucket = went->nextEntityInGridBucket;
+	}
+
+	if ( went->nextEntityInGridBucket )
+	{
+		went->nextEntityInGridBucket->prevEntityInGridBucket = went->prevEntityInGridBucket;
+	}
+
+	gridBucketChanged[ went->gridBucket - gridBuckets ] = ++gridChangeCount;
+
+	went->gridBucket = NULL;
+	went->prevEntityInGridBucket = went->nextEntityInGridBucket = NULL;
+}
+
+static void G_CM_GridLink( worldEntity_t *went, const gentity_t *gEnt )
+{
+	worldEntity_t **bucket;
+	float         x, y;
+
+	x = gEnt->r.currentOrigin[ 0 ] + ( gEnt->r.mins[ 0 ] + gEnt->r.maxs[ 0 ] ) * 0.5;
+	y = gEnt->r.currentOrigin[ 1 ] + ( gEnt->r.mins[ 1 ] + gEnt->r.maxs[ 1 ] ) * 0.5;
+
+	bucket = G_CM_GridBucket( G_CM_GridCell( x ), G_CM_GridCell( y ) );
+
+	went->gridBucket = bucket;
+	went->prevEntityInGridBucket = NULL;
+	went->nextEntityInGridBucket = *bucket;
+
+	if ( *bucket )
+	{
+		( *bucket )->prevEntityInGridBucket = went;
+	}
+
+	*bucket = went;
+	gridBucketChanged[ bucket - gridBuckets ] = ++gridChangeCount;
 }
 
 /*
 ===============
-G_CM_UnlinkEntity
+G_CM_GridQueryBuckets
 
+Fills in the buckets of the columns overlapping the sphere, each only once
 ===============
 */
-void G_CM_UnlinkEntity( gentity_t *gEnt )
+static int G_CM_GridQueryBuckets( const vec3_t origin, float radius, int *buckets )
 {
-	worldEntity_t* scan;
-	worldSector_t* ws;
+	int x, y, minX, minY, maxX, maxY, bucket;
+	int count = 0;
 
-	worldEntity_t* went = G_CM_WorldEntityForGentity( gEnt );
+	gridCheckCount++;
 
-	gEnt->r.linked = qfalse;
+	if ( radius < ( GRID_HASH_SIZE << GRID_CELL_SHIFT ) )
+	{
+		minX = G_CM_GridCell( origin[ 0 ] - radius );
+		minY = G_CM_GridCell( origin[ 1 ] - radius );
+		maxX = G_CM_GridCell( origin[ 0 ] + radius );
+		maxY = G_CM_GridCell( origin[ 1 ] + radius );
+	}
+	else
+	{
+		minX = minY = 0;
+		maxX = maxY = GRID_HASH_SIZE;
+	}
+
+	if ( ( maxX - minX + 1 ) * ( maxY - minY + 1 ) >= GRID_HASH_SIZE )
+	{
+		// the sphere covers more columns than there are buckets
+		for ( bucket = 0; bucket < GRID_HASH_SIZE; bucket++ )
+		{
+			buckets[ count++ ] = bucket;
+		}
+
+		return count;
+	}
+
+	for ( x = minX; x <= maxX; x++ )
+	{
+		for ( y = minY; y <= maxY; y++ )
+		{
+			bucket = G_CM_GridBucket( x, y ) - gridBuckets;
+
+			// several columns can share a bucket
+			if ( gridBucketCheck[ bucket ] != gridCheckCount )
+			{
+				gridBucketCheck[ bucket ] = gridCheckCount;
+				buckets[ count++ ] = bucket;
+			}
+		}
+	}
+
+	return count;
+}
 
-	ws = went->worldSector;
+static int G_CM_GridAddBucket( int bucket, const vec3_t origin, float radius, int *list, int count, int maxcount )
+{
+	worldEntity_t *check;
+	gentity_t     *gcheck;
 
-	if ( !ws )
+	for ( check = gridBuckets[ bucket ]; check; check = check->nextEntityInGridBucket )
 	{
-		return; // not linked in anywhere
+		gcheck = G_CM_GEntityForWorldEntity( check );
+
+		if ( !gcheck->inuse || !G_EntityWithinRadius( gcheck, origin, radius ) )
+		{
+			continue;
+		}
+
+		if ( count == maxcount )
+		{
+			Com_Printf( "G_CM_RadiusEntities: MAXCOUNT\n" );
+			return count;
+		}
+
+		list[ count++ ] = check - wentities;
 	}
 
-	went->worldSector = NULL;
+	return count;
+}
+
+static int G_CM_CompareEntityNums( const void *a, const void *b )
+{
+	return *( const int * ) a - *( const int * ) b;
+}
 
-	if ( ws->entities == went )
+/*
+===============
+G_CM_RadiusEntities
+===============
+*/
+int G_CM_RadiusEntities( const vec3_t origin, float radius, int *entityList, int maxcount )
+{
+	int buckets[ GRID_HASH_SIZE ];
+	int numBuckets, i;
+	int count = 0;
+
+	if ( radius < 0.0f )
 	{
-		ws->entities = went->nextEntityInWorldSector;
-		return;
+		return 0;
 	}
 
-	for ( scan = ws->entities; scan; scan = scan->nextEntityInWorldSector )
+	numBuckets = G_CM_GridQueryBuckets( origin, radius, buckets );
+
+	for ( i = 0; i < numBuckets && count < maxcount; i++ )
 	{
-		if ( scan->nextEntityInWorldSector == went )
+		count = G_CM_GridAddBucket( buckets[ i ], origin, radius, entityList, count, maxcount );
+	}
+
+	qsort( entityList, count, sizeof( int ), G_CM_CompareEntityNums );
+
+	return count;
+}
+
+/*
+===============
+G_CM_ForgetEntity
+
+Removes a freed entity from the radius grid
+===============
+*/
+void G_CM_ForgetEntity( gentity_t *gEnt )
+{
+	G_CM_GridUnlink( G_CM_WorldEntityForGentity( gEnt ) );
+}
+
+/*
+===============
+G_CM_EntityInGrid
+===============
+*/
+qboolean G_CM_EntityInGrid( const gentity_t *gEnt )
+{
+	return wentities[ gEnt->s.number ].gridBucket != NULL;
+}
+
+/*
+===============
+G_CM_RadiusStamp
+
+Changes whenever an entity enters, leaves or moves within the radius grid
+===============
+*/
+int G_CM_RadiusStamp( void )
+{
+	return gridChangeCount;
+}
+
+/*
+===============
+G_CM_RadiusChangedSince
+
+Whether the result of G_CM_RadiusEntities for the sphere may have changed
+since G_CM_RadiusStamp returned stamp
+===============
+*/
+qboolean G_CM_RadiusChangedSince( const vec3_t origin, float radius, int stamp )
+{
+	int buckets[ GRID_HASH_SIZE ];
+	int numBuckets, i;
+
+	if ( radius < 0.0f )
+	{
+		return qfalse;
+	}
+
+	numBuckets = G_CM_GridQueryBuckets( origin, radius, buckets );
+
+	for ( i = 0; i < numBuckets; i++ )
+	{
+		if ( gridBucketChanged[ buckets[ i ] ] > stamp )
 		{
-			scan->nextEntityInWorldSector = went->nextEntityInWorldSector;
-			return;
+			return qtrue;
 		}
 	}
 
-	Com_Printf( "WARNING: G_CM_UnlinkEntity: not found in worldSector\n" );
+	return qfalse;
+}
+
+/*
+===============
+G_CM_ClearWorld
+
+===============
+*/
+void G_CM_ClearWorld( void )
+{
+	clipHandle_t h;
+	vec3_t       mins, maxs;
+	worldNode_t  *root;
+	int          i;
+
+	memset( wentities, 0, sizeof( wentities ) );
+
+	memset( gridBuckets, 0, sizeof( gridBuckets ) );
+	gridChangeCount++;
+
+	for ( i = 0; i < GRID_HASH_SIZE; i++ )
+	{
+		gridBucketChanged[ i ] = gridChangeCount;
+	}
+
+	memset( worldNodes, 0, sizeof( worldNodes ) );
+	freeWorldNodes = NULL;
+
+	for ( i = OCTREE_NODES - 1; i > 0; i-- )
+	{
+		worldNodes[ i ].parent = freeWorldNodes;
+		freeWorldNodes = &worldNodes[ i ];
+	}
+
+	numWorldNodes = 1;
+	worldNodeKeeps = worldNodeMoves = 0;
+
+	// get world map bounds, the root cell is the cube around them
+	h = CM_InlineModel( 0 );
+	CM_ModelBounds( h, mins, maxs );
+
+	root = worldNodes;
+
+	for ( i = 0; i < 3; i++ )
+	{
+		root->center[ i ] = 0.5f * ( mins[ i ] + maxs[ i ] );
+		root->halfSize = MAX( root->halfSize, 0.5f * ( maxs[ i ] - mins[ i ] ) );
+	}
+
+	root->halfSize = MAX( root->halfSize, 1.0f );
+	VectorCopy( mins, root->mins );
+	VectorCopy( maxs, root->maxs );
+}
+
+/*
+===============
+G_CM_UnlinkEntity
+
+===============
+*/
+void G_CM_UnlinkEntity( gentity_t *gEnt )
+{
+	gEnt->r.linked = qfalse;
+
+	G_CM_RemoveWorldEntity( G_CM_WorldEntityForGentity( gEnt ) );
 }
 
 /*
@@ -399,7 +1002,6 @@ G_CM_LinkEntity
 #define MAX_TOTAL_ENT_LEAFS 128
 void G_CM_LinkEntity( gentity_t *gEnt )
 {
-	worldSector_t *node;
 	int           leafs[ MAX_TOTAL_ENT_LEAFS ];
 	int           cluster;
 	int           num_leafs;
@@ -410,10 +1012,10 @@ void G_CM_LinkEntity( gentity_t *gEnt )
 
 	worldEntity_t* went = G_CM_WorldEntityForGentity( gEnt );
 
-	if ( went->worldSector )
-	{
-		G_CM_UnlinkEntity( gEnt );  // unlink from old position
-	}
+	gEnt->r.linked = qfalse;
+
+	G_CM_GridUnlink( went );
+	G_CM_GridLink( went, gEnt );
 
 	// encode the size into the entityState_t for client prediction
 	if ( gEnt->r.bmodel )
@@ -518,6 +1120,7 @@ void G_CM_LinkEntity( gentity_t *gEnt )
 	// entity is outside the world and can be considered unlinked
 	if ( !num_leafs )
 	{
+		G_CM_RemoveWorldEntity( went );
 		return;
 	}
 
@@ -567,34 +1170,20 @@ void G_CM_LinkEntity( gentity_t *gEnt )
 
 	gEnt->r.linkcount++;
 
-	// find the first world sector node that the ent's box crosses
-	node = sv_worldSectors;
-
-	while ( 1 )
+	// stay in the current node as long as the fat box still contains the entity
+	if ( went->worldNode
+	     && gEnt->r.absmin[ 0 ] >= went->fatMins[ 0 ] && gEnt->r.absmax[ 0 ] <= went->fatMaxs[ 0 ]
+	     && gEnt->r.absmin[ 1 ] >= went->fatMins[ 1 ] && gEnt->r.absmax[ 1 ] <= went->fatMaxs[ 1 ]
+	     && gEnt->r.absmin[ 2 ] >= went->fatMins[ 2 ] && gEnt->r.absmax[ 2 ] <= went->fatMaxs[ 2 ] )
 	{
-		if ( node->axis == -1 )
-		{
-			break;
-		}
-
-		if ( gEnt->r.absmin[ node->axis ] > node->dist )
-		{
-			node = node->children[ 0 ];
-		}
-		else if ( gEnt->r.absmax[ node->axis ] < node->dist )
-		{
-			node = node->children[ 1 ];
-		}
-		else
-		{
-			break; // crosses the node
-		}
+		worldNodeKeeps++;
+	}
+	else
+	{
+		G_CM_RemoveWorldEntity( went );
+		G_CM_InsertWorldEntity( went, gEnt );
+		worldNodeMoves++;
 	}
-
-	// link it in
-	went->worldSector = node;
-	went->nextEntityInWorldSector = node->entities;
-	node->entities = went;
 
 	gEnt->r.linked = qtrue;
 }
@@ -617,47 +1206,85 @@ typedef struct
 	int         count, maxcount;
 } areaParms_t;
 
+static qboolean G_CM_AreaCheck( const gentity_t *gcheck, areaParms_t *ap )
+{
+	if ( !gcheck->r.linked )
+	{
+		return qtrue;
+	}
+
+	if ( gcheck->r.absmin[ 0 ] > ap->maxs[ 0 ]
+	     || gcheck->r.absmin[ 1 ] > ap->maxs[ 1 ]
+	     || gcheck->r.absmin[ 2 ] > ap->maxs[ 2 ]
+	     || gcheck->r.absmax[ 0 ] < ap->mins[ 0 ] || gcheck->r.absmax[ 1 ] < ap->mins[ 1 ] || gcheck->r.absmax[ 2 ] < ap->mins[ 2 ] )
+	{
+		return qtrue;
+	}
+
+	if ( ap->count == ap->maxcount )
+	{
+		Com_Printf( "G_CM_AreaEntities: MAXCOUNT\n" );
+		return qfalse;
+	}
+
+	ap->list[ ap->count ] = gcheck->s.number;
+	ap->count++;
+
+	return qtrue;
+}
+
 /*
 ====================
 G_CM_AreaEntities_r
 
 ====================
 */
-void G_CM_AreaEntities_r( worldSector_t *node, areaParms_t *ap )
+static void G_CM_AreaEntities_r( const worldNode_t *node, areaParms_t *ap )
 {
-	worldEntity_t     *check, *next;
-	gentity_t *gcheck;
-//	int             count;
-
-//	count = 0;
+	const worldEntity_t *check;
+	const worldNode_t   *child;
+	int                 i;
 
-	for ( check = node->entities; check; check = next )
+	for ( check = node->entities; check; check = check->nextEntityInWorldNode )
 	{
-		next = check->nextEntityInWorldSector;
-
-		gcheck = G_CM_GEntityForWorldEntity( check );
-
-		if ( !gcheck->r.linked )
+		if ( !G_CM_AreaCheck( &g_entities[ check - wentities ], ap ) )
 		{
-			continue;
+			return;
 		}
+	}
+
+	for ( i = 0; i < 8; i++ )
+	{
+		child = node->children[ i ];
 
-		if ( gcheck->r.absmin[ 0 ] > ap->maxs[ 0 ]
-		     || gcheck->r.absmin[ 1 ] > ap->maxs[ 1 ]
-		     || gcheck->r.absmin[ 2 ] > ap->maxs[ 2 ]
-		     || gcheck->r.absmax[ 0 ] < ap->mins[ 0 ] || gcheck->r.absmax[ 1 ] < ap->mins[ 1 ] || gcheck->r.absmax[ 2 ] < ap->mins[ 2 ] )
+		if ( !child
+		     || child->mins[ 0 ] > ap->maxs[ 0 ] || child->mins[ 1 ] > ap->maxs[ 1 ] || child->mins[ 2 ] > ap->maxs[ 2 ]
+		     || child->maxs[ 0 ] < ap->mins[ 0 ] || child->maxs[ 1 ] < ap->mins[ 1 ] || child->maxs[ 2 ] < ap->mins[ 2 ] )
 		{
 			continue;
 		}
 
-		if ( ap->count == ap->maxcount )
+		G_CM_AreaEntities_r( child, ap );
+	}
+}
+
+/*
+====================
+G_CM_SectorEntities_r
+
+Same as G_CM_AreaEntities_r, for the sector tree
+====================
+*/
+static void G_CM_SectorEntities_r( const worldSector_t *node, areaParms_t *ap )
+{
+	int check;
+
+	for ( check = node->entities; check != -1; check = nextEntityInSector[ check ] )
+	{
+		if ( !G_CM_AreaCheck( &g_entities[ check ], ap ) )
 		{
-			Com_Printf( "G_CM_AreaEntities: MAXCOUNT\n" );
 			return;
 		}
-
-		ap->list[ ap->count ] = check - wentities;
-		ap->count++;
 	}
 
 	if ( node->axis == -1 )
@@ -668,12 +1295,12 @@ void G_CM_AreaEntities_r( worldSector_t *node, areaParms_t *ap )
 	// recurse down both sides
 	if ( ap->maxs[ node->axis ] > node->dist )
 	{
-		G_CM_AreaEntities_r( node->children[ 0 ], ap );
+		G_CM_SectorEntities_r( node->children[ 0 ], ap );
 	}
 
 	if ( ap->mins[ node->axis ] < node->dist )
 	{
-		G_CM_AreaEntities_r( node->children[ 1 ], ap );
+		G_CM_SectorEntities_r( node->children[ 1 ], ap );
 	}
 }
 
@@ -692,7 +1319,14 @@ int G_CM_AreaEntities( const vec3_t mins, const vec3_t maxs, int *entityList, in
 	ap.count = 0;
 	ap.maxcount = maxcount;
 
-	G_CM_AreaEntities_r( sv_worldSectors, &ap );
+	if ( areaUseSectors )
+	{
+		G_CM_SectorEntities_r( sv_worldSectors, &ap );
+	}
+	else
+	{
+		G_CM_AreaEntities_r( worldNodes, &ap );
+	}
 
 	return ap.count;
 }
@@ -995,3 +1629,146 @@ int G_CM_PointContents( const vec3_t p, int passEntityNum )
 
 	return contents;
 }
+
+/*
+=============
+G_CM_SectorBenchmark_f
+
+Times area queries and traces against both the octree and a sector tree
+built from the same entities
+=============
+*/
+#define BENCHMARK_TRACES 1024
+
+void G_CM_SectorBenchmark_f( void )
+{
+	static vec3_t starts[ BENCHMARK_TRACES ], ends[ BENCHMARK_TRACES ];
+	static vec3_t boxMins[ BENCHMARK_TRACES ], boxMaxs[ BENCHMARK_TRACES ];
+	static int    list1[ MAX_GENTITIES ], list2[ MAX_GENTITIES ];
+	const vec3_t  playerMins = { -15.0f, -15.0f, -24.0f };
+	const vec3_t  playerMaxs = { 15.0f, 15.0f, 32.0f };
+	const float   *mins, *maxs;
+	vec3_t        worldMins, worldMaxs, dir;
+	int           linked[ MAX_GENTITIES ], numLinked;
+	int           areaTime[ 2 ], traceTime[ 2 ], found[ 2 ];
+	int           i, j, pass, iterations, start, mismatches, num1, num2;
+	char          arg[ 16 ];
+	trace_t       tr;
+
+	iterations = 20;
+
+	if ( trap_Argc() > 1 )
+	{
+		trap_Argv( 1, arg, sizeof( arg ) );
+		iterations = MAX( atoi( arg ), 1 );
+	}
+
+	G_CM_BuildSectorTree();
+	CM_ModelBounds( CM_InlineModel( 0 ), worldMins, worldMaxs );
+
+	for ( i = numLinked = 0; i < MAX_GENTITIES; i++ )
+	{
+		if ( g_entities[ i ].r.linked )
+		{
+			linked[ numLinked++ ] = i;
+		}
+	}
+
+	// a mix of movement sized traces around entities and long shots across the map
+	for ( i = 0; i < BENCHMARK_TRACES; i++ )
+	{
+		if ( numLinked && ( i & 1 ) )
+		{
+			VectorCopy( g_entities[ linked[ rand() % numLinked ] ].r.currentOrigin, starts[ i ] );
+		}
+		else
+		{
+			for ( j = 0; j < 3; j++ )
+			{
+				starts[ i ][ j ] = worldMins[ j ] + random() * ( worldMaxs[ j ] - worldMins[ j ] );
+			}
+		}
+
+		dir[ 0 ] = crandom();
+		dir[ 1 ] = crandom();
+		dir[ 2 ] = crandom();
+		VectorNormalize( dir );
+		VectorMA( starts[ i ], ( i & 2 ) ? 64.0f : 4096.0f, dir, ends[ i ] );
+
+		mins = ( i & 2 ) ? playerMins : vec3_origin;
+		maxs = ( i & 2 ) ? playerMaxs : vec3_origin;
+
+		for ( j = 0; j < 3; j++ )
+		{
+			boxMins[ i ][ j ] = MIN( starts[ i ][ j ], ends[ i ][ j ] ) + mins[ j ] - 1;
+			boxMaxs[ i ][ j ] = MAX( starts[ i ][ j ], ends[ i ][ j ] ) + maxs[ j ] + 1;
+		}
+	}
+
+	// both structures must find the same entities
+	mismatches = 0;
+
+	for ( i = 0; i < BENCHMARK_TRACES; i++ )
+	{
+		areaUseSectors = qfalse;
+		num1 = G_CM_AreaEntities( boxMins[ i ], boxMaxs[ i ], list1, MAX_GENTITIES );
+		areaUseSectors = qtrue;
+		num2 = G_CM_AreaEntities( boxMins[ i ], boxMaxs[ i ], list2, MAX_GENTITIES );
+
+		qsort( list1, num1, sizeof( int ), G_CM_CompareEntityNums );
+		qsort( list2, num2, sizeof( int ), G_CM_CompareEntityNums );
+
+		if ( num1 != num2 || memcmp( list1, list2, num1 * sizeof( int ) ) )
+		{
+			mismatches++;
+		}
+	}
+
+	for ( pass = 0; pass < 2; pass++ )
+	{
+		areaUseSectors = pass ? qtrue : qfalse;
+		found[ pass ] = 0;
+
+		start = trap_Milliseconds();
+
+		for ( j = 0; j < iterations; j++ )
+		{
+			for ( i = 0; i < BENCHMARK_TRACES; i++ )
+			{
+				found[ pass ] += G_CM_AreaEntities( boxMins[ i ], boxMaxs[ i ], list1, MAX_GENTITIES );
+			}
+		}
+
+		areaTime[ pass ] = trap_Milliseconds() - start;
+		start = trap_Milliseconds();
+
+		for ( j = 0; j < iterations; j++ )
+		{
+			for ( i = 0; i < BENCHMARK_TRACES; i++ )
+			{
+				mins = ( i & 2 ) ? playerMins : vec3_origin;
+				maxs = ( i & 2 ) ? playerMaxs : vec3_origin;
+				G_CM_Trace( &tr, starts[ i ], mins, maxs, ends[ i ], ENTITYNUM_NONE, MASK_SHOT, TT_AABB );
+			}
+		}
+
+		traceTime[ pass ] = trap_Milliseconds() - start;
+	}
+
+	areaUseSectors = qfalse;
+
+	Com_Printf( "%i linked entities, %i traces x %i\n", numLinked, BENCHMARK_TRACES, iterations );
+
+	for ( pass = 0; pass < 2; pass++ )
+	{
+		Com_Printf( "%-12s area %7.3fus  trace %7.3fus  %.1f entities per query\n", pass ? "sector tree:" : "octree:",
+		            areaTime[ pass ] * 1000.0f / ( BENCHMARK_TRACES * iterations ),
+		            traceTime[ pass ] * 1000.0f / ( BENCHMARK_TRACES * iterations ),
+		            ( float ) found[ pass ] / ( BENCHMARK_TRACES * iterations ) );
+	}
+
+	if ( mismatches )
+	{
+		Com_Printf( "WARNING: %i queries returned different entities\n", mismatches );
+	}
+}
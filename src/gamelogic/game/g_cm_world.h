@@ -60,6 +60,12 @@ clipHandle_t G_CM_ClipHandleForEntity( const sharedEntity_t *ent );
 
 void         G_CM_SectorList_f( void );
 
+// prints the occupancy of the entity octree
+
+void         G_CM_SectorBenchmark_f( void );
+
+// compares area query and trace cost of the octree against the old sector tree
+
 int          G_CM_AreaEntities( const vec3_t mins, const vec3_t maxs, int *entityList, int maxcount );
 
 // fills in a table of entity numbers with entities that have bounding boxes
@@ -69,6 +75,32 @@ int          G_CM_AreaEntities( const vec3_t mins, const vec3_t maxs, int *entit
 // returns the number of pointers filled in
 // The world entity is never returned in this list.
 
+void         G_CM_ForgetEntity( gentity_t *ent );
+
+// call when freeing an entity, so it is no longer found by radius queries
+
+int          G_CM_RadiusEntities( const vec3_t origin, float radius, int *entityList, int maxcount );
+
+// fills in a table of entity numbers, in ascending order, with the entities
+// whose bounding box center lies within radius of origin.  Only entities that
+// have been linked at least once are considered, at their last linked
+// position, even if they have been unlinked since.
+// returns the number of entity numbers filled in
+
+qboolean     G_CM_EntityInGrid( const gentity_t *ent );
+
+// returns qtrue if the entity is considered by G_CM_RadiusEntities
+
+int          G_CM_RadiusStamp( void );
+
+// returns a counter that changes every time an entity is linked or freed
+
+qboolean     G_CM_RadiusChangedSince( const vec3_t origin, float radius, int stamp );
+
+// returns qtrue if an entity was linked or freed, since G_CM_RadiusStamp
+// returned stamp, in a part of the grid that G_CM_RadiusEntities would search
+// for this sphere
+
 int G_CM_PointContents( const vec3_t p, int passEntityNum );
 
 // returns the CONTENTS_* value from the world and all entities at the given point.
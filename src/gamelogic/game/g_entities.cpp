@@ -34,6 +34,7 @@ Maryland 20850 USA.
 
 #include "g_local.h"
 #include "g_entities.h"
+#include "g_cm_world.h"
 
 /*
 =================================================================================
@@ -144,6 +145,9 @@ void G_FreeEntity( gentity_t *entity )
 		return;
 	}
 
+	G_CM_ForgetEntity( entity );
+	G_UnregisterBuildable( entity );
+
 	if ( g_debugEntities.integer > 2 )
 		G_Printf(S_DEBUG "Freeing Entity %s\n", etos(entity));
 
@@ -342,41 +346,172 @@ gentity_t *G_IterateEntitiesWithField( gentity_t *entity, size_t fieldofs, const
 	return G_IterateEntities( entity, NULL, qtrue, fieldofs, match );
 }
 
-// from quakestyle.telefragged.com
-// (NOBODY): Code helper function
-//
-gentity_t *G_IterateEntitiesWithinRadius( gentity_t *entity, vec3_t origin, float radius )
+/*
+=============
+G_EntityWithinRadius
+
+Tests the center of the entity's bounding box against the given sphere
+=============
+*/
+qboolean G_EntityWithinRadius( const gentity_t *entity, const vec3_t origin, float radius )
 {
 	vec3_t eorg;
 	int    j;
 
-	if ( !entity )
+	for ( j = 0; j < 3; j++ )
 	{
-		entity = g_entities;
-	}
-	else
-	{
-		entity++;
+		eorg[ j ] = origin[ j ] - ( entity->r.currentOrigin[ j ] + ( entity->r.mins[ j ] + entity->r.maxs[ j ] ) * 0.5 );
 	}
 
-	for ( ; entity < &g_entities[ level.num_entities ]; entity++ )
+	return VectorLength( eorg ) <= radius;
+}
+
+/*
+=============
+G_IterateEntitiesWithinRadius
+
+Iterates through all placed entities whose center lies within radius of origin,
+in the same order as G_IterateEntities.  Entities that were never linked into
+the world are not returned.
+
+The candidates are looked up in the radius grid of g_cm_world and kept in a
+small cache, so that following calls (including nested loops and later loops
+over the same sphere) only need to search the cached result for the successor
+of the previous entity.  A cached result is rebuilt when an entity has been
+linked or freed in the part of the grid it covers.  Entities have to be
+relinked after moving to be found, see g_cm_world.
+=============
+*/
+#define MAX_RADIUS_QUERIES 8
+
+typedef struct
+{
+	vec3_t origin;
+	float  radius;
+	int    stamp; // G_CM_RadiusStamp when the entities were looked up
+	int    numEntities;
+	int    entityNums[ MAX_GENTITIES ];
+} radiusQuery_t;
+
+static radiusQuery_t radiusQueries[ MAX_RADIUS_QUERIES ];
+static int           nextRadiusQuery;
+
+static void G_CheckRadiusQuery( const radiusQuery_t *query )
+{
+	gentity_t *entity;
+	int       i = 0;
+
+	for ( entity = g_entities; entity < &g_entities[ level.num_entities ]; entity++ )
 	{
-		if ( !entity->inuse )
+		if ( !entity->inuse || !G_CM_EntityInGrid( entity ) || !G_EntityWithinRadius( entity, query->origin, query->radius ) )
 		{
 			continue;
 		}
 
-		for ( j = 0; j < 3; j++ )
+		while ( i < query->numEntities && query->entityNums[ i ] < entity->s.number )
 		{
-			eorg[ j ] = origin[ j ] - ( entity->r.currentOrigin[ j ] + ( entity->r.mins[ j ] + entity->r.maxs[ j ] ) * 0.5 );
+			G_Printf( S_WARNING "G_IterateEntitiesWithinRadius: radius grid returned %s which is not in range\n",
+			          etos( &g_entities[ query->entityNums[ i++ ] ] ) );
 		}
 
-		if ( VectorLength( eorg ) > radius )
+		if ( i < query->numEntities && query->entityNums[ i ] == entity->s.number )
 		{
+			i++;
 			continue;
 		}
 
-		return entity;
+		G_Printf( S_WARNING "G_IterateEntitiesWithinRadius: radius grid missed %s\n", etos( entity ) );
+	}
+
+	while ( i < query->numEntities )
+	{
+		G_Printf( S_WARNING "G_IterateEntitiesWithinRadius: radius grid returned %s which is not in range\n",
+		          etos( &g_entities[ query->entityNums[ i++ ] ] ) );
+	}
+}
+
+static radiusQuery_t *G_RadiusQuery( const vec3_t origin, float radius )
+{
+	radiusQuery_t *query;
+	int           i;
+
+	for ( i = 0; i < MAX_RADIUS_QUERIES; i++ )
+	{
+		query = &radiusQueries[ i ];
+
+		if ( query->radius == radius && VectorCompare( query->origin, origin ) )
+		{
+			if ( !G_CM_RadiusChangedSince( origin, radius, query->stamp ) )
+			{
+				if ( g_debugEntityGrid.integer )
+				{
+					G_CheckRadiusQuery( query );
+				}
+
+				return query;
+			}
+
+			break;
+		}
+	}
+
+	if ( i == MAX_RADIUS_QUERIES )
+	{
+		query = &radiusQueries[ nextRadiusQuery ];
+		nextRadiusQuery = ( nextRadiusQuery + 1 ) % MAX_RADIUS_QUERIES;
+	}
+
+	VectorCopy( origin, query->origin );
+	query->radius = radius;
+	query->stamp = G_CM_RadiusStamp();
+	query->numEntities = G_CM_RadiusEntities( origin, radius, query->entityNums, MAX_GENTITIES );
+
+	if ( g_debugEntityGrid.integer )
+	{
+		G_CheckRadiusQuery( query );
+	}
+
+	return query;
+}
+
+gentity_t *G_IterateEntitiesWithinRadius( gentity_t *entity, vec3_t origin, float radius )
+{
+	radiusQuery_t *query;
+	gentity_t     *candidate;
+	int           low, high, mid;
+
+	query = G_RadiusQuery( origin, radius );
+
+	// find the first candidate after the previous entity
+	low = 0;
+	high = query->numEntities;
+
+	if ( entity )
+	{
+		while ( low < high )
+		{
+			mid = ( low + high ) / 2;
+
+			if ( query->entityNums[ mid ] <= entity->s.number )
+			{
+				low = mid + 1;
+			}
+			else
+			{
+				high = mid;
+			}
+		}
+	}
+
+	for ( ; low < query->numEntities; low++ )
+	{
+		candidate = &g_entities[ query->entityNums[ low ] ];
+
+		// entities may have moved without relinking since the lookup
+		if ( candidate->inuse && G_EntityWithinRadius( candidate, origin, radius ) )
+		{
+			return candidate;
+		}
 	}
 
 	return NULL;
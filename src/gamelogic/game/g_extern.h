@@ -176,6 +176,7 @@ extern  vmCvar_t g_combatCooldown;
 extern  vmCvar_t g_geoip;
 
 extern  vmCvar_t g_debugEntities;
+extern  vmCvar_t g_debugEntityGrid;
 
 // bot buy cvars
 extern vmCvar_t g_bot_buy;
@@ -193,6 +193,7 @@ vmCvar_t           g_combatCooldown;
 vmCvar_t           g_geoip;
 
 vmCvar_t           g_debugEntities;
+vmCvar_t           g_debugEntityGrid;
 
 
 // <bot stuff>
@@ -346,6 +347,7 @@ static cvarTable_t gameCvarTable[] =
 	{ &g_debugVoices,                 "g_debugVoices",                 "0",                                CVAR_TEMP,                                       0, qfalse           },
 	{ &g_debugEntities,               "g_debugEntities",               "0",                                CVAR_TEMP,                                       0, qfalse           },
 	{ &g_debugFire,                   "g_debugFire",                   "0",                                CVAR_TEMP,                                       0, qfalse           },
+	{ &g_debugEntityGrid,             "g_debugEntityGrid",             "0",                                CVAR_TEMP,                                       0, qfalse           },
 
 	// gameplay: basic
 	{ &g_timelimit,                   "timelimit",                     "45",                               CVAR_SERVERINFO,                                 0, qtrue            },
@@ -970,6 +972,8 @@ void G_ShutdownGame( int restart )
 
 	G_Printf( "==== ShutdownGame ====\n" );
 
+	G_ShutdownPmoveRecording();
+
 	if ( level.logFile )
 	{
 		G_LogPrintf( "ShutdownGame:\n" );
@@ -1359,27 +1363,22 @@ Counts the number of spawns for each team
 */
 void G_CountSpawns( void )
 {
-	int       i;
 	gentity_t *ent;
 
-	//I guess this could be changed into one function call per team
 	level.team[ TEAM_ALIENS ].numSpawns = 0;
 	level.team[ TEAM_HUMANS ].numSpawns = 0;
 
-	for ( i = MAX_CLIENTS, ent = g_entities + i; i < level.num_entities; i++, ent++ )
+	for ( ent = NULL; ( ent = G_IterateBuildables( ent, BA_A_SPAWN ) ); )
 	{
-		if ( !ent->inuse || ent->s.eType != ET_BUILDABLE || ent->health <= 0 )
-		{
-			continue;
-			// is it really useful? Seriously?
-		}
-
-		//TODO create a function to check if a building is a spawn
-		if( ent->s.modelindex == BA_A_SPAWN )
+		if ( ent->health > 0 )
 		{
 			level.team[ TEAM_ALIENS ].numSpawns++;
 		}
-		else if ( ent->s.modelindex == BA_H_SPAWN )
+	}
+
+	for ( ent = NULL; ( ent = G_IterateBuildables( ent, BA_H_SPAWN ) ); )
+	{
+		if ( ent->health > 0 )
 		{
 			level.team[ TEAM_HUMANS ].numSpawns++;
 		}
@@ -2894,6 +2893,8 @@ void G_RunFrame( int levelTime )
 	// now we are done spawning
 	level.spawning = qfalse;
 
+	G_BotUpdatePaths();
+
 	//
 	// go through all allocated objects
 	//
@@ -0,0 +1,464 @@
+/*
+===========================================================================
+Copyright (C) 2010 Darklegion Development
+
+This file is part of Daemon.
+
+Daemon is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Daemon is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Daemon; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "g_local.h"
+#include "g_cm_world.h"
+
+/*
+===============================================================================
+
+PMOVE RECORDING AND REPLAY
+
+pmoveRecord captures every client Pmove together with the player state it
+started from and the state it produced.  pmoveReplay runs the same commands
+through Pmove again against the world alone, checks that every command still
+produces the recorded state and reports how many commands per second each
+class moves at.  A recording made before a movement change is the golden file
+for testing it afterwards.
+
+Commands whose traces or point contents were affected by an entity cannot be
+reproduced without the entities and are only replayed for timing.  Pmove draws
+from rand() for weapon spread, so it is reseeded from the command before each
+recorded and replayed move.
+
+===============================================================================
+*/
+
+#define PMOVE_REPLAY_MAGIC   "PMRP"
+#define PMOVE_REPLAY_VERSION 1
+
+typedef struct
+{
+	char magic[ 4 ];
+	int  version;
+	int  recordSize;
+	char mapname[ MAX_QPATH ];
+} pmoveReplayHeader_t;
+
+typedef struct
+{
+	int           clientNum;
+	int           seed;
+	int           tracemask;
+	int           pmoveFixed;
+	int           pmoveMsec;
+	int           pmoveAccurate;
+	int           touchedEntities; // an entity changed a trace or point contents
+	usercmd_t     cmd;
+	playerState_t before;
+	pmoveExt_t    pmextBefore;
+	playerState_t after;
+	pmoveExt_t    pmextAfter;
+} pmoveRecord_t;
+
+static fileHandle_t  pmoveRecordFile;
+static int           pmoveRecordCount;
+static pmoveRecord_t pmoveRecord;
+
+/*
+=================
+G_PmoveRecordSeed
+=================
+*/
+static int G_PmoveRecordSeed( const playerState_t *ps, const usercmd_t *cmd )
+{
+	return cmd->serverTime * MAX_CLIENTS + ps->clientNum;
+}
+
+/*
+=================
+G_PmoveRecordTrace
+
+Flags the command when an entity changed the result of a trace
+=================
+*/
+static void G_PmoveRecordTrace( trace_t *results, const vec3_t start, const vec3_t mins, const vec3_t maxs,
+                                const vec3_t end, int passEntityNum, int contentMask )
+{
+	trap_Trace( results, start, mins, maxs, end, passEntityNum, contentMask );
+
+	if ( results->entityNum != ENTITYNUM_WORLD && results->entityNum != ENTITYNUM_NONE )
+	{
+		pmoveRecord.touchedEntities = qtrue;
+	}
+}
+
+/*
+=================
+G_PmoveRecordPointContents
+=================
+*/
+static int G_PmoveRecordPointContents( const vec3_t point, int passEntityNum )
+{
+	int contents = trap_PointContents( point, passEntityNum );
+
+	if ( contents != CM_PointContents( point, 0 ) )
+	{
+		pmoveRecord.touchedEntities = qtrue;
+	}
+
+	return contents;
+}
+
+/*
+=================
+G_PmoveRecordBegin
+
+Called right before a client Pmove
+=================
+*/
+void G_PmoveRecordBegin( pmove_t *pm )
+{
+	if ( !pmoveRecordFile )
+	{
+		return;
+	}
+
+	pmoveRecord.clientNum = pm->ps->clientNum;
+	pmoveRecord.seed = G_PmoveRecordSeed( pm->ps, &pm->cmd );
+	pmoveRecord.tracemask = pm->tracemask;
+	pmoveRecord.pmoveFixed = pm->pmove_fixed;
+	pmoveRecord.pmoveMsec = pm->pmove_msec;
+	pmoveRecord.pmoveAccurate = pm->pmove_accurate;
+	pmoveRecord.touchedEntities = qfalse;
+	pmoveRecord.cmd = pm->cmd;
+	pmoveRecord.before = *pm->ps;
+	pmoveRecord.pmextBefore = *pm->pmext;
+
+	pm->trace = G_PmoveRecordTrace;
+	pm->pointcontents = G_PmoveRecordPointContents;
+
+	srand( pmoveRecord.seed );
+}
+
+/*
+=================
+G_PmoveRecordEnd
+
+Called right after a client Pmove
+=================
+*/
+void G_PmoveRecordEnd( pmove_t *pm )
+{
+	if ( !pmoveRecordFile )
+	{
+		return;
+	}
+
+	pmoveRecord.after = *pm->ps;
+	pmoveRecord.pmextAfter = *pm->pmext;
+
+	trap_FS_Write( &pmoveRecord, sizeof( pmoveRecord ), pmoveRecordFile );
+	pmoveRecordCount++;
+}
+
+/*
+=================
+G_ShutdownPmoveRecording
+=================
+*/
+void G_ShutdownPmoveRecording( void )
+{
+	if ( !pmoveRecordFile )
+	{
+		return;
+	}
+
+	trap_FS_FCloseFile( pmoveRecordFile );
+	pmoveRecordFile = 0;
+	srand( trap_Milliseconds() );
+
+	G_Printf( "pmoveRecord: %i commands recorded\n", pmoveRecordCount );
+}
+
+/*
+=================
+G_PmoveRecord_f
+
+pmoveRecord [file]
+=================
+*/
+void G_PmoveRecord_f( void )
+{
+	pmoveReplayHeader_t header;
+	char                filename[ MAX_QPATH ];
+
+	if ( trap_Argc() < 2 )
+	{
+		if ( !pmoveRecordFile )
+		{
+			G_Printf( "usage: pmoveRecord <file>\n" );
+		}
+
+		G_ShutdownPmoveRecording();
+		return;
+	}
+
+	G_ShutdownPmoveRecording();
+
+	trap_Argv( 1, filename, sizeof( filename ) );
+
+	if ( trap_FS_FOpenFile( filename, &pmoveRecordFile, FS_WRITE ) < 0 || !pmoveRecordFile )
+	{
+		G_Printf( "pmoveRecord: could not open %s\n", filename );
+		pmoveRecordFile = 0;
+		return;
+	}
+
+	memset( &header, 0, sizeof( header ) );
+	memcpy( header.magic, PMOVE_REPLAY_MAGIC, sizeof( header.magic ) );
+	header.version = PMOVE_REPLAY_VERSION;
+	header.recordSize = sizeof( pmoveRecord_t );
+	trap_Cvar_VariableStringBuffer( "mapname", header.mapname, sizeof( header.mapname ) );
+
+	trap_FS_Write( &header, sizeof( header ), pmoveRecordFile );
+	pmoveRecordCount = 0;
+
+	G_Printf( "pmoveRecord: recording to %s\n", filename );
+}
+
+/*
+=================
+G_PmoveReplayPointContents
+
+Replays only see the world, entity contents were filtered out when recording
+=================
+*/
+static int G_PmoveReplayPointContents( const vec3_t point, int passEntityNum )
+{
+	return CM_PointContents( point, 0 );
+}
+
+/*
+=================
+G_PmoveReplayCommand
+=================
+*/
+static void G_PmoveReplayCommand( const pmoveRecord_t *record, playerState_t *ps, pmoveExt_t *pmext )
+{
+	pmove_t pm;
+
+	*ps = record->before;
+	*pmext = record->pmextBefore;
+
+	memset( &pm, 0, sizeof( pm ) );
+	pm.ps = ps;
+	pm.pmext = pmext;
+	pm.cmd = record->cmd;
+	pm.tracemask = record->tracemask;
+	pm.trace = trap_TraceNoEnts;
+	pm.pointcontents = G_PmoveReplayPointContents;
+	pm.pmove_fixed = record->pmoveFixed;
+	pm.pmove_msec = record->pmoveMsec;
+	pm.pmove_accurate = record->pmoveAccurate;
+
+	srand( record->seed );
+	Pmove( &pm );
+}
+
+/*
+=================
+G_PmoveReplay_f
+
+pmoveReplay <file> [iterations]
+=================
+*/
+#define MAX_REPLAY_MISMATCHES 10
+
+void G_PmoveReplay_f( void )
+{
+	pmoveReplayHeader_t header;
+	pmoveRecord_t       *records;
+	playerState_t       ps;
+	pmoveExt_t          pmext;
+	fileHandle_t        f;
+	char                filename[ MAX_QPATH ], mapname[ MAX_QPATH ], arg[ 16 ];
+	int                 classCount[ PCL_NUM_CLASSES ], classTime[ PCL_NUM_CLASSES ];
+	int                 i, j, len, numRecords, iterations, pClass, start;
+	int                 skipped, mismatches, totalTime;
+
+	if ( trap_Argc() < 2 )
+	{
+		G_Printf( "usage: pmoveReplay <file> [iterations]\n" );
+		return;
+	}
+
+	trap_Argv( 1, filename, sizeof( filename ) );
+	iterations = 10;
+
+	if ( trap_Argc() > 2 )
+	{
+		trap_Argv( 2, arg, sizeof( arg ) );
+		iterations = MAX( atoi( arg ), 1 );
+	}
+
+	len = trap_FS_FOpenFile( filename, &f, FS_READ );
+
+	if ( len < 0 || !f )
+	{
+		G_Printf( "pmoveReplay: could not open %s\n", filename );
+		return;
+	}
+
+	if ( len < ( int ) sizeof( header ) )
+	{
+		G_Printf( "pmoveReplay: %s is truncated\n", filename );
+		trap_FS_FCloseFile( f );
+		return;
+	}
+
+	trap_FS_Read( &header, sizeof( header ), f );
+	header.mapname[ sizeof( header.mapname ) - 1 ] = '\0';
+	trap_Cvar_VariableStringBuffer( "mapname", mapname, sizeof( mapname ) );
+
+	if ( memcmp( header.magic, PMOVE_REPLAY_MAGIC, sizeof( header.magic ) ) ||
+	     header.version != PMOVE_REPLAY_VERSION || header.recordSize != ( int ) sizeof( pmoveRecord_t ) )
+	{
+		G_Printf( "pmoveReplay: %s was not recorded by this version of the game\n", filename );
+		trap_FS_FCloseFile( f );
+		return;
+	}
+
+	if ( Q_stricmp( header.mapname, mapname ) )
+	{
+		G_Printf( "pmoveReplay: %s was recorded on %s, not %s\n", filename, header.mapname, mapname );
+		trap_FS_FCloseFile( f );
+		return;
+	}
+
+	numRecords = ( len - sizeof( header ) ) / sizeof( pmoveRecord_t );
+
+	if ( !numRecords )
+	{
+		G_Printf( "pmoveReplay: %s has no commands\n", filename );
+		trap_FS_FCloseFile( f );
+		return;
+	}
+
+	// recordings easily outgrow the BG_Alloc pool
+	records = ( pmoveRecord_t * ) malloc( numRecords * sizeof( pmoveRecord_t ) );
+
+	if ( !records )
+	{
+		G_Printf( "pmoveReplay: not enough memory for %i commands\n", numRecords );
+		trap_FS_FCloseFile( f );
+		return;
+	}
+
+	trap_FS_Read( records, numRecords * sizeof( pmoveRecord_t ), f );
+	trap_FS_FCloseFile( f );
+
+	// check every reproducible command against its recorded result
+	memset( classCount, 0, sizeof( classCount ) );
+	skipped = mismatches = 0;
+
+	for ( i = 0; i < numRecords; i++ )
+	{
+		pClass = records[ i ].before.stats[ STAT_CLASS ];
+
+		if ( pClass < PCL_NONE || pClass >= PCL_NUM_CLASSES )
+		{
+			pClass = PCL_NONE;
+		}
+
+		classCount[ pClass ]++;
+
+		if ( records[ i ].touchedEntities )
+		{
+			skipped++;
+			continue;
+		}
+
+		G_PmoveReplayCommand( &records[ i ], &ps, &pmext );
+
+		if ( memcmp( &ps, &records[ i ].after, sizeof( ps ) ) ||
+		     memcmp( &pmext, &records[ i ].pmextAfter, sizeof( pmext ) ) )
+		{
+			if ( mismatches < MAX_REPLAY_MISMATCHES )
+			{
+				G_Printf( "command %i (client %i, %s, serverTime %i): expected origin %s velocity %s, got %s %s\n",
+				          i, records[ i ].clientNum, BG_Class( pClass )->name, records[ i ].cmd.serverTime,
+				          vtos( records[ i ].after.origin ), vtos( records[ i ].after.velocity ),
+				          vtos( ps.origin ), vtos( ps.velocity ) );
+			}
+
+			mismatches++;
+		}
+	}
+
+	// time each class separately
+	totalTime = 0;
+
+	for ( pClass = PCL_NONE; pClass < PCL_NUM_CLASSES; pClass++ )
+	{
+		classTime[ pClass ] = 0;
+
+		if ( !classCount[ pClass ] )
+		{
+			continue;
+		}
+
+		start = trap_Milliseconds();
+
+		for ( j = 0; j < iterations; j++ )
+		{
+			for ( i = 0; i < numRecords; i++ )
+			{
+				if ( records[ i ].before.stats[ STAT_CLASS ] == pClass ||
+				     ( pClass == PCL_NONE && ( records[ i ].before.stats[ STAT_CLASS ] < PCL_NONE ||
+				                               records[ i ].before.stats[ STAT_CLASS ] >= PCL_NUM_CLASSES ) ) )
+				{
+					G_PmoveReplayCommand( &records[ i ], &ps, &pmext );
+				}
+			}
+		}
+
+		classTime[ pClass ] = trap_Milliseconds() - start;
+		totalTime += classTime[ pClass ];
+	}
+
+	free( records );
+	srand( trap_Milliseconds() );
+
+	G_Printf( "%i commands x %i, %i touched entities and were only timed\n", numRecords, iterations, skipped );
+
+	for ( pClass = PCL_NONE; pClass < PCL_NUM_CLASSES; pClass++ )
+	{
+		if ( classCount[ pClass ] )
+		{
+			G_Printf( "%-12s %7i commands %10.0f commands/s\n", BG_Class( pClass )->name, classCount[ pClass ],
+			          classCount[ pClass ] * iterations * 1000.0f / MAX( classTime[ pClass ], 1 ) );
+		}
+	}
+
+	G_Printf( "%-12s %7i commands %10.0f commands/s\n", "total", numRecords,
+	          numRecords * iterations * 1000.0f / MAX( totalTime, 1 ) );
+
+	if ( mismatches )
+	{
+		G_Printf( "^1%i of %i commands did not reproduce their recorded state\n", mismatches, numRecords - skipped );
+	}
+	else
+	{
+		G_Printf( "all %i commands reproduced their recorded state\n", numRecords - skipped );
+	}
+}
@@ -78,6 +78,9 @@ qboolean          G_CanAffordBuildPoints( team_t team, float amount );
 void              G_ModifyBuildPoints( team_t team, float amount );
 void              G_GetBuildableResourceValue( int *teamValue );
 void              G_SetHumanBuildablePowerState();
+void              G_UnregisterBuildable( gentity_t *ent );
+gentity_t         *G_IterateBuildables( gentity_t *ent, buildable_t buildable );
+gentity_t         *G_IterateTeamBuildables( gentity_t *ent, team_t team );
 
 // g_client.c
 void              G_AddCreditToClient( gclient_t *client, short credit, qboolean cap );
@@ -214,6 +217,13 @@ void              G_namelog_update_score( gclient_t *client );
 void              G_namelog_update_name( gclient_t *client );
 void              G_namelog_cleanup( void );
 
+// g_pmovereplay.c
+void              G_PmoveRecordBegin( pmove_t *pm );
+void              G_PmoveRecordEnd( pmove_t *pm );
+void              G_ShutdownPmoveRecording( void );
+void              G_PmoveRecord_f( void );
+void              G_PmoveReplay_f( void );
+
 // g_physcis.c
 void              G_Physics( gentity_t *ent, int msec );
 
@@ -169,6 +169,12 @@ struct gentity_s
 	qboolean     powered;
 	gentity_t    *powerSource;
 
+	/**
+	 * buildables are registered in a list per type, see G_IterateBuildables
+	 */
+	gentity_t    *prevBuildableOfType;
+	gentity_t    *nextBuildableOfType;
+
 	/**
 	 * Human buildables compete for power.
 	 * currentSparePower takes temporary influences into account and sets a buildables power state.
@@ -721,6 +727,8 @@ struct level_locals_s
 	gentity_t        *markedBuildables[ MAX_GENTITIES ];
 	int              numBuildablesForRemoval;
 
+	gentity_t        *buildables[ BA_NUM_BUILDABLES ]; // first buildable of each type, in entity order
+
 	team_t           lastWin;
 
 	timeWarning_t    timelimitWarning;
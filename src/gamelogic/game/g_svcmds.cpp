@@ -35,6 +35,7 @@ Maryland 20850 USA.
 // this file holds commands that can be executed by the server console, but not remote clients
 
 #include "g_local.h"
+#include "g_cm_world.h"
 
 #define IS_NON_NULL_VEC3(vec3tor) (vec3tor[0] || vec3tor[1] || vec3tor[2])
 
@@ -692,6 +693,7 @@ static const struct svcmd
 	{ "advanceMapRotation", qfalse, Svcmd_G_AdvanceMapRotation_f },
 	{ "alienWin",           qfalse, Svcmd_TeamWin_f              },
 	{ "asay",               qtrue,  Svcmd_MessageWrapper         },
+	{ "botPerception",      qfalse, G_BotPerceptionInfo          },
 	{ "chat",               qtrue,  Svcmd_MessageWrapper         },
 	{ "cp",                 qtrue,  Svcmd_CenterPrint_f          },
 	{ "dumpuser",           qfalse, Svcmd_DumpUser_f             },
@@ -709,10 +711,14 @@ static const struct svcmd
 	{ "m",                  qtrue,  Svcmd_MessageWrapper         },
 	{ "maplog",             qtrue,  Svcmd_MapLogWrapper          },
 	{ "mapRotation",        qfalse, Svcmd_MapRotation_f          },
+	{ "pmoveRecord",        qfalse, G_PmoveRecord_f              },
+	{ "pmoveReplay",        qfalse, G_PmoveReplay_f              },
 	{ "pr",                 qfalse, Svcmd_Pr_f                   },
 	{ "printqueue",         qfalse, Svcmd_PrintQueue_f           },
 	{ "say",                qtrue,  Svcmd_MessageWrapper         },
 	{ "say_team",           qtrue,  Svcmd_TeamMessage_f          },
+	{ "sectorBenchmark",    qfalse, G_CM_SectorBenchmark_f       },
+	{ "sectorList",         qfalse, G_CM_SectorList_f            },
 	{ "stopMapRotation",    qfalse, G_StopMapRotation            },
 };
 
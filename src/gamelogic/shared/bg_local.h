@@ -58,9 +58,6 @@ typedef struct
 	int      previous_waterlevel;
 } pml_t;
 
-extern  pmove_t *pm;
-extern  pml_t   pml;
-
 // movement parameters
 #define pm_stopspeed         (100.0f)
 #define pm_duckScale         (0.25f)
@@ -78,13 +75,13 @@ extern  pml_t   pml;
 extern  int     c_pmove;
 
 void            PM_ClipVelocity( const vec3_t in, const vec3_t normal, vec3_t out );
-void            PM_AddTouchEnt( int entityNum );
-void            PM_AddEvent( int newEvent );
+void            PM_AddTouchEnt( pmove_t *pm, int entityNum );
+void            PM_AddEvent( pmove_t *pm, int newEvent );
 
-qboolean        PM_SlideMove( qboolean gravity );
-void            PM_StepEvent( const vec3_t from, const vec3_t to, const vec3_t normal );
-qboolean        PM_StepSlideMove( qboolean gravity, qboolean predictive );
-qboolean        PM_PredictStepMove( void );
+qboolean        PM_SlideMove( pmove_t *pm, pml_t *pml, qboolean gravity );
+void            PM_StepEvent( pmove_t *pm, const vec3_t from, const vec3_t to, const vec3_t normal );
+qboolean        PM_StepSlideMove( pmove_t *pm, pml_t *pml, qboolean gravity, qboolean predictive );
+qboolean        PM_PredictStepMove( pmove_t *pm, pml_t *pml );
 
 //==================================================================
 #endif /* BG_LOCAL_H_ */
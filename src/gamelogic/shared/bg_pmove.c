@@ -28,9 +28,6 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "bg_public.h"
 #include "bg_local.h"
 
-pmove_t *pm;
-pml_t   pml;
-
 int     c_pmove = 0;
 
 /*
@@ -39,7 +36,7 @@ PM_AddEvent
 
 ===============
 */
-void PM_AddEvent( int newEvent )
+void PM_AddEvent( pmove_t *pm, int newEvent )
 {
 	BG_AddPredictableEventToPlayerstate( newEvent, 0, pm->ps );
 }
@@ -49,7 +46,7 @@ void PM_AddEvent( int newEvent )
 PM_AddTouchEnt
 ===============
 */
-void PM_AddTouchEnt( int entityNum )
+void PM_AddTouchEnt( pmove_t *pm, int entityNum )
 {
 	int i;
 
@@ -82,7 +79,7 @@ void PM_AddTouchEnt( int entityNum )
 PM_StartTorsoAnim
 ===================
 */
-void PM_StartTorsoAnim( int anim )
+void PM_StartTorsoAnim( pmove_t *pm, int anim )
 {
 	if ( PM_Paralyzed( pm->ps->pm_type ) )
 	{
@@ -98,7 +95,7 @@ void PM_StartTorsoAnim( int anim )
 PM_StartWeaponAnim
 ===================
 */
-static void PM_StartWeaponAnim( int anim )
+static void PM_StartWeaponAnim( pmove_t *pm, int anim )
 {
 	if ( PM_Paralyzed( pm->ps->pm_type ) )
 	{
@@ -114,7 +111,7 @@ static void PM_StartWeaponAnim( int anim )
 PM_StartLegsAnim
 ===================
 */
-static void PM_StartLegsAnim( int anim )
+static void PM_StartLegsAnim( pmove_t *pm, int anim )
 {
 	if ( PM_Paralyzed( pm->ps->pm_type ) )
 	{
@@ -146,7 +143,7 @@ static void PM_StartLegsAnim( int anim )
 PM_ContinueLegsAnim
 ===================
 */
-static void PM_ContinueLegsAnim( int anim )
+static void PM_ContinueLegsAnim( pmove_t *pm, int anim )
 {
 	if ( ( pm->ps->legsAnim & ~ANIM_TOGGLEBIT ) == anim )
 	{
@@ -169,7 +166,7 @@ static void PM_ContinueLegsAnim( int anim )
 		}
 	}
 
-	PM_StartLegsAnim( anim );
+	PM_StartLegsAnim( pm, anim );
 }
 
 /*
@@ -177,7 +174,7 @@ static void PM_ContinueLegsAnim( int anim )
 PM_ContinueTorsoAnim
 ===================
 */
-static void PM_ContinueTorsoAnim( int anim )
+static void PM_ContinueTorsoAnim( pmove_t *pm, int anim )
 {
 	if ( ( pm->ps->torsoAnim & ~ANIM_TOGGLEBIT ) == anim )
 	{
@@ -189,7 +186,7 @@ static void PM_ContinueTorsoAnim( int anim )
 		return; // a high priority animation is running
 	}
 
-	PM_StartTorsoAnim( anim );
+	PM_StartTorsoAnim( pm, anim );
 }
 
 /*
@@ -197,14 +194,14 @@ static void PM_ContinueTorsoAnim( int anim )
 PM_ContinueWeaponAnim
 ===================
 */
-static void PM_ContinueWeaponAnim( int anim )
+static void PM_ContinueWeaponAnim( pmove_t *pm, int anim )
 {
 	if ( ( pm->ps->weaponAnim & ~ANIM_TOGGLEBIT ) == anim )
 	{
 		return;
 	}
 
-	PM_StartWeaponAnim( anim );
+	PM_StartWeaponAnim( pm, anim );
 }
 
 /*
@@ -212,7 +209,7 @@ static void PM_ContinueWeaponAnim( int anim )
 PM_ForceLegsAnim
 ===================
 */
-static void PM_ForceLegsAnim( int anim )
+static void PM_ForceLegsAnim( pmove_t *pm, int anim )
 {
 	//legsTimer is clamped too tightly for nonsegmented models
 	if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
@@ -224,7 +221,7 @@ static void PM_ForceLegsAnim( int anim )
 		pm->ps->torsoTimer = 0;
 	}
 
-	PM_StartLegsAnim( anim );
+	PM_StartLegsAnim( pm, anim );
 }
 
 /*
@@ -247,7 +244,7 @@ PM_Friction
 Handles both ground friction and water friction
 ==================
 */
-static void PM_Friction( void )
+static void PM_Friction( pmove_t *pm, pml_t *pml )
 {
 	vec3_t vec;
 	float  *vel;
@@ -259,7 +256,7 @@ static void PM_Friction( void )
 	// make sure vertical velocity is NOT set to zero when wall climbing
 	VectorCopy( vel, vec );
 
-	if ( pml.walking && !( pm->ps->stats[ STAT_STATE ] & SS_WALLCLIMBING ) )
+	if ( pml->walking && !( pm->ps->stats[ STAT_STATE ] & SS_WALLCLIMBING ) )
 	{
 		vec[ 2 ] = 0; // ignore slope movement
 	}
@@ -274,7 +271,7 @@ static void PM_Friction( void )
 	// apply ground friction
 	if ( pm->waterlevel <= 1 )
 	{
-		if ( ( pml.walking || pml.ladder ) && !( pml.groundTrace.surfaceFlags & SURF_SLICK ) )
+		if ( ( pml->walking || pml->ladder ) && !( pml->groundTrace.surfaceFlags & SURF_SLICK ) )
 		{
 			// if getting knocked back, no friction
 			if ( !( pm->ps->pm_flags & PMF_TIME_KNOCKBACK ) )
@@ -283,7 +280,7 @@ static void PM_Friction( void )
 				float friction = BG_Class( pm->ps->stats[ STAT_CLASS ] )->friction;
 
 				control = speed < stopSpeed ? stopSpeed : speed;
-				drop += control * friction * pml.frametime;
+				drop += control * friction * pml->frametime;
 			}
 		}
 	}
@@ -291,12 +288,12 @@ static void PM_Friction( void )
 	// apply water friction even if just wading
 	if ( pm->waterlevel )
 	{
-		drop += speed * pm_waterfriction * pm->waterlevel * pml.frametime;
+		drop += speed * pm_waterfriction * pm->waterlevel * pml->frametime;
 	}
 
 	if ( pm->ps->pm_type == PM_SPECTATOR )
 	{
-		drop += speed * pm_spectatorfriction * pml.frametime;
+		drop += speed * pm_spectatorfriction * pml->frametime;
 	}
 
 	// scale the velocity
@@ -321,7 +318,7 @@ PM_Accelerate
 Handles user intended acceleration
 ==============
 */
-static void PM_Accelerate( const vec3_t wishdir, float wishspeed, float accel )
+static void PM_Accelerate( pmove_t *pm, pml_t *pml, const vec3_t wishdir, float wishspeed, float accel )
 {
 #if 1
 	// q2 style
@@ -336,7 +333,7 @@ static void PM_Accelerate( const vec3_t wishdir, float wishspeed, float accel )
 		return;
 	}
 
-	accelspeed = accel * pml.frametime * wishspeed;
+	accelspeed = accel * pml->frametime * wishspeed;
 
 	if ( accelspeed > addspeed )
 	{
@@ -359,7 +356,7 @@ static void PM_Accelerate( const vec3_t wishdir, float wishspeed, float accel )
 	VectorSubtract( wishVelocity, pm->ps->velocity, pushDir );
 	pushLen = VectorNormalize( pushDir );
 
-	canPush = accel * pml.frametime * wishspeed;
+	canPush = accel * pml->frametime * wishspeed;
 
 	if ( canPush > pushLen )
 	{
@@ -379,7 +376,7 @@ This allows the clients to use axial -127 to 127 values for all directions
 without getting a sqrt(2) distortion in speed.
 ============
 */
-static float PM_CmdScale( usercmd_t *cmd, qboolean zFlight )
+static float PM_CmdScale( pmove_t *pm, usercmd_t *cmd, qboolean zFlight )
 {
 	int   max;
 	float total;
@@ -559,7 +556,7 @@ PM_SetMovementDir
 Determine the rotation of the legs relative to the facing dir
 ================
 */
-static void PM_SetMovementDir( void )
+static void PM_SetMovementDir( pmove_t *pm )
 {
 	if ( pm->cmd.forwardmove || pm->cmd.rightmove )
 	{
@@ -617,7 +614,7 @@ static void PM_SetMovementDir( void )
 PM_CheckCharge
 =============
 */
-static void PM_CheckCharge( void )
+static void PM_CheckCharge( pmove_t *pm )
 {
 	if ( pm->ps->weapon != WP_ALEVEL4 )
 	{
@@ -646,7 +643,7 @@ static void PM_CheckCharge( void )
 PM_CheckWaterPounce
 =============
 */
-static void PM_CheckWaterPounce( void )
+static void PM_CheckWaterPounce( pmove_t *pm )
 {
 	// Check for valid class
 	switch ( pm->ps->weapon )
@@ -680,17 +677,17 @@ static void PM_CheckWaterPounce( void )
 PM_PlayJumpingAnimation
 =============
 */
-static void PM_PlayJumpingAnimation( void )
+static void PM_PlayJumpingAnimation( pmove_t *pm )
 {
 	if ( pm->cmd.forwardmove >= 0 )
 	{
 		if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 		{
-			PM_ForceLegsAnim( LEGS_JUMP );
+			PM_ForceLegsAnim( pm, LEGS_JUMP );
 		}
 		else
 		{
-			PM_ForceLegsAnim( NSPA_JUMP );
+			PM_ForceLegsAnim( pm, NSPA_JUMP );
 		}
 
 		pm->ps->pm_flags &= ~PMF_BACKWARDS_JUMP;
@@ -699,11 +696,11 @@ static void PM_PlayJumpingAnimation( void )
 	{
 		if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 		{
-			PM_ForceLegsAnim( LEGS_JUMPB );
+			PM_ForceLegsAnim( pm, LEGS_JUMPB );
 		}
 		else
 		{
-			PM_ForceLegsAnim( NSPA_JUMPBACK );
+			PM_ForceLegsAnim( pm, NSPA_JUMPBACK );
 		}
 
 		pm->ps->pm_flags |= PMF_BACKWARDS_JUMP;
@@ -715,7 +712,7 @@ static void PM_PlayJumpingAnimation( void )
 PM_CheckPounce
 =============
 */
-static qboolean PM_CheckPounce( void )
+static qboolean PM_CheckPounce( pmove_t *pm, pml_t *pml )
 {
 	const static vec3_t up = { 0.0f, 0.0f, 1.0f };
 
@@ -805,15 +802,15 @@ static qboolean PM_CheckPounce( void )
 	{
 		case WP_ALEVEL1:
 			// wallwalking (ground surface normal is off more than 45° from Z direction)
-			if ( pm->ps->groundEntityNum == ENTITYNUM_WORLD && acos( pml.groundTrace.plane.normal[ 2 ] ) > M_PI / 4.0f )
+			if ( pm->ps->groundEntityNum == ENTITYNUM_WORLD && acos( pml->groundTrace.plane.normal[ 2 ] ) > M_PI / 4.0f )
 			{
 				// get jump magnitude
 				jumpMagnitude = LEVEL1_WALLPOUNCE_MAGNITUDE;
 
 				// if looking in the direction of the surface, jump in opposite normal direction
-				if ( DotProduct( pml.groundTrace.plane.normal, pml.forward ) < 0.0f )
+				if ( DotProduct( pml->groundTrace.plane.normal, pml->forward ) < 0.0f )
 				{
-					VectorCopy( pml.groundTrace.plane.normal, jumpDirection );
+					VectorCopy( pml->groundTrace.plane.normal, jumpDirection );
 				}
 				// otherwise try to find a trajectory to the surface point the player is looking at
 				else
@@ -824,7 +821,7 @@ static qboolean PM_CheckPounce( void )
 					float    zCorrection;
 					qboolean foundTrajectory;
 
-					VectorMA( pm->ps->origin, 10000.0f, pml.forward, traceTarget );
+					VectorMA( pm->ps->origin, 10000.0f, pml->forward, traceTarget );
 
 					pm->trace( &trace, pm->ps->origin, pm->mins, pm->maxs, traceTarget,
 					           pm->ps->clientNum, MASK_SOLID );
@@ -896,7 +893,7 @@ static qboolean PM_CheckPounce( void )
 						// HACK: make sure we get off the ceiling if jumping to an adjacent wall
 						//       this is done by subsequently rotating the jump direction in surface
 						//       normal direction until its angle is below a threshold (acos(0.1) ~= 85°)
-						for ( iter = 0; DotProduct( jumpDirection, pml.groundTrace.plane.normal ) <= 0.1f; iter++ )
+						for ( iter = 0; DotProduct( jumpDirection, pml->groundTrace.plane.normal ) <= 0.1f; iter++ )
 						{
 							if ( iter > 10 )
 							{
@@ -908,7 +905,7 @@ static qboolean PM_CheckPounce( void )
 								break;
 							}
 
-							VectorMA( jumpDirection, 0.1f, pml.groundTrace.plane.normal, jumpDirection );
+							VectorMA( jumpDirection, 0.1f, pml->groundTrace.plane.normal, jumpDirection );
 							VectorNormalize( jumpDirection );
 
 							if ( pm->debugLevel > 0 )
@@ -927,7 +924,7 @@ static qboolean PM_CheckPounce( void )
 							Com_Printf("[PM_CheckPounce] Failed to find a trajectory\n");
 						}
 
-						VectorCopy( pml.forward, jumpDirection );
+						VectorCopy( pml->forward, jumpDirection );
 					}
 				}
 
@@ -938,11 +935,11 @@ static qboolean PM_CheckPounce( void )
 			else if ( pm->cmd.forwardmove > 0 || ( pm->cmd.forwardmove == 0 && pm->cmd.rightmove == 0 ) )
 			{
 				// get jump direction
-				VectorCopy( pml.forward, jumpDirection );
+				VectorCopy( pml->forward, jumpDirection );
 				jumpDirection[ 2 ] = fabs( jumpDirection[ 2 ] );
 
 				// get pitch towards ground surface
-				pitchToGround = ( M_PI / 2.0f ) - acos( DotProduct( pml.groundTrace.plane.normal, jumpDirection ) );
+				pitchToGround = ( M_PI / 2.0f ) - acos( DotProduct( pml->groundTrace.plane.normal, jumpDirection ) );
 
 				// get pitch towards XY reference plane
 				pitchToRef = ( M_PI / 2.0f ) - acos( DotProduct( up, jumpDirection ) );
@@ -972,15 +969,15 @@ static qboolean PM_CheckPounce( void )
 				// get jump direction
 				if ( pm->cmd.forwardmove < 0 )
 				{
-					VectorNegate( pml.forward, jumpDirection );
+					VectorNegate( pml->forward, jumpDirection );
 				}
 				else if ( pm->cmd.rightmove < 0 )
 				{
-					VectorNegate( pml.right, jumpDirection );
+					VectorNegate( pml->right, jumpDirection );
 				}
 				else
 				{
-					VectorCopy( pml.right, jumpDirection );
+					VectorCopy( pml->right, jumpDirection );
 				}
 
 				jumpDirection[ 2 ] = LEVEL1_SIDEPOUNCE_DIR_Z;
@@ -1012,7 +1009,7 @@ static qboolean PM_CheckPounce( void )
 				              * LEVEL3_POUNCE_JUMP_MAG_UPG / LEVEL3_POUNCE_TIME_UPG;
 			}
 
-			VectorCopy( pml.forward, jumpDirection );
+			VectorCopy( pml->forward, jumpDirection );
 
 			// save payload
 			pm->pmext->pouncePayload = pm->ps->stats[ STAT_MISC ];
@@ -1027,15 +1024,15 @@ static qboolean PM_CheckPounce( void )
 	}
 
 	// Prepare a simulated jump
-	pml.groundPlane = qfalse;
-	pml.walking = qfalse;
+	pml->groundPlane = qfalse;
+	pml->walking = qfalse;
 	pm->ps->pm_flags |= PMF_CHARGE;
 	pm->ps->groundEntityNum = ENTITYNUM_NONE;
 
 	// Jump
 	VectorMA( pm->ps->velocity, jumpMagnitude, jumpDirection, pm->ps->velocity );
-	PM_AddEvent( EV_JUMP );
-	PM_PlayJumpingAnimation();
+	PM_AddEvent( pm, EV_JUMP );
+	PM_PlayJumpingAnimation( pm );
 
 	// We started to pounce
 	return qtrue;
@@ -1046,7 +1043,7 @@ static qboolean PM_CheckPounce( void )
 PM_CheckWallJump
 =============
 */
-static qboolean PM_CheckWallJump( void )
+static qboolean PM_CheckWallJump( pmove_t *pm, pml_t *pml )
 {
 	vec3_t  dir, forward, right, movedir, point;
 	float   normalFraction = 1.5f;
@@ -1061,7 +1058,7 @@ static qboolean PM_CheckWallJump( void )
 		return qfalse;
 	}
 
-	ProjectPointOnPlane( movedir, pml.forward, refNormal );
+	ProjectPointOnPlane( movedir, pml->forward, refNormal );
 	VectorNormalize( movedir );
 
 	if ( pm->cmd.forwardmove < 0 )
@@ -1072,7 +1069,7 @@ static qboolean PM_CheckWallJump( void )
 	//allow strafe transitions
 	if ( pm->cmd.rightmove )
 	{
-		VectorCopy( pml.right, movedir );
+		VectorCopy( pml->right, movedir );
 
 		if ( pm->cmd.rightmove < 0 )
 		{
@@ -1121,14 +1118,14 @@ static qboolean PM_CheckWallJump( void )
 	pm->ps->pm_flags |= PMF_TIME_WALLJUMP;
 	pm->ps->pm_time = 200;
 
-	pml.groundPlane = qfalse; // jumping away
-	pml.walking = qfalse;
+	pml->groundPlane = qfalse; // jumping away
+	pml->walking = qfalse;
 	pm->ps->pm_flags |= PMF_JUMP_HELD;
 
 	pm->ps->groundEntityNum = ENTITYNUM_NONE;
 
-	ProjectPointOnPlane( forward, pml.forward, pm->ps->grapplePoint );
-	ProjectPointOnPlane( right, pml.right, pm->ps->grapplePoint );
+	ProjectPointOnPlane( forward, pml->forward, pm->ps->grapplePoint );
+	ProjectPointOnPlane( right, pml->right, pm->ps->grapplePoint );
 
 	VectorScale( pm->ps->grapplePoint, normalFraction, dir );
 
@@ -1163,8 +1160,8 @@ static qboolean PM_CheckWallJump( void )
 		VectorScale( pm->ps->velocity, LEVEL2_WALLJUMP_MAXSPEED, pm->ps->velocity );
 	}
 
-	PM_AddEvent( EV_JUMP );
-	PM_PlayJumpingAnimation();
+	PM_AddEvent( pm, EV_JUMP );
+	PM_PlayJumpingAnimation( pm );
 
 	return qtrue;
 }
@@ -1173,7 +1170,7 @@ static qboolean PM_CheckWallJump( void )
  * @brief PM_CheckJetpack
  * @return qtrue if and only if thrust was applied
  */
-static qboolean PM_CheckJetpack( void )
+static qboolean PM_CheckJetpack( pmove_t *pm, pml_t *pml )
 {
 	static const vec3_t thrustDir = { 0.0f, 0.0f, 1.0f };
 	int                 sideVelocity;
@@ -1199,7 +1196,7 @@ static qboolean PM_CheckJetpack( void )
 		}
 
 		pm->ps->stats[ STAT_STATE2 ] |= SS2_JETPACK_ENABLED;
-		PM_AddEvent( EV_JETPACK_ENABLE );
+		PM_AddEvent( pm, EV_JETPACK_ENABLE );
 
 		return qfalse;
 	}
@@ -1215,7 +1212,7 @@ static qboolean PM_CheckJetpack( void )
 			}
 
 			pm->ps->stats[ STAT_STATE2 ] &= ~SS2_JETPACK_ACTIVE;
-			PM_AddEvent( EV_JETPACK_STOP );
+			PM_AddEvent( pm, EV_JETPACK_STOP );
 		}
 
 		return qfalse;
@@ -1269,7 +1266,7 @@ static qboolean PM_CheckJetpack( void )
 
 		// ignite
 		pm->ps->stats[ STAT_STATE2 ] |= SS2_JETPACK_WARM;
-		PM_AddEvent( EV_JETPACK_IGNITE );
+		PM_AddEvent( pm, EV_JETPACK_IGNITE );
 	}
 
 	// stop thrusting if completely out of fuel
@@ -1283,7 +1280,7 @@ static qboolean PM_CheckJetpack( void )
 			}
 
 			pm->ps->stats[ STAT_STATE2 ] &= ~SS2_JETPACK_ACTIVE;
-			PM_AddEvent( EV_JETPACK_STOP );
+			PM_AddEvent( pm, EV_JETPACK_STOP );
 		}
 
 		return qfalse;
@@ -1304,17 +1301,17 @@ static qboolean PM_CheckJetpack( void )
 		}
 
 		pm->ps->stats[ STAT_STATE2 ] |= SS2_JETPACK_ACTIVE;
-		PM_AddEvent( EV_JETPACK_START );
+		PM_AddEvent( pm, EV_JETPACK_START );
 	}
 
 	// clear the jumped flag as the reason we are in air now is the jetpack
 	pm->ps->pm_flags &= ~PMF_JUMPED;
 
 	// thrust
-	PM_Accelerate( thrustDir, JETPACK_TARGETSPEED, JETPACK_ACCELERATION );
+	PM_Accelerate( pm, pml, thrustDir, JETPACK_TARGETSPEED, JETPACK_ACCELERATION );
 
 	// remove fuel
-	pm->ps->stats[ STAT_FUEL ] -= pml.msec * JETPACK_FUEL_USAGE;
+	pm->ps->stats[ STAT_FUEL ] -= pml->msec * JETPACK_FUEL_USAGE;
 	if ( pm->ps->stats[ STAT_FUEL ] < 0 ) pm->ps->stats[ STAT_FUEL ] = 0;
 
 	return qtrue;
@@ -1324,7 +1321,7 @@ static qboolean PM_CheckJetpack( void )
  * @brief Restores jetpack fuel
  * @return qtrue if and only if fuel has been restored
  */
-static qboolean PM_CheckJetpackRestoreFuel( void )
+static qboolean PM_CheckJetpackRestoreFuel( pmove_t *pm, pml_t *pml )
 {
 	// don't restore fuel when full or jetpack active
 	if ( pm->ps->stats[ STAT_FUEL ] == JETPACK_FUEL_MAX ||
@@ -1333,7 +1330,7 @@ static qboolean PM_CheckJetpackRestoreFuel( void )
 		return qfalse;
 	}
 
-	pm->ps->stats[ STAT_FUEL ] += pml.msec * JETPACK_FUEL_RESTORE;
+	pm->ps->stats[ STAT_FUEL ] += pml->msec * JETPACK_FUEL_RESTORE;
 
 	if ( pm->ps->stats[ STAT_FUEL ] > JETPACK_FUEL_MAX )
 	{
@@ -1346,7 +1343,7 @@ static qboolean PM_CheckJetpackRestoreFuel( void )
 /**
  * @brief Disables the jetpack. Without force, the call can get ignored based on previous velocity.
  */
-static void PM_LandJetpack( qboolean force )
+static void PM_LandJetpack( pmove_t *pm, pml_t *pml, qboolean force )
 {
 	float angle, sideVelocity;
 
@@ -1356,10 +1353,10 @@ static void PM_LandJetpack( qboolean force )
 		force = qtrue;
 	}
 
-	sideVelocity = sqrt( pml.previous_velocity[ 0 ] * pml.previous_velocity[ 0 ] +
-	                     pml.previous_velocity[ 1 ] * pml.previous_velocity[ 1 ] );
+	sideVelocity = sqrt( pml->previous_velocity[ 0 ] * pml->previous_velocity[ 0 ] +
+	                     pml->previous_velocity[ 1 ] * pml->previous_velocity[ 1 ] );
 
-	angle = atan2( -pml.previous_velocity[ 2 ], sideVelocity );
+	angle = atan2( -pml->previous_velocity[ 2 ], sideVelocity );
 
 	// allow the player to jump instead of land for some impacts
 	if ( !force )
@@ -1385,7 +1382,7 @@ static void PM_LandJetpack( qboolean force )
 
 		pm->ps->stats[ STAT_STATE2 ] &= ~SS2_JETPACK_ACTIVE;
 
-		PM_AddEvent( EV_JETPACK_STOP );
+		PM_AddEvent( pm, EV_JETPACK_STOP );
 
 		// HACK: mark the jump key held so there is no immediate jump on landing
 		pm->ps->pm_flags |= PMF_JUMP_HELD;
@@ -1402,11 +1399,11 @@ static void PM_LandJetpack( qboolean force )
 		pm->ps->stats[ STAT_STATE2 ] &= ~SS2_JETPACK_WARM;
 		pm->ps->stats[ STAT_STATE2 ] &= ~SS2_JETPACK_ENABLED;
 
-		PM_AddEvent( EV_JETPACK_DISABLE );
+		PM_AddEvent( pm, EV_JETPACK_DISABLE );
 	}
 }
 
-static qboolean PM_CheckJump( void )
+static qboolean PM_CheckJump( pmove_t *pm, pml_t *pml )
 {
 	vec3_t   normal;
 	int      staminaJumpCost;
@@ -1491,8 +1488,8 @@ static qboolean PM_CheckJump( void )
 	}
 
 	// go into jump mode
-	pml.groundPlane = qfalse;
-	pml.walking     = qfalse;
+	pml->groundPlane = qfalse;
+	pml->walking     = qfalse;
 	pm->ps->pm_flags |= PMF_JUMP_HELD;
 	pm->ps->pm_flags |= PMF_JUMPED;
 	pm->ps->groundEntityNum = ENTITYNUM_NONE;
@@ -1531,13 +1528,13 @@ static qboolean PM_CheckJump( void )
 
 	VectorMA( pm->ps->velocity, magnitude, normal, pm->ps->velocity );
 
-	PM_AddEvent( EV_JUMP );
-	PM_PlayJumpingAnimation();
+	PM_AddEvent( pm, EV_JUMP );
+	PM_PlayJumpingAnimation( pm );
 
 	return qtrue;
 }
 
-static qboolean PM_CheckWaterJump( void )
+static qboolean PM_CheckWaterJump( pmove_t *pm, pml_t *pml )
 {
 	vec3_t spot;
 	int    cont;
@@ -1554,8 +1551,8 @@ static qboolean PM_CheckWaterJump( void )
 		return qfalse;
 	}
 
-	flatforward[ 0 ] = pml.forward[ 0 ];
-	flatforward[ 1 ] = pml.forward[ 1 ];
+	flatforward[ 0 ] = pml->forward[ 0 ];
+	flatforward[ 1 ] = pml->forward[ 1 ];
 	flatforward[ 2 ] = 0;
 	VectorNormalize( flatforward );
 
@@ -1577,7 +1574,7 @@ static qboolean PM_CheckWaterJump( void )
 	}
 
 	// jump out of water
-	VectorScale( pml.forward, 200, pm->ps->velocity );
+	VectorScale( pml->forward, 200, pm->ps->velocity );
 	pm->ps->velocity[ 2 ] = 350;
 
 	pm->ps->pm_flags |= PMF_TIME_WATERJUMP;
@@ -1595,13 +1592,13 @@ PM_WaterJumpMove
 Flying out of the water
 ===================
 */
-static void PM_WaterJumpMove( void )
+static void PM_WaterJumpMove( pmove_t *pm, pml_t *pml )
 {
 	// waterjump has no control, but falls
 
-	PM_StepSlideMove( qtrue, qfalse );
+	PM_StepSlideMove( pm, pml, qtrue, qfalse );
 
-	pm->ps->velocity[ 2 ] -= pm->ps->gravity * pml.frametime;
+	pm->ps->velocity[ 2 ] -= pm->ps->gravity * pml->frametime;
 
 	if ( pm->ps->velocity[ 2 ] < 0 )
 	{
@@ -1617,7 +1614,7 @@ PM_WaterMove
 
 ===================
 */
-static void PM_WaterMove( void )
+static void PM_WaterMove( pmove_t *pm, pml_t *pml )
 {
 	int    i;
 	vec3_t wishvel;
@@ -1627,11 +1624,11 @@ static void PM_WaterMove( void )
 	float  vel;
 
 	// if pouncing, stop
-	PM_CheckWaterPounce();
+	PM_CheckWaterPounce( pm );
 
-	if ( PM_CheckWaterJump() )
+	if ( PM_CheckWaterJump( pm, pml ) )
 	{
-		PM_WaterJumpMove();
+		PM_WaterJumpMove( pm, pml );
 		return;
 	}
 
@@ -1658,9 +1655,9 @@ static void PM_WaterMove( void )
 	}
 
 #endif
-	PM_Friction();
+	PM_Friction( pm, pml );
 
-	scale = PM_CmdScale( &pm->cmd, qtrue );
+	scale = PM_CmdScale( pm, &pm->cmd, qtrue );
 
 	//
 	// user intentions
@@ -1668,7 +1665,7 @@ static void PM_WaterMove( void )
 
 	for ( i = 0; i < 3; i++ )
 	{
-		wishvel[ i ] = scale * pml.forward[ i ] * pm->cmd.forwardmove + scale * pml.right[ i ] * pm->cmd.rightmove;
+		wishvel[ i ] = scale * pml->forward[ i ] * pm->cmd.forwardmove + scale * pml->right[ i ] * pm->cmd.rightmove;
 	}
 
 	wishvel[ 2 ] += scale * pm->cmd.upmove;
@@ -1681,23 +1678,23 @@ static void PM_WaterMove( void )
 		wishspeed = pm->ps->speed * pm_swimScale;
 	}
 
-	PM_Accelerate( wishdir, wishspeed, pm_wateraccelerate );
+	PM_Accelerate( pm, pml, wishdir, wishspeed, pm_wateraccelerate );
 
 	// make sure we can go up slopes easily under water
-	if ( pml.groundPlane && DotProduct( pm->ps->velocity, pml.groundTrace.plane.normal ) < 0 )
+	if ( pml->groundPlane && DotProduct( pm->ps->velocity, pml->groundTrace.plane.normal ) < 0 )
 	{
 		vel = VectorLength( pm->ps->velocity );
 		// slide along the ground plane
-		PM_ClipVelocity( pm->ps->velocity, pml.groundTrace.plane.normal, pm->ps->velocity );
+		PM_ClipVelocity( pm->ps->velocity, pml->groundTrace.plane.normal, pm->ps->velocity );
 
 		VectorNormalize( pm->ps->velocity );
 		VectorScale( pm->ps->velocity, vel, pm->ps->velocity );
 	}
 
-	PM_SlideMove( qfalse );
+	PM_SlideMove( pm, pml, qfalse );
 }
 
-static void PM_FlyMove( void )
+static void PM_FlyMove( pmove_t *pm, pml_t *pml )
 {
 	int    i;
 	vec3_t wishvel;
@@ -1705,9 +1702,9 @@ static void PM_FlyMove( void )
 	vec3_t wishdir;
 	float  scale;
 
-	PM_Friction();
+	PM_Friction( pm, pml );
 
-	scale = PM_CmdScale( &pm->cmd, qtrue );
+	scale = PM_CmdScale( pm, &pm->cmd, qtrue );
 
 	//
 	// user intentions
@@ -1722,7 +1719,7 @@ static void PM_FlyMove( void )
 	{
 		for ( i = 0; i < 3; i++ )
 		{
-			wishvel[ i ] = scale * pml.forward[ i ] * pm->cmd.forwardmove + scale * pml.right[ i ] * pm->cmd.rightmove;
+			wishvel[ i ] = scale * pml->forward[ i ] * pm->cmd.forwardmove + scale * pml->right[ i ] * pm->cmd.rightmove;
 		}
 
 		wishvel[ 2 ] += scale * pm->cmd.upmove;
@@ -1731,9 +1728,9 @@ static void PM_FlyMove( void )
 	VectorCopy( wishvel, wishdir );
 	wishspeed = VectorNormalize( wishdir );
 
-	PM_Accelerate( wishdir, wishspeed, pm_flyaccelerate );
+	PM_Accelerate( pm, pml, wishdir, wishspeed, pm_flyaccelerate );
 
-	PM_StepSlideMove( qfalse, qfalse );
+	PM_StepSlideMove( pm, pml, qfalse, qfalse );
 }
 
 /*
@@ -1742,7 +1739,7 @@ PM_AirMove
 
 ===================
 */
-static void PM_AirMove( void )
+static void PM_AirMove( pmove_t *pm, pml_t *pml )
 {
 	int       i;
 	vec3_t    wishvel;
@@ -1752,29 +1749,29 @@ static void PM_AirMove( void )
 	float     scale;
 	usercmd_t cmd;
 
-	PM_CheckWallJump();
-	PM_CheckJetpack();
+	PM_CheckWallJump( pm, pml );
+	PM_CheckJetpack( pm, pml );
 
-	PM_Friction();
+	PM_Friction( pm, pml );
 
 	fmove = pm->cmd.forwardmove;
 	smove = pm->cmd.rightmove;
 
 	cmd = pm->cmd;
-	scale = PM_CmdScale( &cmd, qfalse );
+	scale = PM_CmdScale( pm, &cmd, qfalse );
 
 	// set the movementDir so clients can rotate the legs for strafing
-	PM_SetMovementDir();
+	PM_SetMovementDir( pm );
 
 	// project moves down to flat plane
-	pml.forward[ 2 ] = 0;
-	pml.right[ 2 ] = 0;
-	VectorNormalize( pml.forward );
-	VectorNormalize( pml.right );
+	pml->forward[ 2 ] = 0;
+	pml->right[ 2 ] = 0;
+	VectorNormalize( pml->forward );
+	VectorNormalize( pml->right );
 
 	for ( i = 0; i < 2; i++ )
 	{
-		wishvel[ i ] = pml.forward[ i ] * fmove + pml.right[ i ] * smove;
+		wishvel[ i ] = pml->forward[ i ] * fmove + pml->right[ i ] * smove;
 	}
 
 	wishvel[ 2 ] = 0;
@@ -1784,18 +1781,18 @@ static void PM_AirMove( void )
 	wishspeed *= scale;
 
 	// not on ground, so little effect on velocity
-	PM_Accelerate( wishdir, wishspeed,
+	PM_Accelerate( pm, pml, wishdir, wishspeed,
 	               BG_Class( pm->ps->stats[ STAT_CLASS ] )->airAcceleration );
 
 	// we may have a ground plane that is very steep, even
 	// though we don't have a groundentity
 	// slide along the steep plane
-	if ( pml.groundPlane )
+	if ( pml->groundPlane )
 	{
-		PM_ClipVelocity( pm->ps->velocity, pml.groundTrace.plane.normal, pm->ps->velocity );
+		PM_ClipVelocity( pm->ps->velocity, pml->groundTrace.plane.normal, pm->ps->velocity );
 	}
 
-	PM_StepSlideMove( qtrue, qfalse );
+	PM_StepSlideMove( pm, pml, qtrue, qfalse );
 }
 
 /*
@@ -1804,7 +1801,7 @@ PM_ClimbMove
 
 ===================
 */
-static void PM_ClimbMove( void )
+static void PM_ClimbMove( pmove_t *pm, pml_t *pml )
 {
 	int       i;
 	vec3_t    wishvel;
@@ -1816,49 +1813,49 @@ static void PM_ClimbMove( void )
 	float     accelerate;
 	float     vel;
 
-	if ( pm->waterlevel > 2 && DotProduct( pml.forward, pml.groundTrace.plane.normal ) > 0 )
+	if ( pm->waterlevel > 2 && DotProduct( pml->forward, pml->groundTrace.plane.normal ) > 0 )
 	{
 		// begin swimming
-		PM_WaterMove();
+		PM_WaterMove( pm, pml );
 		return;
 	}
 
-	if ( PM_CheckJump() || PM_CheckPounce() )
+	if ( PM_CheckJump( pm, pml ) || PM_CheckPounce( pm, pml ) )
 	{
 		// jumped away
 		if ( pm->waterlevel > 1 )
 		{
-			PM_WaterMove();
+			PM_WaterMove( pm, pml );
 		}
 		else
 		{
-			PM_AirMove();
+			PM_AirMove( pm, pml );
 		}
 
 		return;
 	}
 
-	PM_Friction();
+	PM_Friction( pm, pml );
 
 	fmove = pm->cmd.forwardmove;
 	smove = pm->cmd.rightmove;
 
 	cmd = pm->cmd;
-	scale = PM_CmdScale( &cmd, qfalse );
+	scale = PM_CmdScale( pm, &cmd, qfalse );
 
 	// set the movementDir so clients can rotate the legs for strafing
-	PM_SetMovementDir();
+	PM_SetMovementDir( pm );
 
 	// project the forward and right directions onto the ground plane
-	PM_ClipVelocity( pml.forward, pml.groundTrace.plane.normal, pml.forward );
-	PM_ClipVelocity( pml.right, pml.groundTrace.plane.normal, pml.right );
+	PM_ClipVelocity( pml->forward, pml->groundTrace.plane.normal, pml->forward );
+	PM_ClipVelocity( pml->right, pml->groundTrace.plane.normal, pml->right );
 	//
-	VectorNormalize( pml.forward );
-	VectorNormalize( pml.right );
+	VectorNormalize( pml->forward );
+	VectorNormalize( pml->right );
 
 	for ( i = 0; i < 3; i++ )
 	{
-		wishvel[ i ] = pml.forward[ i ] * fmove + pml.right[ i ] * smove;
+		wishvel[ i ] = pml->forward[ i ] * fmove + pml->right[ i ] * smove;
 	}
 
 	// when going up or down slopes the wish velocity should Not be zero
@@ -1893,7 +1890,7 @@ static void PM_ClimbMove( void )
 
 	// when a player gets hit, they temporarily lose
 	// full control, which allows them to be moved a bit
-	if ( ( pml.groundTrace.surfaceFlags & SURF_SLICK ) || pm->ps->pm_flags & PMF_TIME_KNOCKBACK )
+	if ( ( pml->groundTrace.surfaceFlags & SURF_SLICK ) || pm->ps->pm_flags & PMF_TIME_KNOCKBACK )
 	{
 		accelerate = BG_Class( pm->ps->stats[ STAT_CLASS ] )->airAcceleration;
 	}
@@ -1902,17 +1899,17 @@ static void PM_ClimbMove( void )
 		accelerate = BG_Class( pm->ps->stats[ STAT_CLASS ] )->acceleration;
 	}
 
-	PM_Accelerate( wishdir, wishspeed, accelerate );
+	PM_Accelerate( pm, pml, wishdir, wishspeed, accelerate );
 
-	if ( ( pml.groundTrace.surfaceFlags & SURF_SLICK ) || pm->ps->pm_flags & PMF_TIME_KNOCKBACK )
+	if ( ( pml->groundTrace.surfaceFlags & SURF_SLICK ) || pm->ps->pm_flags & PMF_TIME_KNOCKBACK )
 	{
-		pm->ps->velocity[ 2 ] -= pm->ps->gravity * pml.frametime;
+		pm->ps->velocity[ 2 ] -= pm->ps->gravity * pml->frametime;
 	}
 
 	vel = VectorLength( pm->ps->velocity );
 
 	// slide along the ground plane
-	PM_ClipVelocity( pm->ps->velocity, pml.groundTrace.plane.normal, pm->ps->velocity );
+	PM_ClipVelocity( pm->ps->velocity, pml->groundTrace.plane.normal, pm->ps->velocity );
 
 	// don't decrease velocity when going up or down a slope
 	VectorNormalize( pm->ps->velocity );
@@ -1924,7 +1921,7 @@ static void PM_ClimbMove( void )
 		return;
 	}
 
-	PM_StepSlideMove( qfalse, qfalse );
+	PM_StepSlideMove( pm, pml, qfalse, qfalse );
 }
 
 /*
@@ -1933,7 +1930,7 @@ PM_WalkMove
 
 ===================
 */
-static void PM_WalkMove( void )
+static void PM_WalkMove( pmove_t *pm, pml_t *pml )
 {
 	int       i;
 	vec3_t    wishvel;
@@ -1944,22 +1941,22 @@ static void PM_WalkMove( void )
 	usercmd_t cmd;
 	float     accelerate;
 
-	if ( pm->waterlevel > 2 && DotProduct( pml.forward, pml.groundTrace.plane.normal ) > 0 )
+	if ( pm->waterlevel > 2 && DotProduct( pml->forward, pml->groundTrace.plane.normal ) > 0 )
 	{
 		// begin swimming
-		PM_WaterMove();
+		PM_WaterMove( pm, pml );
 		return;
 	}
 
-	if ( PM_CheckJump() || PM_CheckPounce() )
+	if ( PM_CheckJump( pm, pml ) || PM_CheckPounce( pm, pml ) )
 	{
 		if ( pm->waterlevel > 1 )
 		{
-			PM_WaterMove();
+			PM_WaterMove( pm, pml );
 		}
 		else
 		{
-			PM_AirMove();
+			PM_AirMove( pm, pml );
 		}
 
 		return;
@@ -1967,35 +1964,35 @@ static void PM_WalkMove( void )
 
 	// if PM_Land didn't stop the jetpack (e.g. to allow for a jump) but we didn't get away
 	// from the ground, stop it now
-	PM_LandJetpack( qtrue );
+	PM_LandJetpack( pm, pml, qtrue );
 
-	PM_CheckCharge();
+	PM_CheckCharge( pm );
 
-	PM_Friction();
+	PM_Friction( pm, pml );
 
 	fmove = pm->cmd.forwardmove;
 	smove = pm->cmd.rightmove;
 
 	cmd = pm->cmd;
-	scale = PM_CmdScale( &cmd, qfalse );
+	scale = PM_CmdScale( pm, &cmd, qfalse );
 
 	// set the movementDir so clients can rotate the legs for strafing
-	PM_SetMovementDir();
+	PM_SetMovementDir( pm );
 
 	// project moves down to flat plane
-	pml.forward[ 2 ] = 0;
-	pml.right[ 2 ] = 0;
+	pml->forward[ 2 ] = 0;
+	pml->right[ 2 ] = 0;
 
 	// project the forward and right directions onto the ground plane
-	PM_ClipVelocity( pml.forward, pml.groundTrace.plane.normal, pml.forward );
-	PM_ClipVelocity( pml.right, pml.groundTrace.plane.normal, pml.right );
+	PM_ClipVelocity( pml->forward, pml->groundTrace.plane.normal, pml->forward );
+	PM_ClipVelocity( pml->right, pml->groundTrace.plane.normal, pml->right );
 	//
-	VectorNormalize( pml.forward );
-	VectorNormalize( pml.right );
+	VectorNormalize( pml->forward );
+	VectorNormalize( pml->right );
 
 	for ( i = 0; i < 3; i++ )
 	{
-		wishvel[ i ] = pml.forward[ i ] * fmove + pml.right[ i ] * smove;
+		wishvel[ i ] = pml->forward[ i ] * fmove + pml->right[ i ] * smove;
 	}
 
 	// when going up or down slopes the wish velocity should Not be zero
@@ -2030,7 +2027,7 @@ static void PM_WalkMove( void )
 
 	// when a player gets hit, they temporarily lose
 	// full control, which allows them to be moved a bit
-	if ( ( pml.groundTrace.surfaceFlags & SURF_SLICK ) || pm->ps->pm_flags & PMF_TIME_KNOCKBACK )
+	if ( ( pml->groundTrace.surfaceFlags & SURF_SLICK ) || pm->ps->pm_flags & PMF_TIME_KNOCKBACK )
 	{
 		accelerate = BG_Class( pm->ps->stats[ STAT_CLASS ] )->airAcceleration;
 	}
@@ -2039,14 +2036,14 @@ static void PM_WalkMove( void )
 		accelerate = BG_Class( pm->ps->stats[ STAT_CLASS ] )->acceleration;
 	}
 
-	PM_Accelerate( wishdir, wishspeed, accelerate );
+	PM_Accelerate( pm, pml, wishdir, wishspeed, accelerate );
 
 	//Com_Printf("velocity = %1.1f %1.1f %1.1f\n", pm->ps->velocity[0], pm->ps->velocity[1], pm->ps->velocity[2]);
 	//Com_Printf("velocity1 = %1.1f\n", VectorLength(pm->ps->velocity));
 
-	if ( ( pml.groundTrace.surfaceFlags & SURF_SLICK ) || pm->ps->pm_flags & PMF_TIME_KNOCKBACK )
+	if ( ( pml->groundTrace.surfaceFlags & SURF_SLICK ) || pm->ps->pm_flags & PMF_TIME_KNOCKBACK )
 	{
-		pm->ps->velocity[ 2 ] -= pm->ps->gravity * pml.frametime;
+		pm->ps->velocity[ 2 ] -= pm->ps->gravity * pml->frametime;
 	}
 	else
 	{
@@ -2055,7 +2052,7 @@ static void PM_WalkMove( void )
 	}
 
 	// slide along the ground plane
-	PM_ClipVelocity( pm->ps->velocity, pml.groundTrace.plane.normal, pm->ps->velocity );
+	PM_ClipVelocity( pm->ps->velocity, pml->groundTrace.plane.normal, pm->ps->velocity );
 
 	// don't do anything if standing still
 	if ( !pm->ps->velocity[ 0 ] && !pm->ps->velocity[ 1 ] )
@@ -2063,7 +2060,7 @@ static void PM_WalkMove( void )
 		return;
 	}
 
-	PM_StepSlideMove( qfalse, qfalse );
+	PM_StepSlideMove( pm, pml, qfalse, qfalse );
 
 	//Com_Printf("velocity2 = %1.1f\n", VectorLength(pm->ps->velocity));
 }
@@ -2075,7 +2072,7 @@ PM_LadderMove
 Basically a rip of PM_WaterMove with a few changes
 ===================
 */
-static void PM_LadderMove( void )
+static void PM_LadderMove( pmove_t *pm, pml_t *pml )
 {
 	int    i;
 	vec3_t wishvel;
@@ -2084,13 +2081,13 @@ static void PM_LadderMove( void )
 	float  scale;
 	float  vel;
 
-	PM_Friction();
+	PM_Friction( pm, pml );
 
-	scale = PM_CmdScale( &pm->cmd, qtrue );
+	scale = PM_CmdScale( pm, &pm->cmd, qtrue );
 
 	for ( i = 0; i < 3; i++ )
 	{
-		wishvel[ i ] = scale * pml.forward[ i ] * pm->cmd.forwardmove + scale * pml.right[ i ] * pm->cmd.rightmove;
+		wishvel[ i ] = scale * pml->forward[ i ] * pm->cmd.forwardmove + scale * pml->right[ i ] * pm->cmd.rightmove;
 	}
 
 	wishvel[ 2 ] += scale * pm->cmd.upmove;
@@ -2103,21 +2100,21 @@ static void PM_LadderMove( void )
 		wishspeed = pm->ps->speed * pm_swimScale;
 	}
 
-	PM_Accelerate( wishdir, wishspeed, pm_accelerate );
+	PM_Accelerate( pm, pml, wishdir, wishspeed, pm_accelerate );
 
 	//slanty ladders
-	if ( pml.groundPlane && DotProduct( pm->ps->velocity, pml.groundTrace.plane.normal ) < 0.0f )
+	if ( pml->groundPlane && DotProduct( pm->ps->velocity, pml->groundTrace.plane.normal ) < 0.0f )
 	{
 		vel = VectorLength( pm->ps->velocity );
 
 		// slide along the ground plane
-		PM_ClipVelocity( pm->ps->velocity, pml.groundTrace.plane.normal, pm->ps->velocity );
+		PM_ClipVelocity( pm->ps->velocity, pml->groundTrace.plane.normal, pm->ps->velocity );
 
 		VectorNormalize( pm->ps->velocity );
 		VectorScale( pm->ps->velocity, vel, pm->ps->velocity );
 	}
 
-	PM_SlideMove( qfalse );
+	PM_SlideMove( pm, pml, qfalse );
 }
 
 /*
@@ -2127,7 +2124,7 @@ PM_CheckLadder
 Check to see if the player is on a ladder or not
 =============
 */
-static void PM_CheckLadder( void )
+static void PM_CheckLadder( pmove_t *pm, pml_t *pml )
 {
 	vec3_t  forward, end;
 	trace_t trace;
@@ -2135,11 +2132,11 @@ static void PM_CheckLadder( void )
 	//test if class can use ladders
 	if ( !BG_ClassHasAbility( pm->ps->stats[ STAT_CLASS ], SCA_CANUSELADDERS ) )
 	{
-		pml.ladder = qfalse;
+		pml->ladder = qfalse;
 		return;
 	}
 
-	VectorCopy( pml.forward, forward );
+	VectorCopy( pml->forward, forward );
 	forward[ 2 ] = 0.0f;
 
 	VectorMA( pm->ps->origin, 1.0f, forward, end );
@@ -2148,11 +2145,11 @@ static void PM_CheckLadder( void )
 
 	if ( ( trace.fraction < 1.0f ) && ( trace.surfaceFlags & SURF_LADDER ) )
 	{
-		pml.ladder = qtrue;
+		pml->ladder = qtrue;
 	}
 	else
 	{
-		pml.ladder = qfalse;
+		pml->ladder = qfalse;
 	}
 }
 
@@ -2161,11 +2158,11 @@ static void PM_CheckLadder( void )
 PM_DeadMove
 ==============
 */
-static void PM_DeadMove( void )
+static void PM_DeadMove( pmove_t *pm, pml_t *pml )
 {
 	float forward;
 
-	if ( !pml.walking )
+	if ( !pml->walking )
 	{
 		return;
 	}
@@ -2191,7 +2188,7 @@ static void PM_DeadMove( void )
 PM_NoclipMove
 ===============
 */
-static void PM_NoclipMove( void )
+static void PM_NoclipMove( pmove_t *pm, pml_t *pml )
 {
 	float  speed, drop, friction, control, newspeed;
 	int    i;
@@ -2215,7 +2212,7 @@ static void PM_NoclipMove( void )
 
 		friction = pm_friction * 1.5; // extra friction
 		control = speed < pm_stopspeed ? pm_stopspeed : speed;
-		drop += control * friction * pml.frametime;
+		drop += control * friction * pml->frametime;
 
 		// scale the velocity
 		newspeed = speed - drop;
@@ -2231,14 +2228,14 @@ static void PM_NoclipMove( void )
 	}
 
 	// accelerate
-	scale = PM_CmdScale( &pm->cmd, qtrue );
+	scale = PM_CmdScale( pm, &pm->cmd, qtrue );
 
 	fmove = pm->cmd.forwardmove;
 	smove = pm->cmd.rightmove;
 
 	for ( i = 0; i < 3; i++ )
 	{
-		wishvel[ i ] = pml.forward[ i ] * fmove + pml.right[ i ] * smove;
+		wishvel[ i ] = pml->forward[ i ] * fmove + pml->right[ i ] * smove;
 	}
 
 	wishvel[ 2 ] += pm->cmd.upmove;
@@ -2247,10 +2244,10 @@ static void PM_NoclipMove( void )
 	wishspeed = VectorNormalize( wishdir );
 	wishspeed *= scale;
 
-	PM_Accelerate( wishdir, wishspeed, pm_accelerate );
+	PM_Accelerate( pm, pml, wishdir, wishspeed, pm_accelerate );
 
 	// move
-	VectorMA( pm->ps->origin, pml.frametime, pm->ps->velocity, pm->ps->origin );
+	VectorMA( pm->ps->origin, pml->frametime, pm->ps->velocity, pm->ps->origin );
 }
 
 //============================================================================
@@ -2262,19 +2259,19 @@ PM_FootstepForSurface
 Returns an event number appropriate for the groundsurface
 ================
 */
-static int PM_FootstepForSurface( void )
+static int PM_FootstepForSurface( pmove_t *pm, pml_t *pml )
 {
 	if ( pm->ps->stats[ STAT_STATE ] & SS_CREEPSLOWED )
 	{
 		return EV_FOOTSTEP_SQUELCH;
 	}
 
-	if ( pml.groundTrace.surfaceFlags & SURF_NOSTEPS )
+	if ( pml->groundTrace.surfaceFlags & SURF_NOSTEPS )
 	{
 		return 0;
 	}
 
-	if ( pml.groundTrace.surfaceFlags & SURF_METAL )
+	if ( pml->groundTrace.surfaceFlags & SURF_METAL )
 	{
 		return EV_FOOTSTEP_METAL;
 	}
@@ -2289,31 +2286,31 @@ PM_Land
 Play landing animation
 =================
 */
-static void PM_Land( void )
+static void PM_Land( pmove_t *pm, pml_t *pml )
 {
-	PM_LandJetpack( qfalse ); // don't force a stop, sometimes we can push off with a jump
+	PM_LandJetpack( pm, pml, qfalse ); // don't force a stop, sometimes we can push off with a jump
 
 	// decide which landing animation to use
 	if ( pm->ps->pm_flags & PMF_BACKWARDS_JUMP )
 	{
 		if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 		{
-			PM_ForceLegsAnim( LEGS_LANDB );
+			PM_ForceLegsAnim( pm, LEGS_LANDB );
 		}
 		else
 		{
-			PM_ForceLegsAnim( NSPA_LANDBACK );
+			PM_ForceLegsAnim( pm, NSPA_LANDBACK );
 		}
 	}
 	else
 	{
 		if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 		{
-			PM_ForceLegsAnim( LEGS_LAND );
+			PM_ForceLegsAnim( pm, LEGS_LAND );
 		}
 		else
 		{
-			PM_ForceLegsAnim( NSPA_LAND );
+			PM_ForceLegsAnim( pm, NSPA_LAND );
 		}
 	}
 
@@ -2337,7 +2334,7 @@ PM_CrashLand
 Check for hard landings that generate sound events
 =================
 */
-static void PM_CrashLand( void )
+static void PM_CrashLand( pmove_t *pm, pml_t *pml )
 {
 	float delta;
 	float dist;
@@ -2346,8 +2343,8 @@ static void PM_CrashLand( void )
 	float a, b, c, den;
 
 	// calculate the exact velocity on landing
-	dist = pm->ps->origin[ 2 ] - pml.previous_origin[ 2 ];
-	vel = pml.previous_velocity[ 2 ];
+	dist = pm->ps->origin[ 2 ] - pml->previous_origin[ 2 ];
+	vel = pml->previous_velocity[ 2 ];
 	acc = -pm->ps->gravity;
 
 	a = acc / 2;
@@ -2392,7 +2389,7 @@ static void PM_CrashLand( void )
 
 	// SURF_NODAMAGE is used for bounce pads where you don't ever
 	// want to take damage or play a crunch sound
-	if ( !( pml.groundTrace.surfaceFlags & SURF_NODAMAGE ) )
+	if ( !( pml->groundTrace.surfaceFlags & SURF_NODAMAGE ) )
 	{
 		pm->ps->stats[ STAT_FALLDIST ] = delta;
 
@@ -2400,25 +2397,25 @@ static void PM_CrashLand( void )
 		{
 			if ( PM_Live( pm->ps->pm_type ) )
 			{
-				PM_AddEvent( EV_FALL_FAR );
+				PM_AddEvent( pm, EV_FALL_FAR );
 			}
 		}
 		else if ( delta > MIN_FALL_DISTANCE )
 		{
 			if ( PM_Live( pm->ps->pm_type ) )
 			{
-				PM_AddEvent( EV_FALL_MEDIUM );
+				PM_AddEvent( pm, EV_FALL_MEDIUM );
 			}
 		}
 		else
 		{
 			if ( delta > 7 )
 			{
-				PM_AddEvent( EV_FALL_SHORT );
+				PM_AddEvent( pm, EV_FALL_SHORT );
 			}
 			else
 			{
-				PM_AddEvent( PM_FootstepForSurface() );
+				PM_AddEvent( pm, PM_FootstepForSurface( pm, pml ) );
 			}
 		}
 	}
@@ -2432,7 +2429,7 @@ static void PM_CrashLand( void )
 PM_CorrectAllSolid
 =============
 */
-static int PM_CorrectAllSolid( trace_t *trace )
+static int PM_CorrectAllSolid( pmove_t *pm, pml_t *pml, trace_t *trace )
 {
 	int    i, j, k;
 	vec3_t point;
@@ -2462,7 +2459,7 @@ static int PM_CorrectAllSolid( trace_t *trace )
 					point[ 2 ] = pm->ps->origin[ 2 ] - 0.25;
 
 					pm->trace( trace, pm->ps->origin, pm->mins, pm->maxs, point, pm->ps->clientNum, pm->tracemask );
-					pml.groundTrace = *trace;
+					pml->groundTrace = *trace;
 					return qtrue;
 				}
 			}
@@ -2470,8 +2467,8 @@ static int PM_CorrectAllSolid( trace_t *trace )
 	}
 
 	pm->ps->groundEntityNum = ENTITYNUM_NONE;
-	pml.groundPlane = qfalse;
-	pml.walking = qfalse;
+	pml->groundPlane = qfalse;
+	pml->walking = qfalse;
 
 	return qfalse;
 }
@@ -2483,7 +2480,7 @@ PM_GroundTraceMissed
 The ground trace didn't hit a surface, so we are in freefall
 =============
 */
-static void PM_GroundTraceMissed( void )
+static void PM_GroundTraceMissed( pmove_t *pm, pml_t *pml )
 {
 	trace_t trace;
 	vec3_t  point;
@@ -2509,11 +2506,11 @@ static void PM_GroundTraceMissed( void )
 			{
 				if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 				{
-					PM_ForceLegsAnim( LEGS_JUMP );
+					PM_ForceLegsAnim( pm, LEGS_JUMP );
 				}
 				else
 				{
-					PM_ForceLegsAnim( NSPA_JUMP );
+					PM_ForceLegsAnim( pm, NSPA_JUMP );
 				}
 
 				pm->ps->pm_flags &= ~PMF_BACKWARDS_JUMP;
@@ -2522,11 +2519,11 @@ static void PM_GroundTraceMissed( void )
 			{
 				if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 				{
-					PM_ForceLegsAnim( LEGS_JUMPB );
+					PM_ForceLegsAnim( pm, LEGS_JUMPB );
 				}
 				else
 				{
-					PM_ForceLegsAnim( NSPA_JUMPBACK );
+					PM_ForceLegsAnim( pm, NSPA_JUMPBACK );
 				}
 
 				pm->ps->pm_flags |= PMF_BACKWARDS_JUMP;
@@ -2536,15 +2533,15 @@ static void PM_GroundTraceMissed( void )
 
 	if ( BG_ClassHasAbility( pm->ps->stats[ STAT_CLASS ], SCA_TAKESFALLDAMAGE ) )
 	{
-		if ( pm->ps->velocity[ 2 ] < FALLING_THRESHOLD && pml.previous_velocity[ 2 ] >= FALLING_THRESHOLD )
+		if ( pm->ps->velocity[ 2 ] < FALLING_THRESHOLD && pml->previous_velocity[ 2 ] >= FALLING_THRESHOLD )
 		{
-			PM_AddEvent( EV_FALLING );
+			PM_AddEvent( pm, EV_FALLING );
 		}
 	}
 
 	pm->ps->groundEntityNum = ENTITYNUM_NONE;
-	pml.groundPlane = qfalse;
-	pml.walking = qfalse;
+	pml->groundPlane = qfalse;
+	pml->walking = qfalse;
 }
 
 /*
@@ -2564,7 +2561,7 @@ enum {
 	NUM_GCT_ATP
 };
 
-static void PM_GroundClimbTrace( void )
+static void PM_GroundClimbTrace( pmove_t *pm, pml_t *pml )
 {
 	vec3_t      surfNormal, moveDir, lookDir, point, velocityDir;
 	vec3_t      toAngles, surfAngles;
@@ -2589,7 +2586,7 @@ static void PM_GroundClimbTrace( void )
 
 	// construct a vector which reflects the direction the player is looking at
 	// with respect to the surface normal
-	ProjectPointOnPlane( moveDir, pml.forward, surfNormal );
+	ProjectPointOnPlane( moveDir, pml->forward, surfNormal );
 	VectorNormalize( moveDir );
 
 	VectorCopy( moveDir, lookDir );
@@ -2602,7 +2599,7 @@ static void PM_GroundClimbTrace( void )
 	// allow strafe transitions
 	if ( pm->cmd.rightmove )
 	{
-		VectorCopy( pml.right, moveDir );
+		VectorCopy( pml->right, moveDir );
 
 		if ( pm->cmd.rightmove < 0 )
 		{
@@ -2621,7 +2618,7 @@ static void PM_GroundClimbTrace( void )
 		{
 			case GCT_ATP_MOVEDIRECTION:
 				// we are going to step this frame so skip the transition test
-				if ( PM_PredictStepMove() )
+				if ( PM_PredictStepMove( pm, pml ) )
 				{
 					continue;
 				}
@@ -2642,7 +2639,7 @@ static void PM_GroundClimbTrace( void )
 				break;
 
 			case GCT_ATP_STEPMOVE:
-				if ( pml.groundPlane != qfalse && PM_PredictStepMove() )
+				if ( pml->groundPlane != qfalse && PM_PredictStepMove( pm, pml ) )
 				{
 					// step down
 					VectorMA( pm->ps->origin, -STEPSIZE, surfNormal, point );
@@ -2657,7 +2654,7 @@ static void PM_GroundClimbTrace( void )
 
 			case GCT_ATP_UNDERNEATH:
 				// trace "underneath" BBOX so we can traverse angles > 180deg
-				if ( pml.groundPlane != qfalse )
+				if ( pml->groundPlane != qfalse )
 				{
 					VectorMA( pm->ps->origin, -16.0f, surfNormal, point );
 					VectorMA( point, -16.0f, moveDir, point );
@@ -2702,7 +2699,7 @@ static void PM_GroundClimbTrace( void )
 				// add step event if necessary
 				if ( i == GCT_ATP_STEPMOVE )
 				{
-					PM_StepEvent( pm->ps->origin, trace.endpos, surfNormal );
+					PM_StepEvent( pm, pm->ps->origin, trace.endpos, surfNormal );
 				}
 
 				// snap our origin to the new surface
@@ -2828,7 +2825,7 @@ static void PM_GroundClimbTrace( void )
 					else
 					{
 						// rotate view around itself
-						VectorCopy( pml.forward, pm->ps->grapplePoint );
+						VectorCopy( pml->forward, pm->ps->grapplePoint );
 						pm->ps->grapplePoint[ 2 ] = 0.0f;
 
 						// sanity check grapplePoint, use an arbitrary axis as fallback
@@ -2858,7 +2855,7 @@ static void PM_GroundClimbTrace( void )
 			}
 
 			// we have ground
-			pml.groundTrace = trace;
+			pml->groundTrace = trace;
 
 			// we are climbing on a wall
 			pm->ps->eFlags |= EF_WALLCLIMB;
@@ -2876,7 +2873,7 @@ static void PM_GroundClimbTrace( void )
 		else if ( trace.allsolid )
 		{
 			// do something corrective if the trace starts in a solid
-			if ( !PM_CorrectAllSolid( &trace ) )
+			if ( !PM_CorrectAllSolid( pm, pml, &trace ) )
 			{
 				return;
 			}
@@ -2886,9 +2883,9 @@ static void PM_GroundClimbTrace( void )
 	// check if we are in free wall (the last trace didn't hit)
 	if ( trace.fraction >= 1.0f )
 	{
-		PM_GroundTraceMissed();
-		pml.groundPlane = qfalse;
-		pml.walking = qfalse;
+		PM_GroundTraceMissed( pm, pml );
+		pml->groundPlane = qfalse;
+		pml->walking = qfalse;
 
 		// if we were wallwalking the last frame, apply delta correction
 		if( pm->ps->eFlags & EF_WALLCLIMB || pm->ps->eFlags & EF_WALLCLIMBCEILING)
@@ -2944,8 +2941,8 @@ static void PM_GroundClimbTrace( void )
 	}
 
 	// we are on a surface
-	pml.groundPlane = qtrue;
-	pml.walking = qtrue;
+	pml->groundPlane = qtrue;
+	pml->walking = qtrue;
 
 	// hitting solid ground will end a waterjump
 	if ( pm->ps->pm_flags & PMF_TIME_WATERJUMP )
@@ -2956,7 +2953,7 @@ static void PM_GroundClimbTrace( void )
 
 	pm->ps->groundEntityNum = trace.entityNum;
 
-	PM_AddTouchEnt( trace.entityNum );
+	PM_AddTouchEnt( pm, trace.entityNum );
 }
 
 /*
@@ -2964,7 +2961,7 @@ static void PM_GroundClimbTrace( void )
 PM_GroundTrace
 =============
 */
-static void PM_GroundTrace( void )
+static void PM_GroundTrace( pmove_t *pm, pml_t *pml )
 {
 	vec3_t  point;
 	trace_t trace;
@@ -3013,7 +3010,7 @@ static void PM_GroundTrace( void )
 
 		if ( pm->ps->stats[ STAT_STATE ] & SS_WALLCLIMBING )
 		{
-			PM_GroundClimbTrace();
+			PM_GroundClimbTrace( pm, pml );
 			return;
 		}
 
@@ -3058,12 +3055,12 @@ static void PM_GroundTrace( void )
 
 	pm->trace( &trace, pm->ps->origin, pm->mins, pm->maxs, point, pm->ps->clientNum, pm->tracemask );
 
-	pml.groundTrace = trace;
+	pml->groundTrace = trace;
 
 	// do something corrective if the trace starts in a solid...
 	if ( trace.allsolid )
 	{
-		if ( !PM_CorrectAllSolid( &trace ) )
+		if ( !PM_CorrectAllSolid( pm, pml, &trace ) )
 		{
 			return;
 		}
@@ -3078,7 +3075,7 @@ static void PM_GroundTrace( void )
 		qboolean steppedDown = qfalse;
 
 		// try to step down
-		if ( pml.groundPlane && PM_PredictStepMove() )
+		if ( pml->groundPlane && PM_PredictStepMove( pm, pml ) )
 		{
 			//step down
 			point[ 0 ] = pm->ps->origin[ 0 ];
@@ -3089,7 +3086,7 @@ static void PM_GroundTrace( void )
 			//if we hit something
 			if ( trace.fraction < 1.0f )
 			{
-				PM_StepEvent( pm->ps->origin, trace.endpos, refNormal );
+				PM_StepEvent( pm, pm->ps->origin, trace.endpos, refNormal );
 				VectorCopy( trace.endpos, pm->ps->origin );
 				steppedDown = qtrue;
 			}
@@ -3097,9 +3094,9 @@ static void PM_GroundTrace( void )
 
 		if ( !steppedDown )
 		{
-			PM_GroundTraceMissed();
-			pml.groundPlane = qfalse;
-			pml.walking = qfalse;
+			PM_GroundTraceMissed( pm, pml );
+			pml->groundPlane = qfalse;
+			pml->walking = qfalse;
 
 			return;
 		}
@@ -3118,11 +3115,11 @@ static void PM_GroundTrace( void )
 		{
 			if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 			{
-				PM_ForceLegsAnim( LEGS_JUMP );
+				PM_ForceLegsAnim( pm, LEGS_JUMP );
 			}
 			else
 			{
-				PM_ForceLegsAnim( NSPA_JUMP );
+				PM_ForceLegsAnim( pm, NSPA_JUMP );
 			}
 
 			pm->ps->pm_flags &= ~PMF_BACKWARDS_JUMP;
@@ -3131,19 +3128,19 @@ static void PM_GroundTrace( void )
 		{
 			if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 			{
-				PM_ForceLegsAnim( LEGS_JUMPB );
+				PM_ForceLegsAnim( pm, LEGS_JUMPB );
 			}
 			else
 			{
-				PM_ForceLegsAnim( NSPA_JUMPBACK );
+				PM_ForceLegsAnim( pm, NSPA_JUMPBACK );
 			}
 
 			pm->ps->pm_flags |= PMF_BACKWARDS_JUMP;
 		}
 
 		pm->ps->groundEntityNum = ENTITYNUM_NONE;
-		pml.groundPlane = qfalse;
-		pml.walking = qfalse;
+		pml->groundPlane = qfalse;
+		pml->walking = qfalse;
 		return;
 	}
 
@@ -3158,13 +3155,13 @@ static void PM_GroundTrace( void )
 		// FIXME: if they can't slide down the slope, let them
 		// walk (sharp crevices)
 		pm->ps->groundEntityNum = ENTITYNUM_NONE;
-		pml.groundPlane = qtrue;
-		pml.walking = qfalse;
+		pml->groundPlane = qtrue;
+		pml->walking = qfalse;
 		return;
 	}
 
-	pml.groundPlane = qtrue;
-	pml.walking = qtrue;
+	pml->groundPlane = qtrue;
+	pml->walking = qtrue;
 
 	// hitting solid ground will end a waterjump
 	if ( pm->ps->pm_flags & PMF_TIME_WATERJUMP )
@@ -3182,13 +3179,13 @@ static void PM_GroundTrace( void )
 		}
 
 		// communicate the impact velocity to the server
-		VectorCopy( pml.previous_velocity, pm->pmext->fallImpactVelocity );
+		VectorCopy( pml->previous_velocity, pm->pmext->fallImpactVelocity );
 
-		PM_Land();
+		PM_Land( pm, pml );
 
 		if ( BG_ClassHasAbility( pm->ps->stats[ STAT_CLASS ], SCA_TAKESFALLDAMAGE ) )
 		{
-			PM_CrashLand();
+			PM_CrashLand( pm, pml );
 		}
 	}
 
@@ -3197,7 +3194,7 @@ static void PM_GroundTrace( void )
 	// don't reset the z velocity for slopes
 	//pm->ps->velocity[2] = 0;
 
-	PM_AddTouchEnt( trace.entityNum );
+	PM_AddTouchEnt( pm, trace.entityNum );
 }
 
 /*
@@ -3205,7 +3202,7 @@ static void PM_GroundTrace( void )
 PM_SetWaterLevel  FIXME: avoid this twice?  certainly if not moving
 =============
 */
-static void PM_SetWaterLevel( void )
+static void PM_SetWaterLevel( pmove_t *pm )
 {
 	vec3_t point;
 	int    cont;
@@ -3252,7 +3249,7 @@ static void PM_SetWaterLevel( void )
 PM_SetViewheight
 ==============
 */
-static void PM_SetViewheight( void )
+static void PM_SetViewheight( pmove_t *pm )
 {
 	pm->ps->viewheight = ( pm->ps->pm_flags & PMF_DUCKED )
 	                     ? BG_ClassModelConfig( pm->ps->stats[ STAT_CLASS ] )->crouchViewheight
@@ -3266,7 +3263,7 @@ PM_CheckDuck
 Sets mins and maxs, and calls PM_SetViewheight
 ==============
 */
-static void PM_CheckDuck( void )
+static void PM_CheckDuck( pmove_t *pm )
 {
 	trace_t trace;
 	vec3_t  PCmins, PCmaxs, PCcmaxs;
@@ -3319,7 +3316,7 @@ static void PM_CheckDuck( void )
 		pm->maxs[ 2 ] = PCmaxs[ 2 ];
 	}
 
-	PM_SetViewheight();
+	PM_SetViewheight( pm );
 }
 
 //===================================================================
@@ -3329,7 +3326,7 @@ static void PM_CheckDuck( void )
 PM_Footsteps
 ===============
 */
-static void PM_Footsteps( void )
+static void PM_Footsteps( pmove_t *pm, pml_t *pml )
 {
 	float    bobmove;
 	int      old;
@@ -3339,7 +3336,7 @@ static void PM_Footsteps( void )
 	// calculate speed and cycle to be used for
 	// all cyclic walking effects
 	//
-	if ( BG_ClassHasAbility( pm->ps->stats[ STAT_CLASS ], SCA_WALLCLIMBER ) && ( pml.groundPlane ) )
+	if ( BG_ClassHasAbility( pm->ps->stats[ STAT_CLASS ], SCA_WALLCLIMBER ) && ( pml->groundPlane ) )
 	{
 		// FIXME: yes yes i know this is wrong
 		pm->xyspeed = sqrt( pm->ps->velocity[ 0 ] * pm->ps->velocity[ 0 ]
@@ -3359,11 +3356,11 @@ static void PM_Footsteps( void )
 		{
 			if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 			{
-				PM_ContinueLegsAnim( LEGS_SWIM );
+				PM_ContinueLegsAnim( pm, LEGS_SWIM );
 			}
 			else
 			{
-				PM_ContinueLegsAnim( NSPA_SWIM );
+				PM_ContinueLegsAnim( pm, NSPA_SWIM );
 			}
 		}
 
@@ -3381,22 +3378,22 @@ static void PM_Footsteps( void )
 			{
 				if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 				{
-					PM_ContinueLegsAnim( LEGS_IDLECR );
+					PM_ContinueLegsAnim( pm, LEGS_IDLECR );
 				}
 				else
 				{
-					PM_ContinueLegsAnim( NSPA_STAND );
+					PM_ContinueLegsAnim( pm, NSPA_STAND );
 				}
 			}
 			else
 			{
 				if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 				{
-					PM_ContinueLegsAnim( LEGS_IDLE );
+					PM_ContinueLegsAnim( pm, LEGS_IDLE );
 				}
 				else
 				{
-					PM_ContinueLegsAnim( NSPA_STAND );
+					PM_ContinueLegsAnim( pm, NSPA_STAND );
 				}
 			}
 		}
@@ -3414,21 +3411,21 @@ static void PM_Footsteps( void )
 		{
 			if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 			{
-				PM_ContinueLegsAnim( LEGS_BACKCR );
+				PM_ContinueLegsAnim( pm, LEGS_BACKCR );
 			}
 			else
 			{
 				if ( pm->cmd.rightmove > 0 && !pm->cmd.forwardmove )
 				{
-					PM_ContinueLegsAnim( NSPA_WALKRIGHT );
+					PM_ContinueLegsAnim( pm, NSPA_WALKRIGHT );
 				}
 				else if ( pm->cmd.rightmove < 0 && !pm->cmd.forwardmove )
 				{
-					PM_ContinueLegsAnim( NSPA_WALKLEFT );
+					PM_ContinueLegsAnim( pm, NSPA_WALKLEFT );
 				}
 				else
 				{
-					PM_ContinueLegsAnim( NSPA_WALKBACK );
+					PM_ContinueLegsAnim( pm, NSPA_WALKBACK );
 				}
 			}
 		}
@@ -3436,21 +3433,21 @@ static void PM_Footsteps( void )
 		{
 			if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 			{
-				PM_ContinueLegsAnim( LEGS_WALKCR );
+				PM_ContinueLegsAnim( pm, LEGS_WALKCR );
 			}
 			else
 			{
 				if ( pm->cmd.rightmove > 0 && !pm->cmd.forwardmove )
 				{
-					PM_ContinueLegsAnim( NSPA_WALKRIGHT );
+					PM_ContinueLegsAnim( pm, NSPA_WALKRIGHT );
 				}
 				else if ( pm->cmd.rightmove < 0 && !pm->cmd.forwardmove )
 				{
-					PM_ContinueLegsAnim( NSPA_WALKLEFT );
+					PM_ContinueLegsAnim( pm, NSPA_WALKLEFT );
 				}
 				else
 				{
-					PM_ContinueLegsAnim( NSPA_WALK );
+					PM_ContinueLegsAnim( pm, NSPA_WALK );
 				}
 			}
 		}
@@ -3465,27 +3462,27 @@ static void PM_Footsteps( void )
 
 			if ( pm->ps->weapon == WP_ALEVEL4 && pm->ps->pm_flags & PMF_CHARGE )
 			{
-				PM_ContinueLegsAnim( NSPA_CHARGE );
+				PM_ContinueLegsAnim( pm, NSPA_CHARGE );
 			}
 			else if ( pm->ps->pm_flags & PMF_BACKWARDS_RUN )
 			{
 				if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 				{
-					PM_ContinueLegsAnim( LEGS_BACK );
+					PM_ContinueLegsAnim( pm, LEGS_BACK );
 				}
 				else
 				{
 					if ( pm->cmd.rightmove > 0 && !pm->cmd.forwardmove )
 					{
-						PM_ContinueLegsAnim( NSPA_RUNRIGHT );
+						PM_ContinueLegsAnim( pm, NSPA_RUNRIGHT );
 					}
 					else if ( pm->cmd.rightmove < 0 && !pm->cmd.forwardmove )
 					{
-						PM_ContinueLegsAnim( NSPA_RUNLEFT );
+						PM_ContinueLegsAnim( pm, NSPA_RUNLEFT );
 					}
 					else
 					{
-						PM_ContinueLegsAnim( NSPA_RUNBACK );
+						PM_ContinueLegsAnim( pm, NSPA_RUNBACK );
 					}
 				}
 			}
@@ -3493,21 +3490,21 @@ static void PM_Footsteps( void )
 			{
 				if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 				{
-					PM_ContinueLegsAnim( LEGS_RUN );
+					PM_ContinueLegsAnim( pm, LEGS_RUN );
 				}
 				else
 				{
 					if ( pm->cmd.rightmove > 0 && !pm->cmd.forwardmove )
 					{
-						PM_ContinueLegsAnim( NSPA_RUNRIGHT );
+						PM_ContinueLegsAnim( pm, NSPA_RUNRIGHT );
 					}
 					else if ( pm->cmd.rightmove < 0 && !pm->cmd.forwardmove )
 					{
-						PM_ContinueLegsAnim( NSPA_RUNLEFT );
+						PM_ContinueLegsAnim( pm, NSPA_RUNLEFT );
 					}
 					else
 					{
-						PM_ContinueLegsAnim( NSPA_RUN );
+						PM_ContinueLegsAnim( pm, NSPA_RUN );
 					}
 				}
 			}
@@ -3522,21 +3519,21 @@ static void PM_Footsteps( void )
 			{
 				if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 				{
-					PM_ContinueLegsAnim( LEGS_BACKWALK );
+					PM_ContinueLegsAnim( pm, LEGS_BACKWALK );
 				}
 				else
 				{
 					if ( pm->cmd.rightmove > 0 && !pm->cmd.forwardmove )
 					{
-						PM_ContinueLegsAnim( NSPA_WALKRIGHT );
+						PM_ContinueLegsAnim( pm, NSPA_WALKRIGHT );
 					}
 					else if ( pm->cmd.rightmove < 0 && !pm->cmd.forwardmove )
 					{
-						PM_ContinueLegsAnim( NSPA_WALKLEFT );
+						PM_ContinueLegsAnim( pm, NSPA_WALKLEFT );
 					}
 					else
 					{
-						PM_ContinueLegsAnim( NSPA_WALKBACK );
+						PM_ContinueLegsAnim( pm, NSPA_WALKBACK );
 					}
 				}
 			}
@@ -3544,21 +3541,21 @@ static void PM_Footsteps( void )
 			{
 				if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 				{
-					PM_ContinueLegsAnim( LEGS_WALK );
+					PM_ContinueLegsAnim( pm, LEGS_WALK );
 				}
 				else
 				{
 					if ( pm->cmd.rightmove > 0 && !pm->cmd.forwardmove )
 					{
-						PM_ContinueLegsAnim( NSPA_WALKRIGHT );
+						PM_ContinueLegsAnim( pm, NSPA_WALKRIGHT );
 					}
 					else if ( pm->cmd.rightmove < 0 && !pm->cmd.forwardmove )
 					{
-						PM_ContinueLegsAnim( NSPA_WALKLEFT );
+						PM_ContinueLegsAnim( pm, NSPA_WALKLEFT );
 					}
 					else
 					{
-						PM_ContinueLegsAnim( NSPA_WALK );
+						PM_ContinueLegsAnim( pm, NSPA_WALK );
 					}
 				}
 			}
@@ -3574,7 +3571,7 @@ static void PM_Footsteps( void )
 
 	// check for footstep / splash sounds
 	old = pm->ps->bobCycle;
-	pm->ps->bobCycle = ( int )( old + bobmove * pml.msec ) & 255;
+	pm->ps->bobCycle = ( int )( old + bobmove * pml->msec ) & 255;
 
 	// if we just crossed a cycle boundary, play an appropriate footstep event
 	if ( ( ( old + 64 ) ^ ( pm->ps->bobCycle + 64 ) ) & 128 )
@@ -3584,18 +3581,18 @@ static void PM_Footsteps( void )
 			// on ground will only play sounds if running
 			if ( footstep && !pm->noFootsteps )
 			{
-				PM_AddEvent( PM_FootstepForSurface() );
+				PM_AddEvent( pm, PM_FootstepForSurface( pm, pml ) );
 			}
 		}
 		else if ( pm->waterlevel == 1 )
 		{
 			// splashing
-			PM_AddEvent( EV_FOOTSPLASH );
+			PM_AddEvent( pm, EV_FOOTSPLASH );
 		}
 		else if ( pm->waterlevel == 2 )
 		{
 			// wading / swimming at surface
-			PM_AddEvent( EV_SWIM );
+			PM_AddEvent( pm, EV_SWIM );
 		}
 		else if ( pm->waterlevel == 3 )
 		{
@@ -3611,39 +3608,39 @@ PM_WaterEvents
 Generate sound events for entering and leaving water
 ==============
 */
-static void PM_WaterEvents( void )
+static void PM_WaterEvents( pmove_t *pm, pml_t *pml )
 {
 	// FIXME?
 	//
 	// if just entered a water volume, play a sound
 	//
-	if ( !pml.previous_waterlevel && pm->waterlevel )
+	if ( !pml->previous_waterlevel && pm->waterlevel )
 	{
-		PM_AddEvent( EV_WATER_TOUCH );
+		PM_AddEvent( pm, EV_WATER_TOUCH );
 	}
 
 	//
 	// if just completely exited a water volume, play a sound
 	//
-	if ( pml.previous_waterlevel && !pm->waterlevel )
+	if ( pml->previous_waterlevel && !pm->waterlevel )
 	{
-		PM_AddEvent( EV_WATER_LEAVE );
+		PM_AddEvent( pm, EV_WATER_LEAVE );
 	}
 
 	//
 	// check for head just going under water
 	//
-	if ( pml.previous_waterlevel != 3 && pm->waterlevel == 3 )
+	if ( pml->previous_waterlevel != 3 && pm->waterlevel == 3 )
 	{
-		PM_AddEvent( EV_WATER_UNDER );
+		PM_AddEvent( pm, EV_WATER_UNDER );
 	}
 
 	//
 	// check for head just coming out of water
 	//
-	if ( pml.previous_waterlevel == 3 && pm->waterlevel != 3 )
+	if ( pml->previous_waterlevel == 3 && pm->waterlevel != 3 )
 	{
-		PM_AddEvent( EV_WATER_CLEAR );
+		PM_AddEvent( pm, EV_WATER_CLEAR );
 	}
 }
 
@@ -3652,7 +3649,7 @@ static void PM_WaterEvents( void )
 PM_BeginWeaponChange
 ===============
 */
-static void PM_BeginWeaponChange( int weapon )
+static void PM_BeginWeaponChange( pmove_t *pm, int weapon )
 {
 	if ( weapon <= WP_NONE || weapon >= WP_NUM_WEAPONS )
 	{
@@ -3695,8 +3692,8 @@ static void PM_BeginWeaponChange( int weapon )
 
 	if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 	{
-		PM_StartTorsoAnim( TORSO_DROP );
-		PM_StartWeaponAnim( WANIM_DROP );
+		PM_StartTorsoAnim( pm, TORSO_DROP );
+		PM_StartWeaponAnim( pm, WANIM_DROP );
 	}
 }
 
@@ -3705,11 +3702,11 @@ static void PM_BeginWeaponChange( int weapon )
 PM_FinishWeaponChange
 ===============
 */
-static void PM_FinishWeaponChange( void )
+static void PM_FinishWeaponChange( pmove_t *pm )
 {
 	int weapon;
 
-	PM_AddEvent( EV_CHANGE_WEAPON );
+	PM_AddEvent( pm, EV_CHANGE_WEAPON );
 	weapon = pm->ps->persistant[ PERS_NEWWEAPON ];
 
 	if ( weapon < WP_NONE || weapon >= WP_NUM_WEAPONS )
@@ -3728,8 +3725,8 @@ static void PM_FinishWeaponChange( void )
 
 	if ( !( pm->ps->persistant[ PERS_STATE ] & PS_NONSEGMODEL ) )
 	{
-		PM_StartTorsoAnim( TORSO_RAISE );
-		PM_StartWeaponAnim( WANIM_RAISE );
+		PM_StartTorsoAnim( pm, TORSO_RAISE );
+		PM_StartWeaponAnim( pm, WANIM_RAISE );
 	}
 }
 
@@ -3739,7 +3736,7 @@ PM_TorsoAnimation
 
 ==============
 */
-static void PM_TorsoAnimation( void )
+static void PM_TorsoAnimation( pmove_t *pm )
 {
 	if ( pm->ps->weaponstate == WEAPON_READY )
 	{
@@ -3747,15 +3744,15 @@ static void PM_TorsoAnimation( void )
 		{
 			if ( pm->ps->weapon == WP_BLASTER )
 			{
-				PM_ContinueTorsoAnim( TORSO_STAND_BLASTER );
+				PM_ContinueTorsoAnim( pm, TORSO_STAND_BLASTER );
 			}
 			else
 			{
-				PM_ContinueTorsoAnim( TORSO_STAND );
+				PM_ContinueTorsoAnim( pm, TORSO_STAND );
 			}
 		}
 
-		PM_ContinueWeaponAnim( WANIM_IDLE );
+		PM_ContinueWeaponAnim( pm, WANIM_IDLE );
 	}
 }
 
@@ -3766,7 +3763,7 @@ PM_Weapon
 Generates weapon events and modifies the weapon counter
 ==============
 */
-static void PM_Weapon( void )
+static void PM_Weapon( pmove_t *pm, pml_t *pml )
 {
 	int      addTime = 200; //default addTime - should never be used
 	qboolean attack1 = usercmdButtonPressed( pm->cmd.buttons, BUTTON_ATTACK );
@@ -3789,7 +3786,7 @@ static void PM_Weapon( void )
 	// Pounce cooldown (Mantis)
 	if ( pm->ps->weapon == WP_ALEVEL1 )
 	{
-		pm->ps->stats[ STAT_MISC ] -= pml.msec;
+		pm->ps->stats[ STAT_MISC ] -= pml->msec;
 
 		if ( pm->ps->stats[ STAT_MISC ] < 0 )
 		{
@@ -3806,11 +3803,11 @@ static void PM_Weapon( void )
 
 		if ( usercmdButtonPressed( pm->cmd.buttons, BUTTON_ATTACK2 ) )
 		{
-			pm->ps->stats[ STAT_MISC ] += pml.msec;
+			pm->ps->stats[ STAT_MISC ] += pml->msec;
 		}
 		else
 		{
-			pm->ps->stats[ STAT_MISC ] -= pml.msec;
+			pm->ps->stats[ STAT_MISC ] -= pml->msec;
 		}
 
 		if ( pm->ps->stats[ STAT_MISC ] > max )
@@ -3837,7 +3834,7 @@ static void PM_Weapon( void )
 
 				if ( pm->cmd.forwardmove > 0 )
 				{
-					int    charge = pml.msec;
+					int    charge = pml->msec;
 					vec3_t dir, vel;
 
 					AngleVectors( pm->ps->viewangles, dir, NULL, NULL );
@@ -3871,11 +3868,11 @@ static void PM_Weapon( void )
 					                             LEVEL4_TRAMPLE_DURATION /
 					                             LEVEL4_TRAMPLE_CHARGE_MAX;
 					pm->ps->stats[ STAT_STATE ] |= SS_CHARGING;
-					PM_AddEvent( EV_LEV4_TRAMPLE_START );
+					PM_AddEvent( pm, EV_LEV4_TRAMPLE_START );
 				}
 				else
 				{
-					pm->ps->stats[ STAT_MISC ] -= pml.msec;
+					pm->ps->stats[ STAT_MISC ] -= pml->msec;
 				}
 			}
 		}
@@ -3889,13 +3886,13 @@ static void PM_Weapon( void )
 			}
 			else
 			{
-				pm->ps->stats[ STAT_MISC ] -= pml.msec;
+				pm->ps->stats[ STAT_MISC ] -= pml->msec;
 			}
 
 			// If the charger has stopped moving take a chunk of charge away
 			if ( VectorLength( pm->ps->velocity ) < 64.0f || pm->cmd.rightmove )
 			{
-				pm->ps->stats[ STAT_MISC ] -= LEVEL4_TRAMPLE_STOP_PENALTY * pml.msec;
+				pm->ps->stats[ STAT_MISC ] -= LEVEL4_TRAMPLE_STOP_PENALTY * pml->msec;
 			}
 		}
 
@@ -3916,7 +3913,7 @@ static void PM_Weapon( void )
 		if ( !pm->ps->weaponTime && pm->ps->weaponstate != WEAPON_NEEDS_RESET &&
 		     usercmdButtonPressed( pm->cmd.buttons, BUTTON_ATTACK ) )
 		{
-			pm->ps->stats[ STAT_MISC ] += pml.msec;
+			pm->ps->stats[ STAT_MISC ] += pml->msec;
 
 			if ( pm->ps->stats[ STAT_MISC ] >= LCANNON_CHARGE_TIME_MAX )
 			{
@@ -3955,7 +3952,7 @@ static void PM_Weapon( void )
 	// pump weapon delays (repeat times etc)
 	if ( pm->ps->weaponTime > 0 )
 	{
-		pm->ps->weaponTime -= pml.msec;
+		pm->ps->weaponTime -= pml->msec;
 	}
 
 	if ( pm->ps->weaponTime < 0 )
@@ -3984,7 +3981,7 @@ static void PM_Weapon( void )
 					//if trying to select a weapon, select it
 					if ( pm->ps->weapon != pm->cmd.weapon )
 					{
-						PM_BeginWeaponChange( pm->cmd.weapon );
+						PM_BeginWeaponChange( pm, pm->cmd.weapon );
 					}
 				}
 				else
@@ -4019,12 +4016,12 @@ static void PM_Weapon( void )
 			if ( pm->ps->weapon != WP_NONE )
 			{
 				// drop the current weapon
-				PM_BeginWeaponChange( pm->ps->persistant[ PERS_NEWWEAPON ] );
+				PM_BeginWeaponChange( pm, pm->ps->persistant[ PERS_NEWWEAPON ] );
 			}
 			else
 			{
 				// no current weapon, so just raise the new one
-				PM_FinishWeaponChange();
+				PM_FinishWeaponChange( pm );
 			}
 		}
 	}
@@ -4037,7 +4034,7 @@ static void PM_Weapon( void )
 	// change weapon if time
 	if ( pm->ps->weaponstate == WEAPON_DROPPING )
 	{
-		PM_FinishWeaponChange();
+		PM_FinishWeaponChange( pm );
 		return;
 	}
 
@@ -4050,15 +4047,15 @@ static void PM_Weapon( void )
 		{
 			if ( pm->ps->weapon == WP_BLASTER )
 			{
-				PM_ContinueTorsoAnim( TORSO_STAND_BLASTER );
+				PM_ContinueTorsoAnim( pm, TORSO_STAND_BLASTER );
 			}
 			else
 			{
-				PM_ContinueTorsoAnim( TORSO_STAND );
+				PM_ContinueTorsoAnim( pm, TORSO_STAND );
 			}
 		}
 
-		PM_ContinueWeaponAnim( WANIM_IDLE );
+		PM_ContinueWeaponAnim( pm, WANIM_IDLE );
 
 		return;
 	}
@@ -4070,7 +4067,7 @@ static void PM_Weapon( void )
 		     ( BG_Weapon( pm->ps->weapon )->hasAltMode && attack2 ) ||
 		     ( BG_Weapon( pm->ps->weapon )->hasThirdMode && attack3 ) )
 		{
-			PM_AddEvent( EV_NOAMMO );
+			PM_AddEvent( pm, EV_NOAMMO );
 			pm->ps->weaponTime += 500;
 		}
 
@@ -4090,7 +4087,7 @@ static void PM_Weapon( void )
 
 		//allow some time for the weapon to be raised
 		pm->ps->weaponstate = WEAPON_RAISING;
-		PM_StartTorsoAnim( TORSO_RAISE );
+		PM_StartTorsoAnim( pm, TORSO_RAISE );
 		pm->ps->weaponTime += 250;
 		return;
 	}
@@ -4104,8 +4101,8 @@ static void PM_Weapon( void )
 		pm->ps->weaponstate = WEAPON_RELOADING;
 
 		//drop the weapon
-		PM_StartTorsoAnim( TORSO_DROP );
-		PM_StartWeaponAnim( WANIM_RELOAD );
+		PM_StartTorsoAnim( pm, TORSO_DROP );
+		PM_StartWeaponAnim( pm, WANIM_RELOAD );
 		BG_AddPredictableEventToPlayerstate( EV_WEAPON_RELOAD, pm->ps->weapon, pm->ps );
 
 		pm->ps->weaponTime += BG_Weapon( pm->ps->weapon )->reloadTime;
@@ -4227,7 +4224,7 @@ static void PM_Weapon( void )
 			}
 
 			pm->ps->generic1 = WPM_TERTIARY;
-			PM_AddEvent( EV_FIRE_WEAPON3 );
+			PM_AddEvent( pm, EV_FIRE_WEAPON3 );
 			addTime = BG_Weapon( pm->ps->weapon )->repeatRate3;
 		}
 		else
@@ -4243,7 +4240,7 @@ static void PM_Weapon( void )
 		if ( BG_Weapon( pm->ps->weapon )->hasAltMode )
 		{
 			pm->ps->generic1 = WPM_SECONDARY;
-			PM_AddEvent( EV_FIRE_WEAPON2 );
+			PM_AddEvent( pm, EV_FIRE_WEAPON2 );
 			addTime = BG_Weapon( pm->ps->weapon )->repeatRate2;
 		}
 		else
@@ -4257,7 +4254,7 @@ static void PM_Weapon( void )
 	else if ( attack1 )
 	{
 		pm->ps->generic1 = WPM_PRIMARY;
-		PM_AddEvent( EV_FIRE_WEAPON );
+		PM_AddEvent( pm, EV_FIRE_WEAPON );
 		addTime = BG_Weapon( pm->ps->weapon )->repeatRate1;
 	}
 
@@ -4268,14 +4265,14 @@ static void PM_Weapon( void )
 		{
 			case WP_ALEVEL0:
 				pm->ps->generic1 = WPM_PRIMARY;
-				PM_AddEvent( EV_FIRE_WEAPON );
+				PM_AddEvent( pm, EV_FIRE_WEAPON );
 				addTime = BG_Weapon( pm->ps->weapon )->repeatRate1;
 				break;
 
 			case WP_ALEVEL3:
 			case WP_ALEVEL3_UPG:
 				pm->ps->generic1 = WPM_SECONDARY;
-				PM_AddEvent( EV_FIRE_WEAPON2 );
+				PM_AddEvent( pm, EV_FIRE_WEAPON2 );
 				addTime = BG_Weapon( pm->ps->weapon )->repeatRate2;
 				break;
 
@@ -4292,33 +4289,33 @@ static void PM_Weapon( void )
 			case WP_FLAMER:
 				if ( pm->ps->weaponstate == WEAPON_READY )
 				{
-					PM_StartTorsoAnim( TORSO_ATTACK );
-					PM_StartWeaponAnim( WANIM_ATTACK1 );
+					PM_StartTorsoAnim( pm, TORSO_ATTACK );
+					PM_StartWeaponAnim( pm, WANIM_ATTACK1 );
 				}
 
 				break;
 
 			case WP_BLASTER:
-				PM_StartTorsoAnim( TORSO_ATTACK_BLASTER );
-				PM_StartWeaponAnim( WANIM_ATTACK1 );
+				PM_StartTorsoAnim( pm, TORSO_ATTACK_BLASTER );
+				PM_StartWeaponAnim( pm, WANIM_ATTACK1 );
 				break;
 
 			case WP_PAIN_SAW:
-				PM_StartTorsoAnim( TORSO_ATTACK_PSAW );
-				PM_StartWeaponAnim( WANIM_ATTACK1 );
+				PM_StartTorsoAnim( pm, TORSO_ATTACK_PSAW );
+				PM_StartWeaponAnim( pm, WANIM_ATTACK1 );
 				break;
 
 			default:
 				if ( attack1 )
 				{
-					PM_StartTorsoAnim( TORSO_ATTACK );
-					PM_StartWeaponAnim( WANIM_ATTACK1 );
+					PM_StartTorsoAnim( pm, TORSO_ATTACK );
+					PM_StartWeaponAnim( pm, WANIM_ATTACK1 );
 					break;
 				}
 				else if ( attack2 )
 				{
-					PM_StartTorsoAnim( TORSO_ATTACK );
-					PM_StartWeaponAnim( WANIM_ATTACK2 );
+					PM_StartTorsoAnim( pm, TORSO_ATTACK );
+					PM_StartWeaponAnim( pm, WANIM_ATTACK2 );
 					break;
 				}
 		}
@@ -4335,8 +4332,8 @@ static void PM_Weapon( void )
 				if ( attack1 )
 				{
 					num /= RAND_MAX / 6 + 1;
-					PM_ForceLegsAnim( NSPA_ATTACK1 );
-					PM_StartWeaponAnim( WANIM_ATTACK1 + num );
+					PM_ForceLegsAnim( pm, NSPA_ATTACK1 );
+					PM_StartWeaponAnim( pm, WANIM_ATTACK1 + num );
 				}
 
 				break;
@@ -4344,43 +4341,43 @@ static void PM_Weapon( void )
 			case WP_ALEVEL2_UPG:
 				if ( attack2 )
 				{
-					PM_ForceLegsAnim( NSPA_ATTACK2 );
-					PM_StartWeaponAnim( WANIM_ATTACK7 );
+					PM_ForceLegsAnim( pm, NSPA_ATTACK2 );
+					PM_StartWeaponAnim( pm, WANIM_ATTACK7 );
 				}
 
 			case WP_ALEVEL2:
 				if ( attack1 )
 				{
 					num /= RAND_MAX / 3 + 1;
-					PM_ForceLegsAnim( NSPA_ATTACK1 + num );
+					PM_ForceLegsAnim( pm, NSPA_ATTACK1 + num );
 					num = rand() / ( RAND_MAX / 6 + 1 );
-					PM_StartWeaponAnim( WANIM_ATTACK1 + num );
+					PM_StartWeaponAnim( pm, WANIM_ATTACK1 + num );
 				}
 
 				break;
 
 			case WP_ALEVEL4:
 				num /= RAND_MAX / 3 + 1;
-				PM_ForceLegsAnim( NSPA_ATTACK1 + num );
+				PM_ForceLegsAnim( pm, NSPA_ATTACK1 + num );
 				num = rand() / ( RAND_MAX / 6 + 1 );
-				PM_StartWeaponAnim( WANIM_ATTACK1 + num );
+				PM_StartWeaponAnim( pm, WANIM_ATTACK1 + num );
 				break;
 
 			default:
 				if ( attack1 )
 				{
-					PM_ForceLegsAnim( NSPA_ATTACK1 );
-					PM_StartWeaponAnim( WANIM_ATTACK1 );
+					PM_ForceLegsAnim( pm, NSPA_ATTACK1 );
+					PM_StartWeaponAnim( pm, WANIM_ATTACK1 );
 				}
 				else if ( attack2 )
 				{
-					PM_ForceLegsAnim( NSPA_ATTACK2 );
-					PM_StartWeaponAnim( WANIM_ATTACK2 );
+					PM_ForceLegsAnim( pm, NSPA_ATTACK2 );
+					PM_StartWeaponAnim( pm, WANIM_ATTACK2 );
 				}
 				else if ( attack3 )
 				{
-					PM_ForceLegsAnim( NSPA_ATTACK3 );
-					PM_StartWeaponAnim( WANIM_ATTACK3 );
+					PM_ForceLegsAnim( pm, NSPA_ATTACK3 );
+					PM_StartWeaponAnim( pm, WANIM_ATTACK3 );
 				}
 
 				break;
@@ -4440,7 +4437,7 @@ static void PM_Weapon( void )
 PM_Animate
 ================
 */
-static void PM_Animate( void )
+static void PM_Animate( pmove_t *pm )
 {
 	if ( PM_Paralyzed( pm->ps->pm_type ) )
 	{
@@ -4458,24 +4455,24 @@ static void PM_Animate( void )
 		{
 			if ( pm->ps->torsoTimer == 0 )
 			{
-				PM_StartTorsoAnim( TORSO_GESTURE_BLASTER + ( pm->ps->weapon - WP_BLASTER ) > WP_LUCIFER_CANNON ?
+				PM_StartTorsoAnim( pm, TORSO_GESTURE_BLASTER + ( pm->ps->weapon - WP_BLASTER ) > WP_LUCIFER_CANNON ?
 				    TORSO_GESTURE_CKIT :
 				    TORSO_GESTURE_BLASTER + ( pm->ps->weapon - WP_BLASTER ) );
 				pm->ps->torsoTimer = TIMER_GESTURE;
 				pm->ps->tauntTimer = TIMER_GESTURE;
 
-				PM_AddEvent( EV_TAUNT );
+				PM_AddEvent( pm, EV_TAUNT );
 			}
 		}
 		else
 		{
 			if ( pm->ps->torsoTimer == 0 )
 			{
-				PM_ForceLegsAnim( NSPA_GESTURE );
+				PM_ForceLegsAnim( pm, NSPA_GESTURE );
 				pm->ps->torsoTimer = TIMER_GESTURE;
 				pm->ps->tauntTimer = TIMER_GESTURE;
 
-				PM_AddEvent( EV_TAUNT );
+				PM_AddEvent( pm, EV_TAUNT );
 			}
 		}
 	}
@@ -4491,22 +4488,22 @@ static void PM_Animate( void )
 		{
 			if ( pm->ps->torsoTimer == 0 )
 			{
-				PM_StartTorsoAnim( TORSO_RALLY );
+				PM_StartTorsoAnim( pm, TORSO_RALLY );
 				pm->ps->torsoTimer = TIMER_GESTURE;
 				pm->ps->tauntTimer = TIMER_GESTURE;
 
-				PM_AddEvent( EV_TAUNT );
+				PM_AddEvent( pm, EV_TAUNT );
 			}
 		}
 		else
 		{
 			if ( pm->ps->torsoTimer == 0 )
 			{
-				PM_ForceLegsAnim( NSPA_GESTURE );
+				PM_ForceLegsAnim( pm, NSPA_GESTURE );
 				pm->ps->torsoTimer = TIMER_GESTURE;
 				pm->ps->tauntTimer = TIMER_GESTURE;
 
-				PM_AddEvent( EV_TAUNT );
+				PM_AddEvent( pm, EV_TAUNT );
 			}
 		}
 	}
@@ -4518,26 +4515,26 @@ static void PM_Animate( void )
 PM_DropTimers
 ================
 */
-static void PM_DropTimers( void )
+static void PM_DropTimers( pmove_t *pm, pml_t *pml )
 {
 	// drop misc timing counter
 	if ( pm->ps->pm_time )
 	{
-		if ( pml.msec >= pm->ps->pm_time )
+		if ( pml->msec >= pm->ps->pm_time )
 		{
 			pm->ps->pm_flags &= ~PMF_ALL_TIMES;
 			pm->ps->pm_time = 0;
 		}
 		else
 		{
-			pm->ps->pm_time -= pml.msec;
+			pm->ps->pm_time -= pml->msec;
 		}
 	}
 
 	// drop animation counter
 	if ( pm->ps->legsTimer > 0 )
 	{
-		pm->ps->legsTimer -= pml.msec;
+		pm->ps->legsTimer -= pml->msec;
 
 		if ( pm->ps->legsTimer < 0 )
 		{
@@ -4547,7 +4544,7 @@ static void PM_DropTimers( void )
 
 	if ( pm->ps->torsoTimer > 0 )
 	{
-		pm->ps->torsoTimer -= pml.msec;
+		pm->ps->torsoTimer -= pml->msec;
 
 		if ( pm->ps->torsoTimer < 0 )
 		{
@@ -4557,7 +4554,7 @@ static void PM_DropTimers( void )
 
 	if ( pm->ps->tauntTimer > 0 )
 	{
-		pm->ps->tauntTimer -= pml.msec;
+		pm->ps->tauntTimer -= pml->msec;
 
 		if ( pm->ps->tauntTimer < 0 )
 		{
@@ -4690,7 +4687,7 @@ void PM_UpdateViewAngles( playerState_t *ps, const usercmd_t *cmd )
 	}
 }
 
-static void PM_HumanStaminaEffects( void )
+static void PM_HumanStaminaEffects( pmove_t *pm, pml_t *pml )
 {
 	const classAttributes_t *ca;
 	int      *stats;
@@ -4710,29 +4707,29 @@ static void PM_HumanStaminaEffects( void )
 	// Use/Restore stamina
 	if ( stats[ STAT_STATE2 ] & SS2_JETPACK_WARM )
 	{
-		stats[ STAT_STAMINA ] += ( int )( pml.msec * ca->staminaJogRestore * 0.001f );
+		stats[ STAT_STAMINA ] += ( int )( pml->msec * ca->staminaJogRestore * 0.001f );
 	}
 	else if ( stopped )
 	{
-		stats[ STAT_STAMINA ] += ( int )( pml.msec * ca->staminaStopRestore * 0.001f );
+		stats[ STAT_STAMINA ] += ( int )( pml->msec * ca->staminaStopRestore * 0.001f );
 	}
 	else if ( ( stats[ STAT_STATE ] & SS_SPEEDBOOST ) && !walking && !crouching ) // walk/crouch overrides sprint
 	{
-		stats[ STAT_STAMINA ] -= ( int )( pml.msec * ca->staminaSprintCost * 0.001f );
+		stats[ STAT_STAMINA ] -= ( int )( pml->msec * ca->staminaSprintCost * 0.001f );
 	}
 	else if ( walking || crouching )
 	{
-		stats[ STAT_STAMINA ] += ( int )( pml.msec * ca->staminaWalkRestore * 0.001f );
+		stats[ STAT_STAMINA ] += ( int )( pml->msec * ca->staminaWalkRestore * 0.001f );
 	}
 	else // assume jogging
 	{
-		stats[ STAT_STAMINA ] += ( int )( pml.msec * ca->staminaJogRestore * 0.001f );
+		stats[ STAT_STAMINA ] += ( int )( pml->msec * ca->staminaJogRestore * 0.001f );
 	}
 
 	// Remove stamina based on status effects
 	if ( stats[ STAT_STATE2 ] & SS2_LEVEL1SLOW )
 	{
-		stats[ STAT_STAMINA ] -= pml.msec * STAMINA_LEVEL1SLOW_TAKE;
+		stats[ STAT_STAMINA ] -= pml->msec * STAMINA_LEVEL1SLOW_TAKE;
 	}
 
 	// Check stamina limits
@@ -4752,9 +4749,10 @@ PmoveSingle
 
 ================
 */
-void PmoveSingle( pmove_t *pmove )
+void PmoveSingle( pmove_t *pm )
 {
-	pm = pmove;
+	pml_t locals;
+	pml_t *pml = &locals;
 
 	// this counter lets us debug movement problems with a journal
 	// by setting a conditional breakpoint for the previous frame
@@ -4823,45 +4821,45 @@ void PmoveSingle( pmove_t *pmove )
 	// if talk button is down, dissallow all other input
 	// this is to prevent any possible intercept proxy from
 	// adding fake talk balloons
-	if ( usercmdButtonPressed( pmove->cmd.buttons, BUTTON_TALK ) )
+	if ( usercmdButtonPressed( pm->cmd.buttons, BUTTON_TALK ) )
 	{
-		usercmdClearButtons( pmove->cmd.buttons );
-		usercmdPressButton( pmove->cmd.buttons, BUTTON_TALK );
-		pmove->cmd.forwardmove = 0;
-		pmove->cmd.rightmove = 0;
+		usercmdClearButtons( pm->cmd.buttons );
+		usercmdPressButton( pm->cmd.buttons, BUTTON_TALK );
+		pm->cmd.forwardmove = 0;
+		pm->cmd.rightmove = 0;
 
-		if ( pmove->cmd.upmove > 0 )
+		if ( pm->cmd.upmove > 0 )
 		{
-			pmove->cmd.upmove = 0;
+			pm->cmd.upmove = 0;
 		}
 	}
 
 	// clear all pmove local vars
-	memset( &pml, 0, sizeof( pml ) );
+	memset( pml, 0, sizeof( *pml ) );
 
 	// determine the time
-	pml.msec = pmove->cmd.serverTime - pm->ps->commandTime;
+	pml->msec = pm->cmd.serverTime - pm->ps->commandTime;
 
-	if ( pml.msec < 1 )
+	if ( pml->msec < 1 )
 	{
-		pml.msec = 1;
+		pml->msec = 1;
 	}
-	else if ( pml.msec > 200 )
+	else if ( pml->msec > 200 )
 	{
-		pml.msec = 200;
+		pml->msec = 200;
 	}
 
-	pm->ps->commandTime = pmove->cmd.serverTime;
+	pm->ps->commandTime = pm->cmd.serverTime;
 
 	// save old org in case we get stuck
-	VectorCopy( pm->ps->origin, pml.previous_origin );
+	VectorCopy( pm->ps->origin, pml->previous_origin );
 
 	// save old velocity for crashlanding
-	VectorCopy( pm->ps->velocity, pml.previous_velocity );
+	VectorCopy( pm->ps->velocity, pml->previous_velocity );
 
-	pml.frametime = pml.msec * 0.001;
+	pml->frametime = pml->msec * 0.001;
 
-	AngleVectors( pm->ps->viewangles, pml.forward, pml.right, pml.up );
+	AngleVectors( pm->ps->viewangles, pml->forward, pml->right, pml->up );
 
 	if ( pm->cmd.upmove < 10 )
 	{
@@ -4890,19 +4888,19 @@ void PmoveSingle( pmove_t *pmove )
 	{
 		// update the viewangles
 		PM_UpdateViewAngles( pm->ps, &pm->cmd );
-		PM_CheckDuck();
-		PM_FlyMove();
-		PM_DropTimers();
+		PM_CheckDuck( pm );
+		PM_FlyMove( pm, pml );
+		PM_DropTimers( pm, pml );
 		return;
 	}
 
 	if ( pm->ps->pm_type == PM_NOCLIP )
 	{
 		PM_UpdateViewAngles( pm->ps, &pm->cmd );
-		PM_NoclipMove();
-		PM_SetViewheight();
-		PM_Weapon();
-		PM_DropTimers();
+		PM_NoclipMove( pm, pml );
+		PM_SetViewheight( pm );
+		PM_Weapon( pm, pml );
+		PM_DropTimers( pm, pml );
 		return;
 	}
 
@@ -4917,85 +4915,85 @@ void PmoveSingle( pmove_t *pmove )
 	}
 
 	// set watertype, and waterlevel
-	PM_SetWaterLevel();
-	pml.previous_waterlevel = pmove->waterlevel;
+	PM_SetWaterLevel( pm );
+	pml->previous_waterlevel = pm->waterlevel;
 
 	// set mins, maxs, and viewheight
-	PM_CheckDuck();
+	PM_CheckDuck( pm );
 
-	PM_CheckLadder();
+	PM_CheckLadder( pm, pml );
 
 	// set groundentity
-	PM_GroundTrace();
+	PM_GroundTrace( pm, pml );
 
 	// update the viewangles
 	PM_UpdateViewAngles( pm->ps, &pm->cmd );
 
 	if ( pm->ps->pm_type == PM_DEAD || pm->ps->pm_type == PM_GRABBED )
 	{
-		PM_DeadMove();
+		PM_DeadMove( pm, pml );
 	}
 
-	PM_DropTimers();
+	PM_DropTimers( pm, pml );
 
 	if ( pm->ps->pm_flags & PMF_TIME_WATERJUMP )
 	{
-		PM_WaterJumpMove();
+		PM_WaterJumpMove( pm, pml );
 	}
 	else if ( pm->waterlevel > 1 )
 	{
-		PM_WaterMove();
+		PM_WaterMove( pm, pml );
 	}
-	else if ( pml.ladder )
+	else if ( pml->ladder )
 	{
-		PM_LadderMove();
+		PM_LadderMove( pm, pml );
 	}
-	else if ( pml.walking )
+	else if ( pml->walking )
 	{
 		if ( BG_ClassHasAbility( pm->ps->stats[ STAT_CLASS ], SCA_WALLCLIMBER ) &&
 		     ( pm->ps->stats[ STAT_STATE ] & SS_WALLCLIMBING ) )
 		{
-			PM_ClimbMove(); // walking on any surface
+			PM_ClimbMove( pm, pml ); // walking on any surface
 		}
 		else
 		{
-			PM_WalkMove(); // walking on ground
+			PM_WalkMove( pm, pml ); // walking on ground
 		}
 	}
 	else
 	{
-		PM_AirMove();
+		PM_AirMove( pm, pml );
 	}
 
 	// restore jetpack fuel if possible
-	PM_CheckJetpackRestoreFuel();
+	PM_CheckJetpackRestoreFuel( pm, pml );
 
 	// restore or remove stamina
-	PM_HumanStaminaEffects();
+	PM_HumanStaminaEffects( pm, pml );
 
-	PM_Animate();
+	PM_Animate( pm );
 
 	// set groundentity, watertype, and waterlevel
-	PM_GroundTrace();
+	PM_GroundTrace( pm, pml );
 
 	// update the viewangles
 	PM_UpdateViewAngles( pm->ps, &pm->cmd );
 
-	PM_SetWaterLevel();
+	PM_SetWaterLevel( pm );
 
 	// weapons
-	PM_Weapon();
+	PM_Weapon( pm, pml );
 
 	// torso animation
-	PM_TorsoAnimation();
+	PM_TorsoAnimation( pm );
 
 	// footstep events / legs animations
-	PM_Footsteps();
+	PM_Footsteps( pm, pml );
 
 	// entering / leaving water splashes
-	PM_WaterEvents();
+	PM_WaterEvents( pm, pml );
 
-	if ( !pmove->pmove_accurate )
+	if ( !pm->pmove_accurate )
 	{
 		// snap some parts of playerstate to save network bandwidth
 		SnapVector( pm->ps->velocity );
@@ -5006,7 +5004,9 @@ void PmoveSingle( pmove_t *pmove )
 ================
 Pmove
 
-Can be called by either the server or the client
+Can be called by either the server or the client, and for several players
+at once as long as their traces are reentrant: all the state lives in
+pmove and in the locals of PmoveSingle (c_pmove is only a debug counter)
 ================
 */
 void Pmove( pmove_t *pmove )
@@ -43,7 +43,7 @@ Returns qtrue if the velocity was clipped in some way
 ==================
 */
 #define MAX_CLIP_PLANES 5
-qboolean  PM_SlideMove( qboolean gravity )
+qboolean  PM_SlideMove( pmove_t *pm, pml_t *pml, qboolean gravity )
 {
 	int     bumpcount, numbumps;
 	vec3_t  dir;
@@ -67,24 +67,24 @@ qboolean  PM_SlideMove( qboolean gravity )
 
 	if ( gravity )
 	{
-		endVelocity[ 2 ] -= pm->ps->gravity * pml.frametime;
+		endVelocity[ 2 ] -= pm->ps->gravity * pml->frametime;
 		pm->ps->velocity[ 2 ] = ( pm->ps->velocity[ 2 ] + endVelocity[ 2 ] ) * 0.5;
 		primal_velocity[ 2 ] = endVelocity[ 2 ];
 
-		if ( pml.groundPlane )
+		if ( pml->groundPlane )
 		{
 			// slide along the ground plane
-			PM_ClipVelocity( pm->ps->velocity, pml.groundTrace.plane.normal, pm->ps->velocity );
+			PM_ClipVelocity( pm->ps->velocity, pml->groundTrace.plane.normal, pm->ps->velocity );
 		}
 	}
 
-	time_left = pml.frametime;
+	time_left = pml->frametime;
 
 	// never turn against the ground plane
-	if ( pml.groundPlane )
+	if ( pml->groundPlane )
 	{
 		numplanes = 1;
-		VectorCopy( pml.groundTrace.plane.normal, planes[ 0 ] );
+		VectorCopy( pml->groundTrace.plane.normal, planes[ 0 ] );
 	}
 	else
 	{
@@ -122,7 +122,7 @@ qboolean  PM_SlideMove( qboolean gravity )
 		}
 
 		// save entity for contact
-		PM_AddTouchEnt( trace.entityNum );
+		PM_AddTouchEnt( pm, trace.entityNum );
 
 		time_left -= time_left * trace.fraction;
 
@@ -170,9 +170,9 @@ qboolean  PM_SlideMove( qboolean gravity )
 			}
 
 			// see how hard we are hitting things
-			if ( -into > pml.impactSpeed )
+			if ( -into > pml->impactSpeed )
 			{
-				pml.impactSpeed = -into;
+				pml->impactSpeed = -into;
 			}
 
 			// slide along the plane
@@ -260,7 +260,7 @@ qboolean  PM_SlideMove( qboolean gravity )
 PM_StepEvent
 ==================
 */
-void PM_StepEvent( const vec3_t from, const vec3_t to, const vec3_t normal )
+void PM_StepEvent( pmove_t *pm, const vec3_t from, const vec3_t to, const vec3_t normal )
 {
 	float  size;
 	vec3_t delta, dNormal;
@@ -277,19 +277,19 @@ void PM_StepEvent( const vec3_t from, const vec3_t to, const vec3_t normal )
 		{
 			if ( size < 7.0f )
 			{
-				PM_AddEvent( EV_STEPDN_4 );
+				PM_AddEvent( pm, EV_STEPDN_4 );
 			}
 			else if ( size < 11.0f )
 			{
-				PM_AddEvent( EV_STEPDN_8 );
+				PM_AddEvent( pm, EV_STEPDN_8 );
 			}
 			else if ( size < 15.0f )
 			{
-				PM_AddEvent( EV_STEPDN_12 );
+				PM_AddEvent( pm, EV_STEPDN_12 );
 			}
 			else
 			{
-				PM_AddEvent( EV_STEPDN_16 );
+				PM_AddEvent( pm, EV_STEPDN_16 );
 			}
 		}
 	}
@@ -301,19 +301,19 @@ void PM_StepEvent( const vec3_t from, const vec3_t to, const vec3_t normal )
 		{
 			if ( size < 7.0f )
 			{
-				PM_AddEvent( EV_STEP_4 );
+				PM_AddEvent( pm, EV_STEP_4 );
 			}
 			else if ( size < 11.0f )
 			{
-				PM_AddEvent( EV_STEP_8 );
+				PM_AddEvent( pm, EV_STEP_8 );
 			}
 			else if ( size < 15.0f )
 			{
-				PM_AddEvent( EV_STEP_12 );
+				PM_AddEvent( pm, EV_STEP_12 );
 			}
 			else
 			{
-				PM_AddEvent( EV_STEP_16 );
+				PM_AddEvent( pm, EV_STEP_16 );
 			}
 		}
 	}
@@ -329,7 +329,7 @@ void PM_StepEvent( const vec3_t from, const vec3_t to, const vec3_t normal )
 PM_StepSlideMove
 ==================
 */
-qboolean PM_StepSlideMove( qboolean gravity, qboolean predictive )
+qboolean PM_StepSlideMove( pmove_t *pm, pml_t *pml, qboolean gravity, qboolean predictive )
 {
 	vec3_t   start_o, start_v;
 	vec3_t   down_o, down_v;
@@ -345,7 +345,7 @@ qboolean PM_StepSlideMove( qboolean gravity, qboolean predictive )
 	VectorCopy( pm->ps->origin, start_o );
 	VectorCopy( pm->ps->velocity, start_v );
 
-	if ( PM_SlideMove( gravity ) == 0 )
+	if ( PM_SlideMove( pm, pml, gravity ) == 0 )
 	{
 		VectorCopy( start_o, down );
 		VectorMA( down, -STEPSIZE, normal, down );
@@ -353,7 +353,7 @@ qboolean PM_StepSlideMove( qboolean gravity, qboolean predictive )
 
 		//we can step down
 		if ( trace.fraction > 0.01f && trace.fraction < 1.0f &&
-		     !trace.allsolid && pml.groundPlane != qfalse )
+		     !trace.allsolid && pml->groundPlane != qfalse )
 		{
 			if ( pm->debugLevel > 1 )
 			{
@@ -410,7 +410,7 @@ qboolean PM_StepSlideMove( qboolean gravity, qboolean predictive )
 		VectorCopy( trace.endpos, pm->ps->origin );
 		VectorCopy( start_v, pm->ps->velocity );
 
-		if ( PM_SlideMove( gravity ) == 0 )
+		if ( PM_SlideMove( pm, pml, gravity ) == 0 )
 		{
 			if ( pm->debugLevel > 1 )
 			{
@@ -438,7 +438,7 @@ qboolean PM_StepSlideMove( qboolean gravity, qboolean predictive )
 
 	if ( !predictive && stepped )
 	{
-		PM_StepEvent( start_o, pm->ps->origin, normal );
+		PM_StepEvent( pm, start_o, pm->ps->origin, normal );
 	}
 
 	return stepped;
@@ -449,7 +449,7 @@ qboolean PM_StepSlideMove( qboolean gravity, qboolean predictive )
 PM_PredictStepMove
 ==================
 */
-qboolean PM_PredictStepMove( void )
+qboolean PM_PredictStepMove( pmove_t *pm, pml_t *pml )
 {
 	vec3_t   velocity, origin;
 	float    impactSpeed;
@@ -457,16 +457,16 @@ qboolean PM_PredictStepMove( void )
 
 	VectorCopy( pm->ps->velocity, velocity );
 	VectorCopy( pm->ps->origin, origin );
-	impactSpeed = pml.impactSpeed;
+	impactSpeed = pml->impactSpeed;
 
-	if ( PM_StepSlideMove( qfalse, qtrue ) )
+	if ( PM_StepSlideMove( pm, pml, qfalse, qtrue ) )
 	{
 		stepped = qtrue;
 	}
 
 	VectorCopy( velocity, pm->ps->velocity );
 	VectorCopy( origin, pm->ps->origin );
-	pml.impactSpeed = impactSpeed;
+	pml->impactSpeed = impactSpeed;
 
 	return stepped;
 }